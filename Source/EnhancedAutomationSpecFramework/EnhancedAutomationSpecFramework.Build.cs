@@ -19,5 +19,12 @@ public class EnhancedAutomationSpecFramework : ModuleRules
 				"AutomationController",
 			}
 		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new[]
+			{
+				"Json",
+			}
+		);
 	}
 }
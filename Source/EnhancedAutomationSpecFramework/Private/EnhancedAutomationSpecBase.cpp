@@ -8,16 +8,225 @@
 
 #include "EnhancedAutomationSpecBase.h"
 
-#include <IAutomationControllerModule.h>
+#include <Algo/AllOf.h>
+#include <Algo/AnyOf.h>
+
+#include <Async/ParallelFor.h>
+
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformMemory.h>
+#include <HAL/PlatformTime.h>
+#include <HAL/PlatformTLS.h>
+
+#include <Misc/CommandLine.h>
+#include <Misc/Parse.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+#include "EnhancedSpecBenchmarkBaseline.h"
+#include "EnhancedSpecDefinitionCache.h"
+#include "EnhancedSpecDurationBaseline.h"
+#include "EnhancedSpecIdHash.h"
+#include "EnhancedSpecPerfCounters.h"
+#include "EnhancedSpecSharding.h"
+#include "EnhancedSpecStragglers.h"
+#include "EnhancedSpecTimerQueue.h"
+#include "EnhancedSpecTimingStore.h"
+#include "EnhancedSpecTraceRecorder.h"
+#include "EnhancedSpecWorkerPool.h"
+
+static TAutoConsoleVariable<float> CVarEnhancedSpecFrameBudgetMs(
+	TEXT("EnhancedSpecs.FrameBudgetMs"),
+	0.0f,
+	TEXT("The maximum time, in milliseconds, that enhanced automation specs spend running blocks back to back within ")
+	TEXT("a single frame before yielding to the engine, including time spent blocking the game thread while waiting ")
+	TEXT("for asynchronous blocks to finish. 0 (the default) removes the limit on blocks that run back to back, and ")
+	TEXT("never blocks the game thread waiting on asynchronous blocks."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarEnhancedSpecRunSynchronousSpecsAhead(
+	TEXT("EnhancedSpecs.RunSynchronousSpecsAhead"),
+	false,
+	TEXT("Whether a test case made entirely of synchronous blocks also runs the requested test cases of the same spec ")
+	TEXT("that follow it, as long as they are synchronous too, so that each of them only has to report its stored ")
+	TEXT("results when the automation controller gets to it, without waiting for a frame. Messages logged through ")
+	TEXT("UE_LOG and errors expected through AddExpectedError() by a test case that runs ahead are attributed to the ")
+	TEXT("test case that ran it."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<bool> CVarEnhancedSpecReportMemoryWatermark(
+	TEXT("EnhancedSpecs.ReportMemoryWatermark"),
+	false,
+	TEXT("Whether to log how much each enhanced automation spec raised the peak physical memory of the process, and ")
+	TEXT("how much memory was still in use after its variables were released. Specs run in parallel are not reported."),
+	ECVF_Default
+);
+
+// =====================================================================================================================
+// FSpecLatentCommand
+// =====================================================================================================================
+void FEnhancedAutomationSpecBase::FSpecLatentCommand::BeginTrace()
+{
+	if (this->IsTraced())
+	{
+		this->TraceStartSeconds = FPlatformTime::Seconds();
+		this->TraceEndSeconds   = 0.0;
+		this->TraceStartFrame   = GFrameCounter;
+		this->TraceThreadId     = FPlatformTLS::GetCurrentThreadId();
+	}
+}
+
+void FEnhancedAutomationSpecBase::FSpecLatentCommand::MarkTraceThread()
+{
+	if (this->IsTraced())
+	{
+		this->TraceThreadId = FPlatformTLS::GetCurrentThreadId();
+	}
+}
+
+void FEnhancedAutomationSpecBase::FSpecLatentCommand::MarkTraceWorkDone()
+{
+	if (this->IsTraced())
+	{
+		this->TraceEndSeconds = FPlatformTime::Seconds();
+	}
+}
+
+void FEnhancedAutomationSpecBase::FSpecLatentCommand::EndTrace(const FEnhancedAutomationSpecBase& Spec,
+                                                               const bool                         bTimedOut)
+{
+	if (this->IsTraced())
+	{
+		const double EndSeconds =
+			(bTimedOut || (this->TraceEndSeconds == 0.0)) ? FPlatformTime::Seconds() : this->TraceEndSeconds;
+
+		this->RecordTrace(
+			Spec,
+			this->TraceStartSeconds,
+			this->TraceStartFrame,
+			EndSeconds,
+			this->TraceThreadId,
+			bTimedOut
+		);
+	}
+}
+
+void FEnhancedAutomationSpecBase::FSpecLatentCommand::ArmWakeSignal(const TSharedRef<FSpecWakeSignal>& Signal,
+                                                                     const double                       Deadline)
+{
+	const int32 Generation = Signal->Arm();
+
+	FEnhancedSpecTimerQueue::Get().Schedule(Deadline, Signal, Generation);
+}
+
+bool FEnhancedAutomationSpecBase::FSpecLatentCommand::IsItBlock() const
+{
+	return this->IsTraced() && (FCString::Strcmp(this->TraceCategory, TEXT("It")) == 0);
+}
+
+void FEnhancedAutomationSpecBase::FSpecLatentCommand::RecordTrace(const FEnhancedAutomationSpecBase& Spec,
+                                                                  const double                       StartSeconds,
+                                                                  const uint64                       StartFrame,
+                                                                  const double                       EndSeconds,
+                                                                  const uint32                       ThreadId,
+                                                                  const bool                         bTimedOut) const
+{
+	const FSpec*                   RunningSpec = Spec.GetRunningSpec();
+	const bool                     bIsItBlock  = this->IsItBlock();
+	FEnhancedSpecDurationBaseline& Baseline    = FEnhancedSpecDurationBaseline::Get();
+	FString                        BlockName;
+	FEnhancedSpecTraceEvent        Event;
+
+	if (this->TraceScope.IsEmpty())
+	{
+		BlockName = this->TraceCategory;
+	}
+	else
+	{
+		BlockName = FString::Printf(TEXT("%s (%s)"), this->TraceCategory, *this->TraceScope);
+	}
+
+	// The duration of each It() block is already part of the duration recorded for its test case.
+	if (Baseline.IsEnabled() && !bIsItBlock && !bTimedOut)
+	{
+		Baseline.RecordHook(FString::Printf(TEXT("%s %s"), *Spec.TestName, *BlockName), EndSeconds - StartSeconds);
+	}
+
+	if (!FEnhancedSpecTraceRecorder::Get().IsEnabled())
+	{
+		return;
+	}
+
+	if (RunningSpec == nullptr)
+	{
+		Event.TestName = Spec.GetTestFullName();
+	}
+	else
+	{
+		Event.TestName = Spec.GetFullTestName(*RunningSpec);
+	}
+
+	if (bIsItBlock && (RunningSpec != nullptr))
+	{
+		Event.Name = RunningSpec->Description;
+	}
+	else
+	{
+		Event.Name = MoveTemp(BlockName);
+	}
+
+	Event.Category     = this->TraceCategory;
+	Event.Scope        = this->TraceScope;
+	Event.StartSeconds = StartSeconds;
+	Event.EndSeconds   = EndSeconds;
+	Event.ThreadId     = ThreadId;
+	Event.NumFrames    = GFrameCounter - StartFrame;
+	Event.bTimedOut    = bTimedOut;
+
+	FEnhancedSpecTraceRecorder::Get().Record(MoveTemp(Event));
+}
 
 // =====================================================================================================================
 // FSimpleBlockingCommand
 // =====================================================================================================================
 bool FEnhancedAutomationSpecBase::FSimpleBlockingCommand::Update()
 {
-	if (!this->bSkipIfErrored || !this->Spec->HasAnyErrors())
+	if (!this->bSkipIfErrored || !this->Spec->HasAnyErrorsInContext())
 	{
-		this->Work();
+		if (this->IsTraced())
+		{
+			// This command can be run by several workers at once in a parallel batch, so the run is timed with locals
+			// rather than with the fields of the command.
+			const double                  StartSeconds = FPlatformTime::Seconds();
+			const uint64                  StartFrame   = GFrameCounter;
+			FEnhancedSpecPerfCounterScope PerfCounterScope(this->IsItBlock());
+
+			this->Work();
+
+			if (PerfCounterScope.IsMeasuring())
+			{
+				const FEnhancedSpecPerfCounterValues PerfCounters = PerfCounterScope.Stop();
+
+				if (PerfCounters.HasAny())
+				{
+					this->Spec->AddInfo(FString::Printf(TEXT("Performance counters: %s"), *PerfCounters.ToString()));
+				}
+			}
+
+			this->RecordTrace(
+				*this->Spec,
+				StartSeconds,
+				StartFrame,
+				FPlatformTime::Seconds(),
+				FPlatformTLS::GetCurrentThreadId(),
+				false
+			);
+		}
+		else
+		{
+			this->Work();
+		}
 	}
 
 	return true;
@@ -28,31 +237,50 @@ bool FEnhancedAutomationSpecBase::FSimpleBlockingCommand::Update()
 // =====================================================================================================================
 bool FEnhancedAutomationSpecBase::FAsyncCommand::Update()
 {
-	if (!this->Future.IsValid())
+	if (!this->bHasStartedRunning)
 	{
 		if (this->bSkipIfErrored && this->Spec->HasAnyErrors())
 		{
 			return true;
 		}
 
-		this->bDone = false;
+		this->bDone              = false;
+		this->bHasStartedRunning = true;
+		this->Deadline           = FPlatformTime::Seconds() + this->Timeout.GetTotalSeconds();
 
-		this->Future = Async(this->Execution, [this]() {
-			this->Work();
-			this->Done();
-		});
+		ArmWakeSignal(this->WakeSignal, this->Deadline);
+
+		this->BeginTrace();
+
+		const TSharedRef<FSpecCancellationToken> Token = MakeShared<FSpecCancellationToken>();
+
+		this->CancellationToken = Token;
 
-		this->StartTime = FDateTime::UtcNow();
+		// The command is kept alive for as long as the work runs, in case the work is abandoned and outlives the test.
+		this->Future = FEnhancedSpecWorkerPool::Get().Launch(
+			this->Execution,
+			[this, Token, KeepAlive = this->AsShared()]()
+			{
+				TGuardValue<TSharedPtr<FSpecCancellationToken>> TokenGuard(GetCancellationTokenForThread(), Token);
+
+				this->MarkTraceThread();
+				this->Work();
+				this->Done(Token);
+			}
+		);
 	}
 
 	if (this->bDone)
 	{
+		this->EndTrace(*this->Spec, false);
 		this->Reset();
 
 		return true;
 	}
-	else if (FDateTime::UtcNow() >= (StartTime + Timeout))
+	else if (FPlatformTime::Seconds() >= this->Deadline)
 	{
+		this->EndTrace(*this->Spec, true);
+		this->Abandon();
 		this->Reset();
 		this->Spec->AddError(TEXT("Latent command timed out."), 0);
 
@@ -62,19 +290,54 @@ bool FEnhancedAutomationSpecBase::FAsyncCommand::Update()
 	return false;
 }
 
-void FEnhancedAutomationSpecBase::FAsyncCommand::Done()
+bool FEnhancedAutomationSpecBase::FAsyncCommand::WaitForProgress(const double MaxWaitSeconds)
+{
+	const double WaitSeconds = FMath::Min(MaxWaitSeconds, this->Deadline - FPlatformTime::Seconds());
+
+	// Work that runs on the game thread cannot make progress while the game thread is blocked waiting on it.
+	if (!this->bHasStartedRunning || (this->Execution == EAsyncExecution::TaskGraphMainThread))
+	{
+		return false;
+	}
+
+	if (!this->bDone && (WaitSeconds > 0.0))
+	{
+		this->CompletionEvent->Wait(FTimespan::FromSeconds(WaitSeconds));
+	}
+
+	return true;
+}
+
+void FEnhancedAutomationSpecBase::FAsyncCommand::Done(const TSharedRef<FSpecCancellationToken> Token)
 {
-	if (this->Future.IsValid())
+	// Work that was abandoned must not complete a later run of this command.
+	if (this->bHasStartedRunning && !Token->IsCanceled())
 	{
+		this->MarkTraceWorkDone();
+
 		this->bDone = true;
+		this->CompletionEvent->Trigger();
+		this->WakeSignal->Raise();
+	}
+}
+
+void FEnhancedAutomationSpecBase::FAsyncCommand::Abandon()
+{
+	if (this->CancellationToken.IsValid())
+	{
+		this->CancellationToken->Cancel();
 	}
+
+	FEnhancedSpecStragglers::Get().Quarantine(this->Spec->GetTestFullName(), MoveTemp(this->Future));
 }
 
 void FEnhancedAutomationSpecBase::FAsyncCommand::Reset()
 {
 	// Reset the status for the next potential run of this command.
-	this->bDone = false;
+	this->bDone              = false;
+	this->bHasStartedRunning = false;
 
+	this->CancellationToken.Reset();
 	this->Future.Reset();
 }
 
@@ -90,22 +353,28 @@ bool FEnhancedAutomationSpecBase::FMultiFrameLatentCommand::Update()
 			return true;
 		}
 
-		this->bDone = false;
+		this->bDone              = false;
+		this->bHasStartedRunning = true;
+		this->Deadline           = FPlatformTime::Seconds() + this->Timeout.GetTotalSeconds();
+
+		ArmWakeSignal(this->WakeSignal, this->Deadline);
 
-		this->Work(FDoneDelegate::CreateSP(this, &FMultiFrameLatentCommand::Done));
+		this->BeginTrace();
 
-		this->bHasStartedRunning = true;
-		this->StartTime          = FDateTime::UtcNow();
+		// The work may signal that it is done before it returns, so the command must already be marked as running.
+		this->Work(FDoneDelegate::CreateSP(this, &FMultiFrameLatentCommand::Done));
 	}
 
 	if (this->bDone)
 	{
+		this->EndTrace(*this->Spec, false);
 		this->Reset();
 
 		return true;
 	}
-	else if (FDateTime::UtcNow() >= (this->StartTime + this->Timeout))
+	else if (FPlatformTime::Seconds() >= this->Deadline)
 	{
+		this->EndTrace(*this->Spec, true);
 		this->Reset();
 		this->Spec->AddError(TEXT("Latent command timed out."), 0);
 
@@ -119,7 +388,10 @@ void FEnhancedAutomationSpecBase::FMultiFrameLatentCommand::Done()
 {
 	if (this->bHasStartedRunning)
 	{
+		this->MarkTraceWorkDone();
+
 		this->bDone = true;
+		this->WakeSignal->Raise();
 	}
 }
 
@@ -135,30 +407,48 @@ void FEnhancedAutomationSpecBase::FMultiFrameLatentCommand::Reset()
 // =====================================================================================================================
 bool FEnhancedAutomationSpecBase::FAsyncMultiFrameLatentCommand::Update()
 {
-	if (!this->Future.IsValid())
+	if (!this->bHasStartedRunning)
 	{
 		if (this->bSkipIfErrored && this->Spec->HasAnyErrors())
 		{
 			return true;
 		}
 
-		this->bDone = false;
+		this->bDone              = false;
+		this->bHasStartedRunning = true;
+		this->Deadline           = FPlatformTime::Seconds() + this->Timeout.GetTotalSeconds();
 
-		this->Future = Async(this->Execution, [this]() {
-			this->Work(FDoneDelegate::CreateRaw(this, &FAsyncMultiFrameLatentCommand::Done));
-		});
+		ArmWakeSignal(this->WakeSignal, this->Deadline);
 
-		this->StartTime = FDateTime::UtcNow();
+		this->BeginTrace();
+
+		const TSharedRef<FSpecCancellationToken> Token = MakeShared<FSpecCancellationToken>();
+
+		this->CancellationToken = Token;
+
+		this->Future = FEnhancedSpecWorkerPool::Get().Launch(
+			this->Execution,
+			[this, Token, KeepAlive = this->AsShared()]()
+			{
+				TGuardValue<TSharedPtr<FSpecCancellationToken>> TokenGuard(GetCancellationTokenForThread(), Token);
+
+				this->MarkTraceThread();
+				this->Work(FDoneDelegate::CreateSP(this, &FAsyncMultiFrameLatentCommand::Done, Token));
+			}
+		);
 	}
 
 	if (this->bDone)
 	{
+		this->EndTrace(*this->Spec, false);
 		this->Reset();
 
 		return true;
 	}
-	else if (FDateTime::UtcNow() >= (this->StartTime + this->Timeout))
+	else if (FPlatformTime::Seconds() >= this->Deadline)
 	{
+		this->EndTrace(*this->Spec, true);
+		this->Abandon();
 		this->Reset();
 		this->Spec->AddError(TEXT("Latent command timed out."), 0);
 
@@ -168,22 +458,123 @@ bool FEnhancedAutomationSpecBase::FAsyncMultiFrameLatentCommand::Update()
 	return false;
 }
 
-void FEnhancedAutomationSpecBase::FAsyncMultiFrameLatentCommand::Done()
+bool FEnhancedAutomationSpecBase::FAsyncMultiFrameLatentCommand::WaitForProgress(const double MaxWaitSeconds)
+{
+	const double WaitSeconds = FMath::Min(MaxWaitSeconds, this->Deadline - FPlatformTime::Seconds());
+
+	// Work that runs on the game thread cannot make progress while the game thread is blocked waiting on it.
+	if (!this->bHasStartedRunning || (this->Execution == EAsyncExecution::TaskGraphMainThread))
+	{
+		return false;
+	}
+
+	if (!this->bDone && (WaitSeconds > 0.0))
+	{
+		this->CompletionEvent->Wait(FTimespan::FromSeconds(WaitSeconds));
+	}
+
+	return true;
+}
+
+void FEnhancedAutomationSpecBase::FAsyncMultiFrameLatentCommand::Done(const TSharedRef<FSpecCancellationToken> Token)
 {
-	if (this->Future.IsValid())
+	// Work that was abandoned must not complete a later run of this command.
+	if (this->bHasStartedRunning && !Token->IsCanceled())
 	{
+		this->MarkTraceWorkDone();
+
 		this->bDone = true;
+		this->CompletionEvent->Trigger();
+		this->WakeSignal->Raise();
+	}
+}
+
+void FEnhancedAutomationSpecBase::FAsyncMultiFrameLatentCommand::Abandon()
+{
+	if (this->CancellationToken.IsValid())
+	{
+		this->CancellationToken->Cancel();
 	}
+
+	FEnhancedSpecStragglers::Get().Quarantine(this->Spec->GetTestFullName(), MoveTemp(this->Future));
 }
 
 void FEnhancedAutomationSpecBase::FAsyncMultiFrameLatentCommand::Reset()
 {
 	// Reset the status for the next potential run of this command.
-	this->bDone = false;
+	this->bDone              = false;
+	this->bHasStartedRunning = false;
 
+	this->CancellationToken.Reset();
 	this->Future.Reset();
 }
 
+// =====================================================================================================================
+// FSpecCommandSequence
+// =====================================================================================================================
+bool FEnhancedAutomationSpecBase::FSpecCommandSequence::Update()
+{
+	bool bIsDone;
+
+	// A command that is waiting cannot make progress until it raises its signal, so it is not updated before then.
+	if (this->PendingWakeSignal.IsValid())
+	{
+		FEnhancedSpecTimerQueue::Get().RaiseDueSignals(FPlatformTime::Seconds());
+
+		if (!this->PendingWakeSignal->IsRaised())
+		{
+			return false;
+		}
+
+		this->PendingWakeSignal.Reset();
+	}
+
+	// Only the time spent within this update counts towards the duration of the test case that is running, not the
+	// frames that pass while it waits to be updated again.
+	this->Spec->ResumeSpecTimer();
+
+	bIsDone = this->UpdateCommands();
+
+	this->Spec->PauseSpecTimer();
+
+	return bIsDone;
+}
+
+bool FEnhancedAutomationSpecBase::FSpecCommandSequence::UpdateCommands()
+{
+	const double FrameBudgetSeconds = CVarEnhancedSpecFrameBudgetMs.GetValueOnGameThread() / 1000.0;
+	const double Deadline           = FPlatformTime::Seconds() + FrameBudgetSeconds;
+
+	while (this->NextCommandIndex < this->Commands.Num())
+	{
+		const TSharedRef<FSpecLatentCommand>& Command = this->Commands[this->NextCommandIndex];
+
+		while (!Command->Update())
+		{
+			const double RemainingSeconds = Deadline - FPlatformTime::Seconds();
+
+			// If the command can signal when it finishes, wait for it while there is time left in this frame rather
+			// than yielding to the engine. Without a budget, there is no bound on how long the engine would be stalled,
+			// so the sequence instead yields right away, and resumes once the command raises its wake signal.
+			if ((FrameBudgetSeconds <= 0.0) || (RemainingSeconds <= 0.0) || !Command->WaitForProgress(RemainingSeconds))
+			{
+				this->PendingWakeSignal = Command->GetWakeSignal();
+
+				return false;
+			}
+		}
+
+		++this->NextCommandIndex;
+
+		if ((FrameBudgetSeconds > 0.0) && (FPlatformTime::Seconds() >= Deadline))
+		{
+			break;
+		}
+	}
+
+	return (this->NextCommandIndex >= this->Commands.Num());
+}
+
 // =====================================================================================================================
 // FSpecBlockHandle
 // =====================================================================================================================
@@ -197,24 +588,26 @@ void FEnhancedAutomationSpecBase::FSpecBlockHandle::Assign()
 // =====================================================================================================================
 // FEnhancedTestSessionState
 // =====================================================================================================================
-FEnhancedAutomationSpecBase::FEnhancedTestSessionState::FEnhancedTestSessionState()
+FEnhancedAutomationSpecBase::FEnhancedTestSessionState::FEnhancedTestSessionState(FEnhancedAutomationSpecBase& Spec) :
+	Spec(Spec),
+	bIsEndingSession(false),
+	bAreRequestedTestNamesKnown(false)
 {
-	const IAutomationControllerManagerPtr AutomationControllerManager = this->GetAutomationController();
+	FEnhancedAutomationSpecFramework* Module = FEnhancedAutomationSpecFramework::GetIfLoaded();
 
-	if (AutomationControllerManager.IsValid())
+	if (Module != nullptr)
 	{
-		this->TestDelegateHandle =
-			AutomationControllerManager->OnTestsComplete().AddRaw(this, &FEnhancedTestSessionState::ClearState);
+		this->SessionEndHandle = Module->OnSessionEnd().AddRaw(this, &FEnhancedTestSessionState::EndSession);
 	}
 }
 
 FEnhancedAutomationSpecBase::FEnhancedTestSessionState::~FEnhancedTestSessionState()
 {
-	const IAutomationControllerManagerPtr AutomationControllerManager = this->GetAutomationController();
+	FEnhancedAutomationSpecFramework* Module = FEnhancedAutomationSpecFramework::GetIfLoaded();
 
-	if (this->TestDelegateHandle.IsValid() && AutomationControllerManager.IsValid())
+	if (this->SessionEndHandle.IsValid() && (Module != nullptr))
 	{
-		AutomationControllerManager->OnTestsComplete().Remove(this->TestDelegateHandle);
+		Module->OnSessionEnd().Remove(this->SessionEndHandle);
 	}
 }
 
@@ -229,24 +622,81 @@ void FEnhancedAutomationSpecBase::FEnhancedTestSessionState::MarkBlockAsRun(cons
 	this->BlocksRun.Add(BlockHandle);
 }
 
-IAutomationControllerManagerPtr FEnhancedAutomationSpecBase::FEnhancedTestSessionState::GetAutomationController()
+void FEnhancedAutomationSpecBase::FEnhancedTestSessionState::StoreParallelResult(const FString&           SpecId,
+                                                                                 TArray<FAutomationEvent> Events)
+{
+	this->ParallelResults.Add(SpecId, MoveTemp(Events));
+}
+
+bool FEnhancedAutomationSpecBase::FEnhancedTestSessionState::TakeParallelResult(const FString&            SpecId,
+                                                                                TArray<FAutomationEvent>& OutEvents)
+{
+	return this->ParallelResults.RemoveAndCopyValue(SpecId, OutEvents);
+}
+
+bool FEnhancedAutomationSpecBase::FEnhancedTestSessionState::HasParallelResult(const FString& SpecId) const
+{
+	return this->ParallelResults.Contains(SpecId);
+}
+
+void FEnhancedAutomationSpecBase::FEnhancedTestSessionState::MarkSpecAsRun(const FString& SpecId)
 {
-	IAutomationControllerManagerPtr Result;
+	this->SpecsRun.Add(SpecId);
+}
 
-	IAutomationControllerModule* AutomationControllerModule =
-		FModuleManager::GetModulePtr<IAutomationControllerModule>(TEXT("AutomationController"));
+bool FEnhancedAutomationSpecBase::FEnhancedTestSessionState::HasSpecRun(const FString& SpecId) const
+{
+	return this->SpecsRun.Contains(SpecId);
+}
 
-	if (AutomationControllerModule != nullptr)
+const TSet<FString>* FEnhancedAutomationSpecBase::FEnhancedTestSessionState::GetRequestedTestNames()
+{
+	if (!this->RequestedTestNames.IsSet())
 	{
-		Result = AutomationControllerModule->GetAutomationController();
+		TSet<FString> TestNames;
+
+		this->bAreRequestedTestNamesKnown = this->Spec.GetRequestedTestNames(TestNames);
+		this->RequestedTestNames          = MoveTemp(TestNames);
 	}
 
-	return Result;
+	return this->bAreRequestedTestNamesKnown ? &this->RequestedTestNames.GetValue() : nullptr;
+}
+
+void FEnhancedAutomationSpecBase::FEnhancedTestSessionState::MarkSpecAsFinished(const FSpecBlockHandle& ScopeHandle)
+{
+	++this->NumSpecsFinishedPerScope.FindOrAdd(ScopeHandle, 0);
+}
+
+int32 FEnhancedAutomationSpecBase::FEnhancedTestSessionState::GetNumSpecsFinished(
+	const FSpecBlockHandle& ScopeHandle) const
+{
+	const int32* NumSpecsFinished = this->NumSpecsFinishedPerScope.Find(ScopeHandle);
+
+	return (NumSpecsFinished != nullptr) ? *NumSpecsFinished : 0;
+}
+
+void FEnhancedAutomationSpecBase::FEnhancedTestSessionState::MarkScopeAsStarted(const FSpecBlockHandle& ScopeHandle)
+{
+	this->ScopesStarted.Add(ScopeHandle);
+}
+
+bool FEnhancedAutomationSpecBase::FEnhancedTestSessionState::HasScopeStarted(const FSpecBlockHandle& ScopeHandle) const
+{
+	return this->ScopesStarted.Contains(ScopeHandle);
 }
 
-void FEnhancedAutomationSpecBase::FEnhancedTestSessionState::ClearState()
+void FEnhancedAutomationSpecBase::FEnhancedTestSessionState::EndSession()
 {
+	this->bIsEndingSession = true;
+	this->Spec.RunPendingAfterAllBlocks();
+	this->bIsEndingSession = false;
+
 	this->BlocksRun.Empty();
+	this->ParallelResults.Empty();
+	this->SpecsRun.Empty();
+	this->RequestedTestNames.Reset();
+	this->NumSpecsFinishedPerScope.Empty();
+	this->ScopesStarted.Empty();
 }
 
 // =====================================================================================================================
@@ -254,14 +704,19 @@ void FEnhancedAutomationSpecBase::FEnhancedTestSessionState::ClearState()
 // =====================================================================================================================
 FString FEnhancedAutomationSpecBase::GetTestSourceFileName(const FString& InTestName) const
 {
-	FString TestId = InTestName;
+	const FStringView                               TestId         = this->GetSpecIdFromTestName(InTestName);
+	const TSharedPtr<const FEnhancedSpecListingSet> CachedListings = this->FindCachedListings();
+	const FEnhancedSpecListing*                     CachedListing  =
+		CachedListings.IsValid() ? CachedListings->Find(TestId) : nullptr;
 
-	if (TestId.StartsWith(this->TestName + TEXT(" ")))
+	if (CachedListing != nullptr)
 	{
-		TestId = InTestName.RightChop(this->TestName.Len() + 1);
+		return CachedListing->Filename;
 	}
 
-	const TSharedRef<FSpec>* Spec = this->IdToSpecMap.Find(TestId);
+	this->EnsureDefinitionFor(TestId);
+
+	const TSharedRef<FSpec>* Spec = this->FindSpec(TestId);
 
 	if (Spec != nullptr)
 	{
@@ -273,14 +728,19 @@ FString FEnhancedAutomationSpecBase::GetTestSourceFileName(const FString& InTest
 
 int32 FEnhancedAutomationSpecBase::GetTestSourceFileLine(const FString& InTestName) const
 {
-	FString TestId = InTestName;
+	const FStringView                               TestId         = this->GetSpecIdFromTestName(InTestName);
+	const TSharedPtr<const FEnhancedSpecListingSet> CachedListings = this->FindCachedListings();
+	const FEnhancedSpecListing*                     CachedListing  =
+		CachedListings.IsValid() ? CachedListings->Find(TestId) : nullptr;
 
-	if (TestId.StartsWith(this->TestName + TEXT(" ")))
+	if (CachedListing != nullptr)
 	{
-		TestId = InTestName.RightChop(this->TestName.Len() + 1);
+		return CachedListing->LineNumber;
 	}
 
-	const TSharedRef<FSpec>* Spec = this->IdToSpecMap.Find(TestId);
+	this->EnsureDefinitionFor(TestId);
+
+	const TSharedRef<FSpec>* Spec = this->FindSpec(TestId);
 
 	if (Spec != nullptr)
 	{
@@ -292,66 +752,230 @@ int32 FEnhancedAutomationSpecBase::GetTestSourceFileLine(const FString& InTestNa
 
 void FEnhancedAutomationSpecBase::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
 {
-	TArray<TSharedRef<FSpec>> Specs;
+	FEnhancedSpecDefinitionCache&                   Cache          = FEnhancedSpecDefinitionCache::Get();
+	const bool                                      bShouldCache   = Cache.IsEnabled() && this->CanCacheDefinitions();
+	const TSharedPtr<const FEnhancedSpecListingSet> CachedListings = this->FindCachedListings();
+	TArray<TSharedRef<FSpec>>                       Specs;
+	TArray<FEnhancedSpecListing>                    Listings;
+
+	// Listing test cases from the cache avoids having to define this specification until one of them runs.
+	if (CachedListings.IsValid())
+	{
+		FEnhancedAutomationSpecBase* MutableThis = const_cast<FEnhancedAutomationSpecBase*>(this);
+
+		for (const FEnhancedSpecListing& Listing : CachedListings->Listings)
+		{
+			OutTestCommands.Push(Listing.Id);
+			OutBeautifiedNames.Push(Listing.Description);
+		}
+
+		// Count this specification as a dependent of its fixtures now, as if it had been defined. Otherwise, the
+		// fixtures would be released after each dependent spec class that does get defined, only to be built again by
+		// the next one.
+		for (const FString& FixtureName : CachedListings->FixtureNames)
+		{
+			FEnhancedSpecFixtureBase* Fixture = FEnhancedSpecFixtureRegistry::Get().Find(FName(*FixtureName));
+
+			if (Fixture != nullptr)
+			{
+				MutableThis->CountAsFixtureDependent(*Fixture);
+			}
+		}
+
+		return;
+	}
 
 	this->EnsureDefinitions();
 
-	this->IdToSpecMap.GenerateValueArray(Specs);
+	this->SpecsByIdHash.GenerateValueArray(Specs);
 
 	for (auto TestIterator = Specs.CreateIterator(); TestIterator; ++TestIterator)
 	{
 		const TSharedRef<FSpec> SpecToRun = *TestIterator;
 
+		if (!SpecToRun->bIsInShard)
+		{
+			continue;
+		}
+
 		OutTestCommands.Push(SpecToRun->Id);
 		OutBeautifiedNames.Push(SpecToRun->Description);
+
+		if (bShouldCache)
+		{
+			Listings.Add({ SpecToRun->Id, SpecToRun->Description, SpecToRun->Filename, SpecToRun->LineNumber });
+		}
+	}
+
+	if (bShouldCache)
+	{
+		TArray<FString> FixtureNames;
+
+		for (const FEnhancedSpecFixtureBase* Fixture : this->FixtureDependencies)
+		{
+			FixtureNames.Add(Fixture->GetName().ToString());
+		}
+
+		Cache.Store(
+			this->TestName,
+			Cache.GetBuildStamp(this->ModuleName),
+			MoveTemp(Listings),
+			MoveTemp(FixtureNames)
+		);
 	}
 }
 
 bool FEnhancedAutomationSpecBase::RunTest(const FString& InParameters)
 {
-	this->EnsureDefinitions();
+	if (InParameters.IsEmpty())
+	{
+		this->EnsureDefinitions();
+	}
+	else
+	{
+		this->EnsureDefinitionFor(InParameters);
+	}
 
 	if (!this->SuiteSessionState.IsValid())
 	{
-		this->SuiteSessionState = MakeShareable(new FEnhancedTestSessionState());
+		this->SuiteSessionState = MakeShareable(new FEnhancedTestSessionState(*this));
 	}
 
+	TArray<TSharedRef<FSpecLatentCommand>> Commands;
+	FSpecParallelBatches                   ParallelBatches;
+	bool                                   bHasStoredResult = false;
+
 	if (InParameters.IsEmpty())
 	{
 		TArray<TSharedRef<FSpec>> Specs;
 
-		this->IdToSpecMap.GenerateValueArray(Specs);
+		this->SpecsByIdHash.GenerateValueArray(Specs);
 
 		// Run all tests.
 		for (auto TestIterator = Specs.CreateIterator(); TestIterator; ++TestIterator)
 		{
 			const TSharedRef<FSpec> SpecToRun = *TestIterator;
 
-			this->RunSpec(SpecToRun);
+			if (SpecToRun->bIsInShard)
+			{
+				this->GatherSpecCommands(SpecToRun, ParallelBatches, Commands);
+			}
 		}
 	}
 	else
 	{
-		const TSharedRef<FSpec>* SpecToRun = this->IdToSpecMap.Find(InParameters);
+		const TSharedRef<FSpec>* SpecToRun = this->FindSpec(InParameters);
 
 		// Run specific test.
 		if (SpecToRun != nullptr)
 		{
-			this->RunSpec(*SpecToRun);
+			this->GatherSpecCommands(*SpecToRun, ParallelBatches, Commands);
+
+			bHasStoredResult = this->SuiteSessionState->HasParallelResult((*SpecToRun)->Id);
+		}
+	}
+
+	if (Commands.Num() != 0)
+	{
+		const TSharedRef<FSpecCommandSequence> Sequence =
+			MakeShareable(new FSpecCommandSequence(this, MoveTemp(Commands)));
+
+		// A test case that already ran in parallel or ahead of time only has to report what it stored, which does not
+		// need to wait for the next frame.
+		if (!bHasStoredResult || !Sequence->Update())
+		{
+			FAutomationTestFramework::GetInstance().EnqueueLatentCommand(Sequence);
 		}
 	}
 
 	return true;
 }
 
-void FEnhancedAutomationSpecBase::Describe(const FString& InDescription, const TFunction<void()>& DoWork)
+void FEnhancedAutomationSpecBase::AddError(const FString& InError, const int32 StackOffset)
 {
-	LLM_SCOPE_BYNAME(TEXT("AutomationTest/Framework"));
+	if (DiscardIfAbandoned(TEXT("error"), InError))
+	{
+		return;
+	}
 
-	const TSharedRef<FSpecDefinitionScope> ParentScope = this->DefinitionScopeStack.Last();
-	const TSharedRef<FSpecDefinitionScope> NewScope    = MakeShareable(new FSpecDefinitionScope());
+	FParallelSpecContext* ParallelContext = this->bIsRunningInParallel ? GetParallelContextForThread() : nullptr;
 
-	NewScope->Description = InDescription;
+	if (ParallelContext != nullptr)
+	{
+		ParallelContext->Events.Emplace(EAutomationEventType::Error, InError);
+		ParallelContext->bHasErrors = true;
+	}
+	else
+	{
+		FAutomationTestBase::AddError(InError, StackOffset);
+	}
+}
+
+void FEnhancedAutomationSpecBase::AddWarning(const FString& InWarning, const int32 StackOffset)
+{
+	if (DiscardIfAbandoned(TEXT("warning"), InWarning))
+	{
+		return;
+	}
+
+	FParallelSpecContext* ParallelContext = this->bIsRunningInParallel ? GetParallelContextForThread() : nullptr;
+
+	if (ParallelContext != nullptr)
+	{
+		ParallelContext->Events.Emplace(EAutomationEventType::Warning, InWarning);
+	}
+	else
+	{
+		FAutomationTestBase::AddWarning(InWarning, StackOffset);
+	}
+}
+
+void FEnhancedAutomationSpecBase::AddInfo(const FString& InLogItem, const int32 StackOffset, const bool bCaptureStack)
+{
+	if (DiscardIfAbandoned(TEXT("message"), InLogItem))
+	{
+		return;
+	}
+
+	FParallelSpecContext* ParallelContext = this->bIsRunningInParallel ? GetParallelContextForThread() : nullptr;
+
+	if (ParallelContext != nullptr)
+	{
+		ParallelContext->Events.Emplace(EAutomationEventType::Info, InLogItem);
+	}
+	else
+	{
+		FAutomationTestBase::AddInfo(InLogItem, StackOffset, bCaptureStack);
+	}
+}
+
+void FEnhancedAutomationSpecBase::Describe(const FString& InDescription, const TFunction<void()>& DoWork)
+{
+	this->DescribeScope(InDescription, false, DoWork);
+}
+
+void FEnhancedAutomationSpecBase::DescribeParallel(const FString& InDescription, const TFunction<void()>& DoWork)
+{
+	this->DescribeScope(InDescription, true, DoWork);
+}
+
+void FEnhancedAutomationSpecBase::DescribeScope(const FString&           InDescription,
+                                                const bool               bRunInParallel,
+                                                const TFunction<void()>& DoWork)
+{
+	LLM_SCOPE_BYNAME(TEXT("AutomationTest/Framework"));
+
+	if (this->bIsDefiningLazily && !bRunInParallel && !this->IsDefiningParallelScope())
+	{
+		this->DeferScope(InDescription, DoWork);
+		return;
+	}
+
+	const TSharedRef<FSpecDefinitionScope> ParentScope = this->DefinitionScopeStack.Last();
+	const TSharedRef<FSpecDefinitionScope> NewScope    = this->DefinitionArena->New<FSpecDefinitionScope>();
+
+	NewScope->Description    = InDescription;
+	NewScope->bRunInParallel = bRunInParallel;
 
 	ParentScope->Children.Push(NewScope);
 
@@ -363,53 +987,56 @@ void FEnhancedAutomationSpecBase::Describe(const FString& InDescription, const T
 	this->PopDescription();
 	this->DefinitionScopeStack.Pop();
 
-	if (NewScope->It.Num() == 0 && NewScope->Children.Num() == 0)
+	if (NewScope->It.Num() == 0 && NewScope->Children.Num() == 0 && NewScope->DeferredChildren.Num() == 0)
 	{
 		ParentScope->Children.Remove(NewScope);
 	}
 }
 
-void FEnhancedAutomationSpecBase::It(const FString& InDescription, const TFunction<void()>& DoWork)
+void FEnhancedAutomationSpecBase::It(const FString&             InDescription,
+                                     const TFunction<void()>&   DoWork,
+                                     const FSpecSourceLocation& Location)
 {
-	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
-	const FProgramCounterSymbolInfo&       TopOfStack   = GetTopOfCallStack();
+	const TSharedRef<FSpecDefinitionScope> CurrentScope           = this->DefinitionScopeStack.Last();
+	const auto                             [Filename, LineNumber] = ResolveSourceLocation(Location);
 
 	this->PushDescription(InDescription);
 
 	CurrentScope->It.Push(
-		MakeShareable(
-			new FSpecItDefinition(
-				this->GetId(),
-				this->GetDescription(),
-				TopOfStack.Filename,
-				TopOfStack.LineNumber,
-				MakeShareable(new FSimpleBlockingCommand(this, DoWork, this->bEnableSkipIfError))
-			)
+		this->DefinitionArena->New<FSpecItDefinition>(
+			this->GetId(),
+			this->GetDescription(),
+			Filename,
+			LineNumber,
+			this->DefinitionArena->New<FSimpleBlockingCommand>(this, DoWork, this->bEnableSkipIfError)
 		)
 	);
 
 	this->PopDescription();
 }
 
-void FEnhancedAutomationSpecBase::It(const FString&           InDescription,
-                                     const EAsyncExecution    Execution,
-                                     const TFunction<void()>& DoWork)
+void FEnhancedAutomationSpecBase::It(const FString&             InDescription,
+                                     const EAsyncExecution      Execution,
+                                     const TFunction<void()>&   DoWork,
+                                     const FSpecSourceLocation& Location)
 {
-	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
-	const FProgramCounterSymbolInfo&       TopOfStack   = GetTopOfCallStack();
+	const TSharedRef<FSpecDefinitionScope> CurrentScope           = this->DefinitionScopeStack.Last();
+	const auto                             [Filename, LineNumber] = ResolveSourceLocation(Location);
 
 	this->PushDescription(InDescription);
 
 	CurrentScope->It.Push(
-		MakeShareable(
-			new FSpecItDefinition(
-				this->GetId(),
-				this->GetDescription(),
-				TopOfStack.Filename,
-				TopOfStack.LineNumber,
-				MakeShareable(
-					new FAsyncCommand(this, Execution, DoWork, this->DefaultTimeout, this->bEnableSkipIfError)
-				)
+		this->DefinitionArena->New<FSpecItDefinition>(
+			this->GetId(),
+			this->GetDescription(),
+			Filename,
+			LineNumber,
+			this->DefinitionArena->New<FAsyncCommand>(
+				this,
+				Execution,
+				DoWork,
+				this->DefaultTimeout,
+				this->bEnableSkipIfError
 			)
 		)
 	);
@@ -417,49 +1044,50 @@ void FEnhancedAutomationSpecBase::It(const FString&           InDescription,
 	this->PopDescription();
 }
 
-void FEnhancedAutomationSpecBase::It(const FString&           InDescription,
-                                     const EAsyncExecution    Execution,
-                                     const FTimespan&         Timeout,
-                                     const TFunction<void()>& DoWork)
+void FEnhancedAutomationSpecBase::It(const FString&             InDescription,
+                                     const EAsyncExecution      Execution,
+                                     const FTimespan&           Timeout,
+                                     const TFunction<void()>&   DoWork,
+                                     const FSpecSourceLocation& Location)
 {
-	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
-	const FProgramCounterSymbolInfo&       TopOfStack   = GetTopOfCallStack();
+	const TSharedRef<FSpecDefinitionScope> CurrentScope           = this->DefinitionScopeStack.Last();
+	const auto                             [Filename, LineNumber] = ResolveSourceLocation(Location);
 
 	this->PushDescription(InDescription);
 
 	CurrentScope->It.Push(
-		MakeShareable(
-			new FSpecItDefinition(
-				this->GetId(),
-				this->GetDescription(),
-				TopOfStack.Filename,
-				TopOfStack.LineNumber,
-				MakeShareable(new FAsyncCommand(this, Execution, DoWork, Timeout, this->bEnableSkipIfError))
-			)
+		this->DefinitionArena->New<FSpecItDefinition>(
+			this->GetId(),
+			this->GetDescription(),
+			Filename,
+			LineNumber,
+			this->DefinitionArena->New<FAsyncCommand>(this, Execution, DoWork, Timeout, this->bEnableSkipIfError)
 		)
 	);
 
 	this->PopDescription();
 }
 
-void FEnhancedAutomationSpecBase::LatentIt(const FString& InDescription,
-                                           const TFunction<void(const FDoneDelegate&)>& DoWork)
+void FEnhancedAutomationSpecBase::LatentIt(const FString&                               InDescription,
+                                           const TFunction<void(const FDoneDelegate&)>& DoWork,
+                                           const FSpecSourceLocation&                   Location)
 {
-	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
-	const FProgramCounterSymbolInfo&       TopOfStack   = GetTopOfCallStack();
+	const TSharedRef<FSpecDefinitionScope> CurrentScope           = this->DefinitionScopeStack.Last();
+	const auto                             [Filename, LineNumber] = ResolveSourceLocation(Location);
 
 	this->PushDescription(InDescription);
 
 	CurrentScope->It.Push(
-		MakeShareable(
-			new FSpecItDefinition(
-				this->GetId(),
-				this->GetDescription(),
-				TopOfStack.Filename,
-				TopOfStack.LineNumber,
-				MakeShareable(
-					new FMultiFrameLatentCommand(this, DoWork, this->DefaultTimeout, this->bEnableSkipIfError)
-				)
+		this->DefinitionArena->New<FSpecItDefinition>(
+			this->GetId(),
+			this->GetDescription(),
+			Filename,
+			LineNumber,
+			this->DefinitionArena->New<FMultiFrameLatentCommand>(
+				this,
+				DoWork,
+				this->DefaultTimeout,
+				this->bEnableSkipIfError
 			)
 		)
 	);
@@ -469,22 +1097,21 @@ void FEnhancedAutomationSpecBase::LatentIt(const FString& InDescription,
 
 void FEnhancedAutomationSpecBase::LatentIt(const FString&                               InDescription,
                                            const FTimespan&                             Timeout,
-                                           const TFunction<void(const FDoneDelegate&)>& DoWork)
+                                           const TFunction<void(const FDoneDelegate&)>& DoWork,
+                                           const FSpecSourceLocation&                   Location)
 {
-	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
-	const FProgramCounterSymbolInfo&       TopOfStack   = GetTopOfCallStack();
+	const TSharedRef<FSpecDefinitionScope> CurrentScope           = this->DefinitionScopeStack.Last();
+	const auto                             [Filename, LineNumber] = ResolveSourceLocation(Location);
 
 	this->PushDescription(InDescription);
 
 	CurrentScope->It.Push(
-		MakeShareable(
-			new FSpecItDefinition(
-				this->GetId(),
-				this->GetDescription(),
-				TopOfStack.Filename,
-				TopOfStack.LineNumber,
-				MakeShareable(new FMultiFrameLatentCommand(this, DoWork, Timeout, this->bEnableSkipIfError))
-			)
+		this->DefinitionArena->New<FSpecItDefinition>(
+			this->GetId(),
+			this->GetDescription(),
+			Filename,
+			LineNumber,
+			this->DefinitionArena->New<FMultiFrameLatentCommand>(this, DoWork, Timeout, this->bEnableSkipIfError)
 		)
 	);
 
@@ -493,29 +1120,26 @@ void FEnhancedAutomationSpecBase::LatentIt(const FString&
 
 void FEnhancedAutomationSpecBase::LatentIt(const FString&                               InDescription,
                                            const EAsyncExecution                        Execution,
-                                           const TFunction<void(const FDoneDelegate&)>& DoWork)
+                                           const TFunction<void(const FDoneDelegate&)>& DoWork,
+                                           const FSpecSourceLocation&                   Location)
 {
-	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
-	const FProgramCounterSymbolInfo&       TopOfStack   = GetTopOfCallStack();
+	const TSharedRef<FSpecDefinitionScope> CurrentScope           = this->DefinitionScopeStack.Last();
+	const auto                             [Filename, LineNumber] = ResolveSourceLocation(Location);
 
 	this->PushDescription(InDescription);
 
 	CurrentScope->It.Push(
-		MakeShareable(
-			new FSpecItDefinition(
-				this->GetId(),
-				this->GetDescription(),
-				TopOfStack.Filename,
-				TopOfStack.LineNumber,
-				MakeShareable(
-					new FAsyncMultiFrameLatentCommand(
-						this,
-						Execution,
-						DoWork,
-						this->DefaultTimeout,
-						this->bEnableSkipIfError
-					)
-				)
+		this->DefinitionArena->New<FSpecItDefinition>(
+			this->GetId(),
+			this->GetDescription(),
+			Filename,
+			LineNumber,
+			this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(
+				this,
+				Execution,
+				DoWork,
+				this->DefaultTimeout,
+				this->bEnableSkipIfError
 			)
 		)
 	);
@@ -526,23 +1150,63 @@ void FEnhancedAutomationSpecBase::LatentIt(const FString&
 void FEnhancedAutomationSpecBase::LatentIt(const FString&                               InDescription,
                                            const EAsyncExecution                        Execution,
                                            const FTimespan&                             Timeout,
-                                           const TFunction<void(const FDoneDelegate&)>& DoWork)
+                                           const TFunction<void(const FDoneDelegate&)>& DoWork,
+                                           const FSpecSourceLocation&                   Location)
 {
-	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
-	const FProgramCounterSymbolInfo&       TopOfStack   = GetTopOfCallStack();
+	const TSharedRef<FSpecDefinitionScope> CurrentScope           = this->DefinitionScopeStack.Last();
+	const auto                             [Filename, LineNumber] = ResolveSourceLocation(Location);
 
 	this->PushDescription(InDescription);
 
 	CurrentScope->It.Push(
-		MakeShareable(
-			new FSpecItDefinition(
-				this->GetId(),
-				this->GetDescription(),
-				TopOfStack.Filename,
-				TopOfStack.LineNumber,
-				MakeShareable(
-					new FAsyncMultiFrameLatentCommand(this, Execution, DoWork, Timeout, this->bEnableSkipIfError)
-				)
+		this->DefinitionArena->New<FSpecItDefinition>(
+			this->GetId(),
+			this->GetDescription(),
+			Filename,
+			LineNumber,
+			this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(
+				this,
+				Execution,
+				DoWork,
+				Timeout,
+				this->bEnableSkipIfError
+			)
+		)
+	);
+
+	this->PopDescription();
+}
+
+void FEnhancedAutomationSpecBase::Benchmark(const FString&             InDescription,
+                                            const TFunction<void()>&   DoWork,
+                                            const FSpecSourceLocation& Location)
+{
+	this->Benchmark(InDescription, FEnhancedSpecBenchmarkOptions(), DoWork, Location);
+}
+
+void FEnhancedAutomationSpecBase::Benchmark(const FString&                       InDescription,
+                                            const FEnhancedSpecBenchmarkOptions& Options,
+                                            const TFunction<void()>&             DoWork,
+                                            const FSpecSourceLocation&           Location)
+{
+	const TSharedRef<FSpecDefinitionScope> CurrentScope           = this->DefinitionScopeStack.Last();
+	const auto                             [Filename, LineNumber] = ResolveSourceLocation(Location);
+
+	this->PushDescription(InDescription);
+
+	CurrentScope->It.Push(
+		this->DefinitionArena->New<FSpecItDefinition>(
+			this->GetId(),
+			this->GetDescription(),
+			Filename,
+			LineNumber,
+			this->DefinitionArena->New<FSimpleBlockingCommand>(
+				this,
+				[this, Options, DoWork]
+				{
+					this->RunBenchmark(Options, DoWork);
+				},
+				this->bEnableSkipIfError
 			)
 		)
 	);
@@ -558,7 +1222,7 @@ void FEnhancedAutomationSpecBase::BeforeAll(const TFunction<void()>& DoWork)
 	const TFunction<void()>&               RunWorkOnce = this->CreateRunWorkOnceWrapper(BlockHandle, DoWork);
 
 	CurrentScope->BeforeAll.Push(
-		MakeShareable(new FSimpleBlockingCommand(this, RunWorkOnce, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FSimpleBlockingCommand>(this, RunWorkOnce, this->bEnableSkipIfError)
 	);
 }
 
@@ -569,8 +1233,12 @@ void FEnhancedAutomationSpecBase::BeforeAll(const EAsyncExecution Execution, con
 	const TFunction<void()>&               RunWorkOnce = this->CreateRunWorkOnceWrapper(BlockHandle, DoWork);
 
 	CurrentScope->BeforeAll.Push(
-		MakeShareable(
-			new FAsyncCommand(this, Execution, RunWorkOnce, this->DefaultTimeout, this->bEnableSkipIfError)
+		this->DefinitionArena->New<FAsyncCommand>(
+			this,
+			Execution,
+			RunWorkOnce,
+			this->DefaultTimeout,
+			this->bEnableSkipIfError
 		)
 	);
 }
@@ -584,7 +1252,7 @@ void FEnhancedAutomationSpecBase::BeforeAll(const EAsyncExecution    Execution,
 	const TFunction<void()>&               RunWorkOnce = this->CreateRunWorkOnceWrapper(BlockHandle, DoWork);
 
 	CurrentScope->BeforeAll.Push(
-		MakeShareable(new FAsyncCommand(this, Execution, RunWorkOnce, Timeout, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FAsyncCommand>(this, Execution, RunWorkOnce, Timeout, this->bEnableSkipIfError)
 	);
 }
 
@@ -595,7 +1263,12 @@ void FEnhancedAutomationSpecBase::LatentBeforeAll(const TFunction<void(const FDo
 	const TFunction<void(const FDoneDelegate&)>& RunWorkOnce = this->CreateRunWorkOnceWrapper(BlockHandle, DoWork);
 
 	CurrentScope->BeforeAll.Push(
-		MakeShareable(new FMultiFrameLatentCommand(this, RunWorkOnce, this->DefaultTimeout, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FMultiFrameLatentCommand>(
+			this,
+			RunWorkOnce,
+			this->DefaultTimeout,
+			this->bEnableSkipIfError
+		)
 	);
 }
 
@@ -607,7 +1280,7 @@ void FEnhancedAutomationSpecBase::LatentBeforeAll(const FTimespan&
 	const TFunction<void(const FDoneDelegate&)>& RunWorkOnce = this->CreateRunWorkOnceWrapper(BlockHandle, DoWork);
 
 	CurrentScope->BeforeAll.Push(
-		MakeShareable(new FMultiFrameLatentCommand(this, RunWorkOnce, Timeout, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FMultiFrameLatentCommand>(this, RunWorkOnce, Timeout, this->bEnableSkipIfError)
 	);
 }
 
@@ -619,14 +1292,12 @@ void FEnhancedAutomationSpecBase::LatentBeforeAll(const EAsyncExecution
 	const TFunction<void(const FDoneDelegate&)>& RunWorkOnce = this->CreateRunWorkOnceWrapper(BlockHandle, DoWork);
 
 	CurrentScope->BeforeAll.Push(
-		MakeShareable(
-			new FAsyncMultiFrameLatentCommand(
-				this,
-				Execution,
-				RunWorkOnce,
-				this->DefaultTimeout,
-				this->bEnableSkipIfError
-			)
+		this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(
+			this,
+			Execution,
+			RunWorkOnce,
+			this->DefaultTimeout,
+			this->bEnableSkipIfError
 		)
 	);
 }
@@ -640,8 +1311,12 @@ void FEnhancedAutomationSpecBase::LatentBeforeAll(const EAsyncExecution
 	const TFunction<void(const FDoneDelegate&)>& RunWorkOnce = this->CreateRunWorkOnceWrapper(BlockHandle, DoWork);
 
 	CurrentScope->BeforeAll.Push(
-		MakeShareable(
-			new FAsyncMultiFrameLatentCommand(this, Execution, RunWorkOnce, Timeout, this->bEnableSkipIfError)
+		this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(
+			this,
+			Execution,
+			RunWorkOnce,
+			Timeout,
+			this->bEnableSkipIfError
 		)
 	);
 }
@@ -651,7 +1326,7 @@ void FEnhancedAutomationSpecBase::BeforeEach(const TFunction<void()>& DoWork)
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
 	CurrentScope->BeforeEach.Push(
-		MakeShareable(new FSimpleBlockingCommand(this, DoWork, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FSimpleBlockingCommand>(this, DoWork, this->bEnableSkipIfError)
 	);
 }
 
@@ -660,7 +1335,13 @@ void FEnhancedAutomationSpecBase::BeforeEach(const EAsyncExecution Execution, co
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
 	CurrentScope->BeforeEach.Push(
-		MakeShareable(new FAsyncCommand(this, Execution, DoWork, this->DefaultTimeout, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FAsyncCommand>(
+			this,
+			Execution,
+			DoWork,
+			this->DefaultTimeout,
+			this->bEnableSkipIfError
+		)
 	);
 }
 
@@ -670,7 +1351,7 @@ void FEnhancedAutomationSpecBase::BeforeEach(const EAsyncExecution Execution, co
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
 	CurrentScope->BeforeEach.Push(
-		MakeShareable(new FAsyncCommand(this, Execution, DoWork, Timeout, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FAsyncCommand>(this, Execution, DoWork, Timeout, this->bEnableSkipIfError)
 	);
 }
 
@@ -679,7 +1360,12 @@ void FEnhancedAutomationSpecBase::LatentBeforeEach(const TFunction<void(const FD
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
 	CurrentScope->BeforeEach.Push(
-		MakeShareable(new FMultiFrameLatentCommand(this, DoWork, this->DefaultTimeout, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FMultiFrameLatentCommand>(
+			this,
+			DoWork,
+			this->DefaultTimeout,
+			this->bEnableSkipIfError
+		)
 	);
 }
 
@@ -689,7 +1375,7 @@ void FEnhancedAutomationSpecBase::LatentBeforeEach(const FTimespan& Timeout,
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
 	CurrentScope->BeforeEach.Push(
-		MakeShareable(new FMultiFrameLatentCommand(this, DoWork, Timeout, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FMultiFrameLatentCommand>(this, DoWork, Timeout, this->bEnableSkipIfError)
 	);
 }
 
@@ -699,8 +1385,12 @@ void FEnhancedAutomationSpecBase::LatentBeforeEach(const EAsyncExecution Executi
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
 	CurrentScope->BeforeEach.Push(
-		MakeShareable(
-			new FAsyncMultiFrameLatentCommand(this, Execution, DoWork, this->DefaultTimeout, this->bEnableSkipIfError)
+		this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(
+			this,
+			Execution,
+			DoWork,
+			this->DefaultTimeout,
+			this->bEnableSkipIfError
 		)
 	);
 }
@@ -712,7 +1402,13 @@ void FEnhancedAutomationSpecBase::LatentBeforeEach(const EAsyncExecution
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
 	CurrentScope->BeforeEach.Push(
-		MakeShareable(new FAsyncMultiFrameLatentCommand(this, Execution, DoWork, Timeout, this->bEnableSkipIfError))
+		this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(
+			this,
+			Execution,
+			DoWork,
+			Timeout,
+			this->bEnableSkipIfError
+		)
 	);
 }
 
@@ -720,7 +1416,7 @@ void FEnhancedAutomationSpecBase::AfterEach(const TFunction<void()>& DoWork)
 {
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
-	CurrentScope->AfterEach.Push(MakeShareable(new FSimpleBlockingCommand(this, DoWork)));
+	CurrentScope->AfterEach.Push(this->DefinitionArena->New<FSimpleBlockingCommand>(this, DoWork));
 }
 
 void FEnhancedAutomationSpecBase::AfterEach(const EAsyncExecution Execution, const TFunction<void()>& DoWork)
@@ -728,7 +1424,7 @@ void FEnhancedAutomationSpecBase::AfterEach(const EAsyncExecution Execution, con
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
 	CurrentScope->AfterEach.Push(
-		MakeShareable(new FAsyncCommand(this, Execution, DoWork, this->DefaultTimeout))
+		this->DefinitionArena->New<FAsyncCommand>(this, Execution, DoWork, this->DefaultTimeout)
 	);
 }
 
@@ -738,14 +1434,16 @@ void FEnhancedAutomationSpecBase::AfterEach(const EAsyncExecution    Execution,
 {
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
-	CurrentScope->AfterEach.Push(MakeShareable(new FAsyncCommand(this, Execution, DoWork, Timeout)));
+	CurrentScope->AfterEach.Push(this->DefinitionArena->New<FAsyncCommand>(this, Execution, DoWork, Timeout));
 }
 
 void FEnhancedAutomationSpecBase::LatentAfterEach(const TFunction<void(const FDoneDelegate&)>& DoWork)
 {
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
-	CurrentScope->AfterEach.Push(MakeShareable(new FMultiFrameLatentCommand(this, DoWork, this->DefaultTimeout)));
+	CurrentScope->AfterEach.Push(
+		this->DefinitionArena->New<FMultiFrameLatentCommand>(this, DoWork, this->DefaultTimeout)
+	);
 }
 
 void FEnhancedAutomationSpecBase::LatentAfterEach(const FTimespan& Timeout,
@@ -753,7 +1451,7 @@ void FEnhancedAutomationSpecBase::LatentAfterEach(const FTimespan& Timeout,
 {
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
-	CurrentScope->AfterEach.Push(MakeShareable(new FMultiFrameLatentCommand(this, DoWork, Timeout)));
+	CurrentScope->AfterEach.Push(this->DefinitionArena->New<FMultiFrameLatentCommand>(this, DoWork, Timeout));
 }
 
 void FEnhancedAutomationSpecBase::LatentAfterEach(const EAsyncExecution Execution,
@@ -762,7 +1460,7 @@ void FEnhancedAutomationSpecBase::LatentAfterEach(const EAsyncExecution Executio
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
 	CurrentScope->AfterEach.Push(
-		MakeShareable(new FAsyncMultiFrameLatentCommand(this, Execution, DoWork, this->DefaultTimeout))
+		this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(this, Execution, DoWork, this->DefaultTimeout)
 	);
 }
 
@@ -772,229 +1470,504 @@ void FEnhancedAutomationSpecBase::LatentAfterEach(const EAsyncExecution
 {
 	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->DefinitionScopeStack.Last();
 
-	CurrentScope->AfterEach.Push(MakeShareable(new FAsyncMultiFrameLatentCommand(this, Execution, DoWork, Timeout)));
+	CurrentScope->AfterEach.Push(
+		this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(this, Execution, DoWork, Timeout)
+	);
 }
 
-void FEnhancedAutomationSpecBase::EnsureDefinitions() const
+void FEnhancedAutomationSpecBase::AfterAll(const TFunction<void()>& DoWork)
 {
-	if (!this->bHasBeenDefined)
-	{
-		const_cast<FEnhancedAutomationSpecBase*>(this)->Define();
-		const_cast<FEnhancedAutomationSpecBase*>(this)->PostDefine();
-	}
+	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->GetCurrentScope();
+	const FSpecBlockHandle                 BlockHandle;
+	const TFunction<void()>&               RunWorkAfterScope =
+		this->CreateRunAfterScopeWrapper(CurrentScope->Handle, BlockHandle, DoWork);
+
+	CurrentScope->AfterAll.Push(this->DefinitionArena->New<FSimpleBlockingCommand>(this, RunWorkAfterScope));
 }
 
-void FEnhancedAutomationSpecBase::PostDefine()
+void FEnhancedAutomationSpecBase::AfterAll(const EAsyncExecution Execution, const TFunction<void()>& DoWork)
 {
-	TArray<TSharedRef<FSpecDefinitionScope>>     Stack;
-	TArray<TSharedRef<IAutomationLatentCommand>> BeforeAll,
-	                                             BeforeEach,
-	                                             AfterEach;
-
-	Stack.Push(RootDefinitionScope.ToSharedRef());
-
-	while (Stack.Num() > 0)
-	{
-		const TSharedRef<FSpecDefinitionScope> Scope = Stack.Last();
-
-		BeforeAll.Append(Scope->BeforeAll);
-		BeforeEach.Append(Scope->BeforeEach);
-		AfterEach.Append(Scope->AfterEach);
+	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->GetCurrentScope();
+	const FSpecBlockHandle                 BlockHandle;
+	const TFunction<void()>&               RunWorkAfterScope =
+		this->CreateRunAfterScopeWrapper(CurrentScope->Handle, BlockHandle, DoWork);
 
-		for (auto ScopeIterator = Scope->It.CreateIterator(); ScopeIterator; ++ScopeIterator)
-		{
-			const TSharedRef<FSpecItDefinition> ItBlockScope = *ScopeIterator;
-			TSharedRef<FSpec>                   Spec         = MakeShareable(new FSpec());
-			FSpecVariableScope                  Variables;
+	CurrentScope->AfterAll.Push(
+		this->DefinitionArena->New<FAsyncCommand>(this, Execution, RunWorkAfterScope, this->DefaultTimeout)
+	);
+}
 
-			Spec->Id          = ItBlockScope->Id;
-			Spec->Description = ItBlockScope->Description;
-			Spec->Filename    = ItBlockScope->Filename;
-			Spec->LineNumber  = ItBlockScope->LineNumber;
+void FEnhancedAutomationSpecBase::AfterAll(const EAsyncExecution    Execution,
+                                           const FTimespan&         Timeout,
+                                           const TFunction<void()>& DoWork)
+{
+	const TSharedRef<FSpecDefinitionScope> CurrentScope = this->GetCurrentScope();
+	const FSpecBlockHandle                 BlockHandle;
+	const TFunction<void()>&               RunWorkAfterScope =
+		this->CreateRunAfterScopeWrapper(CurrentScope->Handle, BlockHandle, DoWork);
 
-			Spec->Commands.Append(BeforeAll);
-			Spec->Commands.Append(BeforeEach);
-			Spec->Commands.Add(ItBlockScope->Command);
+	CurrentScope->AfterAll.Push(this->DefinitionArena->New<FAsyncCommand>(this, Execution, RunWorkAfterScope, Timeout));
+}
 
-			// Iterate in reverse to evaluate AfterEach() from the inner-most scope outwards.
-			for (int32 AfterEachIndex = AfterEach.Num() - 1; AfterEachIndex >= 0; --AfterEachIndex)
-			{
-				Spec->Commands.Add(AfterEach[AfterEachIndex]);
-			}
+void FEnhancedAutomationSpecBase::LatentAfterAll(const TFunction<void(const FDoneDelegate&)>& DoWork)
+{
+	const TSharedRef<FSpecDefinitionScope>       CurrentScope = this->GetCurrentScope();
+	const FSpecBlockHandle                       BlockHandle;
+	const TFunction<void(const FDoneDelegate&)>& RunWorkAfterScope =
+		this->CreateRunAfterScopeWrapper(CurrentScope->Handle, BlockHandle, DoWork);
 
-			for (const auto& ScopeInStack : Stack)
-			{
-				Variables.Append(ScopeInStack->Variables);
-			}
+	CurrentScope->AfterAll.Push(
+		this->DefinitionArena->New<FMultiFrameLatentCommand>(this, RunWorkAfterScope, this->DefaultTimeout)
+	);
+}
 
-			Spec->Variables = Variables;
+void FEnhancedAutomationSpecBase::LatentAfterAll(const FTimespan&                             Timeout,
+                                                 const TFunction<void(const FDoneDelegate&)>& DoWork)
+{
+	const TSharedRef<FSpecDefinitionScope>       CurrentScope = this->GetCurrentScope();
+	const FSpecBlockHandle                       BlockHandle;
+	const TFunction<void(const FDoneDelegate&)>& RunWorkAfterScope =
+		this->CreateRunAfterScopeWrapper(CurrentScope->Handle, BlockHandle, DoWork);
 
-			check(!this->IdToSpecMap.Contains(Spec->Id));
-			this->IdToSpecMap.Add(Spec->Id, Spec);
-		}
+	CurrentScope->AfterAll.Push(this->DefinitionArena->New<FMultiFrameLatentCommand>(this, RunWorkAfterScope, Timeout));
+}
 
-		Scope->It.Empty();
+void FEnhancedAutomationSpecBase::LatentAfterAll(const EAsyncExecution                        Execution,
+                                                 const TFunction<void(const FDoneDelegate&)>& DoWork)
+{
+	const TSharedRef<FSpecDefinitionScope>       CurrentScope = this->GetCurrentScope();
+	const FSpecBlockHandle                       BlockHandle;
+	const TFunction<void(const FDoneDelegate&)>& RunWorkAfterScope =
+		this->CreateRunAfterScopeWrapper(CurrentScope->Handle, BlockHandle, DoWork);
+
+	CurrentScope->AfterAll.Push(
+		this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(
+			this,
+			Execution,
+			RunWorkAfterScope,
+			this->DefaultTimeout
+		)
+	);
+}
 
-		if (Scope->Children.Num() > 0)
-		{
-			// As long as we have deeper nested scopes, keep going.
-			Stack.Append(Scope->Children);
-			Scope->Children.Empty();
-		}
-		else
-		{
-			// We have no deeper scopes. Keep popping context off stacks until we reach an outer scope that has
-			// children.
-			while ((Stack.Num() > 0) && (Stack.Last()->Children.Num() == 0) && (Stack.Last()->It.Num() == 0))
-			{
-				const TSharedRef<FSpecDefinitionScope> PoppedScope        = Stack.Pop();
-				const int32                            NumBeforeAllAdded  = PoppedScope->BeforeAll.Num(),
-				                                       NumBeforeEachAdded = PoppedScope->BeforeEach.Num(),
-				                                       NumAfterEachAdded  = PoppedScope->AfterEach.Num();
+void FEnhancedAutomationSpecBase::LatentAfterAll(const EAsyncExecution                        Execution,
+                                                 const FTimespan&                             Timeout,
+                                                 const TFunction<void(const FDoneDelegate&)>& DoWork)
+{
+	const TSharedRef<FSpecDefinitionScope>       CurrentScope = this->GetCurrentScope();
+	const FSpecBlockHandle                       BlockHandle;
+	const TFunction<void(const FDoneDelegate&)>& RunWorkAfterScope =
+		this->CreateRunAfterScopeWrapper(CurrentScope->Handle, BlockHandle, DoWork);
 
-				if (NumBeforeAllAdded > 0)
-				{
-					// Remove all BeforeAll() blocks added by the current scope.
-					BeforeAll.RemoveAt(BeforeAll.Num() - NumBeforeAllAdded, NumBeforeAllAdded);
-				}
+	CurrentScope->AfterAll.Push(
+		this->DefinitionArena->New<FAsyncMultiFrameLatentCommand>(this, Execution, RunWorkAfterScope, Timeout)
+	);
+}
 
-				if (NumBeforeEachAdded > 0)
-				{
-					// Remove all BeforeEach() blocks added by the current scope.
-					BeforeEach.RemoveAt(BeforeEach.Num() - NumBeforeEachAdded, NumBeforeEachAdded);
-				}
+void FEnhancedAutomationSpecBase::UseFixture(FEnhancedSpecFixtureBase& Fixture)
+{
+	const TSharedRef<FSpecDefinitionScope> RootScope = this->RootDefinitionScope.ToSharedRef();
+	const FSpecBlockHandle                 BlockHandle;
 
-				if (NumAfterEachAdded > 0)
-				{
-					// Remove all AfterEach() blocks added by the current scope.
-					AfterEach.RemoveAt(AfterEach.Num() - NumAfterEachAdded, NumAfterEachAdded);
-				}
-			}
-		}
+	if (this->FixtureDependencies.Contains(&Fixture))
+	{
+		return;
 	}
 
-	this->RootDefinitionScope.Reset();
-	this->DefinitionScopeStack.Reset();
+	this->FixtureDependencies.Add(&Fixture);
 
-	this->bHasBeenDefined = true;
+	// This specification stops depending on the fixture once its last test case on this runner has finished, which is
+	// exactly when the AfterAll() blocks of the root scope run.
+	RootScope->AfterAll.Push(
+		this->DefinitionArena->New<FSimpleBlockingCommand>(
+			this,
+			this->CreateRunAfterScopeWrapper(RootScope->Handle, BlockHandle, [&Fixture]
+			{
+				FEnhancedSpecFixtureRegistry::Get().MarkDependentAsFinished(Fixture);
+			})
+		)
+	);
 }
 
-void FEnhancedAutomationSpecBase::Redefine()
+bool FEnhancedAutomationSpecBase::IsCancellationRequested() const
 {
-	this->DescriptionStack.Empty();
-	this->IdToSpecMap.Empty();
-	this->RootDefinitionScope.Reset();
-	this->DefinitionScopeStack.Empty();
+	const TSharedPtr<FSpecCancellationToken>& Token = GetCancellationTokenForThread();
 
-	this->bHasBeenDefined = false;
+	return Token.IsValid() && Token->IsCanceled();
 }
 
-FString FEnhancedAutomationSpecBase::GetId() const
+TSharedPtr<FEnhancedAutomationSpecBase::FSpecCancellationToken> FEnhancedAutomationSpecBase::
+GetCancellationToken() const
 {
-	if (this->DescriptionStack.Last().EndsWith(TEXT("]")))
-	{
-		FString ItDescription = this->DescriptionStack.Last();
+	return GetCancellationTokenForThread();
+}
 
-		ItDescription.RemoveAt(ItDescription.Len() - 1);
+void FEnhancedAutomationSpecBase::EnsureDefinitions() const
+{
+	FEnhancedAutomationSpecBase* MutableThis = const_cast<FEnhancedAutomationSpecBase*>(this);
 
-		int32 StartingBraceIndex = INDEX_NONE;
+	if (!this->bHasBeenDefined)
+	{
+		MutableThis->bIsDefiningLazily = this->ShouldDefineLazily();
 
-		if (ItDescription.FindLastChar(TEXT('['), StartingBraceIndex) &&
-		    (StartingBraceIndex != (ItDescription.Len() - 1)))
-		{
-			FString CommandId = ItDescription.RightChop(StartingBraceIndex + 1);
+		MutableThis->Define();
+		MutableThis->PostDefine();
+	}
 
-			return CommandId;
-		}
+	if (this->DeferredScopes.Num() != 0)
+	{
+		MutableThis->ExpandDeferredScopes([](const FSpecDeferredScope&)
+		{
+			return true;
+		});
 	}
+}
+
+void FEnhancedAutomationSpecBase::EnsureDefinitionFor(const FStringView SpecId) const
+{
+	FEnhancedAutomationSpecBase* MutableThis = const_cast<FEnhancedAutomationSpecBase*>(this);
 
+	if (!this->bHasBeenDefined)
 	{
-		FString CompleteId;
+		MutableThis->bIsDefiningLazily = this->ShouldDefineLazily();
 
-		for (auto DescriptionIterator = this->DescriptionStack.CreateConstIterator();
-			 DescriptionIterator;
-			 ++DescriptionIterator)
-		{
-			const FString CurrentDescription = *DescriptionIterator;
+		MutableThis->Define();
+		MutableThis->PostDefine();
+	}
 
-			if (CurrentDescription.IsEmpty())
-			{
-				continue;
-			}
+	if ((this->DeferredScopes.Num() == 0) || (this->FindSpec(SpecId) != nullptr))
+	{
+		return;
+	}
 
-			if (CompleteId.IsEmpty())
-			{
-				CompleteId = CurrentDescription;
-			}
-			else if (FChar::IsWhitespace(CompleteId[CompleteId.Len() - 1]) ||
-			         FChar::IsWhitespace(CurrentDescription[0]))
-			{
-				CompleteId = CompleteId + CurrentDescription;
-			}
-			else
-			{
-				CompleteId = FString::Printf(TEXT("%s %s"), *CompleteId, *CurrentDescription);
-			}
-		}
+	MutableThis->ExpandDeferredScopes([&SpecId](const FSpecDeferredScope& DeferredScope)
+	{
+		return SpecId.StartsWith(DeferredScope.IdPrefix);
+	});
 
-		return CompleteId;
+	// Test cases with custom IDs can be in any scope, so fall back to expanding all of them.
+	if (this->FindSpec(SpecId) == nullptr)
+	{
+		this->EnsureDefinitions();
 	}
 }
 
-FString FEnhancedAutomationSpecBase::GetDescription() const
+bool FEnhancedAutomationSpecBase::CanCacheDefinitions() const
+{
+	return !this->ModuleName.IsEmpty();
+}
+
+bool FEnhancedAutomationSpecBase::GetRequestedTestNames(TSet<FString>& OutTestNames) const
+{
+	const FEnhancedAutomationSpecFramework* Module = FEnhancedAutomationSpecFramework::GetIfLoaded();
+
+	return (Module != nullptr) && Module->GetRequestedTestNames(OutTestNames);
+}
+
+bool FEnhancedAutomationSpecBase::ShouldDefineLazily() const
+{
+	return !FEnhancedSpecSharding::IsEnabled() && FParse::Param(FCommandLine::Get(), TEXT("EnhancedSpecLazyDefine"));
+}
+
+void FEnhancedAutomationSpecBase::PostDefine()
 {
-	FString CompleteDescription;
+	const FSpecBlockHandle RootHandle = this->RootDefinitionScope->Handle;
 
-	for (auto DescriptionIterator = this->DescriptionStack.CreateConstIterator();
-		 DescriptionIterator;
-		 ++DescriptionIterator)
+	this->BuildScopeNode(this->RootDefinitionScope.ToSharedRef(), nullptr);
+
+	if (FEnhancedSpecSharding::IsEnabled())
 	{
-		const FString CurrentDescription = *DescriptionIterator;
+		this->AssignSpecsToShard();
+	}
 
-		if (CurrentDescription.IsEmpty())
-		{
-			continue;
-		}
+	this->CountSpecsInShardPerScope();
 
-		if (CompleteDescription.IsEmpty())
-		{
-			CompleteDescription = CurrentDescription;
-		}
-		else if (FChar::IsWhitespace(CompleteDescription[CompleteDescription.Len() - 1]) ||
-		         FChar::IsWhitespace(CurrentDescription[0]))
-		{
-			CompleteDescription = CompleteDescription + TEXT(".") + CurrentDescription;
-		}
-		else
+	// Spec classes without any test cases on this runner must not keep fixtures alive waiting for them to finish.
+	if ((this->NumSpecsInShardPerScope.FindRef(RootHandle) > 0) || (this->DeferredScopes.Num() != 0))
+	{
+		for (FEnhancedSpecFixtureBase* Fixture : this->FixtureDependencies)
 		{
-			CompleteDescription = FString::Printf(TEXT("%s.%s"), *CompleteDescription, *CurrentDescription);
+			this->CountAsFixtureDependent(*Fixture);
 		}
 	}
 
-	return CompleteDescription;
+	this->RootDefinitionScope.Reset();
+	this->DefinitionScopeStack.Reset();
+
+	this->bHasBeenDefined = true;
 }
 
-TSharedRef<TArray<FProgramCounterSymbolInfo>> FEnhancedAutomationSpecBase::GetCallStack()
+void FEnhancedAutomationSpecBase::Redefine()
 {
-	QUICK_SCOPE_CYCLE_COUNTER(STAT_FEnhancedAutomationSpecBase_GetStack);
+	for (FEnhancedSpecFixtureBase* Fixture : this->FixturesCountedAsDependent)
+	{
+		FEnhancedSpecFixtureRegistry::Get().RemoveDependent(*Fixture);
+	}
 
-	return MakeShared<TArray<FProgramCounterSymbolInfo>>(
-		FAutomationTestFramework::NeedSkipStackWalk() ? SkipCallStackWalk() : CallStackWalk()
-	);
+	this->FixturesCountedAsDependent.Empty();
+	this->FixtureDependencies.Empty();
+	this->ClearDescriptionStack();
+	this->SpecsByIdHash.Empty();
+	this->ParallelSpecGroups.Empty();
+	this->NumSpecsInShardPerScope.Empty();
+	this->DeferredScopes.Empty();
+	this->ScopesWithDeferredScopes.Empty();
+	this->NumVariableSlots = 0;
+	this->RunningSpec      = nullptr;
+
+	// Objects from the previous definition that are still referenced keep the old arena alive until they are released.
+	this->DefinitionArena     = MakeShared<FEnhancedSpecArena>();
+	this->RootDefinitionScope = this->DefinitionArena->New<FSpecDefinitionScope>();
+
+	this->DefinitionScopeStack.Empty();
+	this->DefinitionScopeStack.Push(this->RootDefinitionScope.ToSharedRef());
+
+	this->bHasBeenDefined = false;
 }
 
-TArray<FProgramCounterSymbolInfo> FEnhancedAutomationSpecBase::CallStackWalk()
+int32 FEnhancedAutomationSpecBase::RunSpecImmediately(const FString& SpecId)
 {
-	QUICK_SCOPE_CYCLE_COUNTER(STAT_FEnhancedAutomationSpecBase_StackWalk);
-	LLM_SCOPE_BYNAME(TEXT("AutomationTest/Framework"));
-	SAFE_GETSTACK(Stack, 3, 1);
+	int32 NumFrames;
 
-	return Stack;
+	return this->RunSpecImmediately(SpecId, NumFrames);
 }
 
-TArray<FProgramCounterSymbolInfo> FEnhancedAutomationSpecBase::SkipCallStackWalk()
+int32 FEnhancedAutomationSpecBase::RunSpecImmediately(const FString& SpecId, int32& OutNumFrames)
 {
-	QUICK_SCOPE_CYCLE_COUNTER(STAT_FEnhancedAutomationSpecBase_SkipStackWalk);
+	TArray<TSharedRef<FSpecLatentCommand>> Commands;
+	FSpecParallelBatches                   ParallelBatches;
+	const TSharedRef<FSpec>*               SpecToRun;
+	int32                                  NumCommands;
+
+	OutNumFrames = 0;
+
+	this->EnsureDefinitionFor(SpecId);
+
+	if (!this->SuiteSessionState.IsValid())
+	{
+		this->SuiteSessionState = MakeShareable(new FEnhancedTestSessionState(*this));
+	}
+
+	SpecToRun = this->FindSpec(SpecId);
+
+	if (SpecToRun == nullptr)
+	{
+		return 0;
+	}
+
+	this->GatherSpecCommands(*SpecToRun, ParallelBatches, Commands);
+
+	NumCommands = Commands.Num();
+
+	FSpecCommandSequence Sequence(this, MoveTemp(Commands));
+
+	// Like RunTest(), report a stored result right away. Otherwise, keep going until every command has finished. Each
+	// update after that stands in for one frame of the automation framework.
+	bool bIsDone = this->SuiteSessionState->HasParallelResult((*SpecToRun)->Id) && Sequence.Update();
+
+	while (!bIsDone)
+	{
+		++OutNumFrames;
+
+		bIsDone = Sequence.Update();
+	}
+
+	return NumCommands;
+}
+
+void FEnhancedAutomationSpecBase::CountCommandReferences(int64& OutNumHeld, int64& OutNumReachable) const
+{
+	TSet<const FSpecScopeNode*> NodesCounted;
+	FSpecScopeChain             ScopeChain;
+
+	OutNumHeld      = 0;
+	OutNumReachable = 0;
+
+	for (const TPair<uint64, TSharedRef<FSpec>>& SpecPair : this->SpecsByIdHash)
+	{
+		const FSpec& Spec = SpecPair.Value.Get();
+
+		ScopeChain.Reset();
+		GatherScopeChain(Spec, ScopeChain);
+
+		for (const FSpecScopeNode* Node : ScopeChain)
+		{
+			const int64 NumNodeCommands =
+				Node->BeforeAll.Num() + Node->BeforeEach.Num() + Node->AfterEach.Num() + Node->AfterAll.Num();
+			bool        bIsAlreadyCounted;
+
+			NodesCounted.Add(Node, &bIsAlreadyCounted);
+
+			if (!bIsAlreadyCounted)
+			{
+				OutNumHeld += NumNodeCommands;
+			}
+
+			OutNumReachable += NumNodeCommands;
+		}
+
+		if (Spec.Command.IsValid())
+		{
+			++OutNumHeld;
+			++OutNumReachable;
+		}
+	}
+}
+
+void FEnhancedAutomationSpecBase::EmulateFlattenedSpecs(const TFunction<void()>& WhileFlattened,
+                                                        int64&                   OutNumCommandsCopied,
+                                                        int64&                   OutNumBytesCopied) const
+{
+	TArray<TArray<TSharedRef<FSpecLatentCommand>>> CommandsPerSpec;
+	TArray<FSpecVariableScope>                     VariablesPerSpec;
+	FSpecScopeChain                                ScopeChain;
+
+	OutNumCommandsCopied = 0;
+	OutNumBytesCopied    = 0;
+
+	CommandsPerSpec.Reserve(this->SpecsByIdHash.Num());
+	VariablesPerSpec.Reserve(this->SpecsByIdHash.Num());
+
+	for (const TPair<uint64, TSharedRef<FSpec>>& SpecPair : this->SpecsByIdHash)
+	{
+		const FSpec&                            Spec      = SpecPair.Value.Get();
+		TArray<TSharedRef<FSpecLatentCommand>>& Commands  = CommandsPerSpec.AddDefaulted_GetRef();
+		FSpecVariableScope&                     Variables = VariablesPerSpec.AddDefaulted_GetRef();
+
+		ScopeChain.Reset();
+		GatherScopeChain(Spec, ScopeChain);
+
+		// Copy the commands in the order they run, as the flattened layout stored them.
+		for (int32 ScopeIndex = ScopeChain.Num() - 1; ScopeIndex >= 0; --ScopeIndex)
+		{
+			Commands.Append(ScopeChain[ScopeIndex]->BeforeAll);
+		}
+
+		for (int32 ScopeIndex = ScopeChain.Num() - 1; ScopeIndex >= 0; --ScopeIndex)
+		{
+			Commands.Append(ScopeChain[ScopeIndex]->BeforeEach);
+		}
+
+		if (Spec.Command.IsValid())
+		{
+			Commands.Add(Spec.Command.ToSharedRef());
+		}
+
+		for (const FSpecScopeNode* Node : ScopeChain)
+		{
+			for (int32 AfterEachIndex = Node->AfterEach.Num() - 1; AfterEachIndex >= 0; --AfterEachIndex)
+			{
+				Commands.Add(Node->AfterEach[AfterEachIndex]);
+			}
+		}
+
+		for (const FSpecScopeNode* Node : ScopeChain)
+		{
+			for (int32 AfterAllIndex = Node->AfterAll.Num() - 1; AfterAllIndex >= 0; --AfterAllIndex)
+			{
+				Commands.Add(Node->AfterAll[AfterAllIndex]);
+			}
+		}
+
+		// Each test case also had its own variable table, with a slot for every variable of the specification.
+		Variables = *Spec.Scope->Variables;
+		Variables.SetNum(this->NumVariableSlots);
+
+		OutNumCommandsCopied += Commands.Num();
+		OutNumBytesCopied    += Commands.GetAllocatedSize() + Variables.GetAllocatedSize();
+	}
+
+	WhileFlattened();
+}
+
+TSharedPtr<const FEnhancedSpecListingSet> FEnhancedAutomationSpecBase::FindCachedListings() const
+{
+	if (!this->CanCacheDefinitions())
+	{
+		return nullptr;
+	}
+
+	FEnhancedSpecDefinitionCache& Cache = FEnhancedSpecDefinitionCache::Get();
+
+	return Cache.Find(this->TestName, Cache.GetBuildStamp(this->ModuleName));
+}
+
+FString FEnhancedAutomationSpecBase::GetId() const
+{
+	if (this->DescriptionStack.Last().EndsWith(TEXT("]")))
+	{
+		const FStringView ItDescription = FStringView(this->DescriptionStack.Last()).LeftChop(1);
+		int32             StartingBraceIndex;
+
+		if (ItDescription.FindLastChar(TEXT('['), StartingBraceIndex) &&
+		    (StartingBraceIndex != (ItDescription.Len() - 1)))
+		{
+			return FString(ItDescription.RightChop(StartingBraceIndex + 1));
+		}
+	}
+
+	return this->StackedId;
+}
+
+FString FEnhancedAutomationSpecBase::GetDescription() const
+{
+	return this->StackedDescription;
+}
+
+const TSharedRef<FEnhancedAutomationSpecBase::FSpec>* FEnhancedAutomationSpecBase::FindSpec(
+	const FStringView SpecId) const
+{
+	for (auto SpecIterator = this->SpecsByIdHash.CreateConstKeyIterator(FEnhancedSpecIdHash::Hash(SpecId));
+	     SpecIterator;
+	     ++SpecIterator)
+	{
+		const TSharedRef<FSpec>& Spec = SpecIterator.Value();
+
+		if (SpecId.Equals(Spec->Id, ESearchCase::IgnoreCase))
+		{
+			return &Spec;
+		}
+	}
+
+	return nullptr;
+}
+
+FStringView FEnhancedAutomationSpecBase::GetSpecIdFromTestName(const FString& InTestName) const
+{
+	const FStringView TestNameView = InTestName;
+	const int32       SuiteNameLen = this->TestName.Len();
+
+	if ((TestNameView.Len() > SuiteNameLen) &&
+	    (TestNameView[SuiteNameLen] == TEXT(' ')) &&
+	    TestNameView.StartsWith(this->TestName))
+	{
+		return TestNameView.RightChop(SuiteNameLen + 1);
+	}
+
+	return TestNameView;
+}
+
+TSharedRef<TArray<FProgramCounterSymbolInfo>> FEnhancedAutomationSpecBase::GetCallStack()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FEnhancedAutomationSpecBase_GetStack);
+
+	return MakeShared<TArray<FProgramCounterSymbolInfo>>(
+		FAutomationTestFramework::NeedSkipStackWalk() ? SkipCallStackWalk() : CallStackWalk()
+	);
+}
+
+TArray<FProgramCounterSymbolInfo> FEnhancedAutomationSpecBase::CallStackWalk()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FEnhancedAutomationSpecBase_StackWalk);
+	LLM_SCOPE_BYNAME(TEXT("AutomationTest/Framework"));
+	SAFE_GETSTACK(Stack, 3, 1);
+
+	return Stack;
+}
+
+TArray<FProgramCounterSymbolInfo> FEnhancedAutomationSpecBase::SkipCallStackWalk()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FEnhancedAutomationSpecBase_SkipStackWalk);
 	LLM_SCOPE_BYNAME(TEXT("AutomationTest/Framework"));
 
 	TArray<FProgramCounterSymbolInfo> Stack;
@@ -1008,18 +1981,143 @@ TArray<FProgramCounterSymbolInfo> FEnhancedAutomationSpecBase::SkipCallStackWalk
 	return Stack;
 }
 
+void FEnhancedAutomationSpecBase::SetVariableInScope(FSpecVariableScope&      Variables,
+                                                     const int32              SlotIndex,
+                                                     FSpecVariablePtrWildcard Definition)
+{
+	check(SlotIndex >= 0);
+
+	if (Variables.Num() <= SlotIndex)
+	{
+		Variables.SetNum(SlotIndex + 1);
+	}
+
+	Variables[SlotIndex] = MoveTemp(Definition);
+}
+
+FEnhancedAutomationSpecBase::FParallelSpecContext*& FEnhancedAutomationSpecBase::GetParallelContextForThread()
+{
+	static thread_local FParallelSpecContext* ParallelContext = nullptr;
+
+	return ParallelContext;
+}
+
+TSharedPtr<FEnhancedAutomationSpecBase::FSpecCancellationToken>& FEnhancedAutomationSpecBase::
+GetCancellationTokenForThread()
+{
+	static thread_local TSharedPtr<FSpecCancellationToken> CancellationToken;
+
+	return CancellationToken;
+}
+
+bool FEnhancedAutomationSpecBase::DiscardIfAbandoned(const TCHAR* MessageKind, const FString& Message)
+{
+	const TSharedPtr<FSpecCancellationToken>& Token = GetCancellationTokenForThread();
+
+	if (Token.IsValid() && Token->IsCanceled())
+	{
+		// The test that started this work has already moved on, so anything it reports now would be attributed to
+		// whichever test happens to be running.
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Verbose,
+			TEXT("Discarding %s reported by work that was abandoned after timing out: %s"),
+			MessageKind,
+			*Message
+		);
+
+		return true;
+	}
+
+	return false;
+}
+
+void FEnhancedAutomationSpecBase::GatherScopeChain(const FSpec& Spec, FSpecScopeChain& OutScopeChain)
+{
+	for (const FSpecScopeNode* Node = Spec.Scope.Get(); Node != nullptr; Node = Node->Parent.Get())
+	{
+		OutScopeChain.Add(Node);
+	}
+}
+
+bool FEnhancedAutomationSpecBase::CanRunInParallel(const FSpec& Spec, const FSpecScopeChain& ScopeChain)
+{
+	return (Spec.Scope->ParallelScope != nullptr) && CanRunSynchronously(Spec, ScopeChain);
+}
+
+bool FEnhancedAutomationSpecBase::CanRunSynchronously(const FSpec& Spec, const FSpecScopeChain& ScopeChain)
+{
+	if (!Spec.Command->IsSynchronous())
+	{
+		return false;
+	}
+
+	const auto IsSynchronous = [](const TSharedRef<FSpecLatentCommand>& Command)
+	{
+		return Command->IsSynchronous();
+	};
+
+	for (const FSpecScopeNode* Node : ScopeChain)
+	{
+		if (!Algo::AllOf(Node->BeforeAll, IsSynchronous) ||
+		    !Algo::AllOf(Node->BeforeEach, IsSynchronous) ||
+		    !Algo::AllOf(Node->AfterEach, IsSynchronous))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void FEnhancedAutomationSpecBase::PushDescription(const FString& InDescription)
 {
 	LLM_SCOPE_BYNAME(TEXT("AutomationTest/Framework"));
 
 	this->DescriptionStack.Add(InDescription);
+	this->StackedIdLengths.Add(this->StackedId.Len());
+	this->StackedDescriptionLengths.Add(this->StackedDescription.Len());
+
+	// Each test case is defined with one append onto the IDs and descriptions of its parents, rather than by re-joining
+	// the whole stack, which adds up quickly in deeply-nested specs.
+	if (InDescription.IsEmpty())
+	{
+		return;
+	}
+
+	if (!this->StackedId.IsEmpty())
+	{
+		if (!FChar::IsWhitespace(this->StackedId[this->StackedId.Len() - 1]) &&
+		    !FChar::IsWhitespace(InDescription[0]))
+		{
+			this->StackedId.AppendChar(TEXT(' '));
+		}
+
+		this->StackedDescription.AppendChar(TEXT('.'));
+	}
+
+	this->StackedId.Append(InDescription);
+	this->StackedDescription.Append(InDescription);
 }
 
 void FEnhancedAutomationSpecBase::PopDescription()
 {
+	// Truncate without shrinking, since the next description pushed usually needs the same capacity.
+	this->StackedId.LeftInline(this->StackedIdLengths.Pop(false), false);
+	this->StackedDescription.LeftInline(this->StackedDescriptionLengths.Pop(false), false);
+
 	this->DescriptionStack.RemoveAt(this->DescriptionStack.Num() - 1);
 }
 
+void FEnhancedAutomationSpecBase::ClearDescriptionStack()
+{
+	this->DescriptionStack.Empty();
+	this->StackedId.Empty();
+	this->StackedDescription.Empty();
+	this->StackedIdLengths.Empty();
+	this->StackedDescriptionLengths.Empty();
+}
+
 TFunction<void()> FEnhancedAutomationSpecBase::CreateRunWorkOnceWrapper(const FSpecBlockHandle&  BlockHandle,
                                                                    const TFunction<void()>& DoWork) const
 {
@@ -1048,23 +2146,1155 @@ TFunction<void(const FDoneDelegate&)> FEnhancedAutomationSpecBase::CreateRunWork
 
 			this->SuiteSessionState->MarkBlockAsRun(BlockHandle);
 		}
+		else
+		{
+			DoneDelegate.Execute();
+		}
+	};
+}
+
+TFunction<void()> FEnhancedAutomationSpecBase::CreateRunAfterScopeWrapper(const FSpecBlockHandle&  ScopeHandle,
+                                                                     const FSpecBlockHandle&  BlockHandle,
+                                                                     const TFunction<void()>& DoWork) const
+{
+	return [=, this]
+	{
+		// Only allow this block to run once per test session per runner, after the last test case of its scope.
+		if (this->HasScopeFinished(ScopeHandle) && !this->SuiteSessionState->HasBlockRun(BlockHandle))
+		{
+			DoWork();
+
+			this->SuiteSessionState->MarkBlockAsRun(BlockHandle);
+		}
+	};
+}
+
+TFunction<void(const FDoneDelegate&)> FEnhancedAutomationSpecBase::CreateRunAfterScopeWrapper(
+	const FSpecBlockHandle&                      ScopeHandle,
+	const FSpecBlockHandle&                      BlockHandle,
+	const TFunction<void(const FDoneDelegate&)>& DoWork) const
+{
+	return [=, this](const FDoneDelegate& DoneDelegate)
+	{
+		// Only allow this block to run once per test session per runner, after the last test case of its scope.
+		if (this->HasScopeFinished(ScopeHandle) && !this->SuiteSessionState->HasBlockRun(BlockHandle))
+		{
+			DoWork(DoneDelegate);
+
+			this->SuiteSessionState->MarkBlockAsRun(BlockHandle);
+		}
+		else
+		{
+			DoneDelegate.Execute();
+		}
 	};
 }
 
-void FEnhancedAutomationSpecBase::RunSpec(const TSharedRef<FSpec>& SpecToRun)
+bool FEnhancedAutomationSpecBase::HasScopeFinished(const FSpecBlockHandle& ScopeHandle) const
 {
-	FAutomationTestFramework& AutomationTestFramework = FAutomationTestFramework::GetInstance();
-	FSpecVariableScope&       Variables               = SpecToRun->Variables;
+	const int32* NumSpecsInShard = this->NumSpecsInShardPerScope.Find(ScopeHandle);
 
-	for (const auto& [_, Variable] : Variables)
+	if (this->SuiteSessionState->IsEndingSession())
 	{
-		Variable->Reset();
+		// No more test cases will run during this session, so the scope is done as long as any of them ran in it.
+		return this->SuiteSessionState->HasScopeStarted(ScopeHandle);
 	}
 
-	this->VariablesInScope = Variables;
+	return (NumSpecsInShard != nullptr) &&
+	       !this->ScopesWithDeferredScopes.Contains(ScopeHandle) &&
+	       (this->SuiteSessionState->GetNumSpecsFinished(ScopeHandle) >= *NumSpecsInShard);
+}
+
+void FEnhancedAutomationSpecBase::BuildScopeNode(const TSharedRef<FSpecDefinitionScope>& Scope,
+                                                 const TSharedPtr<const FSpecScopeNode>& ParentNode)
+{
+	const TSharedRef<FSpecScopeNode> Node = this->DefinitionArena->New<FSpecScopeNode>();
+
+	Node->Parent      = ParentNode;
+	Node->Handle      = Scope->Handle;
+	Node->Description = Scope->Description;
+	Node->BeforeAll   = MoveTemp(Scope->BeforeAll);
+	Node->BeforeEach  = MoveTemp(Scope->BeforeEach);
+	Node->AfterEach   = MoveTemp(Scope->AfterEach);
+	Node->AfterAll    = MoveTemp(Scope->AfterAll);
+
+	if (ParentNode.IsValid() && (ParentNode->ParallelScope != nullptr))
+	{
+		// Nested parallel scopes are run as part of the batch of the outer-most parallel scope.
+		Node->ParallelScope = ParentNode->ParallelScope;
+	}
+	else if (Scope->bRunInParallel)
+	{
+		Node->ParallelScope = &Node.Get();
+	}
 
-	for (int32 CommandIndex = 0; CommandIndex < SpecToRun->Commands.Num(); ++CommandIndex)
+	if (ParentNode.IsValid() && (Scope->Variables.Num() == 0))
+	{
+		// This scope neither defines nor redefines any variables, so it can share the table of its enclosing scope.
+		Node->Variables = ParentNode->Variables;
+	}
+	else
 	{
-		AutomationTestFramework.EnqueueLatentCommand(SpecToRun->Commands[CommandIndex]);
+		FSpecVariableScope Variables;
+
+		if (ParentNode.IsValid())
+		{
+			Variables = *ParentNode->Variables;
+		}
+
+		Variables.SetNum(this->NumVariableSlots);
+
+		for (int32 SlotIndex = 0; SlotIndex < Scope->Variables.Num(); ++SlotIndex)
+		{
+			if (Scope->Variables[SlotIndex].IsValid())
+			{
+				Variables[SlotIndex] = Scope->Variables[SlotIndex];
+			}
+		}
+
+		Node->Variables = this->DefinitionArena->New<FSpecVariableScope>(MoveTemp(Variables));
 	}
+
+	for (const TSharedRef<FSpecItDefinition>& ItDefinition : Scope->It)
+	{
+		const TSharedRef<FSpec> Spec = this->DefinitionArena->New<FSpec>();
+
+		Spec->Id          = ItDefinition->Id;
+		Spec->Description = ItDefinition->Description;
+		Spec->Filename    = ItDefinition->Filename;
+		Spec->LineNumber  = ItDefinition->LineNumber;
+		Spec->Scope       = Node;
+		Spec->Command     = ItDefinition->Command;
+
+		if (this->FindSpec(Spec->Id) != nullptr)
+		{
+			UE_LOG(
+				LogEnhancedAutomationSpecs,
+				Error,
+				TEXT("%s: Test ID '%s' is not unique, so the test defined at %s:%d will not run."),
+				*this->TestName,
+				*Spec->Id,
+				*Spec->Filename,
+				Spec->LineNumber
+			);
+
+			continue;
+		}
+
+		this->SpecsByIdHash.Add(FEnhancedSpecIdHash::Hash(Spec->Id), Spec);
+
+		if (Node->ParallelScope != nullptr)
+		{
+			this->ParallelSpecGroups.FindOrAdd(Node->ParallelScope).Add(Spec);
+		}
+	}
+
+	if (FEnhancedSpecTraceRecorder::Get().IsEnabled() ||
+	    FEnhancedSpecDurationBaseline::Get().IsEnabled() ||
+	    FEnhancedSpecPerfCounters::IsEnabled())
+	{
+		TraceScopeCommands(*Node, Scope->It);
+	}
+
+	Scope->It.Empty();
+
+	for (const TSharedRef<FSpecDefinitionScope>& ChildScope : Scope->Children)
+	{
+		this->BuildScopeNode(ChildScope, Node);
+	}
+
+	Scope->Children.Empty();
+
+	for (const TSharedRef<FSpecDeferredScope>& DeferredScope : Scope->DeferredChildren)
+	{
+		DeferredScope->ParentNode = Node;
+
+		this->DeferredScopes.Add(DeferredScope);
+	}
+
+	Scope->DeferredChildren.Empty();
+}
+
+void FEnhancedAutomationSpecBase::TraceScopeCommands(const FSpecScopeNode&                        Node,
+                                                     const TArray<TSharedRef<FSpecItDefinition>>& ItDefinitions)
+{
+	TArray<FString> Descriptions;
+
+	for (const FSpecScopeNode* CurrentNode = &Node; CurrentNode != nullptr; CurrentNode = CurrentNode->Parent.Get())
+	{
+		if (!CurrentNode->Description.IsEmpty())
+		{
+			Descriptions.Insert(CurrentNode->Description, 0);
+		}
+	}
+
+	const FString ScopePath = FString::Join(Descriptions, TEXT("."));
+
+	for (const TSharedRef<FSpecLatentCommand>& Command : Node.BeforeAll)
+	{
+		Command->SetTraceInfo(TEXT("BeforeAll"), ScopePath);
+	}
+
+	for (const TSharedRef<FSpecLatentCommand>& Command : Node.BeforeEach)
+	{
+		Command->SetTraceInfo(TEXT("BeforeEach"), ScopePath);
+	}
+
+	for (const TSharedRef<FSpecItDefinition>& ItDefinition : ItDefinitions)
+	{
+		ItDefinition->Command->SetTraceInfo(TEXT("It"), ScopePath);
+	}
+
+	for (const TSharedRef<FSpecLatentCommand>& Command : Node.AfterEach)
+	{
+		Command->SetTraceInfo(TEXT("AfterEach"), ScopePath);
+	}
+
+	for (const TSharedRef<FSpecLatentCommand>& Command : Node.AfterAll)
+	{
+		Command->SetTraceInfo(TEXT("AfterAll"), ScopePath);
+	}
+}
+
+bool FEnhancedAutomationSpecBase::IsDefiningParallelScope() const
+{
+	return Algo::AnyOf(this->DefinitionScopeStack, [](const TSharedRef<FSpecDefinitionScope>& Scope)
+	{
+		return Scope->bRunInParallel;
+	});
+}
+
+void FEnhancedAutomationSpecBase::DeferScope(const FString& InDescription, const TFunction<void()>& DoWork)
+{
+	const TSharedRef<FSpecDeferredScope> DeferredScope = this->DefinitionArena->New<FSpecDeferredScope>();
+
+	this->PushDescription(InDescription);
+
+	DeferredScope->Description      = InDescription;
+	DeferredScope->DescriptionStack = this->DescriptionStack;
+	DeferredScope->IdPrefix         = this->GetId();
+	DeferredScope->DoWork           = DoWork;
+
+	this->PopDescription();
+
+	this->GetCurrentScope()->DeferredChildren.Push(DeferredScope);
+}
+
+void FEnhancedAutomationSpecBase::ExpandDeferredScopes(
+	const TFunctionRef<bool(const FSpecDeferredScope&)> ShouldExpand)
+{
+	bool bHasExpandedAny = false,
+	     bHasExpandedAnyInPass;
+
+	do
+	{
+		TArray<TSharedRef<FSpecDeferredScope>> ScopesToCheck = MoveTemp(this->DeferredScopes);
+
+		bHasExpandedAnyInPass = false;
+
+		for (const TSharedRef<FSpecDeferredScope>& DeferredScope : ScopesToCheck)
+		{
+			if (ShouldExpand(*DeferredScope))
+			{
+				// Scopes that this one defers are added to the list of deferred scopes, to be checked in the next pass.
+				this->ExpandDeferredScope(DeferredScope);
+
+				bHasExpandedAnyInPass = true;
+			}
+			else
+			{
+				this->DeferredScopes.Add(DeferredScope);
+			}
+		}
+
+		bHasExpandedAny |= bHasExpandedAnyInPass;
+	}
+	while (bHasExpandedAnyInPass);
+
+	if (bHasExpandedAny)
+	{
+		this->CountSpecsInShardPerScope();
+	}
+}
+
+void FEnhancedAutomationSpecBase::ExpandDeferredScope(const TSharedRef<FSpecDeferredScope>& DeferredScope)
+{
+	LLM_SCOPE_BYNAME(TEXT("AutomationTest/Framework"));
+
+	const TSharedRef<FSpecDefinitionScope> Scope = this->DefinitionArena->New<FSpecDefinitionScope>();
+
+	Scope->Description = DeferredScope->Description;
+
+	for (const FString& Description : DeferredScope->DescriptionStack)
+	{
+		this->PushDescription(Description);
+	}
+
+	this->DeferredScopeParentNode = DeferredScope->ParentNode;
+	this->DefinitionScopeStack.Push(Scope);
+
+	DeferredScope->DoWork();
+
+	this->DefinitionScopeStack.Pop();
+	this->DeferredScopeParentNode.Reset();
+	this->ClearDescriptionStack();
+
+	this->BuildScopeNode(Scope, DeferredScope->ParentNode);
+}
+
+const FEnhancedAutomationSpecBase::FSpecScopeNode* FEnhancedAutomationSpecBase::GetShardGroupScope(
+	const FSpecScopeChain& ScopeChain)
+{
+	// Iterate in reverse to find the outer-most scope first.
+	for (int32 ScopeIndex = ScopeChain.Num() - 1; ScopeIndex >= 0; --ScopeIndex)
+	{
+		const FSpecScopeNode* Node = ScopeChain[ScopeIndex];
+
+		if ((Node->BeforeAll.Num() != 0) || (Node->ParallelScope == Node))
+		{
+			return Node;
+		}
+	}
+
+	return nullptr;
+}
+
+void FEnhancedAutomationSpecBase::AssignSpecsToShard()
+{
+	const FEnhancedSpecTimingStore&    TimingStore = FEnhancedSpecTimingStore::Get();
+	TArray<TSharedRef<FSpec>>          Specs;
+	TArray<int32>                      SpecGroupIndices;
+	TMap<const FSpecScopeNode*, int32> GroupIndicesByScope;
+	TArray<FEnhancedSpecShardGroup>    Groups;
+	TArray<int32>                      NumUntimedSpecsPerGroup;
+	TArray<int32>                      ShardAssignments;
+	double                             TotalTimedSeconds = 0.0;
+	int32                              NumTimedSpecs     = 0;
+
+	this->SpecsByIdHash.GenerateValueArray(Specs);
+
+	// Sort by ID so that every runner forms the same groups with the same keys.
+	Specs.Sort([](const TSharedRef<FSpec>& Left, const TSharedRef<FSpec>& Right)
+	{
+		return Left->Id < Right->Id;
+	});
+
+	for (const TSharedRef<FSpec>& Spec : Specs)
+	{
+		FSpecScopeChain ScopeChain;
+		int32           GroupIndex;
+		double          Seconds;
+
+		GatherScopeChain(*Spec, ScopeChain);
+
+		const FSpecScopeNode* GroupScope         = GetShardGroupScope(ScopeChain);
+		const int32*          ExistingGroupIndex = nullptr;
+
+		if (GroupScope != nullptr)
+		{
+			ExistingGroupIndex = GroupIndicesByScope.Find(GroupScope);
+		}
+
+		if (ExistingGroupIndex != nullptr)
+		{
+			GroupIndex = *ExistingGroupIndex;
+		}
+		else
+		{
+			FEnhancedSpecShardGroup NewGroup;
+
+			NewGroup.Key = Spec->Id;
+
+			GroupIndex = Groups.Add(MoveTemp(NewGroup));
+			NumUntimedSpecsPerGroup.Add(0);
+
+			if (GroupScope != nullptr)
+			{
+				GroupIndicesByScope.Add(GroupScope, GroupIndex);
+			}
+		}
+
+		if (TimingStore.FindDuration(this->GetFullTestName(*Spec), Seconds))
+		{
+			Groups[GroupIndex].EstimatedSeconds += Seconds;
+			Groups[GroupIndex].bHasTiming        = true;
+
+			TotalTimedSeconds += Seconds;
+			++NumTimedSpecs;
+		}
+		else
+		{
+			++NumUntimedSpecsPerGroup[GroupIndex];
+		}
+
+		SpecGroupIndices.Add(GroupIndex);
+	}
+
+	// Specs that are new to groups with recorded durations are assumed to take as long as an average spec.
+	if (NumTimedSpecs != 0)
+	{
+		const double AverageSeconds = TotalTimedSeconds / NumTimedSpecs;
+
+		for (int32 GroupIndex = 0; GroupIndex < Groups.Num(); ++GroupIndex)
+		{
+			Groups[GroupIndex].EstimatedSeconds += NumUntimedSpecsPerGroup[GroupIndex] * AverageSeconds;
+		}
+	}
+
+	ShardAssignments =
+		FEnhancedSpecSharding::AssignShards(this->TestName, Groups, FEnhancedSpecSharding::GetShardCount());
+
+	for (int32 SpecIndex = 0; SpecIndex < Specs.Num(); ++SpecIndex)
+	{
+		const int32 ShardIndex = ShardAssignments[SpecGroupIndices[SpecIndex]];
+
+		Specs[SpecIndex]->bIsInShard = (ShardIndex == FEnhancedSpecSharding::GetShardIndex());
+	}
+}
+
+void FEnhancedAutomationSpecBase::CountSpecsInShardPerScope()
+{
+	this->NumSpecsInShardPerScope.Empty();
+	this->ScopesWithDeferredScopes.Empty();
+
+	for (const TSharedRef<FSpecDeferredScope>& DeferredScope : this->DeferredScopes)
+	{
+		for (const FSpecScopeNode* Node = DeferredScope->ParentNode.Get(); Node != nullptr; Node = Node->Parent.Get())
+		{
+			if (Node->AfterAll.Num() != 0)
+			{
+				this->ScopesWithDeferredScopes.Add(Node->Handle);
+			}
+		}
+	}
+
+	for (const TPair<uint64, TSharedRef<FSpec>>& Entry : this->SpecsByIdHash)
+	{
+		const FSpec& Spec = Entry.Value.Get();
+
+		if (!Spec.bIsInShard)
+		{
+			continue;
+		}
+
+		for (const FSpecScopeNode* Node = Spec.Scope.Get(); Node != nullptr; Node = Node->Parent.Get())
+		{
+			if (Node->AfterAll.Num() != 0)
+			{
+				++this->NumSpecsInShardPerScope.FindOrAdd(Node->Handle, 0);
+			}
+		}
+	}
+}
+
+void FEnhancedAutomationSpecBase::MarkSpecAsFinished(const FSpec& Spec)
+{
+	for (const FSpecScopeNode* Node = Spec.Scope.Get(); Node != nullptr; Node = Node->Parent.Get())
+	{
+		if (Node->AfterAll.Num() != 0)
+		{
+			this->SuiteSessionState->MarkSpecAsFinished(Node->Handle);
+		}
+	}
+}
+
+void FEnhancedAutomationSpecBase::CountAsFixtureDependent(FEnhancedSpecFixtureBase& Fixture)
+{
+	if (!this->FixturesCountedAsDependent.Contains(&Fixture))
+	{
+		this->FixturesCountedAsDependent.Add(&Fixture);
+
+		FEnhancedSpecFixtureRegistry::Get().AddDependent(Fixture);
+	}
+}
+
+void FEnhancedAutomationSpecBase::MarkSpecAsStarted(const FSpec& Spec)
+{
+	for (const FSpecScopeNode* Node = Spec.Scope.Get(); Node != nullptr; Node = Node->Parent.Get())
+	{
+		if (Node->AfterAll.Num() != 0)
+		{
+			this->SuiteSessionState->MarkScopeAsStarted(Node->Handle);
+		}
+	}
+}
+
+void FEnhancedAutomationSpecBase::RunPendingAfterAllBlocks()
+{
+	const TSet<FSpecBlockHandle>&               ScopesStarted = this->SuiteSessionState->GetScopesStarted();
+	TMap<const FSpecScopeNode*, int32>          DepthPerNode;
+	TArray<TPair<const FSpecScopeNode*, int32>> NodesToRun;
+	TArray<TSharedRef<FSpecLatentCommand>>      Commands;
+
+	if (ScopesStarted.Num() == 0)
+	{
+		return;
+	}
+
+	for (const TPair<uint64, TSharedRef<FSpec>>& Entry : this->SpecsByIdHash)
+	{
+		for (const FSpecScopeNode* Node = Entry.Value->Scope.Get(); Node != nullptr; Node = Node->Parent.Get())
+		{
+			if (!DepthPerNode.Contains(Node) && ScopesStarted.Contains(Node->Handle))
+			{
+				int32 Depth = 0;
+
+				for (const FSpecScopeNode* Ancestor = Node->Parent.Get(); Ancestor != nullptr;
+				     Ancestor = Ancestor->Parent.Get())
+				{
+					++Depth;
+				}
+
+				DepthPerNode.Add(Node, Depth);
+			}
+		}
+	}
+
+	for (const TPair<const FSpecScopeNode*, int32>& Entry : DepthPerNode)
+	{
+		NodesToRun.Add(Entry);
+	}
+
+	// Run the blocks of nested scopes before those of the scopes that enclose them.
+	NodesToRun.Sort([](const TPair<const FSpecScopeNode*, int32>& A, const TPair<const FSpecScopeNode*, int32>& B)
+	{
+		return A.Value > B.Value;
+	});
+
+	for (const TPair<const FSpecScopeNode*, int32>& Entry : NodesToRun)
+	{
+		const FSpecScopeNode* Node = Entry.Key;
+
+		for (int32 AfterAllIndex = Node->AfterAll.Num() - 1; AfterAllIndex >= 0; --AfterAllIndex)
+		{
+			Commands.Add(Node->AfterAll[AfterAllIndex]);
+		}
+	}
+
+	// Blocks that have already run during this session skip their work, so this only runs the ones still pending. The
+	// session is over, so there are no more frames to wait for; keep updating until each block finishes or times out.
+	FSpecCommandSequence Sequence(this, MoveTemp(Commands));
+
+	while (!Sequence.Update())
+	{
+		FPlatformProcess::Sleep(0.0f);
+	}
+}
+
+FString FEnhancedAutomationSpecBase::GetFullTestName(const FSpec& Spec) const
+{
+	return FString::Printf(TEXT("%s %s"), *this->TestName, *Spec.Id);
+}
+
+const FEnhancedAutomationSpecBase::FSpec* FEnhancedAutomationSpecBase::GetRunningSpec() const
+{
+	const FParallelSpecContext* ParallelContext = this->bIsRunningInParallel ? GetParallelContextForThread() : nullptr;
+
+	if (ParallelContext != nullptr)
+	{
+		return ParallelContext->Spec;
+	}
+
+	return this->RunningSpec;
+}
+
+void FEnhancedAutomationSpecBase::RunBenchmark(const FEnhancedSpecBenchmarkOptions& Options,
+                                               const TFunction<void()>&             DoWork)
+{
+	const FSpec*                    Spec         = this->GetRunningSpec();
+	FEnhancedSpecBenchmarkBaseline& Baseline     = FEnhancedSpecBenchmarkBaseline::Get();
+	bool                            bHasBaseline = false;
+	FEnhancedSpecBenchmarkResult    Result,
+	                                BaselineResult;
+	FString                         FullTestName,
+	                                ResultPath;
+
+	Result = FEnhancedSpecBenchmark::Run(DoWork, Options, [this]
+	{
+		return this->HasAnyErrorsInContext();
+	});
+
+	// Failures have already been reported by the body itself.
+	if ((Result.NumSamples == 0) || (Spec == nullptr))
+	{
+		return;
+	}
+
+	FullTestName = this->GetFullTestName(*Spec);
+
+	this->AddInfo(FString::Printf(TEXT("Benchmark: %s"), *Result.ToString()));
+
+	if (Result.PerfCounters.HasAny())
+	{
+		this->AddInfo(
+			FString::Printf(TEXT("Benchmark performance counters per iteration: %s"), *Result.PerfCounters.ToString())
+		);
+	}
+	else if (Options.Budget.UsesPerfCounters())
+	{
+		this->AddWarning(
+			TEXT("Instruction budgets of this benchmark were not checked because hardware performance counters are ")
+			TEXT("not being read. Pass \"-EnhancedSpecPerfCounters\" on Linux to read them.")
+		);
+	}
+
+	ResultPath = FEnhancedSpecBenchmark::SaveResult(FullTestName, Spec->Filename, Spec->LineNumber, Result);
+
+	if (ResultPath.IsEmpty())
+	{
+		this->AddWarning(TEXT("Failed to save the results of this benchmark."));
+	}
+
+	if (Baseline.IsRecording())
+	{
+		Baseline.Record(FullTestName, Spec->Filename, Spec->LineNumber, Result);
+	}
+	else if (Options.Budget.IsRelativeToBaseline())
+	{
+		bHasBaseline = Baseline.Find(FullTestName, BaselineResult);
+
+		if (!bHasBaseline)
+		{
+			this->AddWarning(
+				FString::Printf(
+					TEXT("No baseline has been recorded for this benchmark in '%s', so it was not compared to one. ")
+					TEXT("Record one with \"-EnhancedSpecRecordBenchmarkBaseline\"."),
+					*Baseline.GetFilePath()
+				)
+			);
+		}
+	}
+
+	for (const FString& Violation : Options.Budget.Check(Result, bHasBaseline ? &BaselineResult : nullptr))
+	{
+		// Prefixing the location in the same way as compiler diagnostics lets IDEs and CI link straight to the block.
+		this->AddError(
+			FString::Printf(
+				TEXT("%s(%d): Performance budget exceeded: %s"),
+				*Spec->Filename,
+				Spec->LineNumber,
+				*Violation
+			)
+		);
+	}
+}
+
+void FEnhancedAutomationSpecBase::GatherSpecCommands(const TSharedRef<FSpec>&                SpecToRun,
+                                                     FSpecParallelBatches&                   ParallelBatches,
+                                                     TArray<TSharedRef<FSpecLatentCommand>>& OutCommands)
+{
+	FSpecScopeChain ScopeChain;
+
+	GatherScopeChain(*SpecToRun, ScopeChain);
+
+	if (CanRunInParallel(*SpecToRun, ScopeChain))
+	{
+		const FSpecScopeNode*                  ParallelScope = SpecToRun->Scope->ParallelScope;
+		TSharedRef<TArray<TSharedRef<FSpec>>>* BatchPtr      = ParallelBatches.Find(ParallelScope);
+
+		if (BatchPtr == nullptr)
+		{
+			BatchPtr = &ParallelBatches.Add(ParallelScope, MakeShared<TArray<TSharedRef<FSpec>>>());
+		}
+
+		const TSharedRef<TArray<TSharedRef<FSpec>>> Batch = *BatchPtr;
+
+		Batch->Add(SpecToRun);
+
+		// The spec runs alongside the other requested specs of its parallel scope, as soon as any of them is run. The
+		// automation controller runs each spec through its own call to RunTest(), so the specs that later calls will
+		// ask for join the batch as well, and those calls only report the results that were stored for them.
+		OutCommands.Add(
+			MakeShareable(new FSimpleBlockingCommand(this, [this, SpecToRun, ParallelScope, Batch]
+			{
+				if (!this->ReportParallelResult(*SpecToRun))
+				{
+					this->AddPendingParallelSpecs(*ParallelScope, Batch.Get());
+					this->RunParallelBatch(Batch.Get());
+
+					if (!this->ReportParallelResult(*SpecToRun))
+					{
+						// The batch that contained the spec ran without leaving a result for it (e.g., because the
+						// session ended in between), so run it on its own rather than letting it pass without running.
+						TArray<TSharedRef<FSpec>> RetryBatch = { SpecToRun };
+
+						this->RunParallelBatch(RetryBatch);
+						this->ReportParallelResult(*SpecToRun);
+					}
+				}
+
+				this->MarkSpecAsFinished(*SpecToRun);
+
+				// The AfterAll() blocks that follow belong to this test case, whichever test case started the batch.
+				this->RunningSpec = &SpecToRun.Get();
+			}))
+		);
+	}
+	else if (this->CanRunAhead(*SpecToRun, ScopeChain))
+	{
+		// Unless an earlier test case already ran this one ahead of time, this runs it along with the synchronous test
+		// cases that the automation controller will run after it, so that those only have to report their results.
+		OutCommands.Add(
+			MakeShareable(new FSimpleBlockingCommand(this, [this, SpecToRun]
+			{
+				if (!this->ReportParallelResult(*SpecToRun))
+				{
+					this->RunSpecsAhead(SpecToRun);
+					this->ReportParallelResult(*SpecToRun);
+				}
+
+				this->MarkSpecAsFinished(*SpecToRun);
+
+				this->RunningSpec = &SpecToRun.Get();
+			}))
+		);
+	}
+	else
+	{
+		this->GatherSequentialSpecCommands(SpecToRun, ScopeChain, OutCommands);
+	}
+
+	// Evaluate AfterAll() from the inner-most scope outwards, last block first. Each block only does its work if this
+	// spec turns out to be the last of its scope to finish.
+	for (const FSpecScopeNode* Node : ScopeChain)
+	{
+		for (int32 AfterAllIndex = Node->AfterAll.Num() - 1; AfterAllIndex >= 0; --AfterAllIndex)
+		{
+			OutCommands.Add(Node->AfterAll[AfterAllIndex]);
+		}
+	}
+}
+
+void FEnhancedAutomationSpecBase::GatherSequentialSpecCommands(const TSharedRef<FSpec>&                SpecToRun,
+                                                               const FSpecScopeChain&                  ScopeChain,
+                                                               TArray<TSharedRef<FSpecLatentCommand>>& OutCommands)
+{
+	OutCommands.Add(
+		MakeShareable(new FSimpleBlockingCommand(this, [this, SpecToRun]
+		{
+			this->BeginSpec(*SpecToRun);
+		}))
+	);
+
+	// Iterate in reverse to evaluate BeforeAll() from the outer-most scope inwards.
+	for (int32 ScopeIndex = ScopeChain.Num() - 1; ScopeIndex >= 0; --ScopeIndex)
+	{
+		for (const TSharedRef<FSpecLatentCommand>& Command : ScopeChain[ScopeIndex]->BeforeAll)
+		{
+			OutCommands.Add(Command);
+		}
+	}
+
+	// Iterate in reverse to evaluate BeforeEach() from the outer-most scope inwards.
+	for (int32 ScopeIndex = ScopeChain.Num() - 1; ScopeIndex >= 0; --ScopeIndex)
+	{
+		for (const TSharedRef<FSpecLatentCommand>& Command : ScopeChain[ScopeIndex]->BeforeEach)
+		{
+			OutCommands.Add(Command);
+		}
+	}
+
+	OutCommands.Add(SpecToRun->Command.ToSharedRef());
+
+	// Evaluate AfterEach() from the inner-most scope outwards, last block first.
+	for (const FSpecScopeNode* Node : ScopeChain)
+	{
+		for (int32 AfterEachIndex = Node->AfterEach.Num() - 1; AfterEachIndex >= 0; --AfterEachIndex)
+		{
+			OutCommands.Add(Node->AfterEach[AfterEachIndex]);
+		}
+	}
+
+	OutCommands.Add(
+		MakeShareable(new FSimpleBlockingCommand(this, [this, SpecToRun]
+		{
+			this->EndSpec(*SpecToRun);
+		}))
+	);
+}
+
+void FEnhancedAutomationSpecBase::BeginSpec(const FSpec& SpecToRun)
+{
+	// A test case that was aborted part-way through (e.g., by the automation controller) never reaches EndSpec(), so
+	// release anything it left behind before its memory is counted against this one.
+	this->ReleaseGeneratedVariables();
+
+	// Values memoized by earlier test cases become stale as soon as the generation advances, so there is no need to
+	// visit each variable here.
+	++this->VariableRunState.Generation;
+
+	this->MarkSpecAsStarted(SpecToRun);
+	this->SuiteSessionState->MarkSpecAsRun(SpecToRun.Id);
+
+	this->VariablesInScope   = SpecToRun.Scope->Variables;
+	this->RunningSpec        = &SpecToRun;
+	this->bIsReportingMemory = CVarEnhancedSpecReportMemoryWatermark.GetValueOnGameThread();
+
+	if (this->bIsReportingMemory)
+	{
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+		this->SpecStartPeakUsedPhysical = MemoryStats.PeakUsedPhysical;
+		this->SpecStartUsedPhysical     = MemoryStats.UsedPhysical;
+	}
+
+	this->SpecWorkSeconds   = 0.0;
+	this->SpecWorkStartTime = FPlatformTime::Seconds();
+}
+
+void FEnhancedAutomationSpecBase::EndSpec(const FSpec& SpecToRun)
+{
+	const double  DurationSeconds = this->SpecWorkSeconds + (FPlatformTime::Seconds() - this->SpecWorkStartTime);
+	const FString FullTestName    = this->GetFullTestName(SpecToRun);
+
+	if (this->bIsReportingMemory)
+	{
+		constexpr double           BytesPerMiB    = 1024.0 * 1024.0;
+		const FPlatformMemoryStats EndMemoryStats = FPlatformMemory::GetStats();
+		const uint64               StartPeak      =
+			FMath::Min(this->SpecStartPeakUsedPhysical, static_cast<uint64>(EndMemoryStats.PeakUsedPhysical));
+
+		this->ReleaseGeneratedVariables();
+
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Display,
+			TEXT("Memory of '%s': peak %.1f MiB (raised by %.1f MiB); in use %.1f MiB at start, %.1f MiB at end, ")
+			TEXT("%.1f MiB after releasing variables."),
+			*FullTestName,
+			EndMemoryStats.PeakUsedPhysical / BytesPerMiB,
+			(EndMemoryStats.PeakUsedPhysical - StartPeak) / BytesPerMiB,
+			this->SpecStartUsedPhysical / BytesPerMiB,
+			EndMemoryStats.UsedPhysical / BytesPerMiB,
+			FPlatformMemory::GetStats().UsedPhysical / BytesPerMiB
+		);
+	}
+	else
+	{
+		this->ReleaseGeneratedVariables();
+	}
+
+	FEnhancedSpecTimingStore::Get().RecordDuration(FullTestName, DurationSeconds);
+	FEnhancedSpecDurationBaseline::Get().RecordSpec(
+		FullTestName,
+		SpecToRun.Filename,
+		SpecToRun.LineNumber,
+		DurationSeconds
+	);
+
+	this->MarkSpecAsFinished(SpecToRun);
+}
+
+void FEnhancedAutomationSpecBase::ResumeSpecTimer()
+{
+	this->SpecWorkStartTime = FPlatformTime::Seconds();
+}
+
+void FEnhancedAutomationSpecBase::PauseSpecTimer()
+{
+	// Between test cases, this accumulates time that is discarded when the next test case starts.
+	this->SpecWorkSeconds += FPlatformTime::Seconds() - this->SpecWorkStartTime;
+}
+
+void FEnhancedAutomationSpecBase::ReleaseGeneratedVariables()
+{
+	TArray<FSpecLetWildcard*>& GeneratedVariables = this->VariableRunState.GeneratedVariables;
+
+	for (int32 VariableIndex = GeneratedVariables.Num() - 1; VariableIndex >= 0; --VariableIndex)
+	{
+		GeneratedVariables[VariableIndex]->Release();
+	}
+
+	GeneratedVariables.Reset();
+}
+
+void FEnhancedAutomationSpecBase::AddPendingParallelSpecs(const FSpecScopeNode&      ParallelScope,
+                                                          TArray<TSharedRef<FSpec>>& BatchSpecs)
+{
+	const TArray<TSharedRef<FSpec>>* ScopeSpecs         = this->ParallelSpecGroups.Find(&ParallelScope);
+	const TSet<FString>*             RequestedTestNames = this->SuiteSessionState->GetRequestedTestNames();
+
+	if (ScopeSpecs == nullptr)
+	{
+		return;
+	}
+
+	for (const TSharedRef<FSpec>& Spec : *ScopeSpecs)
+	{
+		FSpecScopeChain ScopeChain;
+
+		if (!Spec->bIsInShard ||
+		    BatchSpecs.Contains(Spec) ||
+		    this->SuiteSessionState->HasSpecRun(Spec->Id) ||
+		    ((RequestedTestNames != nullptr) && !this->IsSpecRequested(*Spec, *RequestedTestNames)))
+		{
+			continue;
+		}
+
+		GatherScopeChain(*Spec, ScopeChain);
+
+		if (CanRunInParallel(*Spec, ScopeChain))
+		{
+			BatchSpecs.Add(Spec);
+		}
+	}
+}
+
+bool FEnhancedAutomationSpecBase::IsSpecRequested(const FSpec& Spec, const TSet<FString>& RequestedTestNames) const
+{
+	// The automation controller lists test cases by their beautified paths, while the command line lists them by name.
+	return RequestedTestNames.Contains(this->GetFullTestName(Spec)) ||
+		RequestedTestNames.Contains(FString::Printf(TEXT("%s.%s"), *this->GetBeautifiedTestName(), *Spec.Description));
+}
+
+void FEnhancedAutomationSpecBase::RunParallelBatch(TArray<TSharedRef<FSpec>>& BatchSpecs)
+{
+	TArray<TSharedRef<FSpec>>    SpecsToRun = MoveTemp(BatchSpecs);
+	TArray<FSpecScopeChain>      BatchScopeChains;
+	TArray<FParallelSpecContext> Contexts;
+
+	BatchSpecs.Reset();
+
+	// A test case that another batch has already run for this call only needs its stored result to be reported.
+	SpecsToRun.RemoveAll([this](const TSharedRef<FSpec>& Spec)
+	{
+		return this->SuiteSessionState->HasParallelResult(Spec->Id);
+	});
+
+	if (SpecsToRun.Num() == 0)
+	{
+		// Another test case of the batch has already run it.
+		return;
+	}
+
+	for (const TSharedRef<FSpec>& Spec : SpecsToRun)
+	{
+		FSpecScopeChain ScopeChain;
+
+		GatherScopeChain(*Spec, ScopeChain);
+
+		this->MarkSpecAsStarted(*Spec);
+		this->SuiteSessionState->MarkSpecAsRun(Spec->Id);
+
+		this->RunningSpec = &Spec.Get();
+
+		// BeforeAll() blocks only run once per session, so this only runs blocks that have not yet run. Iterate in
+		// reverse to evaluate them from the outer-most scope inwards.
+		for (int32 ScopeIndex = ScopeChain.Num() - 1; ScopeIndex >= 0; --ScopeIndex)
+		{
+			for (const TSharedRef<FSpecLatentCommand>& Command : ScopeChain[ScopeIndex]->BeforeAll)
+			{
+				Command->Update();
+			}
+		}
+
+		BatchScopeChains.Add(MoveTemp(ScopeChain));
+	}
+
+	Contexts.SetNum(SpecsToRun.Num());
+
+	this->bIsRunningInParallel = true;
+
+	ParallelFor(SpecsToRun.Num(), [&SpecsToRun, &BatchScopeChains, &Contexts](const int32 SpecIndex)
+	{
+		RunSpecInContext(*SpecsToRun[SpecIndex], BatchScopeChains[SpecIndex], Contexts[SpecIndex], false);
+	});
+
+	this->bIsRunningInParallel = false;
+
+	for (int32 SpecIndex = 0; SpecIndex < SpecsToRun.Num(); ++SpecIndex)
+	{
+		this->StoreContextResult(*SpecsToRun[SpecIndex], Contexts[SpecIndex]);
+	}
+}
+
+void FEnhancedAutomationSpecBase::RunSpecInContext(const FSpec&           Spec,
+                                                   const FSpecScopeChain& ScopeChain,
+                                                   FParallelSpecContext&  Context,
+                                                   const bool             bRunBeforeAll)
+{
+	FSpecVariableScope Variables;
+
+	Variables.Reserve(Spec.Scope->Variables->Num());
+
+	for (const FSpecVariablePtrWildcard& Variable : *Spec.Scope->Variables)
+	{
+		Variables.Add(Variable.IsValid() ? Variable->Clone(&Context.VariableRunState) : FSpecVariablePtrWildcard());
+	}
+
+	Context.Variables = MakeShareable(new FSpecVariableScope(MoveTemp(Variables)));
+	Context.Spec      = &Spec;
+
+	GetParallelContextForThread() = &Context;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	if (bRunBeforeAll)
+	{
+		// BeforeAll() blocks only run once per session, so this only runs blocks that have not yet run. Iterate in
+		// reverse to evaluate them from the outer-most scope inwards.
+		for (int32 ScopeIndex = ScopeChain.Num() - 1; ScopeIndex >= 0; --ScopeIndex)
+		{
+			for (const TSharedRef<FSpecLatentCommand>& Command : ScopeChain[ScopeIndex]->BeforeAll)
+			{
+				Command->Update();
+			}
+		}
+	}
+
+	// Iterate in reverse to evaluate BeforeEach() from the outer-most scope inwards.
+	for (int32 ScopeIndex = ScopeChain.Num() - 1; ScopeIndex >= 0; --ScopeIndex)
+	{
+		for (const TSharedRef<FSpecLatentCommand>& Command : ScopeChain[ScopeIndex]->BeforeEach)
+		{
+			Command->Update();
+		}
+	}
+
+	Spec.Command->Update();
+
+	// Evaluate AfterEach() from the inner-most scope outwards, last block first.
+	for (const FSpecScopeNode* Node : ScopeChain)
+	{
+		for (int32 AfterEachIndex = Node->AfterEach.Num() - 1; AfterEachIndex >= 0; --AfterEachIndex)
+		{
+			Node->AfterEach[AfterEachIndex]->Update();
+		}
+	}
+
+	Context.DurationSeconds = FPlatformTime::Seconds() - StartTime;
+
+	GetParallelContextForThread() = nullptr;
+
+	// Release the variables on the thread that generated their values.
+	Context.Variables.Reset();
+}
+
+bool FEnhancedAutomationSpecBase::CanRunAhead(const FSpec& Spec, const FSpecScopeChain& ScopeChain) const
+{
+	// Memory watermarks are measured per test case, which cannot be done once several of them run back to back.
+	return CVarEnhancedSpecRunSynchronousSpecsAhead.GetValueOnGameThread() &&
+	       !CVarEnhancedSpecReportMemoryWatermark.GetValueOnGameThread() &&
+	       (Spec.Scope->ParallelScope == nullptr) &&
+	       CanRunSynchronously(Spec, ScopeChain);
+}
+
+void FEnhancedAutomationSpecBase::RunSpecsAhead(const TSharedRef<FSpec>& FirstSpec)
+{
+	const double         FrameBudgetSeconds = CVarEnhancedSpecFrameBudgetMs.GetValueOnGameThread() / 1000.0;
+	const double         Deadline           = FPlatformTime::Seconds() + FrameBudgetSeconds;
+	const TSet<FString>* RequestedTestNames = this->SuiteSessionState->GetRequestedTestNames();
+	bool                 bHasFoundFirstSpec = false;
+
+	const auto HasAfterAll = [](const FSpecScopeNode* Node)
+	{
+		return Node->AfterAll.Num() != 0;
+	};
+
+	for (const TPair<uint64, TSharedRef<FSpec>>& Entry : this->SpecsByIdHash)
+	{
+		const TSharedRef<FSpec>& Spec = Entry.Value;
+		FSpecScopeChain          ScopeChain;
+		FParallelSpecContext     Context;
+
+		if (Spec == FirstSpec)
+		{
+			bHasFoundFirstSpec = true;
+		}
+		else if (!bHasFoundFirstSpec ||
+		         !Spec->bIsInShard ||
+		         this->SuiteSessionState->HasSpecRun(Spec->Id) ||
+		         !this->IsSpecRequested(*Spec, *RequestedTestNames))
+		{
+			// Test cases defined before the first one have already had their turn, and the automation controller will
+			// not get to the others during this session.
+			continue;
+		}
+
+		GatherScopeChain(*Spec, ScopeChain);
+
+		if ((Spec != FirstSpec) && !this->CanRunAhead(*Spec, ScopeChain))
+		{
+			// The automation controller runs this test case next, and it has to run one block at a time.
+			break;
+		}
+
+		this->MarkSpecAsStarted(*Spec);
+		this->SuiteSessionState->MarkSpecAsRun(Spec->Id);
+
+		this->RunningSpec          = &Spec.Get();
+		this->bIsRunningInParallel = true;
+
+		RunSpecInContext(*Spec, ScopeChain, Context, true);
+
+		this->bIsRunningInParallel = false;
+
+		this->StoreContextResult(*Spec, Context);
+
+		// Stop if it is not known which test cases the automation controller will run next, if AfterAll() blocks may
+		// have to run before the next test case starts, or once the time budget for this frame has been used up.
+		if ((RequestedTestNames == nullptr) ||
+		    Algo::AnyOf(ScopeChain, HasAfterAll) ||
+		    ((FrameBudgetSeconds > 0.0) && (FPlatformTime::Seconds() >= Deadline)))
+		{
+			break;
+		}
+	}
+}
+
+void FEnhancedAutomationSpecBase::StoreContextResult(const FSpec& Spec, FParallelSpecContext& Context)
+{
+	const FString FullTestName = this->GetFullTestName(Spec);
+
+	FEnhancedSpecTimingStore::Get().RecordDuration(FullTestName, Context.DurationSeconds);
+	FEnhancedSpecDurationBaseline::Get().RecordSpec(
+		FullTestName,
+		Spec.Filename,
+		Spec.LineNumber,
+		Context.DurationSeconds
+	);
+
+	this->SuiteSessionState->StoreParallelResult(Spec.Id, MoveTemp(Context.Events));
+}
+
+bool FEnhancedAutomationSpecBase::ReportParallelResult(const FSpec& SpecToReport)
+{
+	TArray<FAutomationEvent> Events;
+
+	if (!this->SuiteSessionState->TakeParallelResult(SpecToReport.Id, Events))
+	{
+		return false;
+	}
+
+	for (const FAutomationEvent& Event : Events)
+	{
+		switch (Event.Type)
+		{
+			case EAutomationEventType::Error:
+				FAutomationTestBase::AddError(Event.Message);
+				break;
+
+			case EAutomationEventType::Warning:
+				FAutomationTestBase::AddWarning(Event.Message);
+				break;
+
+			default:
+				FAutomationTestBase::AddInfo(Event.Message);
+				break;
+		}
+	}
+
+	return true;
+}
+
+bool FEnhancedAutomationSpecBase::HasAnyErrorsInContext() const
+{
+	const FParallelSpecContext* ParallelContext = this->bIsRunningInParallel ? GetParallelContextForThread() : nullptr;
+
+	if (ParallelContext != nullptr)
+	{
+		return ParallelContext->bHasErrors;
+	}
+
+	return this->HasAnyErrors();
 }
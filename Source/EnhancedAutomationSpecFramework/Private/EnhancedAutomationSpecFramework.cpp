@@ -5,4 +5,148 @@
 //
 #include "EnhancedAutomationSpecFramework.h"
 
+#include <IAutomationControllerModule.h>
+
+#include <HAL/IConsoleManager.h>
+
+#include "EnhancedSpecBenchmarkBaseline.h"
+#include "EnhancedSpecDefinitionCache.h"
+#include "EnhancedSpecDurationBaseline.h"
+#include "EnhancedSpecFixture.h"
+#include "EnhancedSpecStragglers.h"
+#include "EnhancedSpecTimingStore.h"
+#include "EnhancedSpecTraceRecorder.h"
+#include "EnhancedSpecWorkerPool.h"
+
+DEFINE_LOG_CATEGORY(LogEnhancedAutomationSpecs);
+
+static TAutoConsoleVariable<float> CVarEnhancedSpecStragglerJoinSeconds(
+	TEXT("EnhancedSpecs.StragglerJoinSeconds"),
+	5.0f,
+	TEXT("The maximum time, in seconds, to wait at the end of a test session for asynchronous work that was abandoned ")
+	TEXT("after timing out to return."),
+	ECVF_Default
+);
+
+namespace EnhancedAutomationSpecFramework
+{
+	/**
+	 * Tries to get the automation controller manager.
+	 *
+	 * @return
+	 *	Either the automation controller manager; or a null pointer if the manager is not available (e.g., because the
+	 *	automation controller has not been loaded, or during shutdown of the engine).
+	 */
+	static IAutomationControllerManagerPtr GetAutomationController()
+	{
+		IAutomationControllerManagerPtr Result;
+
+		IAutomationControllerModule* AutomationControllerModule =
+			FModuleManager::GetModulePtr<IAutomationControllerModule>(TEXT("AutomationController"));
+
+		if (AutomationControllerModule != nullptr)
+		{
+			Result = AutomationControllerModule->GetAutomationController();
+		}
+
+		return Result;
+	}
+}
+
+FEnhancedAutomationSpecFramework* FEnhancedAutomationSpecFramework::GetIfLoaded()
+{
+	return FModuleManager::GetModulePtr<FEnhancedAutomationSpecFramework>(TEXT("EnhancedAutomationSpecFramework"));
+}
+
+void FEnhancedAutomationSpecFramework::StartupModule()
+{
+	this->RegisterWithAutomationController();
+
+	// The automation controller may be loaded after this module, in which case registration waits until it is.
+	this->ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddLambda(
+		[this](const FName ModuleName, const EModuleChangeReason Reason)
+		{
+			if ((Reason == EModuleChangeReason::ModuleLoaded) && (ModuleName == TEXT("AutomationController")))
+			{
+				this->RegisterWithAutomationController();
+			}
+		}
+	);
+}
+
+void FEnhancedAutomationSpecFramework::ShutdownModule()
+{
+	const IAutomationControllerManagerPtr AutomationController =
+		EnhancedAutomationSpecFramework::GetAutomationController();
+
+	FModuleManager::Get().OnModulesChanged().Remove(this->ModulesChangedHandle);
+
+	if (this->TestsCompleteHandle.IsValid() && AutomationController.IsValid())
+	{
+		AutomationController->OnTestsComplete().Remove(this->TestsCompleteHandle);
+	}
+
+	// Processes that run tests without an automation controller never see a session end, and listing test cases does
+	// not always lead to a session, so whatever the last session left unsaved is saved here instead.
+	this->EndSession();
+
+	FEnhancedSpecWorkerPool::Get().Shutdown();
+}
+
+bool FEnhancedAutomationSpecFramework::GetRequestedTestNames(TSet<FString>& OutTestNames) const
+{
+	TArray<FString>                       EnabledTestNames;
+	const IAutomationControllerManagerPtr AutomationController =
+		EnhancedAutomationSpecFramework::GetAutomationController();
+
+	if (!AutomationController.IsValid())
+	{
+		return false;
+	}
+
+	AutomationController->GetEnabledTestNames(EnabledTestNames);
+
+	if (EnabledTestNames.IsEmpty())
+	{
+		return false;
+	}
+
+	OutTestNames.Append(EnabledTestNames);
+
+	return true;
+}
+
+void FEnhancedAutomationSpecFramework::RegisterWithAutomationController()
+{
+	if (this->TestsCompleteHandle.IsValid())
+	{
+		return;
+	}
+
+	const IAutomationControllerManagerPtr AutomationController =
+		EnhancedAutomationSpecFramework::GetAutomationController();
+
+	if (AutomationController.IsValid())
+	{
+		this->TestsCompleteHandle =
+			AutomationController->OnTestsComplete().AddRaw(this, &FEnhancedAutomationSpecFramework::EndSession);
+	}
+}
+
+void FEnhancedAutomationSpecFramework::EndSession()
+{
+	// Spec classes finish first, since their teardown may still use shared fixtures and record timings.
+	this->SessionEndDelegate.Broadcast();
+
+	FEnhancedSpecStragglers::Get().JoinAll(CVarEnhancedSpecStragglerJoinSeconds.GetValueOnAnyThread());
+	FEnhancedSpecWorkerPool::Get().LogStats();
+	FEnhancedSpecFixtureRegistry::Get().EndSession();
+
+	FEnhancedSpecTimingStore::Get().Save();
+	FEnhancedSpecDefinitionCache::Get().Save();
+	FEnhancedSpecTraceRecorder::Get().EndSession();
+	FEnhancedSpecDurationBaseline::Get().EndSession();
+	FEnhancedSpecBenchmarkBaseline::Get().EndSession();
+}
+
 IMPLEMENT_MODULE(FEnhancedAutomationSpecFramework, EnhancedAutomationSpecFramework);
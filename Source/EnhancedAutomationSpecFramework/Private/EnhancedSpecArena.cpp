@@ -0,0 +1,61 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecArena.h"
+
+#include <HAL/UnrealMemory.h>
+
+#include <Templates/AlignmentTemplates.h>
+
+FEnhancedSpecArena::FEnhancedSpecArena() :
+	BlockCursor(nullptr),
+	BlockEnd(nullptr),
+	NumBytesUsed(0),
+	NumBytesAllocated(0)
+{
+}
+
+FEnhancedSpecArena::~FEnhancedSpecArena()
+{
+	for (void* Block : this->Blocks)
+	{
+		FMemory::Free(Block);
+	}
+}
+
+void* FEnhancedSpecArena::Allocate(const SIZE_T Size, const SIZE_T Alignment)
+{
+	uint8* Memory = Align(this->BlockCursor, Alignment);
+
+	this->NumBytesUsed += Size;
+
+	if ((this->BlockCursor != nullptr) && (Memory + Size <= this->BlockEnd))
+	{
+		this->BlockCursor = Memory + Size;
+
+		return Memory;
+	}
+
+	if (Size > (BlockSize / 4))
+	{
+		// Large objects get a block of their own, leaving the current block available for the objects that follow.
+		void* LargeBlock = FMemory::Malloc(Size, Alignment);
+
+		this->Blocks.Add(LargeBlock);
+		this->NumBytesAllocated += Size;
+
+		return LargeBlock;
+	}
+
+	uint8* Block = static_cast<uint8*>(FMemory::Malloc(BlockSize, FMath::Max<SIZE_T>(Alignment, 16)));
+
+	this->Blocks.Add(Block);
+	this->NumBytesAllocated += BlockSize;
+
+	this->BlockCursor = Block + Size;
+	this->BlockEnd    = Block + BlockSize;
+
+	return Block;
+}
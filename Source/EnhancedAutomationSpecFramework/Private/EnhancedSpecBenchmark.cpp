@@ -0,0 +1,363 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecBenchmark.h"
+
+#include <Dom/JsonObject.h>
+
+#include <HAL/PlatformTime.h>
+
+#include <Misc/CommandLine.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Parse.h>
+#include <Misc/Paths.h>
+
+#include <Serialization/JsonSerializer.h>
+
+#include "EnhancedSpecPerfCounters.h"
+
+namespace EnhancedSpecBenchmark
+{
+	/**
+	 * The factor that scales the median absolute deviation of normally-distributed values to their standard deviation.
+	 */
+	constexpr double MadToStandardDeviation = 1.4826;
+
+	/**
+	 * Formats a duration with a unit that suits its magnitude.
+	 *
+	 * @param Seconds
+	 *	The duration, in seconds.
+	 *
+	 * @return
+	 *	The duration in nanoseconds, microseconds, milliseconds, or seconds.
+	 */
+	static FString FormatDuration(const double Seconds)
+	{
+		if (Seconds < 1e-6)
+		{
+			return FString::Printf(TEXT("%.1f ns"), Seconds * 1e9);
+		}
+		else if (Seconds < 1e-3)
+		{
+			return FString::Printf(TEXT("%.3f us"), Seconds * 1e6);
+		}
+		else if (Seconds < 1.0)
+		{
+			return FString::Printf(TEXT("%.3f ms"), Seconds * 1e3);
+		}
+		else
+		{
+			return FString::Printf(TEXT("%.3f s"), Seconds);
+		}
+	}
+}
+
+// =====================================================================================================================
+// FEnhancedSpecBenchmarkBudget
+// =====================================================================================================================
+TArray<FString> FEnhancedSpecBenchmarkBudget::Check(const FEnhancedSpecBenchmarkResult& Result,
+                                                    const FEnhancedSpecBenchmarkResult* Baseline) const
+{
+	TArray<FString> Violations;
+
+	const auto CheckLimit = [&Violations](const TCHAR* Statistic, const double Seconds, const double MaxSeconds)
+	{
+		if ((MaxSeconds > 0.0) && (Seconds > MaxSeconds))
+		{
+			Violations.Add(
+				FString::Printf(
+					TEXT("%s of %s exceeds the budget of %s."),
+					Statistic,
+					*EnhancedSpecBenchmark::FormatDuration(Seconds),
+					*EnhancedSpecBenchmark::FormatDuration(MaxSeconds)
+				)
+			);
+		}
+	};
+
+	CheckLimit(TEXT("Median"), Result.MedianSeconds, this->MaxMedianSeconds);
+	CheckLimit(TEXT("95th percentile"), Result.P95Seconds, this->MaxP95Seconds);
+	CheckLimit(TEXT("99th percentile"), Result.P99Seconds, this->MaxP99Seconds);
+
+	if ((Baseline != nullptr) && (this->MaxMedianRegression > 0.0) && (Baseline->MedianSeconds > 0.0) &&
+	    (Result.MedianSeconds > Baseline->MedianSeconds * (1.0 + this->MaxMedianRegression)))
+	{
+		Violations.Add(
+			FString::Printf(
+				TEXT("Median of %s is %.1f%% slower than the baseline of %s, which exceeds the budget of %.1f%%."),
+				*EnhancedSpecBenchmark::FormatDuration(Result.MedianSeconds),
+				(Result.MedianSeconds / Baseline->MedianSeconds - 1.0) * 100.0,
+				*EnhancedSpecBenchmark::FormatDuration(Baseline->MedianSeconds),
+				this->MaxMedianRegression * 100.0
+			)
+		);
+	}
+
+	if ((this->MaxInstructions > 0.0) && (Result.PerfCounters.Instructions > this->MaxInstructions))
+	{
+		Violations.Add(
+			FString::Printf(
+				TEXT("Instructions per iteration of %.0f exceed the budget of %.0f."),
+				Result.PerfCounters.Instructions,
+				this->MaxInstructions
+			)
+		);
+	}
+
+	if ((Baseline != nullptr) && (this->MaxInstructionsRegression > 0.0) &&
+	    (Baseline->PerfCounters.Instructions > 0.0) && (Result.PerfCounters.Instructions >= 0.0) &&
+	    (Result.PerfCounters.Instructions >
+	     Baseline->PerfCounters.Instructions * (1.0 + this->MaxInstructionsRegression)))
+	{
+		Violations.Add(
+			FString::Printf(
+				TEXT("Instructions per iteration of %.0f are %.1f%% more than the baseline of %.0f, which exceeds the ")
+				TEXT("budget of %.1f%%."),
+				Result.PerfCounters.Instructions,
+				(Result.PerfCounters.Instructions / Baseline->PerfCounters.Instructions - 1.0) * 100.0,
+				Baseline->PerfCounters.Instructions,
+				this->MaxInstructionsRegression * 100.0
+			)
+		);
+	}
+
+	return Violations;
+}
+
+// =====================================================================================================================
+// FEnhancedSpecBenchmarkResult
+// =====================================================================================================================
+FEnhancedSpecBenchmarkResult FEnhancedSpecBenchmarkResult::FromSamples(TArray<double> SampleSeconds,
+                                                                       const int64    IterationsPerSample,
+                                                                       const double   OutlierThreshold)
+{
+	FEnhancedSpecBenchmarkResult Result;
+	TArray<double>               Deviations,
+	                             KeptSamples;
+	double                       Median,
+	                             OutlierLimit,
+	                             TotalSeconds = 0.0;
+
+	Result.IterationsPerSample = IterationsPerSample;
+	Result.NumSamples          = SampleSeconds.Num();
+
+	if (SampleSeconds.Num() == 0)
+	{
+		return Result;
+	}
+
+	SampleSeconds.Sort();
+
+	Median = GetPercentile(SampleSeconds, 50.0);
+
+	Deviations.Reserve(SampleSeconds.Num());
+
+	for (const double Sample : SampleSeconds)
+	{
+		Deviations.Add(FMath::Abs(Sample - Median));
+	}
+
+	Deviations.Sort();
+
+	Result.MadSeconds = GetPercentile(Deviations, 50.0);
+
+	// When most samples are identical, the deviation is zero and every other sample would be rejected, so nothing is.
+	if ((OutlierThreshold > 0.0) && (Result.MadSeconds > 0.0))
+	{
+		OutlierLimit = OutlierThreshold * EnhancedSpecBenchmark::MadToStandardDeviation * Result.MadSeconds;
+	}
+	else
+	{
+		OutlierLimit = TNumericLimits<double>::Max();
+	}
+
+	KeptSamples.Reserve(SampleSeconds.Num());
+
+	for (const double Sample : SampleSeconds)
+	{
+		if (FMath::Abs(Sample - Median) <= OutlierLimit)
+		{
+			KeptSamples.Add(Sample);
+
+			TotalSeconds += Sample;
+		}
+	}
+
+	Result.NumOutliers   = SampleSeconds.Num() - KeptSamples.Num();
+	Result.MinSeconds    = KeptSamples[0];
+	Result.MedianSeconds = GetPercentile(KeptSamples, 50.0);
+	Result.MeanSeconds   = TotalSeconds / KeptSamples.Num();
+
+	// Rejecting outliers would hide the rare slow iterations that the tail of the distribution is meant to capture.
+	Result.P95Seconds = GetPercentile(SampleSeconds, 95.0);
+	Result.P99Seconds = GetPercentile(SampleSeconds, 99.0);
+	Result.MaxSeconds = SampleSeconds.Last();
+
+	return Result;
+}
+
+double FEnhancedSpecBenchmarkResult::GetPercentile(const TArray<double>& SortedValues, const double Percentile)
+{
+	const double Rank       = FMath::Clamp(Percentile / 100.0, 0.0, 1.0) * (SortedValues.Num() - 1);
+	const int32  LowerIndex = FMath::FloorToInt32(Rank);
+	const int32  UpperIndex = FMath::Min(LowerIndex + 1, SortedValues.Num() - 1);
+
+	check(SortedValues.Num() > 0);
+
+	return FMath::Lerp(SortedValues[LowerIndex], SortedValues[UpperIndex], Rank - LowerIndex);
+}
+
+FString FEnhancedSpecBenchmarkResult::ToString() const
+{
+	if (this->NumSamples == 0)
+	{
+		return TEXT("no samples");
+	}
+
+	return FString::Printf(
+		TEXT("median %s, min %s, p95 %s, p99 %s, max %s, MAD %s (%d samples of %lld iterations; %d outliers ")
+		TEXT("rejected)"),
+		*EnhancedSpecBenchmark::FormatDuration(this->MedianSeconds),
+		*EnhancedSpecBenchmark::FormatDuration(this->MinSeconds),
+		*EnhancedSpecBenchmark::FormatDuration(this->P95Seconds),
+		*EnhancedSpecBenchmark::FormatDuration(this->P99Seconds),
+		*EnhancedSpecBenchmark::FormatDuration(this->MaxSeconds),
+		*EnhancedSpecBenchmark::FormatDuration(this->MadSeconds),
+		this->NumSamples,
+		this->IterationsPerSample,
+		this->NumOutliers
+	);
+}
+
+// =====================================================================================================================
+// FEnhancedSpecBenchmark
+// =====================================================================================================================
+FEnhancedSpecBenchmarkResult FEnhancedSpecBenchmark::Run(const TFunctionRef<void()>           Body,
+                                                         const FEnhancedSpecBenchmarkOptions& Options,
+                                                         const TFunctionRef<bool()>           ShouldStop)
+{
+	const int32                    MaxNumSamples       = FMath::Max(Options.NumSamples, 1);
+	const int32                    MinNumSamples       = FMath::Clamp(Options.MinNumSamples, 1, MaxNumSamples);
+	const double                   WarmupEnd           = FPlatformTime::Seconds() + Options.WarmupSeconds;
+	int64                          IterationsPerSample = 1;
+	int32                          NumSamples;
+	double                         SampleSeconds;
+	TArray<double>                 Samples;
+	FEnhancedSpecPerfCounterValues PerfCounters;
+	FEnhancedSpecBenchmarkResult   Result;
+
+	const auto TimeSample = [&Body](const int64 NumIterations)
+	{
+		const double StartSeconds = FPlatformTime::Seconds();
+
+		for (int64 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			Body();
+		}
+
+		return FPlatformTime::Seconds() - StartSeconds;
+	};
+
+	SampleSeconds = TimeSample(1);
+
+	// Calibrate the number of iterations per sample while warming up, doubling it until each sample takes long enough
+	// to be timed accurately.
+	while (!ShouldStop() && ((SampleSeconds < Options.MinSampleSeconds) || (FPlatformTime::Seconds() < WarmupEnd)))
+	{
+		if (SampleSeconds < Options.MinSampleSeconds)
+		{
+			IterationsPerSample *= 2;
+		}
+
+		SampleSeconds = TimeSample(IterationsPerSample);
+	}
+
+	if (ShouldStop())
+	{
+		return FEnhancedSpecBenchmarkResult();
+	}
+
+	NumSamples = FMath::Max(
+		FMath::FloorToInt32(
+			FMath::Min(Options.MaxSeconds / FMath::Max(SampleSeconds, UE_DOUBLE_SMALL_NUMBER), double(MaxNumSamples))
+		),
+		MinNumSamples
+	);
+
+	Samples.Reserve(NumSamples);
+
+	{
+		FEnhancedSpecPerfCounterScope PerfCounterScope;
+
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		{
+			Samples.Add(TimeSample(IterationsPerSample) / IterationsPerSample);
+
+			if (ShouldStop())
+			{
+				return FEnhancedSpecBenchmarkResult();
+			}
+		}
+
+		PerfCounters = PerfCounterScope.Stop();
+	}
+
+	Result =
+		FEnhancedSpecBenchmarkResult::FromSamples(MoveTemp(Samples), IterationsPerSample, Options.OutlierThreshold);
+
+	// Unlike times, counts cannot be split by sample, so they are averaged across every iteration, outliers included.
+	Result.PerfCounters = PerfCounters.DividedBy(static_cast<double>(NumSamples) * IterationsPerSample);
+
+	return Result;
+}
+
+FString FEnhancedSpecBenchmark::SaveResult(const FString&                      FullTestName,
+                                           const FString&                      Filename,
+                                           const int32                         LineNumber,
+                                           const FEnhancedSpecBenchmarkResult& Result)
+{
+	const TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+	FString                       Directory,
+	                              ResultJson,
+	                              ResultPath;
+
+	if (!FParse::Value(FCommandLine::Get(), TEXT("EnhancedSpecBenchmarkResults="), Directory))
+	{
+		Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("EnhancedSpecBenchmarks"));
+	}
+
+	ResultObject->SetStringField(TEXT("Test"), FullTestName);
+	ResultObject->SetStringField(TEXT("Filename"), Filename);
+	ResultObject->SetNumberField(TEXT("LineNumber"), LineNumber);
+	ResultObject->SetNumberField(TEXT("IterationsPerSample"), Result.IterationsPerSample);
+	ResultObject->SetNumberField(TEXT("NumSamples"), Result.NumSamples);
+	ResultObject->SetNumberField(TEXT("NumOutliers"), Result.NumOutliers);
+	ResultObject->SetNumberField(TEXT("MinSeconds"), Result.MinSeconds);
+	ResultObject->SetNumberField(TEXT("MedianSeconds"), Result.MedianSeconds);
+	ResultObject->SetNumberField(TEXT("MeanSeconds"), Result.MeanSeconds);
+	ResultObject->SetNumberField(TEXT("P95Seconds"), Result.P95Seconds);
+	ResultObject->SetNumberField(TEXT("P99Seconds"), Result.P99Seconds);
+	ResultObject->SetNumberField(TEXT("MaxSeconds"), Result.MaxSeconds);
+	ResultObject->SetNumberField(TEXT("MadSeconds"), Result.MadSeconds);
+
+	Result.PerfCounters.ForEachCount([&ResultObject](const TCHAR* Name, const double Value)
+	{
+		if (Value >= 0.0)
+		{
+			ResultObject->SetNumberField(Name, Value);
+		}
+	});
+
+	ResultPath = FPaths::Combine(Directory, FPaths::MakeValidFileName(FullTestName) + TEXT(".json"));
+
+	if (!FJsonSerializer::Serialize(ResultObject, TJsonWriterFactory<>::Create(&ResultJson)) ||
+	    !FFileHelper::SaveStringToFile(ResultJson, *ResultPath))
+	{
+		return FString();
+	}
+
+	return ResultPath;
+}
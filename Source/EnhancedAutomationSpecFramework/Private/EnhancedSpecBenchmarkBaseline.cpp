@@ -0,0 +1,178 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecBenchmarkBaseline.h"
+
+#include <Dom/JsonObject.h>
+
+#include <Misc/CommandLine.h>
+#include <Misc/Parse.h>
+#include <Misc/Paths.h>
+#include <Misc/ScopeLock.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+
+FEnhancedSpecBenchmarkBaseline& FEnhancedSpecBenchmarkBaseline::Get()
+{
+	static FEnhancedSpecBenchmarkBaseline Instance;
+
+	return Instance;
+}
+
+FEnhancedSpecBenchmarkBaseline::FEnhancedSpecBenchmarkBaseline() :
+	Store(FileVersion, TEXT("Benchmarks"), TEXT("benchmark baseline"))
+{
+	const TCHAR*            CommandLine = FCommandLine::Get();
+	TSharedPtr<FJsonObject> Entries;
+
+	if (!FParse::Value(CommandLine, TEXT("EnhancedSpecBenchmarkBaseline="), this->FilePath))
+	{
+		this->FilePath =
+			FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("EnhancedSpecBenchmarkBaseline.json"));
+	}
+
+	this->bIsRecording = FParse::Param(CommandLine, TEXT("EnhancedSpecRecordBenchmarkBaseline"));
+
+	if (this->Store.Read(this->FilePath, Entries))
+	{
+		this->ReadBaseline(*Entries);
+	}
+}
+
+bool FEnhancedSpecBenchmarkBaseline::Find(const FString& FullTestName, FEnhancedSpecBenchmarkResult& OutResult)
+{
+	FScopeLock    ScopeLock(&this->Lock);
+	const FEntry* Entry = this->Baseline.Find(FullTestName);
+
+	if (Entry == nullptr)
+	{
+		return false;
+	}
+
+	OutResult = Entry->Result;
+
+	return true;
+}
+
+void FEnhancedSpecBenchmarkBaseline::Record(const FString&                      FullTestName,
+                                            const FString&                      Filename,
+                                            const int32                         LineNumber,
+                                            const FEnhancedSpecBenchmarkResult& Result)
+{
+	if (!this->bIsRecording)
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&this->Lock);
+
+	this->SessionEntries.Add(FullTestName, FEntry { Filename, LineNumber, Result });
+}
+
+void FEnhancedSpecBenchmarkBaseline::EndSession()
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	if (this->SessionEntries.Num() == 0)
+	{
+		return;
+	}
+
+	const bool bWasSaved = this->Store.Update(this->FilePath, [this](FJsonObject& Entries)
+	{
+		this->ReadBaseline(Entries);
+
+		for (const TPair<FString, FEntry>& SessionEntry : this->SessionEntries)
+		{
+			this->Baseline.Add(SessionEntry.Key, SessionEntry.Value);
+		}
+
+		this->WriteBaseline(Entries);
+	});
+
+	if (bWasSaved)
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Display,
+			TEXT("Recorded the baselines of %d benchmark(s) to '%s'."),
+			this->SessionEntries.Num(),
+			*this->FilePath
+		);
+	}
+
+	this->SessionEntries.Empty();
+}
+
+void FEnhancedSpecBenchmarkBaseline::ReadBaseline(const FJsonObject& Entries)
+{
+	this->Baseline.Empty(Entries.Values.Num());
+
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Value : Entries.Values)
+	{
+		const TSharedPtr<FJsonObject>* EntryObject;
+		FEntry                         Entry;
+
+		if (Value.Value.IsValid() &&
+		    Value.Value->TryGetObject(EntryObject) &&
+		    (*EntryObject)->TryGetNumberField(TEXT("MedianSeconds"), Entry.Result.MedianSeconds) &&
+		    (Entry.Result.MedianSeconds > 0.0))
+		{
+			(*EntryObject)->TryGetStringField(TEXT("Filename"), Entry.Filename);
+			(*EntryObject)->TryGetNumberField(TEXT("LineNumber"), Entry.LineNumber);
+			(*EntryObject)->TryGetNumberField(TEXT("IterationsPerSample"), Entry.Result.IterationsPerSample);
+			(*EntryObject)->TryGetNumberField(TEXT("NumSamples"), Entry.Result.NumSamples);
+			(*EntryObject)->TryGetNumberField(TEXT("NumOutliers"), Entry.Result.NumOutliers);
+			(*EntryObject)->TryGetNumberField(TEXT("MinSeconds"), Entry.Result.MinSeconds);
+			(*EntryObject)->TryGetNumberField(TEXT("MeanSeconds"), Entry.Result.MeanSeconds);
+			(*EntryObject)->TryGetNumberField(TEXT("P95Seconds"), Entry.Result.P95Seconds);
+			(*EntryObject)->TryGetNumberField(TEXT("P99Seconds"), Entry.Result.P99Seconds);
+			(*EntryObject)->TryGetNumberField(TEXT("MaxSeconds"), Entry.Result.MaxSeconds);
+			(*EntryObject)->TryGetNumberField(TEXT("MadSeconds"), Entry.Result.MadSeconds);
+
+			// Counts are only present in baselines recorded while hardware performance counters were being read.
+			Entry.Result.PerfCounters.ForEachCount([&EntryObject](const TCHAR* Name, double& Value)
+			{
+				(*EntryObject)->TryGetNumberField(Name, Value);
+			});
+
+			this->Baseline.Add(Value.Key, MoveTemp(Entry));
+		}
+	}
+}
+
+void FEnhancedSpecBenchmarkBaseline::WriteBaseline(FJsonObject& Entries) const
+{
+	Entries.Values.Empty(this->Baseline.Num());
+
+	for (const TPair<FString, FEntry>& BaselineEntry : this->Baseline)
+	{
+		const FEntry&                 Entry       = BaselineEntry.Value;
+		const TSharedRef<FJsonObject> EntryObject = MakeShared<FJsonObject>();
+
+		EntryObject->SetStringField(TEXT("Filename"), Entry.Filename);
+		EntryObject->SetNumberField(TEXT("LineNumber"), Entry.LineNumber);
+		EntryObject->SetNumberField(TEXT("IterationsPerSample"), Entry.Result.IterationsPerSample);
+		EntryObject->SetNumberField(TEXT("NumSamples"), Entry.Result.NumSamples);
+		EntryObject->SetNumberField(TEXT("NumOutliers"), Entry.Result.NumOutliers);
+		EntryObject->SetNumberField(TEXT("MinSeconds"), Entry.Result.MinSeconds);
+		EntryObject->SetNumberField(TEXT("MedianSeconds"), Entry.Result.MedianSeconds);
+		EntryObject->SetNumberField(TEXT("MeanSeconds"), Entry.Result.MeanSeconds);
+		EntryObject->SetNumberField(TEXT("P95Seconds"), Entry.Result.P95Seconds);
+		EntryObject->SetNumberField(TEXT("P99Seconds"), Entry.Result.P99Seconds);
+		EntryObject->SetNumberField(TEXT("MaxSeconds"), Entry.Result.MaxSeconds);
+		EntryObject->SetNumberField(TEXT("MadSeconds"), Entry.Result.MadSeconds);
+
+		Entry.Result.PerfCounters.ForEachCount([&EntryObject](const TCHAR* Name, const double Value)
+		{
+			if (Value >= 0.0)
+			{
+				EntryObject->SetNumberField(Name, Value);
+			}
+		});
+
+		Entries.SetObjectField(BaselineEntry.Key, EntryObject);
+	}
+}
@@ -0,0 +1,196 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <HAL/CriticalSection.h>
+
+#include "EnhancedSpecBenchmark.h"
+#include "EnhancedSpecJsonStore.h"
+
+class FJsonObject;
+
+/**
+ * Stores the results of each Benchmark() block, so that the budgets of later runs can be relative to them.
+ *
+ * Results are keyed by the full name of each benchmark (the name of the spec class followed by the ID of the test
+ * case), and stored in a versioned JSON file. The file is located at
+ * "Saved/Automation/EnhancedSpecBenchmarkBaseline.json" by default, but a different path can be supplied on the command
+ * line with "-EnhancedSpecBenchmarkBaseline=<Path>". It is meant to be committed alongside the specs, or restored by CI
+ * between runs.
+ *
+ * The baseline is only changed when "-EnhancedSpecRecordBenchmarkBaseline" is passed on the command line. In that mode,
+ * the results of every benchmark that runs replace its baseline, and are saved at the end of the session.
+ */
+class FEnhancedSpecBenchmarkBaseline final
+{
+	// =================================================================================================================
+	// Private Types
+	// =================================================================================================================
+	/**
+	 * The recorded results of a benchmark, along with where it was defined.
+	 */
+	struct FEntry final
+	{
+		/**
+		 * The filename of the specification in which the benchmark was defined.
+		 */
+		FString Filename;
+
+		/**
+		 * The line number where the benchmark was defined.
+		 */
+		int32 LineNumber = 0;
+
+		/**
+		 * The results of the benchmark.
+		 */
+		FEnhancedSpecBenchmarkResult Result;
+	};
+
+	// =================================================================================================================
+	// Private Constants
+	// =================================================================================================================
+	/**
+	 * The version of the file format written by this baseline.
+	 */
+	static constexpr int32 FileVersion = 1;
+
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The path to the file from which the baseline is loaded and to which it is saved.
+	 */
+	FString FilePath;
+
+	/**
+	 * Reads and updates the baseline file.
+	 */
+	FEnhancedSpecJsonStore Store;
+
+	/**
+	 * Whether the results of benchmarks are replacing their baselines during this session.
+	 */
+	bool bIsRecording;
+
+	/**
+	 * Guards access to the baseline, since benchmarks can run on worker threads.
+	 */
+	FCriticalSection Lock;
+
+	/**
+	 * The recorded results of each benchmark, keyed by the full name of each benchmark.
+	 */
+	TMap<FString, FEntry> Baseline;
+
+	/**
+	 * The results recorded during the current session, keyed by the full name of each benchmark.
+	 */
+	TMap<FString, FEntry> SessionEntries;
+
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the benchmark baseline for this process, loading it from disk the first time it is requested.
+	 *
+	 * @return
+	 *	The benchmark baseline.
+	 */
+	static FEnhancedSpecBenchmarkBaseline& Get();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether the results of benchmarks are replacing their baselines during this session.
+	 *
+	 * @return
+	 *	true if baselines are being recorded; or, false if they are only being compared against.
+	 */
+	FORCEINLINE bool IsRecording() const
+	{
+		return this->bIsRecording;
+	}
+
+	/**
+	 * Gets the path to the file from which the baseline is loaded and to which it is saved.
+	 *
+	 * @return
+	 *	The path to the baseline file.
+	 */
+	FORCEINLINE const FString& GetFilePath() const
+	{
+		return this->FilePath;
+	}
+
+	/**
+	 * Looks up the recorded results of a benchmark.
+	 *
+	 * @param FullTestName
+	 *	The name of the spec class followed by a space and the ID of the test case of the benchmark.
+	 * @param OutResult
+	 *	Set to the recorded results of the benchmark, if it has a baseline.
+	 *
+	 * @return
+	 *	true if the benchmark has a baseline; or, false otherwise.
+	 */
+	bool Find(const FString& FullTestName, FEnhancedSpecBenchmarkResult& OutResult);
+
+	/**
+	 * Records the results of a benchmark as its new baseline, if recording is enabled.
+	 *
+	 * @param FullTestName
+	 *	The name of the spec class followed by a space and the ID of the test case of the benchmark.
+	 * @param Filename
+	 *	The filename of the specification in which the benchmark was defined.
+	 * @param LineNumber
+	 *	The line number where the benchmark was defined.
+	 * @param Result
+	 *	The results of the benchmark.
+	 */
+	void Record(const FString&                      FullTestName,
+	            const FString&                      Filename,
+	            const int32                         LineNumber,
+	            const FEnhancedSpecBenchmarkResult& Result);
+
+	/**
+	 * Saves the results recorded during the current session to the baseline file.
+	 *
+	 * The baselines of benchmarks that did not run during this session are preserved, including those saved by other
+	 * runners while this session was running.
+	 */
+	void EndSession();
+
+private:
+	// =================================================================================================================
+	// Private Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new instance and loads the baseline from disk.
+	 */
+	explicit FEnhancedSpecBenchmarkBaseline();
+
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Replaces the baseline with the results read from the entries of the baseline file.
+	 *
+	 * @param Entries
+	 *	The entries of the baseline file.
+	 */
+	void ReadBaseline(const FJsonObject& Entries);
+
+	/**
+	 * Replaces the entries of the baseline file with the results of the baseline.
+	 *
+	 * @param Entries
+	 *	The entries of the baseline file.
+	 */
+	void WriteBaseline(FJsonObject& Entries) const;
+};
@@ -0,0 +1,305 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecDefinitionCache.h"
+
+#include <HAL/FileManager.h>
+#include <HAL/PlatformProcess.h>
+
+#include <Misc/CommandLine.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Parse.h>
+#include <Misc/Paths.h>
+#include <Misc/ScopeLock.h>
+
+#include <Modules/ModuleManager.h>
+
+#include <Serialization/MemoryReader.h>
+#include <Serialization/MemoryWriter.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+#include "EnhancedSpecSharding.h"
+
+FEnhancedSpecDefinitionCache& FEnhancedSpecDefinitionCache::Get()
+{
+	static FEnhancedSpecDefinitionCache Instance;
+
+	return Instance;
+}
+
+FEnhancedSpecDefinitionCache::FEnhancedSpecDefinitionCache(const FString& FilePath) :
+	FilePath(FilePath),
+	bIsEnabled(true),
+	bIsDirty(false)
+{
+	this->ReadFile();
+}
+
+FEnhancedSpecDefinitionCache::FEnhancedSpecDefinitionCache() : bIsDirty(false)
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	if (FParse::Value(CommandLine, TEXT("EnhancedSpecDefinitionCache="), this->FilePath))
+	{
+		this->bIsEnabled = true;
+	}
+	else
+	{
+		this->FilePath =
+			FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("EnhancedSpecDefinitions.bin"));
+
+		this->bIsEnabled = FParse::Param(CommandLine, TEXT("EnhancedSpecDefinitionCache"));
+	}
+
+	// Shards only list the test cases assigned to them, which requires the full definition of each spec class.
+	if (FEnhancedSpecSharding::IsEnabled())
+	{
+		this->bIsEnabled = false;
+	}
+
+	if (this->bIsEnabled)
+	{
+		this->ReadFile();
+	}
+}
+
+FString FEnhancedSpecDefinitionCache::GetBuildStamp(const FString& ModuleName) const
+{
+	FScopeLock     ScopeLock(&this->Lock);
+	const FString* ExistingStamp = this->BuildStampsByModuleName.Find(ModuleName);
+	FString        BinaryPath,
+	               BuildStamp;
+
+	if (ExistingStamp != nullptr)
+	{
+		return *ExistingStamp;
+	}
+
+#if IS_MONOLITHIC
+	BinaryPath = FPlatformProcess::ExecutablePath();
+#else
+	if (FModuleManager::Get().ModuleExists(*ModuleName))
+	{
+		BinaryPath = FModuleManager::Get().GetModuleFilename(FName(*ModuleName));
+	}
+#endif
+
+	if (!BinaryPath.IsEmpty())
+	{
+		const FFileStatData StatData = IFileManager::Get().GetStatData(*BinaryPath);
+
+		if (StatData.bIsValid)
+		{
+			BuildStamp = FString::Printf(
+				TEXT("%lld-%lld"),
+				StatData.FileSize,
+				StatData.ModificationTime.GetTicks()
+			);
+		}
+	}
+
+	this->BuildStampsByModuleName.Add(ModuleName, BuildStamp);
+
+	return BuildStamp;
+}
+
+TSharedPtr<const FEnhancedSpecListingSet> FEnhancedSpecDefinitionCache::Find(const FString& SuiteName,
+                                                                             const FString& BuildStamp) const
+{
+	FScopeLock                                 ScopeLock(&this->Lock);
+	const TSharedRef<FEnhancedSpecListingSet>* ListingSet;
+
+	if (!this->bIsEnabled || BuildStamp.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	ListingSet = this->ListingSets.Find(SuiteName);
+
+	if ((ListingSet == nullptr) || ((*ListingSet)->BuildStamp != BuildStamp))
+	{
+		return nullptr;
+	}
+
+	return *ListingSet;
+}
+
+void FEnhancedSpecDefinitionCache::Store(const FString&                 SuiteName,
+                                         const FString&                 BuildStamp,
+                                         TArray<FEnhancedSpecListing>&& Listings,
+                                         TArray<FString>&&              FixtureNames)
+{
+	const TSharedRef<FEnhancedSpecListingSet> ListingSet = MakeShared<FEnhancedSpecListingSet>();
+
+	if (!this->bIsEnabled || BuildStamp.IsEmpty())
+	{
+		return;
+	}
+
+	ListingSet->BuildStamp   = BuildStamp;
+	ListingSet->Listings     = MoveTemp(Listings);
+	ListingSet->FixtureNames = MoveTemp(FixtureNames);
+	ListingSet->BuildIndex();
+
+	{
+		FScopeLock ScopeLock(&this->Lock);
+
+		this->ListingSets.Add(SuiteName, ListingSet);
+		this->bIsDirty = true;
+	}
+}
+
+void FEnhancedSpecDefinitionCache::Save()
+{
+	FScopeLock    ScopeLock(&this->Lock);
+	TArray<uint8> Contents;
+	FMemoryWriter Writer(Contents);
+	uint32        Magic   = FileMagic;
+	int32         Version = FileVersion,
+	              NumSets = this->ListingSets.Num();
+
+	if (!this->bIsDirty)
+	{
+		return;
+	}
+
+	Writer << Magic;
+	Writer << Version;
+	Writer << NumSets;
+
+	for (const TPair<FString, TSharedRef<FEnhancedSpecListingSet>>& Entry : this->ListingSets)
+	{
+		FString                  SuiteName   = Entry.Key;
+		FEnhancedSpecListingSet& ListingSet  = Entry.Value.Get();
+		TArray<FString>          Filenames;
+		int32                    NumListings = ListingSet.Listings.Num();
+
+		// Nearly all test cases of a spec class share the same file, so each filename is only written once per class.
+		for (const FEnhancedSpecListing& Listing : ListingSet.Listings)
+		{
+			Filenames.AddUnique(Listing.Filename);
+		}
+
+		Writer << SuiteName;
+		Writer << ListingSet.BuildStamp;
+		Writer << ListingSet.FixtureNames;
+		Writer << Filenames;
+		Writer << NumListings;
+
+		for (FEnhancedSpecListing& Listing : ListingSet.Listings)
+		{
+			int32 FilenameIndex = Filenames.IndexOfByKey(Listing.Filename);
+
+			Writer << Listing.Id;
+			Writer << Listing.Description;
+			Writer << FilenameIndex;
+			Writer << Listing.LineNumber;
+		}
+	}
+
+	if (FFileHelper::SaveArrayToFile(Contents, *this->FilePath))
+	{
+		this->bIsDirty = false;
+	}
+	else
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Warning,
+			TEXT("Failed to save spec definition cache to '%s'."),
+			*this->FilePath
+		);
+	}
+}
+
+bool FEnhancedSpecDefinitionCache::ReadFile()
+{
+	TArray<uint8> Contents;
+	uint32        Magic   = 0;
+	int32         Version = 0,
+	              NumSets = 0;
+
+	if (!FFileHelper::LoadFileToArray(Contents, *this->FilePath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Contents);
+
+	Reader << Magic;
+	Reader << Version;
+	Reader << NumSets;
+
+	if (Reader.IsError() || (Magic != FileMagic) || (Version != FileVersion) || (NumSets < 0))
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Warning,
+			TEXT("Ignoring unreadable spec definition cache in '%s'."),
+			*this->FilePath
+		);
+
+		return false;
+	}
+
+	for (int32 SetIndex = 0; (SetIndex < NumSets) && !Reader.IsError(); ++SetIndex)
+	{
+		const TSharedRef<FEnhancedSpecListingSet> ListingSet = MakeShared<FEnhancedSpecListingSet>();
+		FString                                   SuiteName;
+		TArray<FString>                           Filenames;
+		int32                                     NumListings = 0;
+
+		Reader << SuiteName;
+		Reader << ListingSet->BuildStamp;
+		Reader << ListingSet->FixtureNames;
+		Reader << Filenames;
+		Reader << NumListings;
+
+		if (Reader.IsError() || (NumListings < 0) || (NumListings > (Reader.TotalSize() - Reader.Tell())))
+		{
+			Reader.SetError();
+			break;
+		}
+
+		ListingSet->Listings.SetNum(NumListings);
+
+		for (FEnhancedSpecListing& Listing : ListingSet->Listings)
+		{
+			int32 FilenameIndex = INDEX_NONE;
+
+			Reader << Listing.Id;
+			Reader << Listing.Description;
+			Reader << FilenameIndex;
+			Reader << Listing.LineNumber;
+
+			if (!Filenames.IsValidIndex(FilenameIndex))
+			{
+				Reader.SetError();
+				break;
+			}
+
+			Listing.Filename = Filenames[FilenameIndex];
+		}
+
+		ListingSet->BuildIndex();
+
+		this->ListingSets.Add(SuiteName, ListingSet);
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Warning,
+			TEXT("Ignoring truncated spec definition cache in '%s'."),
+			*this->FilePath
+		);
+
+		this->ListingSets.Empty();
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,287 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <HAL/CriticalSection.h>
+
+#include <Templates/SharedPointer.h>
+
+#include "EnhancedSpecIdHash.h"
+
+/**
+ * The information about a single test case that is needed to list it, without having to define its spec class.
+ */
+struct FEnhancedSpecListing final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * The unique identifier of the test case.
+	 */
+	FString Id;
+
+	/**
+	 * The human-readable description of the test case.
+	 */
+	FString Description;
+
+	/**
+	 * The filename of the specification in which the test case was defined.
+	 */
+	FString Filename;
+
+	/**
+	 * The line number where the test case was defined.
+	 */
+	int32 LineNumber = 0;
+};
+
+/**
+ * The listings of all test cases of a single spec class, as of a particular build of that class.
+ */
+struct FEnhancedSpecListingSet final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * The build stamp of the module binary of the spec class from which the listings were gathered.
+	 */
+	FString BuildStamp;
+
+	/**
+	 * The listing of each test case of the spec class.
+	 */
+	TArray<FEnhancedSpecListing> Listings;
+
+	/**
+	 * The names of the shared fixtures on which the spec class declared a dependency with UseFixture().
+	 */
+	TArray<FString> FixtureNames;
+
+	/**
+	 * The index of each listing, keyed by the hash of the ID of its test case.
+	 *
+	 * Different IDs can share the same hash, so each hash can map to more than one listing.
+	 */
+	TMultiMap<uint64, int32> IndicesByIdHash;
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Looks up the listing of a test case by its ID.
+	 *
+	 * @param Id
+	 *	The ID of the test case.
+	 *
+	 * @return
+	 *	The listing of the test case; or, a null pointer if the spec class has no test case with that ID.
+	 */
+	const FEnhancedSpecListing* Find(const FStringView Id) const
+	{
+		for (auto IndexIterator = this->IndicesByIdHash.CreateConstKeyIterator(FEnhancedSpecIdHash::Hash(Id));
+		     IndexIterator;
+		     ++IndexIterator)
+		{
+			const FEnhancedSpecListing& Listing = this->Listings[IndexIterator.Value()];
+
+			if (Id.Equals(Listing.Id, ESearchCase::IgnoreCase))
+			{
+				return &Listing;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Rebuilds the index of listings by ID after the listings have been populated.
+	 */
+	void BuildIndex()
+	{
+		this->IndicesByIdHash.Empty(this->Listings.Num());
+
+		for (int32 ListingIndex = 0; ListingIndex < this->Listings.Num(); ++ListingIndex)
+		{
+			this->IndicesByIdHash.Add(FEnhancedSpecIdHash::Hash(this->Listings[ListingIndex].Id), ListingIndex);
+		}
+	}
+};
+
+/**
+ * A persistent cache of the test cases of each enhanced automation spec class.
+ *
+ * Listing the test cases of a spec class normally requires running its entire Define() method, which adds up across
+ * all spec classes each time the editor or a commandlet starts. This cache allows test cases to be listed, and their
+ * source locations to be found, without defining the spec class at all, until one of its test cases actually runs.
+ *
+ * Listings are keyed by the name of each spec class, and are only used if the build stamp of the class (the size and
+ * modification time of the binary of the module that declares it) matches the stamp recorded with them. The cache is
+ * disabled unless "-EnhancedSpecDefinitionCache" is passed on the command line, and is always disabled while specs are
+ * being sharded. It is stored in a compact binary file that is located at
+ * "Saved/Automation/EnhancedSpecDefinitions.bin" by default, but a different path can be supplied with
+ * "-EnhancedSpecDefinitionCache=<Path>".
+ */
+class FEnhancedSpecDefinitionCache final
+{
+	// =================================================================================================================
+	// Private Constants
+	// =================================================================================================================
+	/**
+	 * A value at the start of the file that identifies it as a cache of spec definitions.
+	 */
+	static constexpr uint32 FileMagic = 0x43535345; // "ESSC"
+
+	/**
+	 * The version of the file format written by this cache.
+	 */
+	static constexpr int32 FileVersion = 2;
+
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The path to the file from which listings are loaded and to which they are saved.
+	 */
+	FString FilePath;
+
+	/**
+	 * Whether listings are being read from and written to the cache during this session.
+	 */
+	bool bIsEnabled;
+
+	/**
+	 * Whether any listings have been stored since the cache was last saved.
+	 */
+	bool bIsDirty;
+
+	/**
+	 * Guards access to the listings.
+	 */
+	mutable FCriticalSection Lock;
+
+	/**
+	 * The listings of each spec class, keyed by the name of the spec class.
+	 */
+	TMap<FString, TSharedRef<FEnhancedSpecListingSet>> ListingSets;
+
+	/**
+	 * The build stamp of each module binary that has been looked up so far, keyed by the name of the module.
+	 */
+	mutable TMap<FString, FString> BuildStampsByModuleName;
+
+public:
+	// =================================================================================================================
+	// Public Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new, enabled instance that loads listings from and saves them to a specific file.
+	 *
+	 * This is only meant for testing the cache itself. Spec classes use the cache of this process, from Get().
+	 *
+	 * @param FilePath
+	 *	The path to the file from which listings are loaded and to which they are saved.
+	 */
+	explicit FEnhancedSpecDefinitionCache(const FString& FilePath);
+
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the definition cache for this process, loading listings from disk the first time it is requested.
+	 *
+	 * @return
+	 *	The definition cache.
+	 */
+	static FEnhancedSpecDefinitionCache& Get();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether listings are being read from and written to the cache during this session.
+	 *
+	 * @return
+	 *	true if the cache is enabled; or, false otherwise.
+	 */
+	FORCEINLINE bool IsEnabled() const
+	{
+		return this->bIsEnabled;
+	}
+
+	/**
+	 * Gets the build stamp of the binary of a module, for comparison with the stamps recorded with listings.
+	 *
+	 * The stamp changes whenever the binary is rebuilt, regardless of which of its source files changed, and does not
+	 * depend on the time at which any source file was compiled, so builds remain deterministic. In monolithic builds,
+	 * all modules share the stamp of the executable.
+	 *
+	 * @param ModuleName
+	 *	The name of the module.
+	 *
+	 * @return
+	 *	The build stamp of the binary of the module; or, an empty string if the binary could not be found.
+	 */
+	FString GetBuildStamp(const FString& ModuleName) const;
+
+	/**
+	 * Looks up the listings of a spec class.
+	 *
+	 * @param SuiteName
+	 *	The name of the spec class.
+	 * @param BuildStamp
+	 *	The build stamp of the module binary of the spec class in this process.
+	 *
+	 * @return
+	 *	The listings of the spec class; or, a null pointer if the cache is disabled, or it has no listings for the
+	 *	spec class that were gathered from the same build.
+	 */
+	TSharedPtr<const FEnhancedSpecListingSet> Find(const FString& SuiteName, const FString& BuildStamp) const;
+
+	/**
+	 * Records the listings of a spec class, replacing any listings from prior builds of it.
+	 *
+	 * @param SuiteName
+	 *	The name of the spec class.
+	 * @param BuildStamp
+	 *	The build stamp of the module binary of the spec class in this process.
+	 * @param Listings
+	 *	The listing of each test case of the spec class.
+	 * @param FixtureNames
+	 *	The names of the shared fixtures on which the spec class depends.
+	 */
+	void Store(const FString&                 SuiteName,
+	           const FString&                 BuildStamp,
+	           TArray<FEnhancedSpecListing>&& Listings,
+	           TArray<FString>&&              FixtureNames);
+
+	/**
+	 * Saves the listings to disk, if any have been stored since they were last saved.
+	 */
+	void Save();
+
+private:
+	// =================================================================================================================
+	// Private Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new instance and loads listings from disk.
+	 */
+	explicit FEnhancedSpecDefinitionCache();
+
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Reads listings from the cache file.
+	 *
+	 * @return
+	 *	true if the file exists and could be parsed; or, false otherwise.
+	 */
+	bool ReadFile();
+};
@@ -0,0 +1,260 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecDurationBaseline.h"
+
+#include <Dom/JsonObject.h>
+
+#include <HAL/IConsoleManager.h>
+
+#include <Misc/CommandLine.h>
+#include <Misc/Parse.h>
+#include <Misc/Paths.h>
+#include <Misc/ScopeLock.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+
+static TAutoConsoleVariable<float> CVarEnhancedSpecRegressionThresholdDeviations(
+	TEXT("EnhancedSpecs.RegressionThresholdDeviations"),
+	3.0f,
+	TEXT("How many standard deviations slower than its baseline a test case or hook must be to be reported as a ")
+	TEXT("regression. Only used when \"-EnhancedSpecDurationBaseline\" is passed on the command line."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarEnhancedSpecRegressionMinMs(
+	TEXT("EnhancedSpecs.RegressionMinMs"),
+	5.0f,
+	TEXT("How much slower than its baseline, in milliseconds, a test case or hook must be, at least, to be reported ")
+	TEXT("as a regression."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarEnhancedSpecRegressionMinSamples(
+	TEXT("EnhancedSpecs.RegressionMinSamples"),
+	3,
+	TEXT("How many prior sessions must have recorded a test case or hook before it can be reported as a regression."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarEnhancedSpecSlowestReportCount(
+	TEXT("EnhancedSpecs.SlowestReportCount"),
+	10,
+	TEXT("How many of the slowest test cases, and of the slowest hooks, to list at the end of each test session. 0 ")
+	TEXT("disables the list."),
+	ECVF_Default
+);
+
+FEnhancedSpecDurationBaseline& FEnhancedSpecDurationBaseline::Get()
+{
+	static FEnhancedSpecDurationBaseline Instance;
+
+	return Instance;
+}
+
+FEnhancedSpecDurationBaseline::FEnhancedSpecDurationBaseline() :
+	Store(FileVersion, TEXT("Durations"), TEXT("spec duration baseline"))
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	if (FParse::Value(CommandLine, TEXT("EnhancedSpecDurationBaseline="), this->FilePath))
+	{
+		this->bIsEnabled = true;
+	}
+	else
+	{
+		this->FilePath =
+			FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("EnhancedSpecDurationBaseline.json"));
+		this->bIsEnabled = FParse::Param(CommandLine, TEXT("EnhancedSpecDurationBaseline"));
+	}
+
+	if (this->bIsEnabled)
+	{
+		TSharedPtr<FJsonObject> Entries;
+
+		if (this->Store.Read(this->FilePath, Entries))
+		{
+			this->ReadBaseline(*Entries);
+		}
+	}
+}
+
+void FEnhancedSpecDurationBaseline::RecordSpec(const FString& FullTestName,
+                                               const FString& Filename,
+                                               const int32    LineNumber,
+                                               const double   Seconds)
+{
+	if (!this->bIsEnabled)
+	{
+		return;
+	}
+
+	FScopeLock        ScopeLock(&this->Lock);
+	FSessionDuration& Duration = this->SpecDurations.FindOrAdd(FullTestName);
+
+	Duration.Filename      = Filename;
+	Duration.LineNumber    = LineNumber;
+	Duration.TotalSeconds += Seconds;
+	++Duration.NumRuns;
+}
+
+void FEnhancedSpecDurationBaseline::RecordHook(const FString& HookName, const double Seconds)
+{
+	if (!this->bIsEnabled)
+	{
+		return;
+	}
+
+	FScopeLock        ScopeLock(&this->Lock);
+	FSessionDuration& Duration = this->HookDurations.FindOrAdd(HookName);
+
+	Duration.TotalSeconds += Seconds;
+	++Duration.NumRuns;
+}
+
+void FEnhancedSpecDurationBaseline::EndSession()
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	if ((this->SpecDurations.Num() == 0) && (this->HookDurations.Num() == 0))
+	{
+		return;
+	}
+
+	this->Report(TEXT("test case"), this->SpecDurations);
+	this->Report(TEXT("hook"), this->HookDurations);
+
+	this->Store.Update(this->FilePath, [this](FJsonObject& Entries)
+	{
+		this->ReadBaseline(Entries);
+
+		this->AddToBaseline(this->SpecDurations);
+		this->AddToBaseline(this->HookDurations);
+
+		this->WriteBaseline(Entries);
+	});
+
+	this->SpecDurations.Empty();
+	this->HookDurations.Empty();
+}
+
+void FEnhancedSpecDurationBaseline::Report(const TCHAR*                           Kind,
+                                           const TMap<FString, FSessionDuration>& SessionDurations) const
+{
+	const int64                           MinSamples = CVarEnhancedSpecRegressionMinSamples.GetValueOnAnyThread();
+	const double                          ThresholdDeviations =
+		CVarEnhancedSpecRegressionThresholdDeviations.GetValueOnAnyThread();
+	const double                          MinSeconds = CVarEnhancedSpecRegressionMinMs.GetValueOnAnyThread() / 1000.0;
+	const int32                           NumSlowest = CVarEnhancedSpecSlowestReportCount.GetValueOnAnyThread();
+	TArray<TPair<double, const FString*>> Slowest;
+
+	Slowest.Reserve(SessionDurations.Num());
+
+	for (const TPair<FString, FSessionDuration>& Entry : SessionDurations)
+	{
+		const FSessionDuration&           Duration      = Entry.Value;
+		const double                      Seconds       = Duration.TotalSeconds / Duration.NumRuns;
+		const FEnhancedSpecDurationStats* BaselineStats = this->Baseline.Find(Entry.Key);
+
+		if ((BaselineStats != nullptr) &&
+		    BaselineStats->IsRegression(Seconds, MinSamples, ThresholdDeviations, MinSeconds))
+		{
+			// Prefixing the location in the same way as compiler diagnostics lets IDEs link straight to the test case.
+			UE_LOG(
+				LogEnhancedAutomationSpecs,
+				Warning,
+				TEXT("%sDuration of %s '%s' regressed: %.3f s, compared to a baseline of %.3f s (+/- %.3f s) over ")
+				TEXT("%lld session(s)."),
+				Duration.Filename.IsEmpty()
+					? TEXT("")
+					: *FString::Printf(TEXT("%s(%d): "), *Duration.Filename, Duration.LineNumber),
+				Kind,
+				*Entry.Key,
+				Seconds,
+				BaselineStats->MeanSeconds,
+				BaselineStats->GetStandardDeviation(),
+				BaselineStats->NumSamples
+			);
+		}
+
+		Slowest.Emplace(Seconds, &Entry.Key);
+	}
+
+	if ((NumSlowest <= 0) || (Slowest.Num() == 0))
+	{
+		return;
+	}
+
+	Slowest.Sort([](const TPair<double, const FString*>& A, const TPair<double, const FString*>& B)
+	{
+		return A.Key > B.Key;
+	});
+
+	UE_LOG(LogEnhancedAutomationSpecs, Display, TEXT("Slowest %s(s) of this session:"), Kind);
+
+	for (int32 RankIndex = 0; RankIndex < FMath::Min(NumSlowest, Slowest.Num()); ++RankIndex)
+	{
+		const FSessionDuration& Duration = SessionDurations.FindChecked(*Slowest[RankIndex].Value);
+
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Display,
+			TEXT("  %2d. %8.3f s  %s%s"),
+			RankIndex + 1,
+			Slowest[RankIndex].Key,
+			**Slowest[RankIndex].Value,
+			Duration.Filename.IsEmpty()
+				? TEXT("")
+				: *FString::Printf(TEXT(" (%s(%d))"), *Duration.Filename, Duration.LineNumber)
+		);
+	}
+}
+
+void FEnhancedSpecDurationBaseline::AddToBaseline(const TMap<FString, FSessionDuration>& SessionDurations)
+{
+	for (const TPair<FString, FSessionDuration>& Entry : SessionDurations)
+	{
+		// Each session contributes a single duration, so hooks that run many times do not crowd out prior sessions.
+		this->Baseline.FindOrAdd(Entry.Key).AddSample(Entry.Value.TotalSeconds / Entry.Value.NumRuns);
+	}
+}
+
+void FEnhancedSpecDurationBaseline::ReadBaseline(const FJsonObject& Entries)
+{
+	this->Baseline.Empty(Entries.Values.Num());
+
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Entry : Entries.Values)
+	{
+		const TSharedPtr<FJsonObject>* StatsObject;
+		FEnhancedSpecDurationStats     Stats;
+
+		if (Entry.Value.IsValid() &&
+		    Entry.Value->TryGetObject(StatsObject) &&
+		    (*StatsObject)->TryGetNumberField(TEXT("Samples"), Stats.NumSamples) &&
+		    (*StatsObject)->TryGetNumberField(TEXT("Mean"), Stats.MeanSeconds) &&
+		    (*StatsObject)->TryGetNumberField(TEXT("SumSquaredDeviations"), Stats.SumSquaredDeviations) &&
+		    (Stats.NumSamples > 0))
+		{
+			this->Baseline.Add(Entry.Key, Stats);
+		}
+	}
+}
+
+void FEnhancedSpecDurationBaseline::WriteBaseline(FJsonObject& Entries) const
+{
+	Entries.Values.Empty(this->Baseline.Num());
+
+	for (const TPair<FString, FEnhancedSpecDurationStats>& Entry : this->Baseline)
+	{
+		const FEnhancedSpecDurationStats& Stats       = Entry.Value;
+		const TSharedRef<FJsonObject>     StatsObject = MakeShared<FJsonObject>();
+
+		StatsObject->SetNumberField(TEXT("Samples"), Stats.NumSamples);
+		StatsObject->SetNumberField(TEXT("Mean"), Stats.MeanSeconds);
+		StatsObject->SetNumberField(TEXT("SumSquaredDeviations"), Stats.SumSquaredDeviations);
+
+		Entries.SetObjectField(Entry.Key, StatsObject);
+	}
+}
@@ -0,0 +1,306 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <HAL/CriticalSection.h>
+
+#include "EnhancedSpecJsonStore.h"
+
+class FJsonObject;
+
+/**
+ * The running mean and variance of how long a test case or hook took to run, across prior test sessions.
+ */
+struct FEnhancedSpecDurationStats final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * The number of sessions that have contributed a duration.
+	 */
+	int64 NumSamples = 0;
+
+	/**
+	 * The mean duration, in seconds.
+	 */
+	double MeanSeconds = 0.0;
+
+	/**
+	 * The sum of the squared differences between each duration and the mean, in seconds squared.
+	 */
+	double SumSquaredDeviations = 0.0;
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Adds a duration to the statistics.
+	 *
+	 * This uses Welford's algorithm, so that the variance stays accurate no matter how many durations are added.
+	 *
+	 * @param Seconds
+	 *	The duration to add, in seconds.
+	 */
+	void AddSample(const double Seconds)
+	{
+		const double Delta = Seconds - this->MeanSeconds;
+
+		++this->NumSamples;
+
+		this->MeanSeconds          += Delta / this->NumSamples;
+		this->SumSquaredDeviations += Delta * (Seconds - this->MeanSeconds);
+	}
+
+	/**
+	 * Gets the sample standard deviation of the durations.
+	 *
+	 * @return
+	 *	The standard deviation, in seconds; or, 0 if fewer than two durations have been added.
+	 */
+	double GetStandardDeviation() const
+	{
+		if (this->NumSamples < 2)
+		{
+			return 0.0;
+		}
+
+		return FMath::Sqrt(this->SumSquaredDeviations / (this->NumSamples - 1));
+	}
+
+	/**
+	 * Checks whether a duration is slower than the durations added so far by more than can be explained by noise.
+	 *
+	 * @param Seconds
+	 *	The duration to check, in seconds.
+	 * @param MinSamples
+	 *	The fewest durations that must have been added before any duration is considered a regression.
+	 * @param ThresholdDeviations
+	 *	How many standard deviations above the mean the duration must be to be considered a regression.
+	 * @param MinSeconds
+	 *	How much slower than the mean the duration must be, at least, to be considered a regression. This keeps
+	 *	durations with almost no variance from being flagged for tiny changes.
+	 *
+	 * @return
+	 *	true if the duration is a regression; or, false otherwise.
+	 */
+	bool IsRegression(const double Seconds,
+	                  const int64  MinSamples,
+	                  const double ThresholdDeviations,
+	                  const double MinSeconds) const
+	{
+		const double Tolerance = FMath::Max(ThresholdDeviations * this->GetStandardDeviation(), MinSeconds);
+
+		if (this->NumSamples < FMath::Max<int64>(MinSamples, 1))
+		{
+			return false;
+		}
+
+		return (Seconds - this->MeanSeconds) > Tolerance;
+	}
+};
+
+/**
+ * Reports slow and regressed test cases and hooks at the end of each test session, compared to a baseline of how long
+ * they took in prior sessions.
+ *
+ * The duration of each test case is keyed by its full name (the name of the spec class followed by the ID of the test
+ * case). The duration of each hook (e.g., a BeforeEach() block) is keyed by the name of the spec class, the kind of
+ * hook, and the descriptions of the scopes that enclose it. Hooks that run more than once per session contribute the
+ * average of their runs.
+ *
+ * At the end of each session, the test cases and hooks that took longer than their baseline by more than the
+ * "EnhancedSpecs.RegressionThresholdDeviations" standard deviations are logged as warnings, along with the location of
+ * each test case in its source file. The slowest test cases and hooks of the session are then listed, and their
+ * durations are added to the baseline.
+ *
+ * Reporting is enabled by passing "-EnhancedSpecDurationBaseline" on the command line. The baseline is stored in a
+ * JSON file that is located at "Saved/Automation/EnhancedSpecDurationBaseline.json" by default, but a different path
+ * can be supplied on the command line with "-EnhancedSpecDurationBaseline=<Path>".
+ */
+class FEnhancedSpecDurationBaseline final
+{
+	// =================================================================================================================
+	// Private Types
+	// =================================================================================================================
+	/**
+	 * How long a test case or hook took to run during the current session.
+	 */
+	struct FSessionDuration final
+	{
+		/**
+		 * The filename of the specification in which the test case was defined, or an empty string for a hook.
+		 */
+		FString Filename;
+
+		/**
+		 * The line number where the test case was defined, or 0 for a hook.
+		 */
+		int32 LineNumber = 0;
+
+		/**
+		 * The total time that all runs took, in seconds.
+		 */
+		double TotalSeconds = 0.0;
+
+		/**
+		 * The number of runs.
+		 */
+		int32 NumRuns = 0;
+	};
+
+	// =================================================================================================================
+	// Private Constants
+	// =================================================================================================================
+	/**
+	 * The version of the file format written by this baseline.
+	 */
+	static constexpr int32 FileVersion = 1;
+
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The path to the file from which the baseline is loaded and to which it is saved.
+	 */
+	FString FilePath;
+
+	/**
+	 * Reads and updates the baseline file.
+	 */
+	FEnhancedSpecJsonStore Store;
+
+	/**
+	 * Whether durations are being recorded and reported during this session.
+	 */
+	bool bIsEnabled;
+
+	/**
+	 * Guards access to the durations, since they can be recorded from worker threads.
+	 */
+	FCriticalSection Lock;
+
+	/**
+	 * The statistics of each test case and hook from prior sessions, keyed by the name of the test case or hook.
+	 */
+	TMap<FString, FEnhancedSpecDurationStats> Baseline;
+
+	/**
+	 * The durations of the test cases that ran during the current session, keyed by the full name of each test case.
+	 */
+	TMap<FString, FSessionDuration> SpecDurations;
+
+	/**
+	 * The durations of the hooks that ran during the current session, keyed by the name of each hook.
+	 */
+	TMap<FString, FSessionDuration> HookDurations;
+
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the duration baseline for this process, loading it from disk the first time it is requested.
+	 *
+	 * @return
+	 *	The duration baseline.
+	 */
+	static FEnhancedSpecDurationBaseline& Get();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether durations are being recorded and reported during this session.
+	 *
+	 * @return
+	 *	true if durations are being recorded; or, false otherwise.
+	 */
+	FORCEINLINE bool IsEnabled() const
+	{
+		return this->bIsEnabled;
+	}
+
+	/**
+	 * Records how long a test case took to run, if recording is enabled.
+	 *
+	 * @param FullTestName
+	 *	The name of the spec class followed by a space and the ID of the test case.
+	 * @param Filename
+	 *	The filename of the specification in which the test case was defined.
+	 * @param LineNumber
+	 *	The line number where the test case was defined.
+	 * @param Seconds
+	 *	How long the test case took to run, in seconds.
+	 */
+	void RecordSpec(const FString& FullTestName, const FString& Filename, const int32 LineNumber, const double Seconds);
+
+	/**
+	 * Records how long a run of a hook took, if recording is enabled.
+	 *
+	 * @param HookName
+	 *	The name of the spec class, followed by the kind of hook and the descriptions of the scopes enclosing it.
+	 * @param Seconds
+	 *	How long the hook took to run, in seconds.
+	 */
+	void RecordHook(const FString& HookName, const double Seconds);
+
+	/**
+	 * Reports the regressed and slowest test cases and hooks of the current session, then adds their durations to the
+	 * baseline and saves it.
+	 *
+	 * Regressions are reported against the baseline that was loaded when this session started. The durations are then
+	 * added to the baseline as it is on disk at the end of the session, so that the durations other runners have saved
+	 * to the same file in the meantime are kept.
+	 */
+	void EndSession();
+
+private:
+	// =================================================================================================================
+	// Private Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new instance and loads the baseline from disk.
+	 */
+	explicit FEnhancedSpecDurationBaseline();
+
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Logs the durations of the current session that regressed, then lists the slowest of them.
+	 *
+	 * @param Kind
+	 *	What the durations are of (e.g., "test case" or "hook"), for the log.
+	 * @param SessionDurations
+	 *	The durations of the current session.
+	 */
+	void Report(const TCHAR* Kind, const TMap<FString, FSessionDuration>& SessionDurations) const;
+
+	/**
+	 * Adds the durations of the current session to the baseline.
+	 *
+	 * @param SessionDurations
+	 *	The durations of the current session.
+	 */
+	void AddToBaseline(const TMap<FString, FSessionDuration>& SessionDurations);
+
+	/**
+	 * Replaces the baseline with the statistics read from the entries of the baseline file.
+	 *
+	 * @param Entries
+	 *	The entries of the baseline file.
+	 */
+	void ReadBaseline(const FJsonObject& Entries);
+
+	/**
+	 * Replaces the entries of the baseline file with the statistics of the baseline.
+	 *
+	 * @param Entries
+	 *	The entries of the baseline file.
+	 */
+	void WriteBaseline(FJsonObject& Entries) const;
+};
@@ -0,0 +1,119 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecFixture.h"
+
+#include "EnhancedAutomationSpecFramework.h"
+
+// =====================================================================================================================
+// FEnhancedSpecFixtureBase
+// =====================================================================================================================
+FEnhancedSpecFixtureBase::FEnhancedSpecFixtureBase(const FName Name) :
+	Name(Name),
+	NumDependents(0),
+	NumRemainingDependents(0)
+{
+	FEnhancedSpecFixtureRegistry::Get().Register(*this);
+}
+
+FEnhancedSpecFixtureBase::~FEnhancedSpecFixtureBase()
+{
+	FEnhancedSpecFixtureRegistry::Get().Unregister(*this);
+}
+
+// =====================================================================================================================
+// FEnhancedSpecFixtureRegistry
+// =====================================================================================================================
+FEnhancedSpecFixtureRegistry& FEnhancedSpecFixtureRegistry::Get()
+{
+	static FEnhancedSpecFixtureRegistry Instance;
+
+	return Instance;
+}
+
+void FEnhancedSpecFixtureRegistry::Register(FEnhancedSpecFixtureBase& Fixture)
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	checkf(
+		!this->Fixtures.Contains(Fixture.GetName()),
+		TEXT("A spec fixture named '%s' has already been registered."),
+		*Fixture.GetName().ToString()
+	);
+
+	this->Fixtures.Add(Fixture.GetName(), &Fixture);
+}
+
+void FEnhancedSpecFixtureRegistry::Unregister(FEnhancedSpecFixtureBase& Fixture)
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	this->Fixtures.Remove(Fixture.GetName());
+}
+
+FEnhancedSpecFixtureBase* FEnhancedSpecFixtureRegistry::Find(const FName Name)
+{
+	FScopeLock                 ScopeLock(&this->Lock);
+	FEnhancedSpecFixtureBase** Fixture = this->Fixtures.Find(Name);
+
+	return (Fixture != nullptr) ? *Fixture : nullptr;
+}
+
+void FEnhancedSpecFixtureRegistry::AddDependent(FEnhancedSpecFixtureBase& Fixture)
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	++Fixture.NumDependents;
+	++Fixture.NumRemainingDependents;
+}
+
+void FEnhancedSpecFixtureRegistry::RemoveDependent(FEnhancedSpecFixtureBase& Fixture)
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	Fixture.NumDependents          = FMath::Max(0, Fixture.NumDependents - 1);
+	Fixture.NumRemainingDependents = FMath::Min(Fixture.NumRemainingDependents, Fixture.NumDependents);
+}
+
+void FEnhancedSpecFixtureRegistry::MarkDependentAsFinished(FEnhancedSpecFixtureBase& Fixture)
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	if (Fixture.NumRemainingDependents == 0)
+	{
+		return;
+	}
+
+	--Fixture.NumRemainingDependents;
+
+	if (Fixture.NumRemainingDependents == 0)
+	{
+		ReleaseFixture(Fixture);
+	}
+}
+
+void FEnhancedSpecFixtureRegistry::EndSession()
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	for (const TPair<FName, FEnhancedSpecFixtureBase*>& Entry : this->Fixtures)
+	{
+		FEnhancedSpecFixtureBase& Fixture = *Entry.Value;
+
+		ReleaseFixture(Fixture);
+
+		Fixture.NumRemainingDependents = Fixture.NumDependents;
+	}
+}
+
+void FEnhancedSpecFixtureRegistry::ReleaseFixture(FEnhancedSpecFixtureBase& Fixture)
+{
+	if (Fixture.IsBuilt())
+	{
+		Fixture.Release();
+
+		UE_LOG(LogEnhancedAutomationSpecs, Verbose, TEXT("Released spec fixture '%s'."), *Fixture.GetName().ToString());
+	}
+}
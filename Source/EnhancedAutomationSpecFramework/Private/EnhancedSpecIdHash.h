@@ -0,0 +1,45 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <Containers/StringView.h>
+
+#include <Misc/Char.h>
+
+/**
+ * Hashes the IDs of test cases, so that test cases can be looked up by ID without having to allocate a string.
+ *
+ * The automation framework does not distinguish test names that differ only by case, so neither does the hash.
+ */
+class FEnhancedSpecIdHash final
+{
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Computes the 64-bit hash of the ID of a test case.
+	 *
+	 * @param Id
+	 *	The ID of the test case.
+	 *
+	 * @return
+	 *	The hash of the ID, ignoring case.
+	 */
+	FORCEINLINE static uint64 Hash(const FStringView Id)
+	{
+		// 64-bit FNV-1a, which is cheap for the short strings that IDs typically are.
+		uint64 Result = 0xcbf29ce484222325ULL;
+
+		for (const TCHAR Character : Id)
+		{
+			Result ^= static_cast<uint64>(FChar::ToLower(Character));
+			Result *= 0x100000001b3ULL;
+		}
+
+		return Result;
+	}
+};
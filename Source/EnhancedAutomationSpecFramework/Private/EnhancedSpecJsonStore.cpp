@@ -0,0 +1,124 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecJsonStore.h"
+
+#include <Dom/JsonObject.h>
+
+#include <HAL/FileManager.h>
+#include <HAL/PlatformProcess.h>
+
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+#include <Misc/Timespan.h>
+
+#include <Serialization/JsonReader.h>
+#include <Serialization/JsonSerializer.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+
+FEnhancedSpecJsonStore::FEnhancedSpecJsonStore(const int32    FileVersion,
+                                               const FString& EntriesFieldName,
+                                               const FString& Description) :
+	FileVersion(FileVersion),
+	EntriesFieldName(EntriesFieldName),
+	Description(Description)
+{
+}
+
+bool FEnhancedSpecJsonStore::Read(const FString& FilePath, TSharedPtr<FJsonObject>& OutEntries) const
+{
+	FString                        Contents;
+	TSharedPtr<FJsonObject>        RootObject;
+	const TSharedPtr<FJsonObject>* EntriesObject;
+
+	if (!FFileHelper::LoadFileToString(Contents, *FilePath))
+	{
+		return false;
+	}
+
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Contents), RootObject) ||
+	    !RootObject.IsValid() ||
+	    (RootObject->GetIntegerField(TEXT("Version")) != this->FileVersion) ||
+	    !RootObject->TryGetObjectField(this->EntriesFieldName, EntriesObject) ||
+	    !(*EntriesObject).IsValid())
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Warning,
+			TEXT("Ignoring unreadable %s in '%s'."),
+			*this->Description,
+			*FilePath
+		);
+
+		return false;
+	}
+
+	OutEntries = *EntriesObject;
+
+	return true;
+}
+
+bool FEnhancedSpecJsonStore::Update(const FString&                                   FilePath,
+                                    const TFunctionRef<void (FJsonObject& Entries)> UpdateEntries) const
+{
+	const FString           LockFilePath = FPaths::ConvertRelativePathToFull(FilePath + TEXT(".lock"));
+	TSharedPtr<FJsonObject> Entries;
+
+	// The lock is a file next to the one being updated on some platforms, so its folder has to exist first.
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(LockFilePath), true);
+
+	FSystemWideCriticalSection FileLock(LockFilePath, FTimespan::FromSeconds(LockTimeoutSeconds));
+
+	if (!FileLock.IsValid())
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Warning,
+			TEXT("Timed out waiting for another runner to finish saving the %s in '%s'. The results of this session ")
+			TEXT("were not saved."),
+			*this->Description,
+			*FilePath
+		);
+
+		return false;
+	}
+
+	if (!this->Read(FilePath, Entries))
+	{
+		Entries = MakeShared<FJsonObject>();
+	}
+
+	UpdateEntries(*Entries);
+
+	if (!this->Write(FilePath, Entries.ToSharedRef()))
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Warning,
+			TEXT("Failed to save %s to '%s'."),
+			*this->Description,
+			*FilePath
+		);
+
+		return false;
+	}
+
+	return true;
+}
+
+bool FEnhancedSpecJsonStore::Write(const FString& FilePath, const TSharedRef<FJsonObject>& Entries) const
+{
+	const TSharedRef<FJsonObject> RootObject = MakeShared<FJsonObject>();
+	FString                       Contents;
+
+	Entries->Values.KeySort(TLess<FString>());
+
+	RootObject->SetNumberField(TEXT("Version"), this->FileVersion);
+	RootObject->SetObjectField(this->EntriesFieldName, Entries);
+
+	return FJsonSerializer::Serialize(RootObject, TJsonWriterFactory<>::Create(&Contents)) &&
+	       FFileHelper::SaveStringToFile(Contents, *FilePath);
+}
@@ -0,0 +1,125 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <Templates/Function.h>
+#include <Templates/SharedPointer.h>
+
+class FJsonObject;
+
+/**
+ * Reads and updates JSON files that hold named entries (e.g., a duration per test case) across test sessions.
+ *
+ * Each file holds the version of its format and a single object of entries, keyed by name:
+ *
+ * { "Version": 1, "<EntriesFieldName>": { "<Name>": <Entry>, ... } }
+ *
+ * Several runners can share the same file (e.g., the shards of a sharded session on one machine), so each update holds
+ * a system-wide lock on the file while it re-reads the file, merges into its entries, and writes it back. That way, the
+ * entries that other runners saved since the file was first read are kept rather than overwritten.
+ */
+class FEnhancedSpecJsonStore final
+{
+	// =================================================================================================================
+	// Private Constants
+	// =================================================================================================================
+	/**
+	 * How long to wait for another runner to finish updating a file before giving up, in seconds.
+	 */
+	static constexpr double LockTimeoutSeconds = 30.0;
+
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The version of the file format; files with any other version are ignored.
+	 */
+	const int32 FileVersion;
+
+	/**
+	 * The name of the field of the root object that holds the entries.
+	 */
+	const FString EntriesFieldName;
+
+	/**
+	 * What the file holds (e.g., "spec timings"), for the log.
+	 */
+	const FString Description;
+
+public:
+	// =================================================================================================================
+	// Public Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new instance.
+	 *
+	 * @param FileVersion
+	 *	The version of the file format; files with any other version are ignored.
+	 * @param EntriesFieldName
+	 *	The name of the field of the root object that holds the entries.
+	 * @param Description
+	 *	What the file holds (e.g., "spec timings"), for the log.
+	 */
+	explicit FEnhancedSpecJsonStore(const int32    FileVersion,
+	                                const FString& EntriesFieldName,
+	                                const FString& Description);
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Reads the entries of a file.
+	 *
+	 * A warning is logged if the file exists but cannot be parsed, or was written with a different version of the
+	 * format.
+	 *
+	 * @param FilePath
+	 *	The path to the file to read.
+	 * @param OutEntries
+	 *	Set to the object that holds the entries of the file, if it could be read.
+	 *
+	 * @return
+	 *	true if the file exists and could be parsed; or, false otherwise.
+	 */
+	bool Read(const FString& FilePath, TSharedPtr<FJsonObject>& OutEntries) const;
+
+	/**
+	 * Updates the entries of a file, while holding a system-wide lock on it.
+	 *
+	 * The entries are re-read from the file under the lock, so that the entries other runners have saved to it are
+	 * passed to the callback. If the file does not exist or cannot be read, the callback receives no entries. Entries
+	 * are written sorted by name, so that the file stays stable across sessions and changes to it are easy to review.
+	 *
+	 * If the lock cannot be acquired in time, or the file cannot be written, a warning is logged and the file is left
+	 * as it was.
+	 *
+	 * @param FilePath
+	 *	The path to the file to update.
+	 * @param UpdateEntries
+	 *	A callback that merges into the entries read from the file. The entries it leaves behind are written back.
+	 *
+	 * @return
+	 *	true if the file was written; or, false otherwise.
+	 */
+	bool Update(const FString& FilePath, const TFunctionRef<void (FJsonObject& Entries)> UpdateEntries) const;
+
+private:
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Writes entries to a file.
+	 *
+	 * @param FilePath
+	 *	The path to the file to write.
+	 * @param Entries
+	 *	The object that holds the entries to write.
+	 *
+	 * @return
+	 *	true if the file was written; or, false otherwise.
+	 */
+	bool Write(const FString& FilePath, const TSharedRef<FJsonObject>& Entries) const;
+};
@@ -0,0 +1,332 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecPerfCounters.h"
+
+#include <HAL/ThreadSafeBool.h>
+
+#include <Misc/CommandLine.h>
+#include <Misc/Parse.h>
+
+#if PLATFORM_LINUX
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "EnhancedAutomationSpecFramework.h"
+
+namespace EnhancedSpecPerfCounters
+{
+#if PLATFORM_LINUX
+	/**
+	 * The type and config of each counter, in the same order as the counters.
+	 */
+	static const TPair<uint32, uint64> CounterEvents[FEnhancedSpecPerfCounters::NumCounters] =
+	{
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{
+			PERF_TYPE_HW_CACHE,
+			PERF_COUNT_HW_CACHE_L1D |
+			(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			(PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+		},
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+	};
+
+	/**
+	 * Opens a counter of the calling thread.
+	 *
+	 * @param Type
+	 *	The type of the event to count.
+	 * @param Config
+	 *	The event to count, within its type.
+	 * @param GroupFd
+	 *	The file descriptor of the counter that leads the group the new counter should join; or, -1 to start a new
+	 *	group.
+	 *
+	 * @return
+	 *	The file descriptor of the new counter; or, -1 if it could not be opened.
+	 */
+	static int32 OpenCounter(const uint32 Type, const uint64 Config, const int32 GroupFd)
+	{
+		perf_event_attr Attributes;
+
+		FMemory::Memzero(Attributes);
+
+		Attributes.size           = sizeof(Attributes);
+		Attributes.type           = Type;
+		Attributes.config         = Config;
+		Attributes.exclude_kernel = 1;
+		Attributes.exclude_hv     = 1;
+		Attributes.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		// There is no wrapper for this system call in glibc. Counting the calling thread (pid 0) on any CPU (-1) keeps
+		// the counters with the thread as it moves between cores.
+		return static_cast<int32>(syscall(SYS_perf_event_open, &Attributes, 0, -1, GroupFd, PERF_FLAG_FD_CLOEXEC));
+	}
+#endif
+
+	/**
+	 * Appends a count to a summary, if it is available.
+	 *
+	 * @param Summary
+	 *	The summary to append to.
+	 * @param Name
+	 *	The name of the count.
+	 * @param Value
+	 *	The count; or, a negative value if it is not available.
+	 */
+	static void AppendCount(FString& Summary, const TCHAR* Name, const double Value)
+	{
+		if (Value < 0.0)
+		{
+			return;
+		}
+
+		if (!Summary.IsEmpty())
+		{
+			Summary += TEXT(", ");
+		}
+
+		Summary += FString::Printf(TEXT("%s %.0f"), Name, Value);
+	}
+}
+
+// =====================================================================================================================
+// FEnhancedSpecPerfCounterValues
+// =====================================================================================================================
+void FEnhancedSpecPerfCounterValues::ForEachCount(const TFunctionRef<void(const TCHAR* Name, double& Value)> Visitor)
+{
+	Visitor(TEXT("Instructions"), this->Instructions);
+	Visitor(TEXT("Cycles"), this->Cycles);
+	Visitor(TEXT("L1DataCacheMisses"), this->L1DataCacheMisses);
+	Visitor(TEXT("LastLevelCacheMisses"), this->LastLevelCacheMisses);
+	Visitor(TEXT("BranchMisses"), this->BranchMisses);
+}
+
+void FEnhancedSpecPerfCounterValues::ForEachCount(
+	const TFunctionRef<void(const TCHAR* Name, double Value)> Visitor) const
+{
+	Visitor(TEXT("Instructions"), this->Instructions);
+	Visitor(TEXT("Cycles"), this->Cycles);
+	Visitor(TEXT("L1DataCacheMisses"), this->L1DataCacheMisses);
+	Visitor(TEXT("LastLevelCacheMisses"), this->LastLevelCacheMisses);
+	Visitor(TEXT("BranchMisses"), this->BranchMisses);
+}
+
+FEnhancedSpecPerfCounterValues FEnhancedSpecPerfCounterValues::DividedBy(const double Divisor) const
+{
+	FEnhancedSpecPerfCounterValues Result = *this;
+
+	Result.ForEachCount([Divisor](const TCHAR*, double& Value)
+	{
+		if (Value >= 0.0)
+		{
+			Value /= Divisor;
+		}
+	});
+
+	return Result;
+}
+
+FString FEnhancedSpecPerfCounterValues::ToString() const
+{
+	FString Summary;
+
+	EnhancedSpecPerfCounters::AppendCount(Summary, TEXT("instructions"), this->Instructions);
+	EnhancedSpecPerfCounters::AppendCount(Summary, TEXT("cycles"), this->Cycles);
+
+	if ((this->Instructions >= 0.0) && (this->Cycles > 0.0))
+	{
+		Summary += FString::Printf(TEXT(" (%.2f IPC)"), this->Instructions / this->Cycles);
+	}
+
+	EnhancedSpecPerfCounters::AppendCount(Summary, TEXT("L1d misses"), this->L1DataCacheMisses);
+	EnhancedSpecPerfCounters::AppendCount(Summary, TEXT("LLC misses"), this->LastLevelCacheMisses);
+	EnhancedSpecPerfCounters::AppendCount(Summary, TEXT("branch misses"), this->BranchMisses);
+
+	return Summary;
+}
+
+// =====================================================================================================================
+// FEnhancedSpecPerfCounters
+// =====================================================================================================================
+bool FEnhancedSpecPerfCounters::IsEnabled()
+{
+#if PLATFORM_LINUX
+	static const bool bIsEnabled = FParse::Param(FCommandLine::Get(), TEXT("EnhancedSpecPerfCounters"));
+
+	return bIsEnabled;
+#else
+	return false;
+#endif
+}
+
+FEnhancedSpecPerfCounters* FEnhancedSpecPerfCounters::GetForThread()
+{
+	if (!IsEnabled())
+	{
+		return nullptr;
+	}
+
+	// Counters only count the thread that opened them, so each thread needs its own.
+	static thread_local FEnhancedSpecPerfCounters Counters;
+
+	return Counters.IsOpen() ? &Counters : nullptr;
+}
+
+FEnhancedSpecPerfCounters::FEnhancedSpecPerfCounters() : GroupFd(-1), NumOpenCounters(0)
+{
+	for (int32 CounterIndex = 0; CounterIndex < NumCounters; ++CounterIndex)
+	{
+		this->CounterFds[CounterIndex] = -1;
+		this->ReadOrder[CounterIndex]  = -1;
+	}
+
+#if PLATFORM_LINUX
+	static FThreadSafeBool bHasWarned;
+
+	for (int32 CounterIndex = 0; CounterIndex < NumCounters; ++CounterIndex)
+	{
+		const TPair<uint32, uint64>& Event = EnhancedSpecPerfCounters::CounterEvents[CounterIndex];
+		const int32                  Fd    =
+			EnhancedSpecPerfCounters::OpenCounter(Event.Key, Event.Value, this->GroupFd);
+
+		// Counters that this machine does not have are left out, rather than giving up on all of them.
+		if (Fd < 0)
+		{
+			continue;
+		}
+
+		if (this->GroupFd < 0)
+		{
+			this->GroupFd = Fd;
+		}
+
+		this->CounterFds[CounterIndex]           = Fd;
+		this->ReadOrder[this->NumOpenCounters++] = CounterIndex;
+	}
+
+	if (!this->IsOpen() && !bHasWarned.AtomicSet(true))
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Warning,
+			TEXT("Hardware performance counters could not be opened (errno %d), so they will not be read. Check that ")
+			TEXT("\"kernel.perf_event_paranoid\" is 2 or less, and that this machine exposes its counters."),
+			errno
+		);
+	}
+#endif
+}
+
+FEnhancedSpecPerfCounters::~FEnhancedSpecPerfCounters()
+{
+#if PLATFORM_LINUX
+	for (const int32 Fd : this->CounterFds)
+	{
+		if (Fd >= 0)
+		{
+			close(Fd);
+		}
+	}
+#endif
+}
+
+bool FEnhancedSpecPerfCounters::TakeSnapshot(FSnapshot& OutSnapshot) const
+{
+#if PLATFORM_LINUX
+	// The layout of a group read: the number of values, the time enabled, the time running, then each value.
+	uint64        Buffer[3 + NumCounters];
+	const ssize_t ExpectedSize = sizeof(uint64) * (3 + this->NumOpenCounters);
+
+	if (!this->IsOpen() || (read(this->GroupFd, Buffer, sizeof(Buffer)) != ExpectedSize))
+	{
+		return false;
+	}
+
+	OutSnapshot.TimeEnabled = Buffer[1];
+	OutSnapshot.TimeRunning = Buffer[2];
+
+	for (int32 ReadIndex = 0; ReadIndex < this->NumOpenCounters; ++ReadIndex)
+	{
+		OutSnapshot.Values[this->ReadOrder[ReadIndex]] = Buffer[3 + ReadIndex];
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+FEnhancedSpecPerfCounterValues FEnhancedSpecPerfCounters::GetValuesBetween(const FSnapshot& Start,
+                                                                           const FSnapshot& End) const
+{
+	const uint64                   TimeEnabled = End.TimeEnabled - Start.TimeEnabled,
+	                               TimeRunning = End.TimeRunning - Start.TimeRunning;
+	double                         Counts[NumCounters];
+	FEnhancedSpecPerfCounterValues Result;
+
+	// The group never got to count (e.g., because other users of the counters had them the whole time).
+	if (TimeRunning == 0)
+	{
+		return Result;
+	}
+
+	for (int32 CounterIndex = 0; CounterIndex < NumCounters; ++CounterIndex)
+	{
+		if (this->CounterFds[CounterIndex] < 0)
+		{
+			Counts[CounterIndex] = -1.0;
+		}
+		else
+		{
+			Counts[CounterIndex] = static_cast<double>(End.Values[CounterIndex] - Start.Values[CounterIndex]) *
+				(static_cast<double>(TimeEnabled) / static_cast<double>(TimeRunning));
+		}
+	}
+
+	Result.Instructions         = Counts[0];
+	Result.Cycles               = Counts[1];
+	Result.L1DataCacheMisses    = Counts[2];
+	Result.LastLevelCacheMisses = Counts[3];
+	Result.BranchMisses         = Counts[4];
+
+	return Result;
+}
+
+// =====================================================================================================================
+// FEnhancedSpecPerfCounterScope
+// =====================================================================================================================
+FEnhancedSpecPerfCounterScope::FEnhancedSpecPerfCounterScope(const bool bShouldMeasure) : Counters(nullptr)
+{
+	const FEnhancedSpecPerfCounters* ThreadCounters =
+		bShouldMeasure ? FEnhancedSpecPerfCounters::GetForThread() : nullptr;
+
+	if ((ThreadCounters != nullptr) && ThreadCounters->TakeSnapshot(this->StartSnapshot))
+	{
+		this->Counters = ThreadCounters;
+	}
+}
+
+FEnhancedSpecPerfCounterValues FEnhancedSpecPerfCounterScope::Stop()
+{
+	FEnhancedSpecPerfCounters::FSnapshot EndSnapshot;
+	const FEnhancedSpecPerfCounters*     StoppedCounters = this->Counters;
+
+	this->Counters = nullptr;
+
+	if ((StoppedCounters == nullptr) || !StoppedCounters->TakeSnapshot(EndSnapshot))
+	{
+		return FEnhancedSpecPerfCounterValues();
+	}
+
+	return StoppedCounters->GetValuesBetween(this->StartSnapshot, EndSnapshot);
+}
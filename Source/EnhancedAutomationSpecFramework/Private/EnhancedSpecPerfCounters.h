@@ -0,0 +1,217 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include "EnhancedSpecPerfCounterValues.h"
+
+/**
+ * The hardware performance counters of a single thread, read through "perf_event_open" on Linux.
+ *
+ * Counters are opened the first time each thread requests them, stay enabled for the lifetime of the thread, and only
+ * count events of that thread in user space. Code is measured by taking a snapshot of the counters before and after it
+ * runs, so measurements can be nested (e.g., a Benchmark() body within the It() command that runs it).
+ *
+ * Counters are enabled by passing "-EnhancedSpecPerfCounters" on the command line. They are not available on other
+ * platforms, nor when the kernel does not allow them to be opened (e.g., when "kernel.perf_event_paranoid" is above 2,
+ * or in containers and VMs that do not expose them).
+ */
+class FEnhancedSpecPerfCounters final
+{
+public:
+	// =================================================================================================================
+	// Public Constants
+	// =================================================================================================================
+	/**
+	 * The number of counters that are read: instructions, cycles, L1 data cache misses, last level cache misses, and
+	 * branch misses, in that order.
+	 */
+	static constexpr int32 NumCounters = 5;
+
+	// =================================================================================================================
+	// Public Types
+	// =================================================================================================================
+	/**
+	 * The raw values of the counters of a thread at a point in time.
+	 */
+	struct FSnapshot final
+	{
+		/**
+		 * The value of each counter, in the same order as the counters; or, 0 for counters that are not open.
+		 */
+		uint64 Values[NumCounters] = {};
+
+		/**
+		 * How long the counters have been enabled, in nanoseconds.
+		 */
+		uint64 TimeEnabled = 0;
+
+		/**
+		 * How long the counters have actually been counting, in nanoseconds. This is less than TimeEnabled when the
+		 * kernel has had to share the counters of the CPU with other users.
+		 */
+		uint64 TimeRunning = 0;
+	};
+
+private:
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The file descriptor of each counter; or, -1 for counters that could not be opened.
+	 */
+	int32 CounterFds[NumCounters];
+
+	/**
+	 * The file descriptor of the first counter that could be opened, which leads the group that all the other counters
+	 * belong to; or, -1 if no counter could be opened.
+	 */
+	int32 GroupFd;
+
+	/**
+	 * The index of each open counter, in the order that the values of the group are read.
+	 */
+	int32 ReadOrder[NumCounters];
+
+	/**
+	 * The number of counters that are open.
+	 */
+	int32 NumOpenCounters;
+
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether hardware performance counters were requested on the command line, on a platform that has them.
+	 *
+	 * @return
+	 *	true if counters should be read; or, false otherwise.
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * Gets the counters of the calling thread, opening them the first time the thread requests them.
+	 *
+	 * @return
+	 *	The counters of the calling thread; or, nullptr if counters are not enabled or could not be opened.
+	 */
+	static FEnhancedSpecPerfCounters* GetForThread();
+
+	// =================================================================================================================
+	// Public Constructors
+	// =================================================================================================================
+	/**
+	 * Opens the counters of the calling thread.
+	 */
+	explicit FEnhancedSpecPerfCounters();
+
+	/**
+	 * Closes the counters.
+	 */
+	~FEnhancedSpecPerfCounters();
+
+	FEnhancedSpecPerfCounters(const FEnhancedSpecPerfCounters&)            = delete;
+	FEnhancedSpecPerfCounters& operator=(const FEnhancedSpecPerfCounters&) = delete;
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether any counter is open.
+	 *
+	 * @return
+	 *	true if the counters can be read; or, false otherwise.
+	 */
+	FORCEINLINE bool IsOpen() const
+	{
+		return (this->GroupFd >= 0);
+	}
+
+	/**
+	 * Reads the current values of the counters.
+	 *
+	 * This must be called on the thread that opened the counters.
+	 *
+	 * @param OutSnapshot
+	 *	Set to the current values of the counters.
+	 *
+	 * @return
+	 *	true if the counters could be read; or, false otherwise.
+	 */
+	bool TakeSnapshot(FSnapshot& OutSnapshot) const;
+
+	/**
+	 * Computes how many events of each kind occurred between two snapshots.
+	 *
+	 * Counts are scaled up if the kernel did not count for the whole time between the snapshots.
+	 *
+	 * @param Start
+	 *	The snapshot taken before the code that was measured.
+	 * @param End
+	 *	The snapshot taken after the code that was measured.
+	 *
+	 * @return
+	 *	The counts of events between the snapshots. Counts of counters that are not open are not available.
+	 */
+	FEnhancedSpecPerfCounterValues GetValuesBetween(const FSnapshot& Start, const FSnapshot& End) const;
+};
+
+/**
+ * Measures the hardware events of the calling thread from the time this scope is created until it is stopped.
+ *
+ * Nothing is measured when counters are not enabled or could not be opened.
+ */
+class FEnhancedSpecPerfCounterScope final
+{
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The counters of the thread that created this scope; or, nullptr if nothing is being measured.
+	 */
+	const FEnhancedSpecPerfCounters* Counters;
+
+	/**
+	 * The values of the counters when this scope was created.
+	 */
+	FEnhancedSpecPerfCounters::FSnapshot StartSnapshot;
+
+public:
+	// =================================================================================================================
+	// Public Constructors
+	// =================================================================================================================
+	/**
+	 * Starts measuring, if counters are enabled and requested.
+	 *
+	 * @param bShouldMeasure
+	 *	Whether the caller wants the events of this scope measured.
+	 */
+	explicit FEnhancedSpecPerfCounterScope(const bool bShouldMeasure = true);
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether this scope is measuring events.
+	 *
+	 * @return
+	 *	true if the counters of the thread are being read; or, false otherwise.
+	 */
+	FORCEINLINE bool IsMeasuring() const
+	{
+		return (this->Counters != nullptr);
+	}
+
+	/**
+	 * Stops measuring.
+	 *
+	 * This must be called on the thread that created this scope.
+	 *
+	 * @return
+	 *	The counts of events since this scope was created; or, no counts if nothing was measured.
+	 */
+	FEnhancedSpecPerfCounterValues Stop();
+};
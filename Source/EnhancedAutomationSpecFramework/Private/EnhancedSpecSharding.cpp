@@ -0,0 +1,183 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecSharding.h"
+
+#include <Misc/CommandLine.h>
+#include <Misc/Crc.h>
+#include <Misc/Parse.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+
+namespace EnhancedSpecSharding
+{
+	/**
+	 * The shard settings of this process, as parsed from the command line.
+	 */
+	struct FSettings final
+	{
+		/**
+		 * The total number of shards.
+		 */
+		int32 ShardCount = 1;
+
+		/**
+		 * The zero-based index of the shard that this process is running.
+		 */
+		int32 ShardIndex = 0;
+	};
+
+	/**
+	 * Gets the shard settings of this process, parsing them from the command line the first time they are requested.
+	 *
+	 * @return
+	 *	The shard settings.
+	 */
+	static const FSettings& GetSettings()
+	{
+		static const FSettings Settings = []
+		{
+			const TCHAR* CommandLine = FCommandLine::Get();
+			FSettings    Result;
+			int32        ShardCount  = 1;
+			int32        ShardIndex  = 0;
+
+			FParse::Value(CommandLine, TEXT("EnhancedSpecShardCount="), ShardCount);
+			FParse::Value(CommandLine, TEXT("EnhancedSpecShardIndex="), ShardIndex);
+
+			if ((ShardCount < 1) || (ShardIndex < 0) || (ShardIndex >= ShardCount))
+			{
+				UE_LOG(
+					LogEnhancedAutomationSpecs,
+					Error,
+					TEXT("Ignoring invalid shard settings (index %d of %d shards). All specs will run on this runner."),
+					ShardIndex,
+					ShardCount
+				);
+			}
+			else
+			{
+				Result.ShardCount = ShardCount;
+				Result.ShardIndex = ShardIndex;
+			}
+
+			return Result;
+		}();
+
+		return Settings;
+	}
+}
+
+bool FEnhancedSpecSharding::IsEnabled()
+{
+	return GetShardCount() > 1;
+}
+
+int32 FEnhancedSpecSharding::GetShardCount()
+{
+	return EnhancedSpecSharding::GetSettings().ShardCount;
+}
+
+int32 FEnhancedSpecSharding::GetShardIndex()
+{
+	return EnhancedSpecSharding::GetSettings().ShardIndex;
+}
+
+TArray<int32> FEnhancedSpecSharding::AssignShards(const FString&                         SuiteName,
+                                                  const TArray<FEnhancedSpecShardGroup>& Groups,
+                                                  const int32                            ShardCount)
+{
+	TArray<int32>  Assignments;
+	TArray<int32>  TimedGroupIndices;
+	TArray<int32>  UntimedGroupIndices;
+	TArray<double> TimedSeconds;
+	TArray<double> ShardLoads;
+	double         UntimedEstimatedSeconds;
+	int32          FirstShardIndex;
+
+	check(ShardCount > 0);
+
+	Assignments.Init(INDEX_NONE, Groups.Num());
+	ShardLoads.Init(0.0, ShardCount);
+
+	for (int32 GroupIndex = 0; GroupIndex < Groups.Num(); ++GroupIndex)
+	{
+		const FEnhancedSpecShardGroup& Group = Groups[GroupIndex];
+
+		if (Group.bHasTiming)
+		{
+			TimedGroupIndices.Add(GroupIndex);
+			TimedSeconds.Add(Group.EstimatedSeconds);
+		}
+		else
+		{
+			UntimedGroupIndices.Add(GroupIndex);
+		}
+	}
+
+	// Groups without recorded durations are assumed to take as long as a typical group that has them.
+	if (TimedSeconds.IsEmpty())
+	{
+		UntimedEstimatedSeconds = 0.0;
+	}
+	else
+	{
+		const int32 MiddleIndex = TimedSeconds.Num() / 2;
+
+		TimedSeconds.Sort();
+
+		UntimedEstimatedSeconds = ((TimedSeconds.Num() % 2) == 0)
+			? (TimedSeconds[MiddleIndex - 1] + TimedSeconds[MiddleIndex]) / 2.0
+			: TimedSeconds[MiddleIndex];
+	}
+
+	// Untimed groups are placed first, so that the timed groups are packed around the load that they add.
+	for (const int32 GroupIndex : UntimedGroupIndices)
+	{
+		const FString HashInput  = FString::Printf(TEXT("%s %s"), *SuiteName, *Groups[GroupIndex].Key);
+		const int32   ShardIndex =
+			static_cast<int32>(FCrc::StrCrc32(*HashInput) % static_cast<uint32>(ShardCount));
+
+		ShardLoads[ShardIndex]  += UntimedEstimatedSeconds;
+		Assignments[GroupIndex]  = ShardIndex;
+	}
+
+	// Longest first; ties are broken by key so that every runner arrives at the same order.
+	TimedGroupIndices.Sort([&Groups](const int32 LeftIndex, const int32 RightIndex)
+	{
+		const FEnhancedSpecShardGroup& Left  = Groups[LeftIndex];
+		const FEnhancedSpecShardGroup& Right = Groups[RightIndex];
+
+		if (Left.EstimatedSeconds != Right.EstimatedSeconds)
+		{
+			return Left.EstimatedSeconds > Right.EstimatedSeconds;
+		}
+
+		return Left.Key < Right.Key;
+	});
+
+	// Start each suite at a different shard, so that suites with only a few groups do not all pile onto the first one.
+	FirstShardIndex = static_cast<int32>(FCrc::StrCrc32(*SuiteName) % static_cast<uint32>(ShardCount));
+
+	for (const int32 GroupIndex : TimedGroupIndices)
+	{
+		int32 LeastLoadedShardIndex = FirstShardIndex;
+
+		for (int32 Offset = 1; Offset < ShardCount; ++Offset)
+		{
+			const int32 ShardIndex = (FirstShardIndex + Offset) % ShardCount;
+
+			if (ShardLoads[ShardIndex] < ShardLoads[LeastLoadedShardIndex])
+			{
+				LeastLoadedShardIndex = ShardIndex;
+			}
+		}
+
+		ShardLoads[LeastLoadedShardIndex] += Groups[GroupIndex].EstimatedSeconds;
+		Assignments[GroupIndex]            = LeastLoadedShardIndex;
+	}
+
+	return Assignments;
+}
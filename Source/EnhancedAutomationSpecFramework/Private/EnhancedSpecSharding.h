@@ -0,0 +1,98 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+/**
+ * A set of test cases that must always be assigned to the same shard.
+ *
+ * Test cases that share a scope with BeforeAll() blocks are grouped together so that the work of those blocks is only
+ * performed on one runner.
+ */
+struct FEnhancedSpecShardGroup final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * An identifier for the group that is the same in every runner (e.g., the ID of its first test case).
+	 */
+	FString Key;
+
+	/**
+	 * The estimated time that it takes to run all the test cases in the group, in seconds.
+	 */
+	double EstimatedSeconds = 0.0;
+
+	/**
+	 * Whether a duration has been recorded for at least one of the test cases in the group.
+	 *
+	 * Groups without any recorded durations are assigned to shards by hashing their key instead, and are assumed to take
+	 * as long as the median group that has them.
+	 */
+	bool bHasTiming = false;
+};
+
+/**
+ * Splits the test cases of enhanced automation specs across multiple runners.
+ *
+ * Sharding is enabled by passing "-EnhancedSpecShardCount=<N>" and "-EnhancedSpecShardIndex=<I>" on the command line
+ * of each runner, where "N" is the total number of runners and "I" is the zero-based index of the runner. Each runner
+ * then only lists the test cases assigned to its own shard. Assignments are deterministic, so all runners agree on
+ * them as long as they run the same build with the same timing file.
+ */
+class FEnhancedSpecSharding final
+{
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether sharding has been enabled for this process.
+	 *
+	 * @return
+	 *	true if test cases are being split across more than one shard; or, false otherwise.
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * Gets the total number of shards.
+	 *
+	 * @return
+	 *	The number of shards; or, 1 if sharding is not enabled.
+	 */
+	static int32 GetShardCount();
+
+	/**
+	 * Gets the zero-based index of the shard that this process is running.
+	 *
+	 * @return
+	 *	The index of the shard of this process; or, 0 if sharding is not enabled.
+	 */
+	static int32 GetShardIndex();
+
+	/**
+	 * Assigns groups of test cases to shards.
+	 *
+	 * Groups that have recorded durations are bin-packed longest first, each being assigned to the shard with the
+	 * least total estimated time so far. Groups without any recorded durations are assigned by a stable hash of their
+	 * key, so that they remain on the same shard from one session to the next until their durations are known. Each of
+	 * them is assumed to take the median duration of the timed groups, and that estimate is counted against its shard
+	 * before the timed groups are packed.
+	 *
+	 * @param SuiteName
+	 *	The name of the spec class that defines the groups. This is used to spread small suites across shards.
+	 * @param Groups
+	 *	The groups to assign.
+	 * @param ShardCount
+	 *	The total number of shards.
+	 *
+	 * @return
+	 *	The index of the shard assigned to each group, in the same order as the groups.
+	 */
+	static TArray<int32> AssignShards(const FString&                         SuiteName,
+	                                  const TArray<FEnhancedSpecShardGroup>& Groups,
+	                                  const int32                            ShardCount);
+};
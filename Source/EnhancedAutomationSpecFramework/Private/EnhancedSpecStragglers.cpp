@@ -0,0 +1,76 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecStragglers.h"
+
+#include <HAL/PlatformTime.h>
+
+#include <Misc/ScopeLock.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+
+FEnhancedSpecStragglers& FEnhancedSpecStragglers::Get()
+{
+	static FEnhancedSpecStragglers Instance;
+
+	return Instance;
+}
+
+void FEnhancedSpecStragglers::Quarantine(const FString& TestName, TFuture<void>&& Future)
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	this->RemoveFinished();
+
+	if (Future.IsValid() && !Future.IsReady())
+	{
+		this->Stragglers.Add({TestName, MoveTemp(Future)});
+	}
+}
+
+int32 FEnhancedSpecStragglers::GetRunningCount()
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	this->RemoveFinished();
+
+	return this->Stragglers.Num();
+}
+
+void FEnhancedSpecStragglers::JoinAll(const double MaxWaitSeconds)
+{
+	FScopeLock   ScopeLock(&this->Lock);
+	const double Deadline = FPlatformTime::Seconds() + MaxWaitSeconds;
+
+	for (const FStraggler& Straggler : this->Stragglers)
+	{
+		const double RemainingSeconds = Deadline - FPlatformTime::Seconds();
+
+		if (RemainingSeconds > 0.0)
+		{
+			Straggler.Future.WaitFor(FTimespan::FromSeconds(RemainingSeconds));
+		}
+	}
+
+	this->RemoveFinished();
+
+	for (const FStraggler& Straggler : this->Stragglers)
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Warning,
+			TEXT("Work abandoned by '%s' after timing out is still running; leaving it to finish in the background."),
+			*Straggler.TestName
+		);
+	}
+}
+
+void FEnhancedSpecStragglers::RemoveFinished()
+{
+	this->Stragglers.RemoveAll([](const FStraggler& Straggler)
+	{
+		return Straggler.Future.IsReady();
+	});
+}
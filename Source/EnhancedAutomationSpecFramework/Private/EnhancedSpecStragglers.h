@@ -0,0 +1,109 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <Async/Future.h>
+
+#include <HAL/CriticalSection.h>
+
+/**
+ * Keeps track of asynchronous work that was abandoned after it timed out but has not yet returned.
+ *
+ * When an asynchronous block times out, the test moves on without waiting for its work, which may still be running on
+ * a worker thread. Rather than silently dropping the future for that work, the block hands it to this registry. The
+ * worker pool checks it so that a few hung blocks cannot take every worker for the rest of the session. At the end of
+ * the session, the registry waits a limited amount of time for abandoned work to return, and logs any work that is
+ * still running after that.
+ */
+class FEnhancedSpecStragglers final
+{
+	// =================================================================================================================
+	// Private Type Definitions
+	// =================================================================================================================
+	/**
+	 * Abandoned work that might still be running.
+	 */
+	struct FStraggler final
+	{
+		/**
+		 * The name of the test that was running the work when it was abandoned.
+		 */
+		FString TestName;
+
+		/**
+		 * The eventual result of the work.
+		 */
+		TFuture<void> Future;
+	};
+
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * Guards access to the stragglers, since work can be abandoned and checked from different threads.
+	 */
+	FCriticalSection Lock;
+
+	/**
+	 * The abandoned work that has not yet been seen to return.
+	 */
+	TArray<FStraggler> Stragglers;
+
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the straggler registry for this process.
+	 *
+	 * @return
+	 *	The straggler registry.
+	 */
+	static FEnhancedSpecStragglers& Get();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Takes ownership of abandoned work so that it can be joined at the end of the session.
+	 *
+	 * @param TestName
+	 *	The name of the test that was running the work when it was abandoned.
+	 * @param Future
+	 *	The eventual result of the work.
+	 */
+	void Quarantine(const FString& TestName, TFuture<void>&& Future);
+
+	/**
+	 * Gets how much abandoned work is still running.
+	 *
+	 * @return
+	 *	The number of abandoned pieces of work that have not yet returned.
+	 */
+	int32 GetRunningCount();
+
+	/**
+	 * Waits for abandoned work to return, giving up after a limited amount of time.
+	 *
+	 * Work that returns in time is forgotten. Work that is still running afterward is logged and kept, so that it can
+	 * be checked again at the end of the next session.
+	 *
+	 * @param MaxWaitSeconds
+	 *	The longest to wait for all abandoned work to return, in seconds.
+	 */
+	void JoinAll(const double MaxWaitSeconds);
+
+private:
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Forgets abandoned work that has returned.
+	 *
+	 * The lock must be held by the caller.
+	 */
+	void RemoveFinished();
+};
@@ -0,0 +1,36 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecTimerQueue.h"
+
+FEnhancedSpecTimerQueue& FEnhancedSpecTimerQueue::Get()
+{
+	static FEnhancedSpecTimerQueue Instance;
+
+	return Instance;
+}
+
+void FEnhancedSpecTimerQueue::Schedule(const double                                                    DueSeconds,
+                                       const TSharedRef<FEnhancedAutomationSpecBase::FSpecWakeSignal>& Signal,
+                                       const int32                                                     Generation)
+{
+	this->Timers.HeapPush(FTimer { DueSeconds, Signal, Generation });
+}
+
+void FEnhancedSpecTimerQueue::RaiseDueSignals(const double NowSeconds)
+{
+	while (!this->Timers.IsEmpty() && (this->Timers.HeapTop().DueSeconds <= NowSeconds))
+	{
+		FTimer Timer;
+
+		this->Timers.HeapPop(Timer);
+
+		// The command may have been destroyed, or started another run, since this deadline was registered.
+		if (const TSharedPtr<FEnhancedAutomationSpecBase::FSpecWakeSignal> Signal = Timer.Signal.Pin())
+		{
+			Signal->Raise(Timer.Generation);
+		}
+	}
+}
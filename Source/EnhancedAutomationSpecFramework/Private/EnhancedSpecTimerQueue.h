@@ -0,0 +1,117 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <Containers/Array.h>
+
+#include "EnhancedAutomationSpecBase.h"
+
+/**
+ * Keeps track of the deadlines of commands that are waiting, and raises the wake signal of each command once its
+ * deadline has passed.
+ *
+ * Deadlines are kept in a min-heap, so that checking for deadlines that have passed only has to look at the earliest
+ * one, no matter how many commands are waiting. Deadlines of runs that completed before timing out are not removed;
+ * they are dropped once they come due, without raising the signal of a later run of the same command.
+ *
+ * The timer queue is not thread-safe; it must only be used from the game thread.
+ */
+class FEnhancedSpecTimerQueue final
+{
+	// =================================================================================================================
+	// Private Type Definitions
+	// =================================================================================================================
+	/**
+	 * The deadline of one run of a waiting command.
+	 */
+	struct FTimer final
+	{
+		/**
+		 * The time after which the run times out, in seconds, as reported by FPlatformTime::Seconds().
+		 */
+		double DueSeconds;
+
+		/**
+		 * The signal of the command.
+		 */
+		TWeakPtr<FEnhancedAutomationSpecBase::FSpecWakeSignal> Signal;
+
+		/**
+		 * The generation of the signal for the run.
+		 */
+		int32 Generation;
+
+		/**
+		 * Orders timers so that the earliest deadline is at the top of the heap.
+		 *
+		 * @param Other
+		 *	The timer to compare against.
+		 *
+		 * @return
+		 *	true if this timer comes due before the other timer; or, false otherwise.
+		 */
+		FORCEINLINE bool operator<(const FTimer& Other) const
+		{
+			return this->DueSeconds < Other.DueSeconds;
+		}
+	};
+
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The deadlines that have not yet come due, as a min-heap.
+	 */
+	TArray<FTimer> Timers;
+
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the timer queue for this process.
+	 *
+	 * @return
+	 *	The timer queue.
+	 */
+	static FEnhancedSpecTimerQueue& Get();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Registers the deadline of a run of a waiting command.
+	 *
+	 * @param DueSeconds
+	 *	The time after which the run times out, in seconds, as reported by FPlatformTime::Seconds().
+	 * @param Signal
+	 *	The signal to raise once the deadline has passed.
+	 * @param Generation
+	 *	The generation that the signal was armed with for the run.
+	 */
+	void Schedule(const double                                                    DueSeconds,
+	              const TSharedRef<FEnhancedAutomationSpecBase::FSpecWakeSignal>& Signal,
+	              const int32                                                     Generation);
+
+	/**
+	 * Raises the signals of all runs whose deadlines have passed, and forgets those deadlines.
+	 *
+	 * @param NowSeconds
+	 *	The current time, in seconds, as reported by FPlatformTime::Seconds().
+	 */
+	void RaiseDueSignals(const double NowSeconds);
+
+	/**
+	 * Gets how many deadlines have not yet come due.
+	 *
+	 * @return
+	 *	The number of deadlines in the queue.
+	 */
+	FORCEINLINE int32 GetNumPending() const
+	{
+		return this->Timers.Num();
+	}
+};
@@ -0,0 +1,138 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecTimingStore.h"
+
+#include <Dom/JsonObject.h>
+
+#include <Misc/CommandLine.h>
+#include <Misc/Parse.h>
+#include <Misc/Paths.h>
+#include <Misc/ScopeLock.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+#include "EnhancedSpecSharding.h"
+
+FEnhancedSpecTimingStore& FEnhancedSpecTimingStore::Get()
+{
+	static FEnhancedSpecTimingStore Instance;
+
+	return Instance;
+}
+
+FEnhancedSpecTimingStore::FEnhancedSpecTimingStore() :
+	Store(FileVersion, TEXT("Durations"), TEXT("spec timings")),
+	bHasUnsavedDurations(false)
+{
+	const TCHAR*            CommandLine = FCommandLine::Get();
+	TSharedPtr<FJsonObject> Entries;
+
+	if (!FParse::Value(CommandLine, TEXT("EnhancedSpecTimings="), this->InputFilePath))
+	{
+		this->InputFilePath =
+			FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("EnhancedSpecTimings.json"));
+	}
+
+	if (!FParse::Value(CommandLine, TEXT("EnhancedSpecTimingsOutput="), this->OutputFilePath))
+	{
+		if (FEnhancedSpecSharding::IsEnabled())
+		{
+			this->OutputFilePath = FPaths::Combine(
+				FPaths::GetPath(this->InputFilePath),
+				FString::Printf(
+					TEXT("%s.Shard%d.json"),
+					*FPaths::GetBaseFilename(this->InputFilePath),
+					FEnhancedSpecSharding::GetShardIndex()
+				)
+			);
+		}
+		else
+		{
+			this->OutputFilePath = this->InputFilePath;
+		}
+	}
+
+	this->bIsRecordingEnabled =
+		FEnhancedSpecSharding::IsEnabled() || FParse::Param(CommandLine, TEXT("EnhancedSpecRecordTimings"));
+
+	if (this->Store.Read(this->InputFilePath, Entries))
+	{
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Entry : Entries->Values)
+		{
+			double Seconds;
+
+			if (Entry.Value.IsValid() && Entry.Value->TryGetNumber(Seconds))
+			{
+				this->LoadedDurations.Add(Entry.Key, Seconds);
+			}
+		}
+	}
+}
+
+bool FEnhancedSpecTimingStore::FindDuration(const FString& FullTestName, double& OutSeconds) const
+{
+	const double* Seconds = this->LoadedDurations.Find(FullTestName);
+
+	if (Seconds != nullptr)
+	{
+		OutSeconds = *Seconds;
+		return true;
+	}
+
+	return false;
+}
+
+void FEnhancedSpecTimingStore::RecordDuration(const FString& FullTestName, const double Seconds)
+{
+	if (!this->bIsRecordingEnabled)
+	{
+		return;
+	}
+
+	FScopeLock    ScopeLock(&this->Lock);
+	const double* PriorSeconds = this->RecordedDurations.Find(FullTestName);
+
+	if (PriorSeconds == nullptr)
+	{
+		PriorSeconds = this->LoadedDurations.Find(FullTestName);
+	}
+
+	if (PriorSeconds != nullptr)
+	{
+		this->RecordedDurations.Add(
+			FullTestName,
+			(*PriorSeconds * (1.0 - SmoothingFactor)) + (Seconds * SmoothingFactor)
+		);
+	}
+	else
+	{
+		this->RecordedDurations.Add(FullTestName, Seconds);
+	}
+
+	this->bHasUnsavedDurations = true;
+}
+
+void FEnhancedSpecTimingStore::Save()
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	if (!this->bHasUnsavedDurations)
+	{
+		return;
+	}
+
+	const bool bWasSaved = this->Store.Update(this->OutputFilePath, [this](FJsonObject& Entries)
+	{
+		for (const TPair<FString, double>& Entry : this->RecordedDurations)
+		{
+			Entries.SetNumberField(Entry.Key, Entry.Value);
+		}
+	});
+
+	if (bWasSaved)
+	{
+		this->bHasUnsavedDurations = false;
+	}
+}
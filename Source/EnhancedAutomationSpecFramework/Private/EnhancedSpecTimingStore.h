@@ -0,0 +1,157 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <HAL/CriticalSection.h>
+
+#include "EnhancedSpecJsonStore.h"
+
+/**
+ * A persistent record of how long each enhanced automation spec took to run in prior test sessions.
+ *
+ * Durations are keyed by the full name of each test case (the name of the spec class followed by the ID of the test
+ * case), and are loaded from one JSON file and saved to another. Durations are loaded from
+ * "Saved/Automation/EnhancedSpecTimings.json" by default, or from the path supplied on the command line with
+ * "-EnhancedSpecTimings=<Path>". The durations that are loaded never change during a session.
+ *
+ * Recorded durations are saved to the path supplied with "-EnhancedSpecTimingsOutput=<Path>". Without it, they are
+ * saved back to the file they were loaded from, except while sharding: then, each runner saves to its own file (e.g.,
+ * "EnhancedSpecTimings.Shard0.json" next to the file that was loaded), so that the file every runner partitions test
+ * cases with is never written while any runner might still be reading it.
+ */
+class FEnhancedSpecTimingStore final
+{
+	// =================================================================================================================
+	// Private Constants
+	// =================================================================================================================
+	/**
+	 * The version of the file format written by this store.
+	 */
+	static constexpr int32 FileVersion = 1;
+
+	/**
+	 * How much weight a new duration has relative to the durations recorded in prior sessions.
+	 */
+	static constexpr double SmoothingFactor = 0.5;
+
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The path to the file from which durations are loaded.
+	 */
+	FString InputFilePath;
+
+	/**
+	 * The path to the file to which recorded durations are saved.
+	 */
+	FString OutputFilePath;
+
+	/**
+	 * Reads durations from the input file, and updates the output file.
+	 */
+	FEnhancedSpecJsonStore Store;
+
+	/**
+	 * Whether durations of test cases should be recorded and saved during this session.
+	 */
+	bool bIsRecordingEnabled;
+
+	/**
+	 * Guards access to the recorded durations, since they can be recorded from worker threads.
+	 */
+	mutable FCriticalSection Lock;
+
+	/**
+	 * The duration of each test case from prior sessions, in seconds, keyed by the full name of the test case.
+	 *
+	 * This is only written by the constructor, so that every lookup during a session sees the same durations.
+	 */
+	TMap<FString, double> LoadedDurations;
+
+	/**
+	 * The smoothed duration of each test case that has been recorded during this session, in seconds, keyed by the
+	 * full name of the test case.
+	 */
+	TMap<FString, double> RecordedDurations;
+
+	/**
+	 * Whether any durations have been recorded since durations were last saved.
+	 */
+	bool bHasUnsavedDurations;
+
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the timing store for this process, loading durations from disk the first time it is requested.
+	 *
+	 * @return
+	 *	The timing store.
+	 */
+	static FEnhancedSpecTimingStore& Get();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether durations of test cases are being recorded during this session.
+	 *
+	 * Recording is enabled when specs are being sharded, or when "-EnhancedSpecRecordTimings" is passed on the command
+	 * line.
+	 *
+	 * @return
+	 *	true if durations are being recorded; or, false otherwise.
+	 */
+	FORCEINLINE bool IsRecordingEnabled() const
+	{
+		return this->bIsRecordingEnabled;
+	}
+
+	/**
+	 * Looks up the duration of a test case from prior sessions.
+	 *
+	 * Durations recorded during this session are not returned, so that the result does not depend on which test cases
+	 * have already run.
+	 *
+	 * @param FullTestName
+	 *	The name of the spec class followed by a space and the ID of the test case.
+	 * @param OutSeconds
+	 *	A reference to the variable to receive the duration, in seconds.
+	 *
+	 * @return
+	 *	true if a duration has been recorded for the test case; or, false otherwise.
+	 */
+	bool FindDuration(const FString& FullTestName, double& OutSeconds) const;
+
+	/**
+	 * Records how long a test case took to run, if recording is enabled.
+	 *
+	 * @param FullTestName
+	 *	The name of the spec class followed by a space and the ID of the test case.
+	 * @param Seconds
+	 *	How long the test case took to run, in seconds.
+	 */
+	void RecordDuration(const FString& FullTestName, const double Seconds);
+
+	/**
+	 * Saves any durations that were recorded during this session to the output file.
+	 *
+	 * Entries in the output file that were not recorded during this session are preserved, including those saved by
+	 * other runners while this session was running.
+	 */
+	void Save();
+
+private:
+	// =================================================================================================================
+	// Private Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new instance and loads durations from disk.
+	 */
+	explicit FEnhancedSpecTimingStore();
+};
@@ -0,0 +1,186 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecTraceRecorder.h"
+
+#include <HAL/PlatformProcess.h>
+#include <HAL/ThreadManager.h>
+
+#include <Misc/CommandLine.h>
+#include <Misc/DateTime.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Parse.h>
+#include <Misc/Paths.h>
+#include <Misc/ScopeLock.h>
+
+#include <Policies/CondensedJsonPrintPolicy.h>
+
+#include <Serialization/JsonWriter.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+#include "EnhancedSpecSharding.h"
+
+FEnhancedSpecTraceRecorder& FEnhancedSpecTraceRecorder::Get()
+{
+	static FEnhancedSpecTraceRecorder Instance;
+
+	return Instance;
+}
+
+FEnhancedSpecTraceRecorder::FEnhancedSpecTraceRecorder(const FString& OutputDirectory) :
+	OutputDirectory(OutputDirectory),
+	bIsEnabled(true)
+{
+}
+
+FEnhancedSpecTraceRecorder::FEnhancedSpecTraceRecorder()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	if (FParse::Value(CommandLine, TEXT("EnhancedSpecTrace="), this->OutputDirectory))
+	{
+		this->bIsEnabled = true;
+	}
+	else
+	{
+		this->OutputDirectory =
+			FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("EnhancedSpecTraces"));
+		this->bIsEnabled = FParse::Param(CommandLine, TEXT("EnhancedSpecTrace"));
+	}
+}
+
+void FEnhancedSpecTraceRecorder::Record(FEnhancedSpecTraceEvent&& Event)
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	this->Events.Add(MoveTemp(Event));
+}
+
+void FEnhancedSpecTraceRecorder::EndSession()
+{
+	TArray<FEnhancedSpecTraceEvent> SessionEvents;
+	TSet<uint32>                    ThreadIds;
+	double                          SessionStartSeconds = MAX_dbl;
+	const int64                     ProcessId           = FPlatformProcess::GetCurrentProcessId();
+	FString                         SessionFilePath,
+	                                Contents;
+
+	{
+		FScopeLock ScopeLock(&this->Lock);
+
+		SessionEvents = MoveTemp(this->Events);
+		this->Events.Reset();
+	}
+
+	if (!this->bIsEnabled || SessionEvents.IsEmpty())
+	{
+		return;
+	}
+
+	SessionFilePath = this->GetSessionFilePath();
+
+	for (const FEnhancedSpecTraceEvent& Event : SessionEvents)
+	{
+		SessionStartSeconds = FMath::Min(SessionStartSeconds, Event.StartSeconds);
+
+		ThreadIds.Add(Event.ThreadId);
+	}
+
+	// Sessions can contain hundreds of thousands of events, so they are streamed out rather than built up as a tree of
+	// JSON objects first.
+	const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+		TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Contents);
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("displayTimeUnit"), TEXT("ms"));
+	Writer->WriteArrayStart(TEXT("traceEvents"));
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("name"), TEXT("process_name"));
+	Writer->WriteValue(TEXT("ph"), TEXT("M"));
+	Writer->WriteValue(TEXT("pid"), ProcessId);
+	Writer->WriteObjectStart(TEXT("args"));
+	Writer->WriteValue(TEXT("name"), TEXT("Enhanced Automation Specs"));
+	Writer->WriteObjectEnd();
+	Writer->WriteObjectEnd();
+
+	for (const uint32 ThreadId : ThreadIds)
+	{
+		FString ThreadName = FThreadManager::GetThreadName(ThreadId);
+
+		if (ThreadName.IsEmpty() && (ThreadId == GGameThreadId))
+		{
+			ThreadName = TEXT("GameThread");
+		}
+		else if (ThreadName.IsEmpty())
+		{
+			ThreadName = FString::Printf(TEXT("Thread %u"), ThreadId);
+		}
+
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("name"), TEXT("thread_name"));
+		Writer->WriteValue(TEXT("ph"), TEXT("M"));
+		Writer->WriteValue(TEXT("pid"), ProcessId);
+		Writer->WriteValue(TEXT("tid"), static_cast<int64>(ThreadId));
+		Writer->WriteObjectStart(TEXT("args"));
+		Writer->WriteValue(TEXT("name"), ThreadName);
+		Writer->WriteObjectEnd();
+		Writer->WriteObjectEnd();
+	}
+
+	for (const FEnhancedSpecTraceEvent& Event : SessionEvents)
+	{
+		// Trace viewers expect times in microseconds.
+		const double StartMicroseconds    = (Event.StartSeconds - SessionStartSeconds) * 1000000.0,
+		             DurationMicroseconds = FMath::Max(0.0, Event.EndSeconds - Event.StartSeconds) * 1000000.0;
+
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("name"), Event.Name);
+		Writer->WriteValue(TEXT("cat"), Event.Category);
+		Writer->WriteValue(TEXT("ph"), TEXT("X"));
+		Writer->WriteValue(TEXT("ts"), StartMicroseconds);
+		Writer->WriteValue(TEXT("dur"), DurationMicroseconds);
+		Writer->WriteValue(TEXT("pid"), ProcessId);
+		Writer->WriteValue(TEXT("tid"), static_cast<int64>(Event.ThreadId));
+		Writer->WriteObjectStart(TEXT("args"));
+		Writer->WriteValue(TEXT("test"), Event.TestName);
+		Writer->WriteValue(TEXT("scope"), Event.Scope);
+		Writer->WriteValue(TEXT("frames"), static_cast<int64>(Event.NumFrames));
+		Writer->WriteValue(TEXT("timedOut"), Event.bTimedOut);
+		Writer->WriteObjectEnd();
+		Writer->WriteObjectEnd();
+	}
+
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+
+	if (Writer->Close() && FFileHelper::SaveStringToFile(Contents, *SessionFilePath))
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Display,
+			TEXT("Wrote trace of %d spec block(s) to '%s'."),
+			SessionEvents.Num(),
+			*SessionFilePath
+		);
+	}
+	else
+	{
+		UE_LOG(LogEnhancedAutomationSpecs, Warning, TEXT("Failed to save spec trace to '%s'."), *SessionFilePath);
+	}
+}
+
+FString FEnhancedSpecTraceRecorder::GetSessionFilePath() const
+{
+	FString FileName =
+		FString::Printf(TEXT("EnhancedSpecTrace-%s"), *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S-%s")));
+
+	if (FEnhancedSpecSharding::IsEnabled())
+	{
+		FileName += FString::Printf(TEXT("-Shard%d"), FEnhancedSpecSharding::GetShardIndex());
+	}
+
+	return FPaths::Combine(this->OutputDirectory, FileName + TEXT(".json"));
+}
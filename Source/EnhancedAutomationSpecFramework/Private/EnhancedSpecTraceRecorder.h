@@ -0,0 +1,173 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <HAL/CriticalSection.h>
+
+/**
+ * A single run of a block (e.g., a BeforeEach() or It() block) of an enhanced automation spec.
+ */
+struct FEnhancedSpecTraceEvent final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * The label of the block in the timeline.
+	 */
+	FString Name;
+
+	/**
+	 * The kind of block (e.g., "BeforeAll", "BeforeEach", "It", "AfterEach", or "AfterAll").
+	 */
+	FString Category;
+
+	/**
+	 * The full name of the test case that was running when the block ran.
+	 */
+	FString TestName;
+
+	/**
+	 * The descriptions of the scopes that enclose the block, separated by periods.
+	 */
+	FString Scope;
+
+	/**
+	 * The time at which the block started running, in seconds, as reported by FPlatformTime::Seconds().
+	 */
+	double StartSeconds = 0.0;
+
+	/**
+	 * The time at which the block finished running, in seconds, as reported by FPlatformTime::Seconds().
+	 */
+	double EndSeconds = 0.0;
+
+	/**
+	 * The ID of the thread that ran the work of the block.
+	 */
+	uint32 ThreadId = 0;
+
+	/**
+	 * The number of engine frames that passed while the block was running.
+	 */
+	uint64 NumFrames = 0;
+
+	/**
+	 * Whether the block timed out before it finished.
+	 */
+	bool bTimedOut = false;
+};
+
+/**
+ * Records when each block of each enhanced automation spec runs, and writes the record of each test session to a trace
+ * file in the Chrome trace-event format.
+ *
+ * The automation framework only knows how long each test case took as a whole. A trace shows how that time splits
+ * across the BeforeAll(), BeforeEach(), It(), AfterEach(), and AfterAll() blocks of the test case, which thread ran
+ * each block, and how many frames each block spanned, so that slow hooks stand out in a timeline viewer such as
+ * Perfetto (https://ui.perfetto.dev) or "chrome://tracing".
+ *
+ * Tracing is enabled by passing "-EnhancedSpecTrace" on the command line. One file is written per session, to
+ * "Saved/Automation/EnhancedSpecTraces" by default, but a different directory can be supplied on the command line with
+ * "-EnhancedSpecTrace=<Directory>".
+ */
+class FEnhancedSpecTraceRecorder final
+{
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The directory to which trace files are written.
+	 */
+	FString OutputDirectory;
+
+	/**
+	 * Whether blocks are being traced during this session.
+	 */
+	bool bIsEnabled;
+
+	/**
+	 * Guards access to the events, since blocks can finish on worker threads.
+	 */
+	FCriticalSection Lock;
+
+	/**
+	 * The events recorded since the last trace file was written.
+	 */
+	TArray<FEnhancedSpecTraceEvent> Events;
+
+public:
+	// =================================================================================================================
+	// Public Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new, enabled instance that writes trace files to a specific directory.
+	 *
+	 * This is only meant for testing the recorder itself. Spec classes use the recorder of this process, from Get().
+	 *
+	 * @param OutputDirectory
+	 *	The directory to which trace files are written.
+	 */
+	explicit FEnhancedSpecTraceRecorder(const FString& OutputDirectory);
+
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the trace recorder for this process.
+	 *
+	 * @return
+	 *	The trace recorder.
+	 */
+	static FEnhancedSpecTraceRecorder& Get();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether blocks are being traced during this session.
+	 *
+	 * @return
+	 *	true if tracing is enabled; or, false otherwise.
+	 */
+	FORCEINLINE bool IsEnabled() const
+	{
+		return this->bIsEnabled;
+	}
+
+	/**
+	 * Records a run of a block.
+	 *
+	 * @param Event
+	 *	The run to record.
+	 */
+	void Record(FEnhancedSpecTraceEvent&& Event);
+
+	/**
+	 * Writes the events recorded during the current session to a new trace file, and then forgets them.
+	 */
+	void EndSession();
+
+private:
+	// =================================================================================================================
+	// Private Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new instance, reading its settings from the command line.
+	 */
+	explicit FEnhancedSpecTraceRecorder();
+
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Gets the path of the file to which the trace of the current session should be written.
+	 *
+	 * @return
+	 *	The path of a new trace file, named for the current time (and shard, if specs are sharded).
+	 */
+	FString GetSessionFilePath() const;
+};
@@ -0,0 +1,208 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedSpecWorkerPool.h"
+
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformMisc.h>
+#include <HAL/PlatformTime.h>
+
+#include <Misc/QueuedThreadPool.h>
+#include <Misc/ScopeLock.h>
+
+#include "EnhancedAutomationSpecFramework.h"
+#include "EnhancedSpecStragglers.h"
+
+static TAutoConsoleVariable<int32> CVarEnhancedSpecWorkerPoolSize(
+	TEXT("EnhancedSpecs.WorkerPoolSize"),
+	0,
+	TEXT("The number of threads reserved for asynchronous blocks of enhanced automation specs. 0 uses one thread per ")
+	TEXT("logical core. A negative value disables the pool, so that blocks run wherever they asked to be run. Only ")
+	TEXT("read when the first asynchronous block runs."),
+	ECVF_Default
+);
+
+FEnhancedSpecWorkerPool& FEnhancedSpecWorkerPool::Get()
+{
+	static FEnhancedSpecWorkerPool Instance;
+
+	return Instance;
+}
+
+FEnhancedSpecWorkerPool::FEnhancedSpecWorkerPool() : Pool(nullptr), bHasInitialized(false)
+{
+}
+
+TFuture<void> FEnhancedSpecWorkerPool::Launch(const EAsyncExecution Execution, TUniqueFunction<void()> Work)
+{
+	FQueuedThreadPool* ThreadPool;
+	double             QueuedTime;
+
+	if (Execution == EAsyncExecution::TaskGraphMainThread)
+	{
+		return Async(Execution, MoveTemp(Work));
+	}
+
+	ThreadPool = this->GetOrCreatePool();
+
+	if (ThreadPool == nullptr)
+	{
+		return Async(Execution, MoveTemp(Work));
+	}
+
+	// Abandoned work that never returns keeps its thread of the pool forever. Once it has taken every thread, new work
+	// would never start, so it is given its own thread instead.
+	if (FEnhancedSpecStragglers::Get().GetRunningCount() >= ThreadPool->GetNumThreads())
+	{
+		{
+			FScopeLock ScopeLock(&this->Lock);
+
+			++this->Stats.NumOverflowed;
+		}
+
+		return Async(EAsyncExecution::Thread, MoveTemp(Work));
+	}
+
+	{
+		FScopeLock ScopeLock(&this->Lock);
+
+		++this->Stats.NumLaunched;
+		++this->Stats.NumQueued;
+	}
+
+	QueuedTime = FPlatformTime::Seconds();
+
+	return AsyncPool(*ThreadPool, [this, QueuedTime, Work = MoveTemp(Work)]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		this->OnWorkStarted(StartTime - QueuedTime);
+
+		Work();
+
+		this->OnWorkCompleted(FPlatformTime::Seconds() - StartTime);
+	});
+}
+
+FEnhancedSpecWorkerPoolStats FEnhancedSpecWorkerPool::GetStats() const
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	return this->Stats;
+}
+
+void FEnhancedSpecWorkerPool::LogStats() const
+{
+	const FEnhancedSpecWorkerPoolStats CurrentStats = this->GetStats();
+
+	if ((CurrentStats.NumLaunched == 0) && (CurrentStats.NumOverflowed == 0))
+	{
+		return;
+	}
+
+	UE_LOG(
+		LogEnhancedAutomationSpecs,
+		Log,
+		TEXT("Spec worker pool: %d threads; %lld blocks run (%lld on overflow threads); peak of %d running at once; ")
+		TEXT("%.3f s average and %.3f s longest wait for a thread; %.3f s total run time."),
+		CurrentStats.NumThreads,
+		CurrentStats.NumLaunched,
+		CurrentStats.NumOverflowed,
+		CurrentStats.PeakRunning,
+		(CurrentStats.NumCompleted > 0) ? (CurrentStats.TotalQueueSeconds / CurrentStats.NumCompleted) : 0.0,
+		CurrentStats.MaxQueueSeconds,
+		CurrentStats.TotalRunSeconds
+	);
+}
+
+void FEnhancedSpecWorkerPool::Shutdown()
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	if (this->Pool == nullptr)
+	{
+		return;
+	}
+
+	if (FEnhancedSpecStragglers::Get().GetRunningCount() > 0)
+	{
+		UE_LOG(
+			LogEnhancedAutomationSpecs,
+			Warning,
+			TEXT("Leaving the spec worker pool running, since abandoned work is still running on it.")
+		);
+	}
+	else
+	{
+		this->Pool->Destroy();
+		delete this->Pool;
+	}
+
+	this->Pool             = nullptr;
+	this->Stats.NumThreads = 0;
+}
+
+FQueuedThreadPool* FEnhancedSpecWorkerPool::GetOrCreatePool()
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	if (!this->bHasInitialized)
+	{
+		int32 NumThreads = CVarEnhancedSpecWorkerPoolSize.GetValueOnAnyThread();
+
+		this->bHasInitialized = true;
+
+		if (NumThreads == 0)
+		{
+			NumThreads = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+		}
+
+		if (NumThreads > 0)
+		{
+			this->Pool = FQueuedThreadPool::Allocate();
+
+			// Spec code can call into any part of the engine, so its threads get a generous stack.
+			if (this->Pool->Create(NumThreads, 1024 * 1024, TPri_Normal, TEXT("EnhancedSpecWorkerPool")))
+			{
+				this->Stats.NumThreads = NumThreads;
+			}
+			else
+			{
+				UE_LOG(
+					LogEnhancedAutomationSpecs,
+					Error,
+					TEXT("Failed to create the spec worker pool. Asynchronous blocks will run on engine workers.")
+				);
+
+				delete this->Pool;
+				this->Pool = nullptr;
+			}
+		}
+	}
+
+	return this->Pool;
+}
+
+void FEnhancedSpecWorkerPool::OnWorkStarted(const double QueueSeconds)
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	--this->Stats.NumQueued;
+	++this->Stats.NumRunning;
+
+	this->Stats.PeakRunning        = FMath::Max(this->Stats.PeakRunning, this->Stats.NumRunning);
+	this->Stats.TotalQueueSeconds += QueueSeconds;
+	this->Stats.MaxQueueSeconds    = FMath::Max(this->Stats.MaxQueueSeconds, QueueSeconds);
+}
+
+void FEnhancedSpecWorkerPool::OnWorkCompleted(const double RunSeconds)
+{
+	FScopeLock ScopeLock(&this->Lock);
+
+	--this->Stats.NumRunning;
+	++this->Stats.NumCompleted;
+
+	this->Stats.TotalRunSeconds += RunSeconds;
+}
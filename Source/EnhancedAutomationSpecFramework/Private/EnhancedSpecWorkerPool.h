@@ -0,0 +1,193 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <Async/Async.h>
+#include <Async/Future.h>
+
+#include <HAL/CriticalSection.h>
+
+class FQueuedThreadPool;
+
+/**
+ * A snapshot of how the worker pool for asynchronous spec blocks has been used.
+ */
+struct FEnhancedSpecWorkerPoolStats final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * The number of threads in the pool, or 0 if the pool has not been created or is disabled.
+	 */
+	int32 NumThreads = 0;
+
+	/**
+	 * The number of blocks that have been queued on the pool.
+	 */
+	int64 NumLaunched = 0;
+
+	/**
+	 * The number of blocks that were run on a dedicated thread because the pool was full of abandoned work.
+	 */
+	int64 NumOverflowed = 0;
+
+	/**
+	 * The number of blocks that have finished running on the pool.
+	 */
+	int64 NumCompleted = 0;
+
+	/**
+	 * The number of blocks that are waiting for a thread of the pool.
+	 */
+	int32 NumQueued = 0;
+
+	/**
+	 * The number of blocks that are running on the pool.
+	 */
+	int32 NumRunning = 0;
+
+	/**
+	 * The largest number of blocks that have run on the pool at the same time.
+	 */
+	int32 PeakRunning = 0;
+
+	/**
+	 * The total time that blocks have waited for a thread of the pool, in seconds.
+	 */
+	double TotalQueueSeconds = 0.0;
+
+	/**
+	 * The longest time that any block has waited for a thread of the pool, in seconds.
+	 */
+	double MaxQueueSeconds = 0.0;
+
+	/**
+	 * The total time that blocks have spent running on the pool, in seconds.
+	 */
+	double TotalRunSeconds = 0.0;
+};
+
+/**
+ * A pool of threads reserved for the work of asynchronous spec blocks.
+ *
+ * Without this pool, a block that asks for a dedicated thread creates and destroys an OS thread every time that it
+ * runs, and a block that asks for the task graph or the engine thread pool competes with engine work for the same
+ * workers (and can starve that work if it blocks). Instead, all such blocks are queued on this pool, which is created
+ * the first time it is needed and sized by the "EnhancedSpecs.WorkerPoolSize" console variable. Blocks that run on the
+ * game thread are not affected.
+ */
+class FEnhancedSpecWorkerPool final
+{
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * Guards creation of the pool and access to the statistics, since blocks finish on worker threads.
+	 */
+	mutable FCriticalSection Lock;
+
+	/**
+	 * The threads of the pool, or a null pointer if the pool has not been created or is disabled.
+	 */
+	FQueuedThreadPool* Pool;
+
+	/**
+	 * Whether the pool has been created (or found to be disabled) already.
+	 */
+	bool bHasInitialized;
+
+	/**
+	 * How the pool has been used so far.
+	 */
+	FEnhancedSpecWorkerPoolStats Stats;
+
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the worker pool for this process.
+	 *
+	 * @return
+	 *	The worker pool.
+	 */
+	static FEnhancedSpecWorkerPool& Get();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Starts running the work of an asynchronous block.
+	 *
+	 * @param Execution
+	 *	How the block asked for its work to be executed. Work for the game thread is handed to the engine as-is; all
+	 *	other work is queued on this pool, unless the pool is disabled.
+	 * @param Work
+	 *	The work to run.
+	 *
+	 * @return
+	 *	The eventual result of the work.
+	 */
+	TFuture<void> Launch(const EAsyncExecution Execution, TUniqueFunction<void()> Work);
+
+	/**
+	 * Gets how the pool has been used so far.
+	 *
+	 * @return
+	 *	A snapshot of the statistics of the pool.
+	 */
+	FEnhancedSpecWorkerPoolStats GetStats() const;
+
+	/**
+	 * Writes how the pool has been used so far to the log, if any blocks have been queued on it.
+	 */
+	void LogStats() const;
+
+	/**
+	 * Stops and frees the threads of the pool.
+	 *
+	 * If abandoned work is still running on the pool, the threads are left alone instead, since stopping them would
+	 * wait for that work to return.
+	 */
+	void Shutdown();
+
+private:
+	// =================================================================================================================
+	// Private Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new instance without creating the pool.
+	 */
+	explicit FEnhancedSpecWorkerPool();
+
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Gets the threads of the pool, creating them the first time they are needed.
+	 *
+	 * @return
+	 *	The threads of the pool; or, a null pointer if the pool is disabled.
+	 */
+	FQueuedThreadPool* GetOrCreatePool();
+
+	/**
+	 * Records that a block has started running on the pool.
+	 *
+	 * @param QueueSeconds
+	 *	How long the block waited for a thread of the pool, in seconds.
+	 */
+	void OnWorkStarted(const double QueueSeconds);
+
+	/**
+	 * Records that a block has finished running on the pool.
+	 *
+	 * @param RunSeconds
+	 *	How long the block ran, in seconds.
+	 */
+	void OnWorkCompleted(const double RunSeconds);
+};
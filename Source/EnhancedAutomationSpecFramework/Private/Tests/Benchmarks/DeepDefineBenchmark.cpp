@@ -0,0 +1,71 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include <HAL/PlatformTime.h>
+
+#include <Misc/AutomationTest.h>
+
+#include "Tests/Benchmarks/SyntheticSpecTree.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FEnhancedSpecDeepDefineBenchmark,
+	"EnhancedUnrealSpecs.Benchmarks.DeepDefine",
+	EAutomationTestFlags::PerfFilter | EAutomationTestFlags::ApplicationContextMask
+)
+
+bool FEnhancedSpecDeepDefineBenchmark::RunTest(const FString& Parameters)
+{
+	// IDs and descriptions are extended by one description per It(), so the cost of defining each spec should stay
+	// roughly flat as nesting gets deeper, rather than growing with the number of enclosing scopes.
+	for (const int32 Depth : { 8, 32, 128 })
+	{
+		FSyntheticSpecTree Tree(FString::Printf(TEXT("FSyntheticSpecTree.DeepDefineBenchmark.Depth%d"), Depth));
+		FString            DeepestSpecId,
+		                   DeepestSpecDescription;
+		TArray<FString>    BeautifiedNames,
+		                   TestCommands;
+
+		Tree.Shape.Depth           = Depth;
+		Tree.Shape.Breadth         = 1;
+		Tree.Shape.ItsPerLeafScope = 2000;
+
+		for (int32 Level = 0; Level < Depth; ++Level)
+		{
+			DeepestSpecId          += TEXT("scope 0 ");
+			DeepestSpecDescription += TEXT("scope 0.");
+		}
+
+		DeepestSpecId          += TEXT("meets expectation 1999");
+		DeepestSpecDescription += TEXT("meets expectation 1999");
+
+		const double DefineStart = FPlatformTime::Seconds();
+
+		Tree.DefineSpecs();
+
+		const double DefineEnd = FPlatformTime::Seconds();
+
+		Tree.PostDefineSpecs();
+		Tree.GetTests(BeautifiedNames, TestCommands);
+
+		TestEqual("Number of specs", static_cast<int64>(TestCommands.Num()), Tree.Shape.GetNumSpecs());
+		TestTrue(FString::Printf(TEXT("ID of deepest spec at depth %d"), Depth), TestCommands.Contains(DeepestSpecId));
+		TestTrue(
+			FString::Printf(TEXT("Description of deepest spec at depth %d"), Depth),
+			BeautifiedNames.Contains(DeepestSpecDescription)
+		);
+
+		AddInfo(
+			FString::Printf(
+				TEXT("Depth %d: Define() %.2f ms for %lld specs, %.2f us per spec."),
+				Depth,
+				(DefineEnd - DefineStart) * 1000.0,
+				Tree.Shape.GetNumSpecs(),
+				(DefineEnd - DefineStart) * 1000000.0 / Tree.Shape.GetNumSpecs()
+			)
+		);
+	}
+
+	return true;
+}
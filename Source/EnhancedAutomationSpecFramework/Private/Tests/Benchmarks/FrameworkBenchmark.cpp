@@ -0,0 +1,234 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include <Dom/JsonObject.h>
+
+#include <HAL/PlatformMemory.h>
+#include <HAL/PlatformTime.h>
+
+#include <Misc/AutomationTest.h>
+#include <Misc/CommandLine.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Parse.h>
+#include <Misc/Paths.h>
+
+#include <Serialization/JsonSerializer.h>
+#include <Serialization/JsonWriter.h>
+
+#include "Tests/Benchmarks/SyntheticSpecTree.h"
+
+namespace EnhancedSpecFrameworkBenchmark
+{
+	/**
+	 * Gets the shapes of the spec trees that the benchmark measures, keyed by name.
+	 *
+	 * Each shape stresses a different part of the framework, while keeping the number of test cases small enough for
+	 * every shape to be run in a few seconds.
+	 *
+	 * @return
+	 *	The name and shape of each tree.
+	 */
+	static const TArray<TPair<FString, FSyntheticSpecTreeShape>>& GetShapes()
+	{
+		static const TArray<TPair<FString, FSyntheticSpecTreeShape>> Shapes = []
+		{
+			TArray<TPair<FString, FSyntheticSpecTreeShape>> Result;
+			FSyntheticSpecTreeShape                         Shape;
+
+			// 10,000 leaf scopes of 5 expectations each.
+			Result.Emplace(TEXT("Default"), Shape);
+
+			// Few levels, with many scopes at each level.
+			Shape         = FSyntheticSpecTreeShape();
+			Shape.Depth   = 2;
+			Shape.Breadth = 100;
+			Result.Emplace(TEXT("Wide"), Shape);
+
+			// A single chain of nested scopes, so that every expectation has a long chain of enclosing scopes.
+			Shape                 = FSyntheticSpecTreeShape();
+			Shape.Depth           = 32;
+			Shape.Breadth         = 1;
+			Shape.ItsPerLeafScope = 2000;
+			Result.Emplace(TEXT("Deep"), Shape);
+
+			// Many variables per scope, each read many times by every expectation.
+			Shape                    = FSyntheticSpecTreeShape();
+			Shape.Depth              = 3;
+			Shape.LetsPerScope       = 32;
+			Shape.VariableReadsPerIt = 16;
+			Result.Emplace(TEXT("LetHeavy"), Shape);
+
+			// Many setup and teardown blocks per scope.
+			Shape                      = FSyntheticSpecTreeShape();
+			Shape.Depth                = 3;
+			Shape.BeforeAllsPerScope   = 2;
+			Shape.BeforeEachesPerScope = 8;
+			Shape.AfterEachesPerScope  = 8;
+			Result.Emplace(TEXT("HookHeavy"), Shape);
+
+			return Result;
+		}();
+
+		return Shapes;
+	}
+
+	/**
+	 * Gets the directory to which benchmark results are written.
+	 *
+	 * By default, this is "Saved/Automation/EnhancedSpecBenchmarks", but a different directory can be supplied on the
+	 * command line with "-EnhancedSpecBenchmarkResults=<Path>".
+	 *
+	 * @return
+	 *	The path to the results directory.
+	 */
+	static FString GetResultsDirectory()
+	{
+		FString Directory;
+
+		if (!FParse::Value(FCommandLine::Get(), TEXT("EnhancedSpecBenchmarkResults="), Directory))
+		{
+			Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("EnhancedSpecBenchmarks"));
+		}
+
+		return Directory;
+	}
+
+	/**
+	 * Converts the shape of a tree into a JSON object.
+	 *
+	 * @param Shape
+	 *	The shape to convert.
+	 *
+	 * @return
+	 *	The JSON representation of the shape.
+	 */
+	static TSharedRef<FJsonObject> ShapeToJson(const FSyntheticSpecTreeShape& Shape)
+	{
+		const TSharedRef<FJsonObject> ShapeObject = MakeShared<FJsonObject>();
+
+		ShapeObject->SetNumberField(TEXT("Depth"), Shape.Depth);
+		ShapeObject->SetNumberField(TEXT("Breadth"), Shape.Breadth);
+		ShapeObject->SetNumberField(TEXT("ItsPerLeafScope"), Shape.ItsPerLeafScope);
+		ShapeObject->SetNumberField(TEXT("LetsPerScope"), Shape.LetsPerScope);
+		ShapeObject->SetNumberField(TEXT("BeforeAllsPerScope"), Shape.BeforeAllsPerScope);
+		ShapeObject->SetNumberField(TEXT("BeforeEachesPerScope"), Shape.BeforeEachesPerScope);
+		ShapeObject->SetNumberField(TEXT("AfterEachesPerScope"), Shape.AfterEachesPerScope);
+		ShapeObject->SetNumberField(TEXT("VariableReadsPerIt"), Shape.VariableReadsPerIt);
+
+		return ShapeObject;
+	}
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FEnhancedSpecFrameworkBenchmark,
+	"EnhancedUnrealSpecs.Benchmarks.Framework",
+	EAutomationTestFlags::PerfFilter | EAutomationTestFlags::ApplicationContextMask
+)
+
+void FEnhancedSpecFrameworkBenchmark::GetTests(TArray<FString>& OutBeautifiedNames,
+                                               TArray<FString>& OutTestCommands) const
+{
+	for (const TPair<FString, FSyntheticSpecTreeShape>& Entry : EnhancedSpecFrameworkBenchmark::GetShapes())
+	{
+		OutBeautifiedNames.Add(Entry.Key);
+		OutTestCommands.Add(Entry.Key);
+	}
+}
+
+bool FEnhancedSpecFrameworkBenchmark::RunTest(const FString& Parameters)
+{
+	const TPair<FString, FSyntheticSpecTreeShape>* Entry =
+		EnhancedSpecFrameworkBenchmark::GetShapes().FindByPredicate(
+			[&Parameters](const TPair<FString, FSyntheticSpecTreeShape>& Candidate)
+			{
+				return Candidate.Key == Parameters;
+			}
+		);
+
+	if (Entry == nullptr)
+	{
+		AddError(FString::Printf(TEXT("Unknown benchmark shape '%s'."), *Parameters));
+		return false;
+	}
+
+	const FString&                ShapeName = Entry->Key;
+	FSyntheticSpecTree            Tree(FString::Printf(TEXT("FSyntheticSpecTree.FrameworkBenchmark.%s"), *ShapeName));
+	TArray<FString>               BeautifiedNames,
+	                              TestCommands;
+	int64                         NumCommands = 0;
+	const TSharedRef<FJsonObject> Results     = MakeShared<FJsonObject>();
+	FString                       ResultsJson;
+
+	Tree.Shape = Entry->Value;
+
+	const uint64 MemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+	const double DefineStart  = FPlatformTime::Seconds();
+
+	Tree.DefineSpecs();
+
+	const double PostDefineStart = FPlatformTime::Seconds();
+
+	Tree.PostDefineSpecs();
+
+	const double GetTestsStart = FPlatformTime::Seconds();
+	const uint64 MemoryAfter   = FPlatformMemory::GetStats().UsedPhysical;
+
+	Tree.GetTests(BeautifiedNames, TestCommands);
+
+	const double RunStart = FPlatformTime::Seconds();
+
+	for (const FString& TestCommand : TestCommands)
+	{
+		NumCommands += Tree.RunSpec(TestCommand);
+	}
+
+	const double RunEnd   = FPlatformTime::Seconds();
+	const int64  NumSpecs = TestCommands.Num();
+
+	TestEqual("Number of specs", NumSpecs, Tree.Shape.GetNumSpecs());
+
+	Results->SetStringField(TEXT("Shape"), ShapeName);
+	Results->SetObjectField(TEXT("ShapeParameters"), EnhancedSpecFrameworkBenchmark::ShapeToJson(Tree.Shape));
+	Results->SetNumberField(TEXT("NumScopes"), Tree.Shape.GetNumScopes());
+	Results->SetNumberField(TEXT("NumSpecs"), NumSpecs);
+	Results->SetNumberField(TEXT("NumCommands"), NumCommands);
+	Results->SetNumberField(TEXT("DefineMs"), (PostDefineStart - DefineStart) * 1000.0);
+	Results->SetNumberField(TEXT("PostDefineMs"), (GetTestsStart - PostDefineStart) * 1000.0);
+	Results->SetNumberField(TEXT("GetTestsMs"), (RunStart - GetTestsStart) * 1000.0);
+	Results->SetNumberField(TEXT("RunAllSpecsMs"), (RunEnd - RunStart) * 1000.0);
+	Results->SetNumberField(
+		TEXT("PerSpecUs"),
+		(NumSpecs > 0) ? ((RunEnd - RunStart) * 1e6 / NumSpecs) : 0.0
+	);
+	Results->SetNumberField(
+		TEXT("PerCommandNs"),
+		(NumCommands > 0) ? ((RunEnd - RunStart) * 1e9 / NumCommands) : 0.0
+	);
+	Results->SetNumberField(
+		TEXT("VariableGetNs"),
+		(Tree.NumVariableReads > 0) ? (Tree.VariableReadSeconds * 1e9 / Tree.NumVariableReads) : 0.0
+	);
+	Results->SetNumberField(
+		TEXT("DefinitionMemoryMiB"),
+		(static_cast<double>(MemoryAfter) - static_cast<double>(MemoryBefore)) / (1024.0 * 1024.0)
+	);
+
+	if (FJsonSerializer::Serialize(Results, TJsonWriterFactory<>::Create(&ResultsJson)))
+	{
+		const FString ResultsPath = FPaths::Combine(
+			EnhancedSpecFrameworkBenchmark::GetResultsDirectory(),
+			FString::Printf(TEXT("%s.json"), *ShapeName)
+		);
+
+		if (!FFileHelper::SaveStringToFile(ResultsJson, *ResultsPath))
+		{
+			AddWarning(FString::Printf(TEXT("Failed to save benchmark results to '%s'."), *ResultsPath));
+		}
+
+		AddInfo(ResultsJson);
+	}
+
+	return true;
+}
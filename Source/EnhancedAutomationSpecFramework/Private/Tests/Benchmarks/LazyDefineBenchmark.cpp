@@ -0,0 +1,61 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include <HAL/PlatformTime.h>
+
+#include <Misc/AutomationTest.h>
+
+#include "Tests/Benchmarks/SyntheticSpecTree.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FEnhancedSpecLazyDefineBenchmark,
+	"EnhancedUnrealSpecs.Benchmarks.LazyDefine",
+	EAutomationTestFlags::PerfFilter | EAutomationTestFlags::ApplicationContextMask
+)
+
+bool FEnhancedSpecLazyDefineBenchmark::RunTest(const FString& Parameters)
+{
+	FSyntheticSpecTree            EagerTree(TEXT("FSyntheticSpecTree.LazyDefineBenchmark.Eager")),
+	                              LazyTree(TEXT("FSyntheticSpecTree.LazyDefineBenchmark.Lazy"));
+	const FSyntheticSpecTreeShape Shape = LazyTree.Shape;
+	FString                       SpecId;
+	TArray<FString>               BeautifiedNames,
+	                              TestCommands;
+
+	LazyTree.bDefineLazily = true;
+
+	// The last test case of the last scope at each level, so that a lookup cannot get lucky on the first scope.
+	for (int32 Level = 0; Level < Shape.Depth; ++Level)
+	{
+		SpecId += FString::Printf(TEXT("scope %d "), Shape.Breadth - 1);
+	}
+
+	SpecId += FString::Printf(TEXT("meets expectation %d"), Shape.ItsPerLeafScope - 1);
+
+	const double EagerStart    = FPlatformTime::Seconds();
+	const int32  EagerCommands = EagerTree.RunSpec(SpecId);
+	const double LazyStart     = FPlatformTime::Seconds();
+	const int32  LazyCommands  = LazyTree.RunSpec(SpecId);
+	const double LazyEnd       = FPlatformTime::Seconds();
+
+	TestTrue("Spec was found when defined eagerly", EagerCommands > 0);
+	TestEqual("Number of commands run when defined lazily", LazyCommands, EagerCommands);
+
+	// Listing the tests has to expand every scope that is still deferred.
+	LazyTree.GetTests(BeautifiedNames, TestCommands);
+
+	TestEqual("Number of specs", static_cast<int64>(TestCommands.Num()), Shape.GetNumSpecs());
+
+	AddInfo(
+		FString::Printf(
+			TEXT("Running one of %lld specs: %.2f ms when defined eagerly, %.2f ms when defined lazily."),
+			Shape.GetNumSpecs(),
+			(LazyStart - EagerStart) * 1000.0,
+			(LazyEnd - LazyStart) * 1000.0
+		)
+	);
+
+	return true;
+}
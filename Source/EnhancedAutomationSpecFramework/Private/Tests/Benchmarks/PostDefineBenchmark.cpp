@@ -0,0 +1,122 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include <HAL/PlatformMemory.h>
+#include <HAL/PlatformTime.h>
+#include <HAL/UnrealMemory.h>
+
+#include <Misc/AutomationTest.h>
+
+#include "Tests/Benchmarks/SyntheticSpecTree.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FEnhancedSpecPostDefineBenchmark,
+	"EnhancedUnrealSpecs.Benchmarks.PostDefine",
+	EAutomationTestFlags::PerfFilter | EAutomationTestFlags::ApplicationContextMask
+)
+
+bool FEnhancedSpecPostDefineBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr double BytesPerMiB = 1024.0 * 1024.0;
+
+	// The default shape is 10,000 leaf scopes of 5 expectations each, for 50,000 specs in total.
+	FSyntheticSpecTree            Tree(TEXT("FSyntheticSpecTree.PostDefineBenchmark"));
+	const FSyntheticSpecTreeShape Shape     = Tree.Shape;
+	const int64                   NumSpecs  = Shape.GetNumSpecs(),
+	                              NumScopes = Shape.GetNumScopes();
+	int64                         NumCommandsHeld,
+	                              NumCommandsReachable,
+	                              NumCommandsCopied,
+	                              NumBytesCopied;
+	double                        FlattenEnd      = 0.0;
+	uint64                        MemoryFlattened = 0;
+	TArray<FString>               BeautifiedNames,
+	                              TestCommands;
+
+	const uint64 MemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+	const double DefineStart  = FPlatformTime::Seconds();
+
+	Tree.DefineSpecs();
+
+	const double PostDefineStart       = FPlatformTime::Seconds();
+	const uint64 MemoryBeforePostDefine = FPlatformMemory::GetStats().UsedPhysical;
+
+	Tree.PostDefineSpecs();
+
+	const double PostDefineEnd = FPlatformTime::Seconds();
+	const uint64 MemoryAfter   = FPlatformMemory::GetStats().UsedPhysical;
+
+	Tree.GetTests(BeautifiedNames, TestCommands);
+	Tree.CountSpecCommandReferences(NumCommandsHeld, NumCommandsReachable);
+
+	// Return the memory freed by Define() to the system, so that the flattened copies cannot hide in it.
+	FMemory::Trim();
+
+	const uint64 MemoryBeforeFlatten = FPlatformMemory::GetStats().UsedPhysical;
+	const double FlattenStart        = FPlatformTime::Seconds();
+
+	Tree.FlattenSpecCommands(
+		[&FlattenEnd, &MemoryFlattened]
+		{
+			FlattenEnd      = FPlatformTime::Seconds();
+			MemoryFlattened = FPlatformMemory::GetStats().UsedPhysical;
+		},
+		NumCommandsCopied,
+		NumBytesCopied
+	);
+
+	const double PostDefineSeconds = PostDefineEnd - PostDefineStart,
+	             FlattenSeconds    = FlattenEnd - FlattenStart,
+	             PostDefineMemory  = static_cast<double>(MemoryAfter) - static_cast<double>(MemoryBeforePostDefine),
+	             FlattenMemory     = static_cast<double>(MemoryFlattened) - static_cast<double>(MemoryBeforeFlatten);
+
+	TestEqual("Number of specs", static_cast<int64>(TestCommands.Num()), NumSpecs);
+	TestTrue("Scope nodes share commands between specs", NumCommandsHeld < NumCommandsReachable);
+	TestEqual("Command references copied when flattened", NumCommandsCopied, NumCommandsReachable);
+
+	// Flattening stores a shared reference for every command that each spec reaches, so at least half of that must show
+	// up as resident memory. If it does not, the resident deltas reported below do not mean anything.
+	TestTrue(
+		"Resident memory of the flattened copies reflects the number of commands copied",
+		FlattenMemory >= (NumCommandsCopied * sizeof(TSharedRef<int32>)) / 2.0
+	);
+
+	AddInfo(
+		FString::Printf(
+			TEXT("%lld specs in %lld scopes: Define() %.2f ms, PostDefine() %.2f ms, %.2f MiB resident delta ")
+			TEXT("(%.2f MiB from PostDefine())."),
+			NumSpecs,
+			NumScopes,
+			(PostDefineStart - DefineStart) * 1000.0,
+			PostDefineSeconds * 1000.0,
+			(static_cast<double>(MemoryAfter) - static_cast<double>(MemoryBefore)) / BytesPerMiB,
+			PostDefineMemory / BytesPerMiB
+		)
+	);
+
+	AddInfo(
+		FString::Printf(
+			TEXT("Command references held: %lld through the scope tree; %lld if flattened per spec."),
+			NumCommandsHeld,
+			NumCommandsReachable
+		)
+	);
+
+	// The flattened layout built the same test cases as PostDefine(), plus a copy of every command and variable table
+	// per test case, so it is emulated as PostDefine() followed by making those copies.
+	AddInfo(
+		FString::Printf(
+			TEXT("Flattened emulation: copying took %.2f ms and added %.2f MiB resident (%.2f MiB allocated); ")
+			TEXT("PostDefine() would take %.2fx as long and add %.2fx as much resident memory."),
+			FlattenSeconds * 1000.0,
+			FlattenMemory / BytesPerMiB,
+			NumBytesCopied / BytesPerMiB,
+			(PostDefineSeconds + FlattenSeconds) / FMath::Max(PostDefineSeconds, UE_DOUBLE_SMALL_NUMBER),
+			(PostDefineMemory + FlattenMemory) / FMath::Max(PostDefineMemory, 1.0)
+		)
+	);
+
+	return true;
+}
@@ -0,0 +1,89 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "Tests/Benchmarks/SyntheticSpecTree.h"
+
+#include <HAL/PlatformTime.h>
+
+void FSyntheticSpecTree::Define()
+{
+	this->DefineScope(0);
+}
+
+bool FSyntheticSpecTree::ShouldDefineLazily() const
+{
+	return this->bDefineLazily;
+}
+
+void FSyntheticSpecTree::DefineScope(const int32 Level)
+{
+	TArray<TSpecVariable<int32>> ScopeVariables;
+
+	for (int32 LetIndex = 0; LetIndex < this->Shape.LetsPerScope; ++LetIndex)
+	{
+		ScopeVariables.Add(this->Let(TGeneratorFunc<int32>([LetIndex] { return LetIndex; })));
+	}
+
+	for (int32 BlockIndex = 0; BlockIndex < this->Shape.BeforeAllsPerScope; ++BlockIndex)
+	{
+		this->BeforeAll([] {});
+	}
+
+	for (int32 BlockIndex = 0; BlockIndex < this->Shape.BeforeEachesPerScope; ++BlockIndex)
+	{
+		this->BeforeEach([] {});
+	}
+
+	for (int32 BlockIndex = 0; BlockIndex < this->Shape.AfterEachesPerScope; ++BlockIndex)
+	{
+		this->AfterEach([] {});
+	}
+
+	if (Level < this->Shape.Depth)
+	{
+		for (int32 ScopeIndex = 0; ScopeIndex < this->Shape.Breadth; ++ScopeIndex)
+		{
+			this->Describe(FString::Printf(TEXT("scope %d"), ScopeIndex), [this, Level]
+			{
+				this->DefineScope(Level + 1);
+			});
+		}
+	}
+	else
+	{
+		for (int32 ItIndex = 0; ItIndex < this->Shape.ItsPerLeafScope; ++ItIndex)
+		{
+			this->It(FString::Printf(TEXT("meets expectation %d"), ItIndex), [this, ScopeVariables]
+			{
+				this->ReadVariables(ScopeVariables);
+			});
+		}
+	}
+}
+
+void FSyntheticSpecTree::ReadVariables(const TArray<TSpecVariable<int32>>& ScopeVariables)
+{
+	int64 Checksum = 0;
+
+	// The first read of each variable in a test case generates its value, so it is not timed.
+	for (const TSpecVariable<int32>& Variable : ScopeVariables)
+	{
+		Checksum += Variable.Get();
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 ReadIndex = 0; ReadIndex < this->Shape.VariableReadsPerIt; ++ReadIndex)
+	{
+		for (const TSpecVariable<int32>& Variable : ScopeVariables)
+		{
+			Checksum += Variable.Get();
+		}
+	}
+
+	this->VariableReadSeconds += FPlatformTime::Seconds() - StartTime;
+	this->NumVariableReads    += static_cast<int64>(this->Shape.VariableReadsPerIt) * ScopeVariables.Num();
+	this->VariableChecksum    += Checksum;
+}
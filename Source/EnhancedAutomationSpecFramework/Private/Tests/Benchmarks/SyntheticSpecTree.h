@@ -0,0 +1,226 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include "EnhancedAutomationSpecBase.h"
+
+/**
+ * The shape of a synthetic tree of specs, used for benchmarking the spec framework itself.
+ *
+ * Every scope in the tree receives the same number of Let(), BeforeAll(), BeforeEach(), and AfterEach() blocks. Only
+ * the scopes at the deepest level contain It() blocks.
+ */
+struct FSyntheticSpecTreeShape
+{
+	/**
+	 * The number of levels of nested Describe() scopes below the root scope.
+	 */
+	int32 Depth = 4;
+
+	/**
+	 * The number of Describe() scopes nested directly within each scope above the deepest level.
+	 */
+	int32 Breadth = 10;
+
+	/**
+	 * The number of It() blocks within each scope at the deepest level.
+	 */
+	int32 ItsPerLeafScope = 5;
+
+	/**
+	 * The number of Let() blocks within each scope.
+	 */
+	int32 LetsPerScope = 2;
+
+	/**
+	 * The number of BeforeAll() blocks within each scope.
+	 */
+	int32 BeforeAllsPerScope = 1;
+
+	/**
+	 * The number of BeforeEach() blocks within each scope.
+	 */
+	int32 BeforeEachesPerScope = 2;
+
+	/**
+	 * The number of AfterEach() blocks within each scope.
+	 */
+	int32 AfterEachesPerScope = 1;
+
+	/**
+	 * The number of times that each It() block reads every variable defined by the Let() blocks of its own scope,
+	 * after the first read that generates the value of each variable.
+	 */
+	int32 VariableReadsPerIt = 4;
+
+	/**
+	 * Gets the total number of scopes in the tree, including the root scope.
+	 *
+	 * @return
+	 *	The number of scopes.
+	 */
+	int64 GetNumScopes() const
+	{
+		int64 NumScopes        = 0,
+		      NumScopesAtLevel = 1;
+
+		for (int32 Level = 0; Level <= this->Depth; ++Level)
+		{
+			NumScopes        += NumScopesAtLevel;
+			NumScopesAtLevel *= this->Breadth;
+		}
+
+		return NumScopes;
+	}
+
+	/**
+	 * Gets the total number of test cases (It() blocks) in the tree.
+	 *
+	 * @return
+	 *	The number of test cases.
+	 */
+	int64 GetNumSpecs() const
+	{
+		int64 NumLeafScopes = 1;
+
+		for (int32 Level = 0; Level < this->Depth; ++Level)
+		{
+			NumLeafScopes *= this->Breadth;
+		}
+
+		return NumLeafScopes * this->ItsPerLeafScope;
+	}
+};
+
+/**
+ * A spec that defines a synthetic tree of scopes and expectations according to a configurable shape.
+ *
+ * Instances are created on demand by benchmarks. Each instance registers itself with the automation framework under
+ * the name it is given, so each instance that is alive at the same time must have a unique name.
+ */
+BEGIN_DEFINE_ENH_SPEC_PRIVATE(
+	FSyntheticSpecTree,
+	"EnhancedUnrealSpecs.Benchmarks.SyntheticSpecTree",
+	EAutomationTestFlags::PerfFilter | EAutomationTestFlags::ApplicationContextMask,
+	__FILE__,
+	__LINE__
+)
+public:
+	/**
+	 * The shape of the tree to define.
+	 */
+	FSyntheticSpecTreeShape Shape;
+
+	/**
+	 * Whether the scopes of the tree are only defined once a test case within them is looked up.
+	 */
+	bool bDefineLazily = false;
+
+	/**
+	 * Defines all scopes and expectations of the tree, without converting them into executable tests.
+	 */
+	void DefineSpecs()
+	{
+		this->Define();
+	}
+
+	/**
+	 * Converts the scopes and expectations of the tree into executable tests.
+	 */
+	void PostDefineSpecs()
+	{
+		this->PostDefine();
+	}
+
+	/**
+	 * Counts the references to commands held by the test cases of the tree, once they have been converted.
+	 *
+	 * @param OutNumHeld
+	 *	Receives the number of command references actually held by the scope nodes and test cases of the tree.
+	 * @param OutNumReachable
+	 *	Receives the number of command references that would be held if each test case had its own copy of the
+	 *	commands of all enclosing scopes.
+	 */
+	void CountSpecCommandReferences(int64& OutNumHeld, int64& OutNumReachable) const
+	{
+		this->CountCommandReferences(OutNumHeld, OutNumReachable);
+	}
+
+	/**
+	 * Copies the commands of all enclosing scopes into each test case of the tree, as the framework did before scopes
+	 * shared their commands, and keeps the copies until the given callback returns.
+	 *
+	 * @param WhileFlattened
+	 *	The callback to invoke while the copies exist.
+	 * @param OutNumCommandsCopied
+	 *	Receives the number of command references that were copied.
+	 * @param OutNumBytesCopied
+	 *	Receives the number of bytes allocated for the copies.
+	 */
+	void FlattenSpecCommands(const TFunction<void()>& WhileFlattened,
+	                         int64&                   OutNumCommandsCopied,
+	                         int64&                   OutNumBytesCopied) const
+	{
+		this->EmulateFlattenedSpecs(WhileFlattened, OutNumCommandsCopied, OutNumBytesCopied);
+	}
+
+	/**
+	 * The total time that It() blocks have spent reading variables that already had values, in seconds.
+	 */
+	double VariableReadSeconds = 0.0;
+
+	/**
+	 * The total number of timed variable reads performed by It() blocks.
+	 */
+	int64 NumVariableReads = 0;
+
+	/**
+	 * The sum of all values read from variables, which keeps the compiler from discarding the reads.
+	 */
+	int64 VariableChecksum = 0;
+
+	/**
+	 * Discards all definitions so that the tree can be defined again.
+	 */
+	void ResetSpecs()
+	{
+		this->Redefine();
+	}
+
+	/**
+	 * Runs all commands of a test case of the tree to completion on the calling thread.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case to run.
+	 *
+	 * @return
+	 *	The number of commands that were run.
+	 */
+	int32 RunSpec(const FString& SpecId)
+	{
+		return this->RunSpecImmediately(SpecId);
+	}
+
+protected:
+	virtual bool ShouldDefineLazily() const override;
+
+private:
+	/**
+	 * Defines the blocks of one scope of the tree, then the scopes nested within it.
+	 *
+	 * @param Level
+	 *	The level of the scope being defined, where the root scope is level 0.
+	 */
+	void DefineScope(const int32 Level);
+
+	/**
+	 * Reads the variables of a scope as an It() block of the tree, timing all reads after the first.
+	 *
+	 * @param ScopeVariables
+	 *	The variables defined by the Let() blocks of the scope that contains the It() block.
+	 */
+	void ReadVariables(const TArray<TSpecVariable<int32>>& ScopeVariables);
+};
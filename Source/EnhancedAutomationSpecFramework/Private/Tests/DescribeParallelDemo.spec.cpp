@@ -0,0 +1,38 @@
+﻿#include "EnhancedAutomationSpecBase.h"
+
+DEFINE_ENH_SPEC(FDescribeParallelDemoSpec,
+                "EnhancedUnrealSpecs.Demo.DescribeParallel",
+                EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask);
+
+void FDescribeParallelDemoSpec::Define()
+{
+	DescribeParallel("DescribeParallel()", [=, this]
+	{
+		// Each expectation gets its own copy of this variable, even while other expectations are using theirs.
+		LET(Numbers, TArray<int32>, [], { return TArray<int32>({ 3, 1, 2 }); });
+
+		BeforeEach([=, this]
+		{
+			(*Numbers).Sort();
+		});
+
+		It("sorts the numbers before each expectation", [=, this]
+		{
+			TestTrue("Numbers", *Numbers == TArray<int32>({ 1, 2, 3 }));
+		});
+
+		It("does not see changes that other expectations make to the numbers", [=, this]
+		{
+			(*Numbers).Add(4);
+
+			TestTrue("Numbers", *Numbers == TArray<int32>({ 1, 2, 3, 4 }));
+		});
+
+		It("does not see changes that other expectations make to the numbers, either", [=, this]
+		{
+			(*Numbers).RemoveAt(0);
+
+			TestTrue("Numbers", *Numbers == TArray<int32>({ 2, 3 }));
+		});
+	});
+}
@@ -3,8 +3,104 @@
 // This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
 // this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
 
+#include <HAL/PlatformProcess.h>
+#include <HAL/PlatformTime.h>
+
+#include <Misc/App.h>
+
 #include "EnhancedAutomationSpecBase.h"
 
+/**
+ * A spec whose parallel test cases are each run through a separate call by the spec below, the way that the automation
+ * controller runs them.
+ */
+BEGIN_DEFINE_ENH_SPEC_PRIVATE(
+	FParallelBatchProbeSpec,
+	"EnhancedUnrealSpecs.EnhancedAutomationSpecBase.ParallelBatchProbe",
+	EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask,
+	__FILE__,
+	__LINE__
+)
+	/**
+	 * The number of test cases that have arrived at the latch.
+	 */
+	FThreadSafeCounter NumArrived;
+
+	/**
+	 * The number of test cases that saw every other test case arrive at the latch while they were waiting there.
+	 */
+	FThreadSafeCounter NumOverlapped;
+
+public:
+	/**
+	 * Runs all commands of a test case of this spec to completion.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case to run.
+	 */
+	void RunSpec(const FString& SpecId)
+	{
+		this->RunSpecImmediately(SpecId);
+	}
+
+	/**
+	 * Gets how many test cases were running at the same time as each other.
+	 *
+	 * @return
+	 *	The number of test cases that saw every other test case arrive at the latch while they were waiting there.
+	 */
+	int32 GetNumOverlapped() const
+	{
+		return this->NumOverlapped.GetValue();
+	}
+
+protected:
+	virtual bool GetRequestedTestNames(TSet<FString>& OutTestNames) const override
+	{
+		OutTestNames.Add(FString::Printf(TEXT("%s in parallel first spec"), *this->TestName));
+		OutTestNames.Add(FString::Printf(TEXT("%s in parallel second spec"), *this->TestName));
+
+		return true;
+	}
+
+private:
+	/**
+	 * Waits, for a limited time, until both test cases of this spec have arrived.
+	 */
+	void ArriveAtLatch()
+	{
+		const double Deadline = FPlatformTime::Seconds() + 1.0;
+
+		this->NumArrived.Increment();
+
+		while ((this->NumArrived.GetValue() < 2) && (FPlatformTime::Seconds() < Deadline))
+		{
+			FPlatformProcess::Sleep(0.001f);
+		}
+
+		if (this->NumArrived.GetValue() >= 2)
+		{
+			this->NumOverlapped.Increment();
+		}
+	}
+};
+
+void FParallelBatchProbeSpec::Define()
+{
+	DescribeParallel("in parallel", [this]
+	{
+		It("first spec", [this]
+		{
+			this->ArriveAtLatch();
+		});
+
+		It("second spec", [this]
+		{
+			this->ArriveAtLatch();
+		});
+	});
+}
+
 BEGIN_DEFINE_ENH_SPEC(FEnhancedAutomationSpecBaseSpec,
                       "EnhancedUnrealSpecs.EnhancedAutomationSpecBase",
                       EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
@@ -49,6 +145,11 @@ BEGIN_DEFINE_ENH_SPEC(FEnhancedAutomationSpecBaseSpec,
 	bool bBeforeAllBlock1Ran;
 	bool bBeforeAllBlock2Ran;
 
+	FThreadSafeCounter ParallelBeforeAllRunCount;
+
+	int32 AfterAllRunCount;
+	FString AfterAllRunOrder;
+
 	struct FTestObject
 	{
 		FString SomeValue;
@@ -57,6 +158,8 @@ BEGIN_DEFINE_ENH_SPEC(FEnhancedAutomationSpecBaseSpec,
 		{
 		}
 	};
+
+	TWeakPtr<FTestObject> ObjectFromPriorTest;
 END_DEFINE_ENH_SPEC(FEnhancedAutomationSpecBaseSpec)
 
 void FEnhancedAutomationSpecBaseSpec::Define()
@@ -153,6 +256,55 @@ void FEnhancedAutomationSpecBaseSpec::Define()
 				});
 			});
 
+			Describe("when the type of the variable is not default-constructible", [=, this]
+			{
+				LET(MyObject, FTestObject, [], { return FTestObject("ABC"); });
+
+				It("constructs the value from the result of the generator", [=, this]
+				{
+					TestEqual("MyObject.SomeValue", (*MyObject).SomeValue, "ABC");
+				});
+			});
+
+			Describe("when a test has finished", [=, this]
+			{
+				LET(MyObject, TSharedPtr<FTestObject>, [], { return MakeShared<FTestObject>("ABC"); });
+
+				It("keeps the value alive while the test is running", [=, this]
+				{
+					this->ObjectFromPriorTest = *MyObject;
+
+					TestTrue("ObjectFromPriorTest.IsValid()", this->ObjectFromPriorTest.IsValid());
+				});
+
+				It("destroys the values that were generated during the test", [=, this]
+				{
+					TestFalse("ObjectFromPriorTest.IsValid()", this->ObjectFromPriorTest.IsValid());
+				});
+			});
+
+			Describe("when a redefinition changes the original value via its reference", [=, this]
+			{
+				LET(MyVariable, FString, [], { return "ABC"; });
+
+				REDEFINE_LET(MyVariable, FString, [], {
+					**Previous += "DEF";
+					return **Previous;
+				});
+
+				It("regenerates the original value for the first test", [=, this]
+				{
+					// ReSharper disable once StringLiteralTypo
+					TestEqual("MyVariable", *MyVariable, "ABCDEF");
+				});
+
+				It("regenerates the original value for other tests", [=, this]
+				{
+					// ReSharper disable once StringLiteralTypo
+					TestEqual("MyVariable", *MyVariable, "ABCDEF");
+				});
+			});
+
 			Describe("when the same variable is redefined in a nested scope", [=, this]
 			{
 				Describe("when the redefinition does not reference the original value", [=, this]
@@ -617,4 +769,175 @@ void FEnhancedAutomationSpecBaseSpec::Define()
 			});
 		});
 	});
+
+	Describe("AfterAll()", [=, this]
+	{
+		BeforeAll([=, this]
+		{
+			this->AfterAllRunCount = 0;
+			this->AfterAllRunOrder = TEXT("");
+		});
+
+		Describe("when running tests in the first block and its AfterAll() blocks have not yet run", [=, this]
+		{
+			AfterAll([=, this]
+			{
+				++this->AfterAllRunCount;
+				this->AfterAllRunOrder += TEXT("A");
+			});
+
+			AfterAll([=, this]
+			{
+				this->AfterAllRunOrder += TEXT("B");
+			});
+
+			LatentAfterAll([=, this](const FDoneDelegate& Done)
+			{
+				this->AfterAllRunOrder += TEXT("C");
+				Done.Execute();
+			});
+
+			It("does not run AfterAll() before the first test of its scope", [=, this]
+			{
+				TestEqual("RunCount", this->AfterAllRunCount, 0);
+			});
+
+			It("does not run AfterAll() before the last test of its scope", [=, this]
+			{
+				TestEqual("RunCount", this->AfterAllRunCount, 0);
+			});
+
+			Describe("when a nested scope has its own AfterAll() block", [=, this]
+			{
+				AfterAll([=, this]
+				{
+					this->AfterAllRunOrder += TEXT("I");
+				});
+
+				It("does not run the AfterAll() of the enclosing scope", [=, this]
+				{
+					TestEqual("RunCount", this->AfterAllRunCount, 0);
+				});
+			});
+		});
+
+		Describe("when running tests in the second block after the first block has finished", [=, this]
+		{
+			It("has run each AfterAll() of the first block once", [=, this]
+			{
+				TestEqual("RunCount", this->AfterAllRunCount, 1);
+			});
+
+			It("runs AfterAll() of the inner-most scope first, and the blocks of each scope last block first", [=, this]
+			{
+				TestEqual("RunOrder", this->AfterAllRunOrder, TEXT("ICBA"));
+			});
+		});
+	});
+
+	Describe("DescribeParallel()", [=, this]
+	{
+		BeforeAll([=, this]
+		{
+			this->ParallelBeforeAllRunCount.Reset();
+		});
+
+		DescribeParallel("when specs in the scope are independent", [=, this]
+		{
+			LET(Variable, FString, [], { return "ABC"; });
+
+			BeforeAll([=, this]
+			{
+				this->ParallelBeforeAllRunCount.Increment();
+			});
+
+			BeforeEach([=, this]
+			{
+				*Variable += "XYZ";
+			});
+
+			It("only runs each BeforeAll() once", [=, this]
+			{
+				TestEqual("RunCount", this->ParallelBeforeAllRunCount.GetValue(), 1);
+			});
+
+			for (int32 SpecIndex = 0; SpecIndex < 16; ++SpecIndex)
+			{
+				It(FString::Printf(TEXT("gives spec %d its own copy of each variable"), SpecIndex), [=, this]
+				{
+					*Variable += FString::FromInt(SpecIndex);
+
+					// ReSharper disable once StringLiteralTypo
+					TestEqual("Variable", *Variable, FString::Printf(TEXT("ABCXYZ%d"), SpecIndex));
+				});
+			}
+
+			Describe("when the variable is redefined in a nested scope", [=, this]
+			{
+				REDEFINE_LET(Variable, FString, [], { return "Inner"; });
+
+				It("provides the redefined value to the outer BeforeEach() block", [=, this]
+				{
+					// ReSharper disable once StringLiteralTypo
+					TestEqual("Variable", *Variable, "InnerXYZ");
+				});
+			});
+
+			Describe("when a spec in the scope is latent", [=, this]
+			{
+				LatentIt("runs the spec sequentially with its own variables", [=, this](const FDoneDelegate& Done)
+				{
+					// ReSharper disable once StringLiteralTypo
+					TestEqual("Variable", *Variable, "ABCXYZ");
+
+					Done.Execute();
+				});
+			});
+		});
+
+		It("runs the requested specs of a scope together, even when each is run by a separate call", [=, this]
+		{
+			if (!FApp::ShouldUseThreadingForPerformance())
+			{
+				AddInfo(TEXT("Skipped, since parallel batches run on a single thread in this process."));
+				return;
+			}
+
+			const TSharedRef<FParallelBatchProbeSpec> Probe =
+				MakeShared<FParallelBatchProbeSpec>(TEXT("FEnhancedAutomationSpecBaseSpec.ParallelBatchProbe"));
+
+			Probe->RunSpec(TEXT("in parallel first spec"));
+			Probe->RunSpec(TEXT("in parallel second spec"));
+
+			TestEqual("NumOverlapped", Probe->GetNumOverlapped(), 2);
+		});
+	});
+
+	Describe("Cancellation tokens", [=, this]
+	{
+		It("does not provide a token to synchronous blocks", [=, this]
+		{
+			TestFalse("GetCancellationToken().IsValid()", this->GetCancellationToken().IsValid());
+			TestFalse("IsCancellationRequested()", this->IsCancellationRequested());
+		});
+
+		It("provides a token that has not been canceled to asynchronous blocks", EAsyncExecution::ThreadPool, [=, this]
+		{
+			const TSharedPtr<FSpecCancellationToken> Token = this->GetCancellationToken();
+
+			if (TestTrue("Token.IsValid()", Token.IsValid()))
+			{
+				TestFalse("Token->IsCanceled()", Token->IsCanceled());
+			}
+
+			TestFalse("IsCancellationRequested()", this->IsCancellationRequested());
+		});
+
+		LatentIt("provides a token to latent blocks", EAsyncExecution::ThreadPool, [=, this](const FDoneDelegate& Done)
+		{
+			TestTrue("GetCancellationToken().IsValid()", this->GetCancellationToken().IsValid());
+
+			Done.Execute();
+		});
+	});
 }
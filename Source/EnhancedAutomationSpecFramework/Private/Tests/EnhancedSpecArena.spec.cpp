@@ -0,0 +1,142 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecArena.h"
+
+namespace EnhancedSpecArenaSpec
+{
+	/**
+	 * An object that records when it has been destroyed.
+	 */
+	struct FTrackedObject
+	{
+		/**
+		 * The flag to raise when this object is destroyed.
+		 */
+		bool& bWasDestroyed;
+
+		/**
+		 * Constructs a new instance.
+		 *
+		 * @param bWasDestroyed
+		 *	The flag to raise when this object is destroyed.
+		 */
+		explicit FTrackedObject(bool& bWasDestroyed) : bWasDestroyed(bWasDestroyed)
+		{
+		}
+
+		/**
+		 * Destructor. Raises the flag.
+		 */
+		~FTrackedObject()
+		{
+			this->bWasDestroyed = true;
+		}
+	};
+
+	/**
+	 * An object that can hand out shared references to itself.
+	 */
+	struct FSharedObject : TSharedFromThis<FSharedObject>
+	{
+	};
+
+	/**
+	 * An object that requires more alignment than the objects around it.
+	 */
+	struct alignas(64) FOverAlignedObject
+	{
+		uint8 Value = 0;
+	};
+}
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecArenaSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecArena",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecArenaSpec)
+
+void FEnhancedSpecArenaSpec::Define()
+{
+	using namespace EnhancedSpecArenaSpec;
+
+	Describe("New()", [=, this]
+	{
+		It("destroys each object when its last reference is released", [=, this]
+		{
+			const TSharedRef<FEnhancedSpecArena> Arena         = MakeShared<FEnhancedSpecArena>();
+			bool                                 bWasDestroyed = false;
+			TSharedPtr<FTrackedObject>           Object        = Arena->New<FTrackedObject>(bWasDestroyed);
+
+			TestFalse("Destroyed while referenced", bWasDestroyed);
+
+			Object.Reset();
+
+			TestTrue("Destroyed after release", bWasDestroyed);
+		});
+
+		It("keeps the arena alive while objects created in it are still referenced", [=, this]
+		{
+			TSharedPtr<FEnhancedSpecArena>     Arena     = MakeShared<FEnhancedSpecArena>();
+			const TWeakPtr<FEnhancedSpecArena> WeakArena = Arena;
+			const TSharedRef<int32>            Object    = Arena->New<int32>(42);
+
+			Arena.Reset();
+
+			TestTrue("Arena is alive", WeakArena.IsValid());
+			TestEqual("Object", *Object, 42);
+		});
+
+		It("releases the arena once every object created in it is destroyed, even if weakly referenced", [=, this]
+		{
+			TSharedPtr<FEnhancedSpecArena>     Arena      = MakeShared<FEnhancedSpecArena>();
+			const TWeakPtr<FEnhancedSpecArena> WeakArena  = Arena;
+			TSharedPtr<int32>                  Object     = Arena->New<int32>(42);
+			const TWeakPtr<int32>              WeakObject = Object;
+
+			Arena.Reset();
+
+			TestTrue("Arena is alive while the object is referenced", WeakArena.IsValid());
+
+			Object.Reset();
+
+			TestFalse("Object is alive", WeakObject.IsValid());
+			TestFalse("Arena is alive after the object is destroyed", WeakArena.IsValid());
+		});
+
+		It("supports objects that share references to themselves", [=, this]
+		{
+			const TSharedRef<FEnhancedSpecArena> Arena  = MakeShared<FEnhancedSpecArena>();
+			const TSharedRef<FSharedObject>      Object = Arena->New<FSharedObject>();
+
+			TestTrue("AsShared() is the same object", Object->AsShared() == Object);
+		});
+
+		It("aligns each object as its type requires", [=, this]
+		{
+			const TSharedRef<FEnhancedSpecArena> Arena  = MakeShared<FEnhancedSpecArena>();
+
+			// A single byte first, so that the next free byte of the block is not already aligned.
+			const TSharedRef<uint8>              Byte   = Arena->New<uint8>(static_cast<uint8>(1));
+			const TSharedRef<FOverAlignedObject> Object = Arena->New<FOverAlignedObject>();
+
+			TestTrue("Object is aligned", IsAligned(&Object.Get(), alignof(FOverAlignedObject)));
+		});
+
+		It("packs small objects into shared blocks", [=, this]
+		{
+			const TSharedRef<FEnhancedSpecArena> Arena = MakeShared<FEnhancedSpecArena>();
+			TArray<TSharedRef<int64>>            Objects;
+
+			for (int32 Index = 0; Index < 1000; ++Index)
+			{
+				Objects.Add(Arena->New<int64>(Index));
+			}
+
+			TestEqual("GetNumBytesUsed()", Arena->GetNumBytesUsed(), 1000 * sizeof(int64));
+			TestEqual("GetNumBytesAllocated()", Arena->GetNumBytesAllocated(), static_cast<SIZE_T>(64 * 1024));
+		});
+	});
+}
@@ -0,0 +1,303 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecBenchmark.h"
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecBenchmarkSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecBenchmark",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecBenchmarkSpec)
+
+void FEnhancedSpecBenchmarkSpec::Define()
+{
+	Describe("FEnhancedSpecBenchmarkResult", [=, this]
+	{
+		Describe("GetPercentile()", [=, this]
+		{
+			It("returns the middle value for the 50th percentile", [=, this]
+			{
+				TestEqual(
+					"GetPercentile()",
+					FEnhancedSpecBenchmarkResult::GetPercentile({ 1.0, 2.0, 3.0, 4.0, 5.0 }, 50.0),
+					3.0
+				);
+			});
+
+			It("interpolates between the two nearest values", [=, this]
+			{
+				TestEqual(
+					"GetPercentile()",
+					FEnhancedSpecBenchmarkResult::GetPercentile({ 1.0, 2.0, 3.0, 4.0, 5.0 }, 95.0),
+					4.8,
+					1e-9
+				);
+			});
+
+			It("returns the first and last values for the 0th and 100th percentiles", [=, this]
+			{
+				TestEqual(
+					"GetPercentile(0)",
+					FEnhancedSpecBenchmarkResult::GetPercentile({ 1.0, 2.0, 3.0 }, 0.0),
+					1.0
+				);
+
+				TestEqual(
+					"GetPercentile(100)",
+					FEnhancedSpecBenchmarkResult::GetPercentile({ 1.0, 2.0, 3.0 }, 100.0),
+					3.0
+				);
+			});
+		});
+
+		Describe("FromSamples()", [=, this]
+		{
+			It("rejects samples far from the median as outliers", [=, this]
+			{
+				const FEnhancedSpecBenchmarkResult Result =
+					FEnhancedSpecBenchmarkResult::FromSamples({ 4.0, 100.0, 1.0, 3.0, 2.0 }, 8, 3.0);
+
+				TestEqual("Result.IterationsPerSample", Result.IterationsPerSample, static_cast<int64>(8));
+				TestEqual("Result.NumSamples", Result.NumSamples, 5);
+				TestEqual("Result.NumOutliers", Result.NumOutliers, 1);
+				TestEqual("Result.MinSeconds", Result.MinSeconds, 1.0);
+				TestEqual("Result.MedianSeconds", Result.MedianSeconds, 2.5);
+				TestEqual("Result.MeanSeconds", Result.MeanSeconds, 2.5);
+			});
+
+			It("computes the tail percentiles and the maximum over all samples, including outliers", [=, this]
+			{
+				const FEnhancedSpecBenchmarkResult Result =
+					FEnhancedSpecBenchmarkResult::FromSamples({ 4.0, 100.0, 1.0, 3.0, 2.0 }, 1, 3.0);
+
+				TestEqual("Result.NumOutliers", Result.NumOutliers, 1);
+				TestEqual("Result.P95Seconds", Result.P95Seconds, 80.8, 1e-9);
+				TestEqual("Result.P99Seconds", Result.P99Seconds, 96.16, 1e-9);
+				TestEqual("Result.MaxSeconds", Result.MaxSeconds, 100.0);
+			});
+
+			It("computes the median absolute deviation over all samples", [=, this]
+			{
+				const FEnhancedSpecBenchmarkResult Result =
+					FEnhancedSpecBenchmarkResult::FromSamples({ 4.0, 100.0, 1.0, 3.0, 2.0 }, 1, 3.0);
+
+				TestEqual("Result.MadSeconds", Result.MadSeconds, 1.0);
+			});
+
+			It("keeps every sample when the threshold is 0", [=, this]
+			{
+				const FEnhancedSpecBenchmarkResult Result =
+					FEnhancedSpecBenchmarkResult::FromSamples({ 4.0, 100.0, 1.0, 3.0, 2.0 }, 1, 0.0);
+
+				TestEqual("Result.NumOutliers", Result.NumOutliers, 0);
+				TestEqual("Result.MaxSeconds", Result.MaxSeconds, 100.0);
+			});
+
+			It("keeps every sample when most samples are identical", [=, this]
+			{
+				const FEnhancedSpecBenchmarkResult Result =
+					FEnhancedSpecBenchmarkResult::FromSamples({ 2.0, 2.0, 5.0, 2.0 }, 1, 3.0);
+
+				TestEqual("Result.MadSeconds", Result.MadSeconds, 0.0);
+				TestEqual("Result.NumOutliers", Result.NumOutliers, 0);
+				TestEqual("Result.MaxSeconds", Result.MaxSeconds, 5.0);
+			});
+
+			It("reports no statistics when there are no samples", [=, this]
+			{
+				const FEnhancedSpecBenchmarkResult Result = FEnhancedSpecBenchmarkResult::FromSamples({}, 1, 3.0);
+
+				TestEqual("Result.NumSamples", Result.NumSamples, 0);
+				TestEqual("Result.MedianSeconds", Result.MedianSeconds, 0.0);
+			});
+		});
+	});
+
+	Describe("FEnhancedSpecBenchmarkBudget", [=, this]
+	{
+		Describe("Check()", [=, this]
+		{
+			LET(Result, FEnhancedSpecBenchmarkResult, [], {
+				FEnhancedSpecBenchmarkResult NewResult;
+
+				NewResult.NumSamples    = 10;
+				NewResult.MedianSeconds = 0.001;
+				NewResult.P95Seconds    = 0.001;
+				NewResult.P99Seconds    = 0.001;
+
+				return NewResult;
+			});
+
+			LET(Baseline, FEnhancedSpecBenchmarkResult, [], {
+				FEnhancedSpecBenchmarkResult NewBaseline;
+
+				NewBaseline.NumSamples    = 10;
+				NewBaseline.MedianSeconds = 0.001;
+				NewBaseline.P95Seconds    = 0.001;
+				NewBaseline.P99Seconds    = 0.001;
+
+				return NewBaseline;
+			});
+
+			It("accepts any results when no limits are set", [=, this]
+			{
+				const FEnhancedSpecBenchmarkBudget Budget;
+
+				(*Result).MedianSeconds = 10.0;
+				(*Result).P95Seconds    = 20.0;
+				(*Result).P99Seconds    = 20.0;
+
+				TestEqual("Check().Num()", Budget.Check(*Result, &*Baseline).Num(), 0);
+			});
+
+			It("flags a 99th percentile over its limit", [=, this]
+			{
+				FEnhancedSpecBenchmarkBudget Budget;
+
+				Budget.MaxP99Seconds = 0.002;
+
+				(*Result).P99Seconds = 0.002;
+				TestEqual("Check().Num() within budget", Budget.Check(*Result, nullptr).Num(), 0);
+
+				(*Result).P99Seconds = 0.003;
+				TestEqual("Check().Num() over budget", Budget.Check(*Result, nullptr).Num(), 1);
+			});
+
+			It("flags a median slower than the baseline by more than its limit", [=, this]
+			{
+				FEnhancedSpecBenchmarkBudget Budget;
+
+				Budget.MaxMedianRegression = 0.05;
+
+				(*Result).MedianSeconds = 0.00104;
+				TestEqual("Check().Num() within budget", Budget.Check(*Result, &*Baseline).Num(), 0);
+
+				(*Result).MedianSeconds = 0.00106;
+				TestEqual("Check().Num() over budget", Budget.Check(*Result, &*Baseline).Num(), 1);
+			});
+
+			It("accepts a median faster than the baseline", [=, this]
+			{
+				FEnhancedSpecBenchmarkBudget Budget;
+
+				Budget.MaxMedianRegression = 0.05;
+
+				(*Result).MedianSeconds = 0.0005;
+
+				TestEqual("Check().Num()", Budget.Check(*Result, &*Baseline).Num(), 0);
+			});
+
+			It("flags instructions per iteration over their limit", [=, this]
+			{
+				FEnhancedSpecBenchmarkBudget Budget;
+
+				Budget.MaxInstructions = 1000.0;
+
+				(*Result).PerfCounters.Instructions = 900.0;
+				TestEqual("Check().Num() within budget", Budget.Check(*Result, nullptr).Num(), 0);
+
+				(*Result).PerfCounters.Instructions = 1100.0;
+				TestEqual("Check().Num() over budget", Budget.Check(*Result, nullptr).Num(), 1);
+			});
+
+			It("flags more instructions than the baseline by more than their limit", [=, this]
+			{
+				FEnhancedSpecBenchmarkBudget Budget;
+
+				Budget.MaxInstructionsRegression = 0.01;
+
+				(*Baseline).PerfCounters.Instructions = 1000.0;
+
+				(*Result).PerfCounters.Instructions = 1005.0;
+				TestEqual("Check().Num() within budget", Budget.Check(*Result, &*Baseline).Num(), 0);
+
+				(*Result).PerfCounters.Instructions = 1020.0;
+				TestEqual("Check().Num() over budget", Budget.Check(*Result, &*Baseline).Num(), 1);
+			});
+
+			It("skips instruction limits when instructions were not counted", [=, this]
+			{
+				FEnhancedSpecBenchmarkBudget Budget;
+
+				Budget.MaxInstructions           = 1000.0;
+				Budget.MaxInstructionsRegression = 0.01;
+
+				(*Baseline).PerfCounters.Instructions = 10.0;
+
+				TestTrue("UsesPerfCounters()", Budget.UsesPerfCounters());
+				TestEqual("Check().Num()", Budget.Check(*Result, &*Baseline).Num(), 0);
+			});
+
+			It("skips limits relative to the baseline when there is no baseline", [=, this]
+			{
+				FEnhancedSpecBenchmarkBudget Budget;
+
+				Budget.MaxMedianRegression = 0.05;
+
+				(*Result).MedianSeconds = 1.0;
+
+				TestTrue("IsRelativeToBaseline()", Budget.IsRelativeToBaseline());
+				TestEqual("Check().Num()", Budget.Check(*Result, nullptr).Num(), 0);
+			});
+		});
+	});
+
+	Describe("FEnhancedSpecBenchmark", [=, this]
+	{
+		Describe("Run()", [=, this]
+		{
+			LET(Options, FEnhancedSpecBenchmarkOptions, [], {
+				FEnhancedSpecBenchmarkOptions NewOptions;
+
+				NewOptions.WarmupSeconds    = 0.0;
+				NewOptions.MinSampleSeconds = 0.0;
+				NewOptions.NumSamples       = 10;
+				NewOptions.MinNumSamples    = 5;
+				NewOptions.MaxSeconds       = 1.0;
+
+				return NewOptions;
+			});
+
+			It("takes the requested number of samples after running the body once", [=, this]
+			{
+				int32                              NumRuns = 0;
+				const FEnhancedSpecBenchmarkResult Result  = FEnhancedSpecBenchmark::Run(
+					[&NumRuns]
+					{
+						++NumRuns;
+					},
+					*Options,
+					[]
+					{
+						return false;
+					}
+				);
+
+				TestEqual("Result.NumSamples", Result.NumSamples, 10);
+				TestEqual("Result.IterationsPerSample", Result.IterationsPerSample, static_cast<int64>(1));
+				TestEqual("NumRuns", NumRuns, 11);
+			});
+
+			It("stops without results when asked to stop", [=, this]
+			{
+				int32                              NumRuns = 0;
+				const FEnhancedSpecBenchmarkResult Result  = FEnhancedSpecBenchmark::Run(
+					[&NumRuns]
+					{
+						++NumRuns;
+					},
+					*Options,
+					[]
+					{
+						return true;
+					}
+				);
+
+				TestEqual("Result.NumSamples", Result.NumSamples, 0);
+				TestEqual("NumRuns", NumRuns, 1);
+			});
+		});
+	});
+}
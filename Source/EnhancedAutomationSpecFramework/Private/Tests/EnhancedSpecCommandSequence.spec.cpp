@@ -0,0 +1,350 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include <Async/Async.h>
+
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformProcess.h>
+
+#include "EnhancedAutomationSpecBase.h"
+
+/**
+ * A spec whose test cases are run, one simulated frame at a time, by the spec below.
+ */
+BEGIN_DEFINE_ENH_SPEC_PRIVATE(
+	FCommandSequenceProbeSpec,
+	"EnhancedUnrealSpecs.EnhancedSpecCommandSequence.Probe",
+	EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask,
+	__FILE__,
+	__LINE__
+)
+public:
+	/**
+	 * Runs all commands of a test case of this spec to completion.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case to run.
+	 *
+	 * @return
+	 *	The number of frames that the automation framework would have spent running the test case.
+	 */
+	int32 RunSpecInFrames(const FString& SpecId)
+	{
+		int32 NumFrames;
+
+		this->RunSpecImmediately(SpecId, NumFrames);
+
+		return NumFrames;
+	}
+
+	/**
+	 * Gets whether any test case of this spec has reported an error.
+	 *
+	 * @return
+	 *	true if an error has been reported; or, false otherwise.
+	 */
+	bool HasReportedErrors() const
+	{
+		return this->HasAnyErrors();
+	}
+};
+
+void FCommandSequenceProbeSpec::Define()
+{
+	It("runs synchronous blocks", []
+	{
+	});
+
+	Describe("with a slow block", [this]
+	{
+		BeforeEach([]
+		{
+			FPlatformProcess::Sleep(0.02f);
+		});
+
+		It("runs", []
+		{
+		});
+	});
+
+	LatentIt("finishes a latent block from another thread", [](const FDoneDelegate& Done)
+	{
+		Async(EAsyncExecution::ThreadPool, [Done]
+		{
+			FPlatformProcess::Sleep(0.02f);
+			Done.Execute();
+		});
+	});
+
+	LatentIt("never finishes a latent block", FTimespan::FromMilliseconds(50), [](const FDoneDelegate& Done)
+	{
+	});
+
+	It("finishes an asynchronous block", EAsyncExecution::ThreadPool, []
+	{
+		FPlatformProcess::Sleep(0.02f);
+	});
+
+	LatentIt(
+		"never finishes an asynchronous block",
+		EAsyncExecution::ThreadPool,
+		FTimespan::FromMilliseconds(50),
+		[](const FDoneDelegate& Done)
+		{
+			FPlatformProcess::Sleep(0.2f);
+		}
+	);
+}
+
+/**
+ * A spec whose synchronous test cases can run ahead of time, for the spec below.
+ */
+BEGIN_DEFINE_ENH_SPEC_PRIVATE(
+	FRunAheadProbeSpec,
+	"EnhancedUnrealSpecs.EnhancedSpecCommandSequence.RunAheadProbe",
+	EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask,
+	__FILE__,
+	__LINE__
+)
+	/**
+	 * How many times each test case of this spec has run, keyed by the ID of the test case.
+	 */
+	TMap<FString, int32> NumRunsPerSpec;
+
+public:
+	/**
+	 * Runs all commands of a test case of this spec to completion.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case to run.
+	 *
+	 * @return
+	 *	The number of frames that the automation framework would have spent running the test case.
+	 */
+	int32 RunSpecInFrames(const FString& SpecId)
+	{
+		int32 NumFrames;
+
+		this->RunSpecImmediately(SpecId, NumFrames);
+
+		return NumFrames;
+	}
+
+	/**
+	 * Gets how many times a test case of this spec has run.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case.
+	 *
+	 * @return
+	 *	The number of times that the It() block of the test case has run.
+	 */
+	int32 GetNumRuns(const FString& SpecId) const
+	{
+		return this->NumRunsPerSpec.FindRef(SpecId);
+	}
+
+protected:
+	virtual bool GetRequestedTestNames(TSet<FString>& OutTestNames) const override
+	{
+		for (const TCHAR* SpecId : { TEXT("first"), TEXT("second"), TEXT("waits a frame"), TEXT("after waiting") })
+		{
+			OutTestNames.Add(FString::Printf(TEXT("%s %s"), *this->TestName, SpecId));
+		}
+
+		return true;
+	}
+
+private:
+	/**
+	 * Counts a run of a test case of this spec.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case that is running.
+	 */
+	void CountRun(const FString& SpecId)
+	{
+		++this->NumRunsPerSpec.FindOrAdd(SpecId, 0);
+	}
+};
+
+void FRunAheadProbeSpec::Define()
+{
+	It("first", [this]
+	{
+		this->CountRun(TEXT("first"));
+	});
+
+	It("not requested", [this]
+	{
+		this->CountRun(TEXT("not requested"));
+	});
+
+	It("second", [this]
+	{
+		this->CountRun(TEXT("second"));
+	});
+
+	LatentIt("waits a frame", [this](const FDoneDelegate& Done)
+	{
+		this->CountRun(TEXT("waits a frame"));
+
+		Done.Execute();
+	});
+
+	It("after waiting", [this]
+	{
+		this->CountRun(TEXT("after waiting"));
+	});
+}
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecCommandSequenceSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecCommandSequence",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+	float PriorFrameBudgetMs;
+	bool  bPriorRunSpecsAhead;
+END_DEFINE_ENH_SPEC(FEnhancedSpecCommandSequenceSpec)
+
+void FEnhancedSpecCommandSequenceSpec::Define()
+{
+	LET(FrameBudgetMs, IConsoleVariable*, [], {
+		return IConsoleManager::Get().FindConsoleVariable(TEXT("EnhancedSpecs.FrameBudgetMs"));
+	});
+
+	LET(RunSpecsAhead, IConsoleVariable*, [], {
+		return IConsoleManager::Get().FindConsoleVariable(TEXT("EnhancedSpecs.RunSynchronousSpecsAhead"));
+	});
+
+	LET(Probe, TSharedPtr<FCommandSequenceProbeSpec>, [], {
+		return MakeShared<FCommandSequenceProbeSpec>(TEXT("FEnhancedSpecCommandSequenceSpec.Probe"));
+	});
+
+	LET(RunAheadProbe, TSharedPtr<FRunAheadProbeSpec>, [], {
+		return MakeShared<FRunAheadProbeSpec>(TEXT("FEnhancedSpecCommandSequenceSpec.RunAheadProbe"));
+	});
+
+	BeforeEach([=, this]
+	{
+		this->PriorFrameBudgetMs  = (*FrameBudgetMs)->GetFloat();
+		this->bPriorRunSpecsAhead = (*RunSpecsAhead)->GetBool();
+	});
+
+	AfterEach([=, this]
+	{
+		(*FrameBudgetMs)->Set(this->PriorFrameBudgetMs, ECVF_SetByCode);
+		(*RunSpecsAhead)->Set(this->bPriorRunSpecsAhead, ECVF_SetByCode);
+	});
+
+	Describe("Update()", [=, this]
+	{
+		It("runs consecutive synchronous blocks within one frame while they fit in the frame budget", [=, this]
+		{
+			(*FrameBudgetMs)->Set(1000.0f, ECVF_SetByCode);
+
+			TestEqual("Frames", (*Probe)->RunSpecInFrames(TEXT("runs synchronous blocks")), 1);
+		});
+
+		It("yields to the engine once the frame budget has been used up", [=, this]
+		{
+			(*FrameBudgetMs)->Set(1.0f, ECVF_SetByCode);
+
+			TestTrue("Frames > 1", (*Probe)->RunSpecInFrames(TEXT("with a slow block runs")) > 1);
+		});
+
+		It("runs all synchronous blocks within one frame when the frame budget is disabled", [=, this]
+		{
+			(*FrameBudgetMs)->Set(0.0f, ECVF_SetByCode);
+
+			TestEqual("Frames", (*Probe)->RunSpecInFrames(TEXT("with a slow block runs")), 1);
+		});
+
+		It("yields to the engine while a latent block is waiting, even with budget left", [=, this]
+		{
+			(*FrameBudgetMs)->Set(1000.0f, ECVF_SetByCode);
+
+			TestTrue(
+				"Frames > 1",
+				(*Probe)->RunSpecInFrames(TEXT("finishes a latent block from another thread")) > 1
+			);
+		});
+
+		It("waits within the frame for an asynchronous block to finish while there is budget left", [=, this]
+		{
+			(*FrameBudgetMs)->Set(1000.0f, ECVF_SetByCode);
+
+			TestEqual("Frames", (*Probe)->RunSpecInFrames(TEXT("finishes an asynchronous block")), 1);
+		});
+
+		It("yields to the engine when an asynchronous block outlasts the frame budget", [=, this]
+		{
+			(*FrameBudgetMs)->Set(5.0f, ECVF_SetByCode);
+
+			TestTrue("Frames > 1", (*Probe)->RunSpecInFrames(TEXT("finishes an asynchronous block")) > 1);
+		});
+
+		It("yields to the engine while an asynchronous block runs when the frame budget is disabled", [=, this]
+		{
+			(*FrameBudgetMs)->Set(0.0f, ECVF_SetByCode);
+
+			TestTrue("Frames > 1", (*Probe)->RunSpecInFrames(TEXT("finishes an asynchronous block")) > 1);
+		});
+
+		It("resumes a latent block once it times out, even if it never finishes", [=, this]
+		{
+			(*FrameBudgetMs)->Set(0.0f, ECVF_SetByCode);
+
+			TestTrue("Frames > 1", (*Probe)->RunSpecInFrames(TEXT("never finishes a latent block")) > 1);
+			TestTrue("HasReportedErrors()", (*Probe)->HasReportedErrors());
+		});
+
+		It("stops waiting on an asynchronous block once it times out", [=, this]
+		{
+			(*FrameBudgetMs)->Set(1000.0f, ECVF_SetByCode);
+
+			TestEqual("Frames", (*Probe)->RunSpecInFrames(TEXT("never finishes an asynchronous block")), 1);
+			TestTrue("HasReportedErrors()", (*Probe)->HasReportedErrors());
+		});
+	});
+
+	Describe("running synchronous test cases ahead of time", [=, this]
+	{
+		BeforeEach([=, this]
+		{
+			(*FrameBudgetMs)->Set(0.0f, ECVF_SetByCode);
+			(*RunSpecsAhead)->Set(true, ECVF_SetByCode);
+		});
+
+		It("runs the requested synchronous test cases that follow a test case within the same frame", [=, this]
+		{
+			TestEqual("Frames", (*RunAheadProbe)->RunSpecInFrames(TEXT("first")), 1);
+			TestEqual("Runs of second", (*RunAheadProbe)->GetNumRuns(TEXT("second")), 1);
+			TestEqual("Runs of not requested", (*RunAheadProbe)->GetNumRuns(TEXT("not requested")), 0);
+		});
+
+		It("reports a test case that already ran ahead of time without waiting for a frame", [=, this]
+		{
+			(*RunAheadProbe)->RunSpecInFrames(TEXT("first"));
+
+			TestEqual("Frames", (*RunAheadProbe)->RunSpecInFrames(TEXT("second")), 0);
+			TestEqual("Runs of second", (*RunAheadProbe)->GetNumRuns(TEXT("second")), 1);
+		});
+
+		It("stops at the first requested test case that cannot run ahead of time", [=, this]
+		{
+			(*RunAheadProbe)->RunSpecInFrames(TEXT("first"));
+
+			TestEqual("Runs of waits a frame", (*RunAheadProbe)->GetNumRuns(TEXT("waits a frame")), 0);
+			TestEqual("Runs of after waiting", (*RunAheadProbe)->GetNumRuns(TEXT("after waiting")), 0);
+		});
+
+		It("runs each test case on its own when disabled", [=, this]
+		{
+			(*RunSpecsAhead)->Set(false, ECVF_SetByCode);
+
+			TestEqual("Frames", (*RunAheadProbe)->RunSpecInFrames(TEXT("first")), 1);
+			TestEqual("Runs of second", (*RunAheadProbe)->GetNumRuns(TEXT("second")), 0);
+		});
+	});
+}
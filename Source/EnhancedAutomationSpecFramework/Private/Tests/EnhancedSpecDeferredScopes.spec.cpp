@@ -0,0 +1,209 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedAutomationSpecBase.h"
+
+/**
+ * A spec that always defines its Describe() scopes lazily, for the spec below to look up test cases in.
+ */
+BEGIN_DEFINE_ENH_SPEC_PRIVATE(
+	FDeferredScopesProbeSpec,
+	"EnhancedUnrealSpecs.EnhancedSpecDeferredScopes.Probe",
+	EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask,
+	__FILE__,
+	__LINE__
+)
+public:
+	/**
+	 * The number of times the body of the "first scope" has run.
+	 */
+	int32 NumFirstScopeExpansions = 0;
+
+	/**
+	 * The number of times the body of the "second scope" has run.
+	 */
+	int32 NumSecondScopeExpansions = 0;
+
+	/**
+	 * The number of times the AfterAll() block of the scope "with an AfterAll block" has run.
+	 */
+	int32 NumAfterAllRuns = 0;
+
+	/**
+	 * The value of the redefined variable seen by the test case that ran last.
+	 */
+	int32 ValueSeen = 0;
+
+	/**
+	 * Ensures that the definition of a single test case of this spec has been loaded.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case.
+	 */
+	void DefineSpec(const FString& SpecId) const
+	{
+		this->EnsureDefinitionFor(SpecId);
+	}
+
+	/**
+	 * Runs all commands of a test case of this spec to completion.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case to run.
+	 *
+	 * @return
+	 *	The number of commands that were run; or, 0 if no test case with that ID has been defined.
+	 */
+	int32 RunSpec(const FString& SpecId)
+	{
+		return this->RunSpecImmediately(SpecId);
+	}
+
+protected:
+	virtual bool ShouldDefineLazily() const override
+	{
+		return true;
+	}
+};
+
+void FDeferredScopesProbeSpec::Define()
+{
+	LET(Value, int32, [], { return 1; });
+
+	Describe("first scope", [=, this]
+	{
+		++this->NumFirstScopeExpansions;
+
+		It("runs", []
+		{
+		});
+	});
+
+	Describe("second scope", [=, this]
+	{
+		++this->NumSecondScopeExpansions;
+
+		It("runs with a custom ID [CustomId]", []
+		{
+		});
+	});
+
+	Describe("with a redefined variable", [=, this]
+	{
+		REDEFINE_LET(Value, int32, [], { return **Previous + 1; });
+
+		It("records the value", [=, this]
+		{
+			this->ValueSeen = *Value;
+		});
+
+		Describe("redefined again", [=, this]
+		{
+			REDEFINE_LET(Value, int32, [], { return **Previous * 10; });
+
+			It("records the value", [=, this]
+			{
+				this->ValueSeen = *Value;
+			});
+		});
+	});
+
+	Describe("with an AfterAll block", [=, this]
+	{
+		AfterAll([this]
+		{
+			++this->NumAfterAllRuns;
+		});
+
+		Describe("first", []
+		{
+			It("runs", []
+			{
+			});
+		});
+
+		Describe("second", []
+		{
+			It("runs", []
+			{
+			});
+		});
+	});
+}
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecDeferredScopesSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecDeferredScopes",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecDeferredScopesSpec)
+
+void FEnhancedSpecDeferredScopesSpec::Define()
+{
+	LET(Probe, TSharedPtr<FDeferredScopesProbeSpec>, [], {
+		return MakeShared<FDeferredScopesProbeSpec>(TEXT("FEnhancedSpecDeferredScopesSpec.Probe"));
+	});
+
+	Describe("EnsureDefinitionFor()", [=, this]
+	{
+		It("only defines the deferred scopes that contain the test case", [=, this]
+		{
+			(*Probe)->DefineSpec(TEXT("first scope runs"));
+
+			TestEqual("NumFirstScopeExpansions", (*Probe)->NumFirstScopeExpansions, 1);
+			TestEqual("NumSecondScopeExpansions", (*Probe)->NumSecondScopeExpansions, 0);
+		});
+
+		It("does not define a deferred scope again once it has been defined", [=, this]
+		{
+			(*Probe)->DefineSpec(TEXT("first scope runs"));
+			(*Probe)->DefineSpec(TEXT("first scope runs"));
+
+			TestEqual("NumFirstScopeExpansions", (*Probe)->NumFirstScopeExpansions, 1);
+		});
+
+		It("defines every deferred scope when looking up a test case that has a custom ID", [=, this]
+		{
+			(*Probe)->DefineSpec(TEXT("CustomId"));
+
+			TestEqual("NumFirstScopeExpansions", (*Probe)->NumFirstScopeExpansions, 1);
+			TestEqual("NumSecondScopeExpansions", (*Probe)->NumSecondScopeExpansions, 1);
+			TestTrue("RunSpec() > 0", (*Probe)->RunSpec(TEXT("CustomId")) > 0);
+		});
+	});
+
+	Describe("RedefineLet()", [=, this]
+	{
+		It("builds on the definition from the scope that encloses a deferred scope", [=, this]
+		{
+			(*Probe)->RunSpec(TEXT("with a redefined variable records the value"));
+
+			TestEqual("ValueSeen", (*Probe)->ValueSeen, 2);
+		});
+
+		It("builds on the definition from each enclosing deferred scope", [=, this]
+		{
+			(*Probe)->RunSpec(TEXT("with a redefined variable redefined again records the value"));
+
+			TestEqual("ValueSeen", (*Probe)->ValueSeen, 20);
+		});
+	});
+
+	Describe("AfterAll()", [=, this]
+	{
+		It("holds back the blocks of a scope while any of its nested scopes is still deferred", [=, this]
+		{
+			(*Probe)->RunSpec(TEXT("with an AfterAll block first runs"));
+
+			TestEqual("NumAfterAllRuns", (*Probe)->NumAfterAllRuns, 0);
+		});
+
+		It("runs the blocks of a scope once its last test case has been defined and has run", [=, this]
+		{
+			(*Probe)->RunSpec(TEXT("with an AfterAll block first runs"));
+			(*Probe)->RunSpec(TEXT("with an AfterAll block second runs"));
+
+			TestEqual("NumAfterAllRuns", (*Probe)->NumAfterAllRuns, 1);
+		});
+	});
+}
@@ -0,0 +1,182 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include <HAL/FileManager.h>
+
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecDefinitionCache.h"
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecDefinitionCacheSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecDefinitionCache",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecDefinitionCacheSpec)
+
+void FEnhancedSpecDefinitionCacheSpec::Define()
+{
+	Describe("FEnhancedSpecListingSet", [=, this]
+	{
+		LET(ListingSet, FEnhancedSpecListingSet, [], {
+			FEnhancedSpecListingSet Result;
+
+			Result.Listings.Add({ TEXT("Widget spins"), TEXT("Widget.spins"), TEXT("MySpec.spec.cpp"), 10 });
+			Result.Listings.Add({ TEXT("Widget stops"), TEXT("Widget.stops"), TEXT("MySpec.spec.cpp"), 20 });
+			Result.BuildIndex();
+
+			return Result;
+		});
+
+		Describe("Find()", [=, this]
+		{
+			It("finds a listing by its ID", [=, this]
+			{
+				const FEnhancedSpecListing* Listing = (*ListingSet).Find(TEXT("Widget stops"));
+
+				if (TestNotNull("Listing", Listing))
+				{
+					TestEqual("Listing->LineNumber", Listing->LineNumber, 20);
+				}
+			});
+
+			It("ignores the case of the ID", [=, this]
+			{
+				const FEnhancedSpecListing* Listing = (*ListingSet).Find(TEXT("WIDGET SPINS"));
+
+				if (TestNotNull("Listing", Listing))
+				{
+					TestEqual("Listing->LineNumber", Listing->LineNumber, 10);
+				}
+			});
+
+			It("finds a listing by a view into a longer string", [=, this]
+			{
+				const FString               TestName = TEXT("FMySpec Widget spins");
+				const FEnhancedSpecListing* Listing  = (*ListingSet).Find(FStringView(TestName).RightChop(8));
+
+				if (TestNotNull("Listing", Listing))
+				{
+					TestEqual("Listing->LineNumber", Listing->LineNumber, 10);
+				}
+			});
+
+			It("returns a null pointer for an unknown ID", [=, this]
+			{
+				TestNull("Listing", (*ListingSet).Find(TEXT("Widget explodes")));
+			});
+
+			It("finds a listing whose ID shares a hash with the ID of another listing", [=, this]
+			{
+				const uint64 IdHash = FEnhancedSpecIdHash::Hash(TEXT("Widget stops"));
+
+				// Simulate a collision by filing the other listing under the same hash, ahead of the right one.
+				(*ListingSet).IndicesByIdHash.Remove(IdHash);
+				(*ListingSet).IndicesByIdHash.Add(IdHash, 0);
+				(*ListingSet).IndicesByIdHash.Add(IdHash, 1);
+
+				const FEnhancedSpecListing* Listing = (*ListingSet).Find(TEXT("Widget stops"));
+
+				if (TestNotNull("Listing", Listing))
+				{
+					TestEqual("Listing->LineNumber", Listing->LineNumber, 20);
+				}
+			});
+		});
+	});
+
+	Describe("FEnhancedSpecDefinitionCache", [=, this]
+	{
+		LET(FilePath, FString, [], {
+			return FPaths::CreateTempFilename(
+				*FPaths::ProjectIntermediateDir(),
+				TEXT("EnhancedSpecDefinitions"),
+				TEXT(".bin")
+			);
+		});
+
+		BeforeEach([=, this]
+		{
+			FEnhancedSpecDefinitionCache Cache(*FilePath);
+			TArray<FEnhancedSpecListing> Listings;
+
+			Listings.Add({ TEXT("Widget spins"), TEXT("Widget.spins"), TEXT("MySpec.spec.cpp"), 10 });
+			Listings.Add({ TEXT("Widget stops"), TEXT("Widget.stops"), TEXT("MySpec.spec.cpp"), 20 });
+
+			Cache.Store(TEXT("FMySpec"), TEXT("Stamp1"), MoveTemp(Listings), { TEXT("MyFixture") });
+			Cache.Save();
+		});
+
+		AfterEach([=, this]
+		{
+			IFileManager::Get().Delete(**FilePath);
+		});
+
+		Describe("Find()", [=, this]
+		{
+			It("finds the listings that a prior session saved for the same build", [=, this]
+			{
+				const FEnhancedSpecDefinitionCache              Cache(*FilePath);
+				const TSharedPtr<const FEnhancedSpecListingSet> ListingSet =
+					Cache.Find(TEXT("FMySpec"), TEXT("Stamp1"));
+
+				if (TestTrue("ListingSet.IsValid()", ListingSet.IsValid()))
+				{
+					const FEnhancedSpecListing* Listing = (*ListingSet).Find(TEXT("Widget stops"));
+
+					TestEqual("ListingSet.Listings.Num()", (*ListingSet).Listings.Num(), 2);
+					TestEqual("ListingSet.FixtureNames.Num()", (*ListingSet).FixtureNames.Num(), 1);
+					TestEqual("ListingSet.FixtureNames[0]", (*ListingSet).FixtureNames[0], TEXT("MyFixture"));
+
+					if (TestNotNull("Listing", Listing))
+					{
+						TestEqual("Listing->Description", Listing->Description, TEXT("Widget.stops"));
+						TestEqual("Listing->Filename", Listing->Filename, TEXT("MySpec.spec.cpp"));
+						TestEqual("Listing->LineNumber", Listing->LineNumber, 20);
+					}
+				}
+			});
+
+			It("ignores listings that were saved for a different build", [=, this]
+			{
+				const FEnhancedSpecDefinitionCache Cache(*FilePath);
+
+				TestFalse("IsValid()", Cache.Find(TEXT("FMySpec"), TEXT("Stamp2")).IsValid());
+			});
+
+			It("ignores a file that has been truncated", [=, this]
+			{
+				TArray<uint8> Contents;
+
+				FFileHelper::LoadFileToArray(Contents, **FilePath);
+				Contents.SetNum(Contents.Num() / 2);
+				FFileHelper::SaveArrayToFile(Contents, **FilePath);
+
+				AddExpectedError(TEXT("Ignoring truncated spec definition cache"));
+
+				const FEnhancedSpecDefinitionCache Cache(*FilePath);
+
+				TestFalse("IsValid()", Cache.Find(TEXT("FMySpec"), TEXT("Stamp1")).IsValid());
+			});
+
+			It("ignores a file that was written in a different version of the file format", [=, this]
+			{
+				TArray<uint8> Contents;
+
+				FFileHelper::LoadFileToArray(Contents, **FilePath);
+
+				// The version immediately follows the 4-byte magic value.
+				Contents[sizeof(uint32)] = 1;
+				FFileHelper::SaveArrayToFile(Contents, **FilePath);
+
+				AddExpectedError(TEXT("Ignoring unreadable spec definition cache"));
+
+				const FEnhancedSpecDefinitionCache Cache(*FilePath);
+
+				TestFalse("IsValid()", Cache.Find(TEXT("FMySpec"), TEXT("Stamp1")).IsValid());
+			});
+		});
+	});
+}
@@ -0,0 +1,101 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecDurationBaseline.h"
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecDurationBaselineSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecDurationBaseline",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecDurationBaselineSpec)
+
+void FEnhancedSpecDurationBaselineSpec::Define()
+{
+	Describe("FEnhancedSpecDurationStats", [=, this]
+	{
+		Describe("AddSample()", [=, this]
+		{
+			Describe("when several samples have been added", [=, this]
+			{
+				LET(Stats, FEnhancedSpecDurationStats, [], {
+					FEnhancedSpecDurationStats Result;
+
+					for (const double Sample : { 1.0, 2.0, 3.0, 4.0, 5.0 })
+					{
+						Result.AddSample(Sample);
+					}
+
+					return Result;
+				});
+
+				It("tracks the mean of the samples", [=, this]
+				{
+					TestEqual("Stats.NumSamples", (*Stats).NumSamples, static_cast<int64>(5));
+					TestEqual("Stats.MeanSeconds", (*Stats).MeanSeconds, 3.0);
+				});
+
+				It("tracks the sample standard deviation of the samples", [=, this]
+				{
+					TestEqual("Stats.GetStandardDeviation()", (*Stats).GetStandardDeviation(), FMath::Sqrt(2.5), 1e-9);
+				});
+			});
+
+			Describe("when a single sample has been added", [=, this]
+			{
+				LET(Stats, FEnhancedSpecDurationStats, [], {
+					FEnhancedSpecDurationStats Result;
+
+					Result.AddSample(2.0);
+
+					return Result;
+				});
+
+				It("reports no deviation", [=, this]
+				{
+					TestEqual("Stats.GetStandardDeviation()", (*Stats).GetStandardDeviation(), 0.0);
+				});
+			});
+		});
+
+		Describe("IsRegression()", [=, this]
+		{
+			LET(Stats, FEnhancedSpecDurationStats, [], {
+				FEnhancedSpecDurationStats Result;
+
+				for (const double Sample : { 0.9, 1.0, 1.1, 1.0 })
+				{
+					Result.AddSample(Sample);
+				}
+
+				return Result;
+			});
+
+			It("flags a duration beyond the threshold", [=, this]
+			{
+				TestTrue("IsRegression", (*Stats).IsRegression(1.5, 3, 3.0, 0.0));
+			});
+
+			It("does not flag a duration within the threshold", [=, this]
+			{
+				TestFalse("IsRegression", (*Stats).IsRegression(1.2, 3, 3.0, 0.0));
+			});
+
+			It("does not flag a faster duration", [=, this]
+			{
+				TestFalse("IsRegression", (*Stats).IsRegression(0.1, 3, 3.0, 0.0));
+			});
+
+			It("does not flag a duration that is slower by less than the minimum", [=, this]
+			{
+				TestFalse("IsRegression", (*Stats).IsRegression(1.5, 3, 3.0, 1.0));
+			});
+
+			It("does not flag any duration until there are enough samples", [=, this]
+			{
+				TestFalse("IsRegression", (*Stats).IsRegression(100.0, 5, 3.0, 0.0));
+			});
+		});
+	});
+}
@@ -0,0 +1,134 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecFixture.h"
+
+namespace EnhancedSpecFixtureSpec
+{
+	/**
+	 * A fixture that both of the spec classes below depend on.
+	 */
+	static TEnhancedSpecFixture<FString> SharedFixture(TEXT("EnhancedUnrealSpecs.Tests.SharedFixture"), []
+	{
+		return MakeShared<FString>(TEXT("Shared"));
+	});
+
+	/**
+	 * The value of the shared fixture that was seen by the last test case to request it.
+	 *
+	 * This becomes invalid once the fixture has been released, so it never refers to a value from a prior session.
+	 */
+	static TWeakPtr<const FString> LastSeenValue;
+
+	/**
+	 * Requests the value of the shared fixture and checks that it is the same value seen by prior test cases.
+	 *
+	 * @param Test
+	 *	The test case that is requesting the value.
+	 */
+	static void CheckSharedValue(FAutomationTestBase& Test)
+	{
+		const TSharedRef<const FString> Value      = SharedFixture.Get();
+		const TSharedPtr<const FString> PriorValue = LastSeenValue.Pin();
+
+		Test.TestEqual(TEXT("SharedFixture"), *Value, TEXT("Shared"));
+
+		if (PriorValue.IsValid())
+		{
+			Test.TestTrue(TEXT("Value is shared"), PriorValue == Value);
+		}
+
+		LastSeenValue = Value;
+	}
+}
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecFixtureSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecFixture",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecFixtureSpec)
+
+void FEnhancedSpecFixtureSpec::Define()
+{
+	UseFixture(EnhancedSpecFixtureSpec::SharedFixture);
+
+	Describe("Get()", [=, this]
+	{
+		It("builds the value of the fixture the first time it is requested", [=, this]
+		{
+			TestEqual("SharedFixture", *EnhancedSpecFixtureSpec::SharedFixture, TEXT("Shared"));
+			TestTrue("IsBuilt()", EnhancedSpecFixtureSpec::SharedFixture.IsBuilt());
+		});
+
+		It("only builds the value once while dependent spec classes are still running", [=, this]
+		{
+			EnhancedSpecFixtureSpec::CheckSharedValue(*this);
+		});
+	});
+
+	Describe("FEnhancedSpecFixtureRegistry", [=, this]
+	{
+		It("finds fixtures by name", [=, this]
+		{
+			const FEnhancedSpecFixtureBase* Fixture =
+				FEnhancedSpecFixtureRegistry::Get().Find(TEXT("EnhancedUnrealSpecs.Tests.SharedFixture"));
+
+			TestTrue("Find() returned the shared fixture", Fixture == &EnhancedSpecFixtureSpec::SharedFixture);
+		});
+
+		It("releases the value of a fixture once its last dependent has finished", [=, this]
+		{
+			FEnhancedSpecFixtureRegistry& Registry = FEnhancedSpecFixtureRegistry::Get();
+			TEnhancedSpecFixture<int32>   Fixture(TEXT("EnhancedUnrealSpecs.Tests.LocalFixture"), []
+			{
+				return MakeShared<int32>(42);
+			});
+
+			Registry.AddDependent(Fixture);
+			Registry.AddDependent(Fixture);
+
+			TestEqual("Value", *Fixture, 42);
+
+			Registry.MarkDependentAsFinished(Fixture);
+			TestTrue("IsBuilt() after the first dependent finished", Fixture.IsBuilt());
+
+			Registry.MarkDependentAsFinished(Fixture);
+			TestFalse("IsBuilt() after the last dependent finished", Fixture.IsBuilt());
+		});
+
+		It("keeps values alive for test cases that still hold them after release", [=, this]
+		{
+			FEnhancedSpecFixtureRegistry& Registry = FEnhancedSpecFixtureRegistry::Get();
+			TEnhancedSpecFixture<int32>   Fixture(TEXT("EnhancedUnrealSpecs.Tests.HeldFixture"), []
+			{
+				return MakeShared<int32>(42);
+			});
+
+			Registry.AddDependent(Fixture);
+
+			const TSharedRef<const int32> Value = Fixture.Get();
+
+			Registry.MarkDependentAsFinished(Fixture);
+
+			TestFalse("IsBuilt()", Fixture.IsBuilt());
+			TestEqual("Value", *Value, 42);
+		});
+	});
+}
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecFixtureSecondDependentSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecFixture.SecondDependent",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecFixtureSecondDependentSpec)
+
+void FEnhancedSpecFixtureSecondDependentSpec::Define()
+{
+	UseFixture(EnhancedSpecFixtureSpec::SharedFixture);
+
+	It("shares the value of the fixture built for the other spec class", [=, this]
+	{
+		EnhancedSpecFixtureSpec::CheckSharedValue(*this);
+	});
+}
@@ -0,0 +1,103 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecPerfCounters.h"
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecPerfCountersSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecPerfCounters",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecPerfCountersSpec)
+
+void FEnhancedSpecPerfCountersSpec::Define()
+{
+	Describe("FEnhancedSpecPerfCounterValues", [=, this]
+	{
+		LET(Values, FEnhancedSpecPerfCounterValues, [], {
+			FEnhancedSpecPerfCounterValues Result;
+
+			Result.Instructions = 2000.0;
+			Result.Cycles       = 1000.0;
+			Result.BranchMisses = 10.0;
+
+			return Result;
+		});
+
+		Describe("HasAny()", [=, this]
+		{
+			It("returns false when no counter was read", [=, this]
+			{
+				TestFalse("HasAny()", FEnhancedSpecPerfCounterValues().HasAny());
+			});
+
+			It("returns true when any counter was read", [=, this]
+			{
+				TestTrue("HasAny()", (*Values).HasAny());
+			});
+		});
+
+		Describe("DividedBy()", [=, this]
+		{
+			It("divides the counts that were read", [=, this]
+			{
+				const FEnhancedSpecPerfCounterValues Divided = (*Values).DividedBy(10.0);
+
+				TestEqual("Divided.Instructions", Divided.Instructions, 200.0);
+				TestEqual("Divided.Cycles", Divided.Cycles, 100.0);
+				TestEqual("Divided.BranchMisses", Divided.BranchMisses, 1.0);
+			});
+
+			It("leaves the counts that were not read unavailable", [=, this]
+			{
+				const FEnhancedSpecPerfCounterValues Divided = (*Values).DividedBy(10.0);
+
+				TestEqual("Divided.L1DataCacheMisses", Divided.L1DataCacheMisses, -1.0);
+				TestEqual("Divided.LastLevelCacheMisses", Divided.LastLevelCacheMisses, -1.0);
+			});
+		});
+
+		Describe("ToString()", [=, this]
+		{
+			It("lists only the counts that were read, with the instructions per cycle", [=, this]
+			{
+				TestEqual(
+					"ToString()",
+					(*Values).ToString(),
+					TEXT("instructions 2000, cycles 1000 (2.00 IPC), branch misses 10")
+				);
+			});
+		});
+	});
+
+	Describe("FEnhancedSpecPerfCounterScope", [=, this]
+	{
+		It("measures nothing when not asked to", [=, this]
+		{
+			FEnhancedSpecPerfCounterScope Scope(false);
+
+			TestFalse("IsMeasuring()", Scope.IsMeasuring());
+			TestFalse("Stop().HasAny()", Scope.Stop().HasAny());
+		});
+
+		It("counts the instructions of the calling thread when counters are available", [=, this]
+		{
+			FEnhancedSpecPerfCounterScope Scope;
+			volatile int32                Sum = 0;
+
+			if (!Scope.IsMeasuring())
+			{
+				AddInfo(TEXT("Hardware performance counters are not available; skipping."));
+				return;
+			}
+
+			for (int32 Index = 0; Index < 10000; ++Index)
+			{
+				Sum = Sum + Index;
+			}
+
+			TestTrue("Instructions >= 10000", Scope.Stop().Instructions >= 10000.0);
+		});
+	});
+}
@@ -0,0 +1,131 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include <Algo/Reverse.h>
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecSharding.h"
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecShardingSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecSharding",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecShardingSpec)
+
+void FEnhancedSpecShardingSpec::Define()
+{
+	Describe("AssignShards()", [=, this]
+	{
+		Describe("when all groups have recorded durations", [=, this]
+		{
+			LET(Groups, TArray<FEnhancedSpecShardGroup>, [], {
+				return TArray<FEnhancedSpecShardGroup>({
+					FEnhancedSpecShardGroup { TEXT("A"), 7.0, true },
+					FEnhancedSpecShardGroup { TEXT("B"), 5.0, true },
+					FEnhancedSpecShardGroup { TEXT("C"), 4.0, true },
+					FEnhancedSpecShardGroup { TEXT("D"), 3.0, true },
+					FEnhancedSpecShardGroup { TEXT("E"), 1.0, true },
+				});
+			});
+
+			It("balances the total duration of each shard", [=, this]
+			{
+				const TArray<int32> Assignments = FEnhancedSpecSharding::AssignShards("Suite", *Groups, 2);
+				TArray<double>      ShardLoads;
+
+				ShardLoads.Init(0.0, 2);
+
+				for (int32 GroupIndex = 0; GroupIndex < (*Groups).Num(); ++GroupIndex)
+				{
+					ShardLoads[Assignments[GroupIndex]] += (*Groups)[GroupIndex].EstimatedSeconds;
+				}
+
+				TestEqual("ShardLoads[0]", ShardLoads[0], 10.0);
+				TestEqual("ShardLoads[1]", ShardLoads[1], 10.0);
+			});
+
+			It("assigns the same shards regardless of the order of the groups", [=, this]
+			{
+				TArray<FEnhancedSpecShardGroup> ReversedGroups = *Groups;
+
+				Algo::Reverse(ReversedGroups);
+
+				const TArray<int32> Assignments         = FEnhancedSpecSharding::AssignShards("Suite", *Groups, 3);
+				const TArray<int32> ReversedAssignments =
+					FEnhancedSpecSharding::AssignShards("Suite", ReversedGroups, 3);
+
+				for (int32 GroupIndex = 0; GroupIndex < (*Groups).Num(); ++GroupIndex)
+				{
+					TestEqual(
+						FString::Printf(TEXT("Assignments[%d]"), GroupIndex),
+						Assignments[GroupIndex],
+						ReversedAssignments[(*Groups).Num() - GroupIndex - 1]
+					);
+				}
+			});
+		});
+
+		Describe("when only some groups have recorded durations", [=, this]
+		{
+			LET(Groups, TArray<FEnhancedSpecShardGroup>, [], {
+				return TArray<FEnhancedSpecShardGroup>({
+					FEnhancedSpecShardGroup { TEXT("A"), 6.0, true },
+					FEnhancedSpecShardGroup { TEXT("B"), 4.0, true },
+					FEnhancedSpecShardGroup { TEXT("C"), 2.0, true },
+					FEnhancedSpecShardGroup { TEXT("Untimed"), 0.0, false },
+				});
+			});
+
+			It("counts the median recorded duration against the shard of each untimed group", [=, this]
+			{
+				const TArray<int32> Assignments = FEnhancedSpecSharding::AssignShards("Suite", *Groups, 2);
+				TArray<double>      ShardLoads;
+
+				ShardLoads.Init(0.0, 2);
+
+				for (int32 GroupIndex = 0; GroupIndex < (*Groups).Num(); ++GroupIndex)
+				{
+					const FEnhancedSpecShardGroup& Group = (*Groups)[GroupIndex];
+
+					ShardLoads[Assignments[GroupIndex]] += Group.bHasTiming ? Group.EstimatedSeconds : 4.0;
+				}
+
+				TestEqual("ShardLoads[0]", ShardLoads[0], 8.0);
+				TestEqual("ShardLoads[1]", ShardLoads[1], 8.0);
+			});
+		});
+
+		Describe("when no groups have recorded durations", [=, this]
+		{
+			LET(Groups, TArray<FEnhancedSpecShardGroup>, [], {
+				TArray<FEnhancedSpecShardGroup> Result;
+
+				for (int32 GroupIndex = 0; GroupIndex < 50; ++GroupIndex)
+				{
+					Result.Add(FEnhancedSpecShardGroup { FString::Printf(TEXT("Group %d"), GroupIndex), 0.0, false });
+				}
+
+				return Result;
+			});
+
+			It("assigns every group to a valid shard", [=, this]
+			{
+				const TArray<int32> Assignments = FEnhancedSpecSharding::AssignShards("Suite", *Groups, 4);
+
+				for (const int32 ShardIndex : Assignments)
+				{
+					TestTrue("ShardIndex is in range", (ShardIndex >= 0) && (ShardIndex < 4));
+				}
+			});
+
+			It("assigns each group to the same shard every time", [=, this]
+			{
+				const TArray<int32> FirstAssignments  = FEnhancedSpecSharding::AssignShards("Suite", *Groups, 4);
+				const TArray<int32> SecondAssignments = FEnhancedSpecSharding::AssignShards("Suite", *Groups, 4);
+
+				TestTrue("Assignments match", FirstAssignments == SecondAssignments);
+			});
+		});
+	});
+}
@@ -0,0 +1,73 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecTimerQueue.h"
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecTimerQueueSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecTimerQueue",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecTimerQueueSpec)
+
+void FEnhancedSpecTimerQueueSpec::Define()
+{
+	LET(Queue, TSharedPtr<FEnhancedSpecTimerQueue>, [], {
+		return MakeShared<FEnhancedSpecTimerQueue>();
+	});
+
+	LET(Signal, TSharedPtr<FSpecWakeSignal>, [], {
+		return MakeShared<FSpecWakeSignal>();
+	});
+
+	Describe("RaiseDueSignals()", [=, this]
+	{
+		It("raises a signal once its deadline has passed", [=, this]
+		{
+			(*Queue)->Schedule(10.0, (*Signal).ToSharedRef(), (*Signal)->Arm());
+			(*Queue)->RaiseDueSignals(9.0);
+
+			TestFalse("Raised before the deadline", (*Signal)->IsRaised());
+
+			(*Queue)->RaiseDueSignals(10.0);
+
+			TestTrue("Raised at the deadline", (*Signal)->IsRaised());
+			TestEqual("GetNumPending()", (*Queue)->GetNumPending(), 0);
+		});
+
+		It("only forgets the deadlines that have passed", [=, this]
+		{
+			const TSharedRef<FSpecWakeSignal> LaterSignal = MakeShared<FSpecWakeSignal>();
+
+			(*Queue)->Schedule(20.0, LaterSignal, LaterSignal->Arm());
+			(*Queue)->Schedule(10.0, (*Signal).ToSharedRef(), (*Signal)->Arm());
+			(*Queue)->RaiseDueSignals(15.0);
+
+			TestTrue("Earlier signal is raised", (*Signal)->IsRaised());
+			TestFalse("Later signal is raised", LaterSignal->IsRaised());
+			TestEqual("GetNumPending()", (*Queue)->GetNumPending(), 1);
+		});
+
+		It("does not raise a signal that has been armed again since its deadline was registered", [=, this]
+		{
+			(*Queue)->Schedule(10.0, (*Signal).ToSharedRef(), (*Signal)->Arm());
+			(*Signal)->Arm();
+			(*Queue)->RaiseDueSignals(10.0);
+
+			TestFalse("Raised", (*Signal)->IsRaised());
+			TestEqual("GetNumPending()", (*Queue)->GetNumPending(), 0);
+		});
+
+		It("ignores deadlines of signals that have been destroyed", [=, this]
+		{
+			TSharedPtr<FSpecWakeSignal> DestroyedSignal = MakeShared<FSpecWakeSignal>();
+
+			(*Queue)->Schedule(10.0, DestroyedSignal.ToSharedRef(), DestroyedSignal->Arm());
+			DestroyedSignal.Reset();
+			(*Queue)->RaiseDueSignals(10.0);
+
+			TestEqual("GetNumPending()", (*Queue)->GetNumPending(), 0);
+		});
+	});
+}
@@ -0,0 +1,216 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include <Dom/JsonObject.h>
+
+#include <HAL/FileManager.h>
+#include <HAL/PlatformTLS.h>
+
+#include <Misc/FileHelper.h>
+#include <Misc/Guid.h>
+#include <Misc/Paths.h>
+
+#include <Serialization/JsonReader.h>
+#include <Serialization/JsonSerializer.h>
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecTraceRecorder.h"
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecTraceRecorderSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecTraceRecorder",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecTraceRecorderSpec)
+
+void FEnhancedSpecTraceRecorderSpec::Define()
+{
+	LET(OutputDirectory, FString, [], {
+		return FPaths::Combine(
+			FPaths::ProjectIntermediateDir(),
+			TEXT("EnhancedSpecTraceRecorderSpec"),
+			FGuid::NewGuid().ToString()
+		);
+	});
+
+	LET(Recorder, TSharedPtr<FEnhancedSpecTraceRecorder>, [OutputDirectory], {
+		return MakeShared<FEnhancedSpecTraceRecorder>(*OutputDirectory);
+	});
+
+	LET(TraceFilePaths, TArray<FString>, [OutputDirectory], {
+		TArray<FString> FilePaths;
+
+		IFileManager::Get().FindFilesRecursive(FilePaths, **OutputDirectory, TEXT("*.json"), true, false);
+
+		return FilePaths;
+	});
+
+	AfterEach([=, this]
+	{
+		IFileManager::Get().DeleteDirectory(**OutputDirectory, false, true);
+	});
+
+	Describe("EndSession()", [=, this]
+	{
+		Describe("when blocks have been recorded", [=, this]
+		{
+			LET(Trace, TSharedPtr<FJsonObject>, [TraceFilePaths], {
+				TSharedPtr<FJsonObject> Result;
+				FString                 Contents;
+
+				if ((*TraceFilePaths).Num() == 1)
+				{
+					FFileHelper::LoadFileToString(Contents, *(*TraceFilePaths)[0]);
+					FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Contents), Result);
+				}
+
+				return Result;
+			});
+
+			LET(CompleteEvents, TArray<TSharedPtr<FJsonObject>>, [Trace], {
+				const TArray<TSharedPtr<FJsonValue>>* TraceEvents;
+				TArray<TSharedPtr<FJsonObject>>       Result;
+
+				if ((*Trace).IsValid() && (*Trace)->TryGetArrayField(TEXT("traceEvents"), TraceEvents))
+				{
+					for (const TSharedPtr<FJsonValue>& TraceEvent : *TraceEvents)
+					{
+						const TSharedPtr<FJsonObject> EventObject = TraceEvent->AsObject();
+
+						if (EventObject->GetStringField(TEXT("ph")) == TEXT("X"))
+						{
+							Result.Add(EventObject);
+						}
+					}
+				}
+
+				return Result;
+			});
+
+			BeforeEach([=, this]
+			{
+				FEnhancedSpecTraceEvent BeforeEachEvent,
+				                        ItEvent;
+
+				BeforeEachEvent.Name         = TEXT("BeforeEach");
+				BeforeEachEvent.Category     = TEXT("BeforeEach");
+				BeforeEachEvent.TestName     = TEXT("FMySpec says \"hi\" to C:\\Widgets");
+				BeforeEachEvent.Scope        = TEXT("Widget");
+				BeforeEachEvent.StartSeconds = 10.0;
+				BeforeEachEvent.EndSeconds   = 10.0015;
+				BeforeEachEvent.ThreadId     = FPlatformTLS::GetCurrentThreadId();
+				BeforeEachEvent.NumFrames    = 1;
+
+				ItEvent.Name         = TEXT("says hi");
+				ItEvent.Category     = TEXT("It");
+				ItEvent.TestName     = BeforeEachEvent.TestName;
+				ItEvent.Scope        = TEXT("Widget");
+				ItEvent.StartSeconds = 10.002;
+				ItEvent.EndSeconds   = 10.005;
+				ItEvent.ThreadId     = FPlatformTLS::GetCurrentThreadId();
+				ItEvent.NumFrames    = 3;
+				ItEvent.bTimedOut    = true;
+
+				(*Recorder)->Record(MoveTemp(BeforeEachEvent));
+				(*Recorder)->Record(MoveTemp(ItEvent));
+				(*Recorder)->EndSession();
+			});
+
+			It("writes one trace file that parses as JSON", [=, this]
+			{
+				TestEqual("TraceFilePaths.Num()", (*TraceFilePaths).Num(), 1);
+				TestTrue("Trace.IsValid()", (*Trace).IsValid());
+			});
+
+			It("names the process and the thread that ran the blocks", [=, this]
+			{
+				const TArray<TSharedPtr<FJsonValue>>* TraceEvents;
+				int32                                 NumProcessNames = 0,
+				                                      NumThreadNames  = 0;
+
+				if (!TestTrue("Trace.IsValid()", (*Trace).IsValid()) ||
+				    !TestTrue("traceEvents", (*Trace)->TryGetArrayField(TEXT("traceEvents"), TraceEvents)))
+				{
+					return;
+				}
+
+				for (const TSharedPtr<FJsonValue>& TraceEvent : *TraceEvents)
+				{
+					const TSharedPtr<FJsonObject> EventObject = TraceEvent->AsObject();
+					const FString                 EventName   = EventObject->GetStringField(TEXT("name"));
+
+					if (EventObject->GetStringField(TEXT("ph")) != TEXT("M"))
+					{
+						continue;
+					}
+
+					if (EventName == TEXT("process_name"))
+					{
+						++NumProcessNames;
+					}
+					else if (EventName == TEXT("thread_name"))
+					{
+						++NumThreadNames;
+					}
+				}
+
+				TestEqual("NumProcessNames", NumProcessNames, 1);
+				TestEqual("NumThreadNames", NumThreadNames, 1);
+			});
+
+			It("writes a complete event for each block, in microseconds since the first block started", [=, this]
+			{
+				if (!TestEqual("CompleteEvents.Num()", (*CompleteEvents).Num(), 2))
+				{
+					return;
+				}
+
+				const TSharedPtr<FJsonObject>& BeforeEachEvent = (*CompleteEvents)[0];
+				const TSharedPtr<FJsonObject>& ItEvent         = (*CompleteEvents)[1];
+
+				TestEqual("BeforeEach cat", BeforeEachEvent->GetStringField(TEXT("cat")), TEXT("BeforeEach"));
+				TestEqual("BeforeEach ts", BeforeEachEvent->GetNumberField(TEXT("ts")), 0.0, 0.01);
+				TestEqual("BeforeEach dur", BeforeEachEvent->GetNumberField(TEXT("dur")), 1500.0, 0.01);
+				TestEqual("It cat", ItEvent->GetStringField(TEXT("cat")), TEXT("It"));
+				TestEqual("It ts", ItEvent->GetNumberField(TEXT("ts")), 2000.0, 0.01);
+				TestEqual("It dur", ItEvent->GetNumberField(TEXT("dur")), 3000.0, 0.01);
+			});
+
+			It("records the test, frames, and timeout of each block as arguments", [=, this]
+			{
+				if (!TestEqual("CompleteEvents.Num()", (*CompleteEvents).Num(), 2))
+				{
+					return;
+				}
+
+				const TSharedPtr<FJsonObject> Args = (*CompleteEvents)[1]->GetObjectField(TEXT("args"));
+
+				TestEqual("test", Args->GetStringField(TEXT("test")), TEXT("FMySpec says \"hi\" to C:\\Widgets"));
+				TestEqual("scope", Args->GetStringField(TEXT("scope")), TEXT("Widget"));
+				TestEqual("frames", Args->GetNumberField(TEXT("frames")), 3.0);
+				TestTrue("timedOut", Args->GetBoolField(TEXT("timedOut")));
+			});
+
+			It("forgets the recorded blocks once they have been written", [=, this]
+			{
+				TArray<FString> FilePaths;
+
+				(*Recorder)->EndSession();
+
+				IFileManager::Get().FindFilesRecursive(FilePaths, **OutputDirectory, TEXT("*.json"), true, false);
+
+				TestEqual("FilePaths.Num()", FilePaths.Num(), 1);
+			});
+		});
+
+		Describe("when no blocks have been recorded", [=, this]
+		{
+			It("does not write a trace file", [=, this]
+			{
+				(*Recorder)->EndSession();
+
+				TestEqual("TraceFilePaths.Num()", (*TraceFilePaths).Num(), 0);
+			});
+		});
+	});
+}
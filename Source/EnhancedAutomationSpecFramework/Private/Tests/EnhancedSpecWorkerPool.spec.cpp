@@ -0,0 +1,53 @@
+﻿// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#include "EnhancedAutomationSpecBase.h"
+#include "EnhancedSpecWorkerPool.h"
+
+BEGIN_DEFINE_ENH_SPEC(FEnhancedSpecWorkerPoolSpec,
+                      "EnhancedUnrealSpecs.EnhancedSpecWorkerPool",
+                      EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+END_DEFINE_ENH_SPEC(FEnhancedSpecWorkerPoolSpec)
+
+void FEnhancedSpecWorkerPoolSpec::Define()
+{
+	Describe("Launch()", [=, this]
+	{
+		for (const EAsyncExecution Execution : {EAsyncExecution::TaskGraph,
+		                                        EAsyncExecution::ThreadPool,
+		                                        EAsyncExecution::Thread})
+		{
+			const FString Description = FString::Printf(
+				TEXT("runs work requested for execution %d off the game thread"),
+				static_cast<int32>(Execution)
+			);
+
+			It(Description, [=, this]
+			{
+				FEnhancedSpecWorkerPool&           WorkerPool  = FEnhancedSpecWorkerPool::Get();
+				const FEnhancedSpecWorkerPoolStats StatsBefore = WorkerPool.GetStats();
+				FThreadSafeBool                    bRanOnGameThread(true);
+
+				WorkerPool.Launch(Execution, [&bRanOnGameThread]
+				{
+					bRanOnGameThread = IsInGameThread();
+				}).Wait();
+
+				TestFalse("bRanOnGameThread", bRanOnGameThread);
+
+				if (WorkerPool.GetStats().NumThreads > 0)
+				{
+					const FEnhancedSpecWorkerPoolStats StatsAfter = WorkerPool.GetStats();
+
+					TestTrue(
+						"NumLaunched + NumOverflowed increased",
+						(StatsAfter.NumLaunched + StatsAfter.NumOverflowed) >
+						(StatsBefore.NumLaunched + StatsBefore.NumOverflowed)
+					);
+				}
+			});
+		}
+	});
+}
@@ -10,8 +10,16 @@
 
 #include <IAutomationControllerManager.h>
 
+#include <HAL/Event.h>
+
 #include <Misc/AutomationTest.h>
 
+#include "EnhancedSpecArena.h"
+#include "EnhancedSpecBenchmark.h"
+#include "EnhancedSpecFixture.h"
+
+struct FEnhancedSpecListingSet;
+
 // =====================================================================================================================
 // Macro Declarations
 // =====================================================================================================================
@@ -22,7 +30,8 @@
 	class TClass : public FEnhancedAutomationSpecBase \
 	{ \
 	public: \
-		TClass(const FString& InName) : FEnhancedAutomationSpecBase(InName, false) \
+		TClass(const FString& InName, const ANSICHAR* InModuleName = "") : \
+			FEnhancedAutomationSpecBase(InName, false, InModuleName) \
 		{ \
 			static_assert((TFlags)&EAutomationTestFlags::ApplicationContextMask, "AutomationTest has no application flag. It shouldn't run. See AutomationTest.h."); \
 			static_assert((((TFlags)&EAutomationTestFlags::FilterMask) == EAutomationTestFlags::SmokeFilter) || \
@@ -77,7 +86,7 @@
 		DEFINE_ENH_SPEC_PRIVATE(TClass, PrettyName, TFlags, __FILE__, __LINE__) \
 		namespace\
 		{\
-			TClass TClass##AutomationSpecInstance(TEXT(#TClass));\
+			TClass TClass##AutomationSpecInstance(TEXT(#TClass), UE_MODULE_NAME);\
 		}
 
 	/**
@@ -122,7 +131,7 @@
 		};\
 		namespace\
 		{\
-			TClass TClass##AutomationSpecInstance(TEXT(#TClass));\
+			TClass TClass##AutomationSpecInstance(TEXT(#TClass), UE_MODULE_NAME);\
 		}
 #else
 	/**
@@ -230,6 +239,18 @@
 #define REDEFINE_LET(Name, Type, Captures, RegeneratorBody) \
 	RedefineLet(Name, TGeneratorRedefineFunc<Type>(Captures(const TSpecVariablePtr<Type>& Previous) RegeneratorBody))
 
+#if defined(__clang__) || defined(__GNUC__) || (defined(_MSC_VER) && (_MSC_VER >= 1926))
+	/**
+	 * Whether the compiler can capture the file and line of a call site in a default argument.
+	 */
+	#define ENH_SPEC_HAS_BUILTIN_SOURCE_LOCATION 1
+#else
+	/**
+	 * Whether the compiler can capture the file and line of a call site in a default argument.
+	 */
+	#define ENH_SPEC_HAS_BUILTIN_SOURCE_LOCATION 0
+#endif
+
 // =====================================================================================================================
 // Normal Declarations
 // =====================================================================================================================
@@ -255,6 +276,10 @@ private:
 
 	class FSpecLetWildcard;
 
+	struct FSpecVariableRunState;
+
+	struct FSpecDeferredScope;
+
 public:
 	// =================================================================================================================
 	// Public Type Aliases
@@ -283,9 +308,12 @@ public:
 	using TGeneratorRedefineFunc = TFunction<VariableType(const TSpecVariablePtr<VariableType>)>;
 
 	/**
-	 * Alias for a map of variables in a spec scope.
+	 * Alias for the table of variables in a spec scope.
+	 *
+	 * The table is dense and indexed by the slot index that was assigned to each variable when it was declared with
+	 * Let(). Slots for variables that have not been defined in a scope hold null pointers.
 	 */
-	using FSpecVariableScope = TMap<FSpecBlockHandle, FSpecVariablePtrWildcard>;
+	using FSpecVariableScope = TArray<FSpecVariablePtrWildcard>;
 
 	// =================================================================================================================
 	// Public Type Definitions
@@ -381,12 +409,215 @@ public:
 		void Assign();
 	};
 
+	/**
+	 * A flag that tells asynchronous work that it has been abandoned and should stop as soon as it can.
+	 *
+	 * Each run of an asynchronous block gets a new token. When the block times out, its token is canceled and the test
+	 * moves on without waiting for the work to return. Work that runs for a long time should check the token
+	 * periodically (e.g., between iterations of a loop) and return early once it has been canceled, so that it does
+	 * not keep occupying a worker thread for the rest of the session.
+	 */
+	class FSpecCancellationToken final
+	{
+		// =============================================================================================================
+		// Private Fields
+		// =============================================================================================================
+		/**
+		 * Whether the work that was given this token has been abandoned.
+		 */
+		FThreadSafeBool bIsCanceled;
+
+	public:
+		// =============================================================================================================
+		// Public Constructor
+		// =============================================================================================================
+		/**
+		 * Constructs a new instance that has not been canceled.
+		 */
+		explicit FSpecCancellationToken() : bIsCanceled(false)
+		{
+		}
+
+		// =============================================================================================================
+		// Public Instance Methods
+		// =============================================================================================================
+		/**
+		 * Requests that the work which was given this token stop as soon as it can.
+		 */
+		FORCEINLINE void Cancel()
+		{
+			this->bIsCanceled = true;
+		}
+
+		/**
+		 * Gets whether the work that was given this token has been abandoned.
+		 *
+		 * @return
+		 *	true if the work should stop as soon as it can; or, false if it should continue.
+		 */
+		UE_NODISCARD FORCEINLINE bool IsCanceled() const
+		{
+			return this->bIsCanceled;
+		}
+	};
+
+	/**
+	 * A flag that a waiting command raises once it may be able to make progress.
+	 *
+	 * A command that spans multiple frames arms its signal each time it starts a run, and raises it when the work of
+	 * that run completes, from whichever thread the work ran on. The deadline of the run is registered with the timer
+	 * queue of the session, which raises the signal once the run has timed out. Until then, the sequence that is
+	 * running the command skips updating it, rather than checking on it every frame.
+	 */
+	class FSpecWakeSignal final
+	{
+		// =============================================================================================================
+		// Private Fields
+		// =============================================================================================================
+		/**
+		 * Identifies the run for which this signal was most recently armed.
+		 */
+		FThreadSafeCounter Generation;
+
+		/**
+		 * Whether the command that owns this signal may be able to make progress.
+		 */
+		FThreadSafeBool bIsRaised;
+
+	public:
+		// =============================================================================================================
+		// Public Constructor
+		// =============================================================================================================
+		/**
+		 * Constructs a new instance that is raised, so that a command is always updated before it first waits.
+		 */
+		explicit FSpecWakeSignal() : bIsRaised(true)
+		{
+		}
+
+		// =============================================================================================================
+		// Public Instance Methods
+		// =============================================================================================================
+		/**
+		 * Lowers this signal for a new run of the command that owns it.
+		 *
+		 * @return
+		 *	The generation of the new run, which the timer queue uses to ignore deadlines of earlier runs.
+		 */
+		FORCEINLINE int32 Arm()
+		{
+			this->bIsRaised = false;
+
+			return this->Generation.Increment();
+		}
+
+		/**
+		 * Raises this signal, so that the command that owns it is updated again.
+		 */
+		FORCEINLINE void Raise()
+		{
+			this->bIsRaised = true;
+		}
+
+		/**
+		 * Raises this signal if it has not been armed again since a given run started.
+		 *
+		 * @param RunGeneration
+		 *	The generation that Arm() returned when the run started.
+		 */
+		FORCEINLINE void Raise(const int32 RunGeneration)
+		{
+			if (this->Generation.GetValue() == RunGeneration)
+			{
+				this->bIsRaised = true;
+			}
+		}
+
+		/**
+		 * Gets whether the command that owns this signal may be able to make progress.
+		 *
+		 * @return
+		 *	true if the command should be updated; or, false if it is still waiting.
+		 */
+		UE_NODISCARD FORCEINLINE bool IsRaised() const
+		{
+			return this->bIsRaised;
+		}
+	};
+
+	/**
+	 * The location in source code at which a block of a specification was defined.
+	 *
+	 * When Current() is used as a default argument, the compiler substitutes the file and line number of the call site
+	 * at compile time, so test results can link back to the code that defined each expectation without having to walk
+	 * and symbolicate the call stack at runtime.
+	 */
+	struct FSpecSourceLocation final
+	{
+		// =============================================================================================================
+		// Public Fields
+		// =============================================================================================================
+		/**
+		 * The filename of the source file, or a null pointer if the location is not known.
+		 */
+		const ANSICHAR* Filename;
+
+		/**
+		 * The line number within the source file.
+		 */
+		int32 LineNumber;
+
+		// =============================================================================================================
+		// Public Static Methods
+		// =============================================================================================================
+		/**
+		 * Captures the location of the caller.
+		 *
+		 * This must be invoked as a default argument for the location to be that of the code calling the function to
+		 * which the default argument belongs. If the compiler does not support capturing source locations, the
+		 * location that is returned is unknown.
+		 *
+		 * @param Filename
+		 *	The filename of the caller. Supplied automatically by the compiler.
+		 * @param LineNumber
+		 *	The line number of the caller. Supplied automatically by the compiler.
+		 *
+		 * @return
+		 *	The location of the caller.
+		 */
+		UE_NODISCARD static constexpr FSpecSourceLocation Current(
+#if ENH_SPEC_HAS_BUILTIN_SOURCE_LOCATION
+			const ANSICHAR* Filename   = __builtin_FILE(),
+			const int32     LineNumber = __builtin_LINE())
+#else
+			const ANSICHAR* Filename   = nullptr,
+			const int32     LineNumber = 0)
+#endif
+		{
+			return FSpecSourceLocation{ Filename, LineNumber };
+		}
+
+		// =============================================================================================================
+		// Public Instance Methods
+		// =============================================================================================================
+		/**
+		 * Checks whether this location identifies a place in source code.
+		 *
+		 * @return
+		 *	true if the filename of this location is known; or, false otherwise.
+		 */
+		UE_NODISCARD constexpr bool IsKnown() const
+		{
+			return (this->Filename != nullptr);
+		}
+	};
+
 	/**
 	 * A reference to a variable in a test context.
 	 *
-	 * The real value of the variable is not stored in this object; rather, the value is retrieved from the variable map
-	 * of the current scope (the active spec). This allows the value of a variable to be redefined in nested scopes in a
-	 * way that impacts outer scopes (e.g., BeforeEach()).
+	 * The real value of the variable is not stored in this object; rather, the value is retrieved from the variable
+	 * table of the current scope (the active spec). This allows the value of a variable to be redefined in nested
+	 * scopes in a way that impacts outer scopes (e.g., BeforeEach()).
 	 *
 	 * @tparam VariableType
 	 *	The type of the variable.
@@ -398,11 +629,12 @@ public:
 		// Private Fields
 		// =============================================================================================================
 		/**
-		 * The unique handle of this variable.
+		 * The index of the slot that holds this variable in the variable table of each spec.
 		 *
-		 * This handle uniquely defines this variable and is retained even if the value of the variable is redefined.
+		 * Slots are assigned sequentially by Let() and are unique within a spec class. The slot of a variable is
+		 * retained even if the value of the variable is redefined.
 		 */
-		FSpecBlockHandle Handle;
+		int32 SlotIndex;
 
 		/**
 		 * The outer test.
@@ -418,8 +650,12 @@ public:
 		 *
 		 * @param Spec
 		 *	The outer test.
+		 * @param SlotIndex
+		 *	The index of the slot that holds the variable in the variable table of each spec.
 		 */
-		explicit TSpecVariable(const FEnhancedAutomationSpecBase* const Spec) : Spec(Spec)
+		explicit TSpecVariable(const FEnhancedAutomationSpecBase* const Spec, const int32 SlotIndex) :
+			SlotIndex(SlotIndex),
+			Spec(Spec)
 		{
 		}
 
@@ -427,14 +663,14 @@ public:
 		// Public Methods
 		// =============================================================================================================
 		/**
-		 * Gets the unique handle for this variable.
+		 * Gets the index of the slot that holds this variable in the variable table of each spec.
 		 *
 		 * @return
-		 *	The block handle for this variable.
+		 *	The slot index for this variable.
 		 */
-		UE_NODISCARD FORCEINLINE FSpecBlockHandle GetHandle() const
+		UE_NODISCARD FORCEINLINE int32 GetSlotIndex() const
 		{
-			return this->Handle;
+			return this->SlotIndex;
 		}
 
 		/**
@@ -449,9 +685,7 @@ public:
 		UE_NODISCARD FORCEINLINE VariableType& Get() const
 		{
 			// ReSharper disable once CppRedundantTemplateKeyword
-			TSpecVariablePtr<VariableType> VariablePtr = this->Spec->template GetVariable<VariableType>(this->Handle);
-
-			return VariablePtr->Get();
+			return this->Spec->template GetVariable<VariableType>(this->SlotIndex).Get();
 		}
 
 		/**
@@ -487,11 +721,40 @@ private:
 	// =================================================================================================================
 	// Private Type Definitions
 	// =================================================================================================================
+	/**
+	 * The state shared by all variables that are read while a test case runs.
+	 *
+	 * Sequential test cases share the run state of their spec. Each test case that runs in parallel has its own.
+	 */
+	struct FSpecVariableRunState final
+	{
+		// =============================================================================================================
+		// Public Fields
+		// =============================================================================================================
+		/**
+		 * The generation of the test case that is currently running.
+		 *
+		 * This is advanced each time a test case starts, so that variables can tell lazily, when they are next read,
+		 * whether the values they memoized belong to an earlier test case. Generation 0 is never used, so that
+		 * variables which have never generated a value are always treated as stale.
+		 */
+		uint64 Generation = 1;
+
+		/**
+		 * The variables that have generated values during the current test case.
+		 *
+		 * Only these variables hold values that need to be destroyed when the test case ends, so variables that a test
+		 * case never reads cost nothing.
+		 */
+		TArray<FSpecLetWildcard*> GeneratedVariables;
+	};
+
 	/**
 	 * Un-templated base class for variables declared with Let() in spec contexts.
 	 *
-	 * This class mainly exists to give us a concrete type to store in the map of variables in tests, since maps require
-	 * a concrete value type. At execution time, this type is downcast to the specific variable type upon retrieval.
+	 * This class mainly exists to give us a concrete type to store in the table of variables in tests, since tables
+	 * require a concrete element type. At execution time, this type is downcast to the specific variable type upon
+	 * retrieval.
 	 */
 	class FSpecLetWildcard
 	{
@@ -500,17 +763,29 @@ private:
 		// Protected Fields
 		// =============================================================================================================
 		/**
-		 * Whether the value of the variable has been generated and memoized during the current test.
+		 * The state of the test case that is currently running, which is owned by the spec that defined the variable
+		 * (or, for copies made to run a test case in parallel, by the context of that test case).
+		 */
+		FSpecVariableRunState* RunState;
+
+		/**
+		 * The generation of the test during which the value of the variable was last generated and memoized; or, 0 if
+		 * the value has never been generated.
 		 */
-		bool bWasGenerated;
+		uint64 GeneratedGeneration;
 
 		// =============================================================================================================
 		// Protected Constructors
 		// =============================================================================================================
 		/**
 		 * Constructs a new instance.
+		 *
+		 * @param RunState
+		 *	The state of the test case that is currently running.
 		 */
-		explicit FSpecLetWildcard() : bWasGenerated(false)
+		explicit FSpecLetWildcard(FSpecVariableRunState* RunState) :
+			RunState(RunState),
+			GeneratedGeneration(0)
 		{
 		}
 
@@ -524,63 +799,60 @@ private:
 		// Public Methods
 		// =============================================================================================================
 		/**
-		 * Resets the value of this variable so that will regenerate its value on the next request.
+		 * Destroys the value of this variable, if it has one, so that it no longer occupies memory.
+		 *
+		 * The value is generated again the next time it is requested.
 		 */
-		virtual void Reset()
-		{
-			this->bWasGenerated = false;
-		}
+		virtual void Release() = 0;
 
+		/**
+		 * Creates an independent copy of this variable that has not yet generated a value.
+		 *
+		 * Prior definitions of the variable are copied as well, so that the copy never shares memoized state with this
+		 * variable. This is used to give each spec that runs in parallel its own variables.
+		 *
+		 * @param CopyRunState
+		 *	The state of the test case for which the copy is being made.
+		 *
+		 * @return
+		 *	The copy of this variable.
+		 */
+		UE_NODISCARD virtual FSpecVariablePtrWildcard Clone(FSpecVariableRunState* CopyRunState) const = 0;
+
+	protected:
 		// =============================================================================================================
 		// Protected Methods
 		// =============================================================================================================
+		/**
+		 * Gets whether the value of this variable has been generated and memoized during the current test.
+		 *
+		 * @return
+		 *	true if the memoized value belongs to the current test; or, false if it is missing or stale.
+		 */
 		UE_NODISCARD FORCEINLINE bool WasGenerated() const
 		{
-			return this->bWasGenerated;
+			return (this->GeneratedGeneration == this->RunState->Generation);
 		}
-	};
 
-	/**
-	 * A placeholder for a Let() block that performs no operation and returns the default value for a type.
-	 *
-	 * This is instantiated as the "prior definition" for the first definition of a variable within a scope.
-	 *
-	 * @tparam VariableType
-	 *	The type of variable that this is standing in for.
-	 */
-	template <typename VariableType>
-	class TNoOpSpecLet final : public TSpecLet<VariableType>
-	{
-	public:
-		// =============================================================================================================
-		// Public Constructors and Destructors
-		// =============================================================================================================
 		/**
-		 * Constructs a new instance.
+		 * Records that the value of this variable has been generated and memoized during the current test.
 		 */
-		explicit TNoOpSpecLet() :
-			TSpecLet<VariableType>(
-				TGeneratorRedefineFunc<VariableType>([](const TSpecVariablePtr<VariableType>&)
-				{
-					return VariableType();
-				}),
-				TSpecVariablePtr<VariableType>()
-			)
+		FORCEINLINE void MarkAsGenerated()
 		{
+			this->GeneratedGeneration = this->RunState->Generation;
+			this->RunState->GeneratedVariables.Add(this);
 		}
-
-		/**
-		 * Destructs this instance.
-		 */
-		virtual ~TNoOpSpecLet() override = default;
 	};
 
 	/**
 	 * A lazy-loaded, memoized variable that can be defined in a spec. scope and overridden in nested scopes.
 	 *
-	 * This is the actual object stored in the variables map of a test. Tests generate and retrieve the value from this
+	 * This is the actual object stored in the variable table of a test. Tests generate and retrieve the value from this
 	 * object via a TSpecVariable object, which acts like a handle.
 	 *
+	 * The value is constructed in place from the result of the generator the first time it is requested during a test,
+	 * so the type of the variable does not need to be default-constructible, and the value is never constructed twice.
+	 *
 	 * @tparam VariableType
 	 *	The type of the variable.
 	 */
@@ -591,7 +863,8 @@ private:
 		// Private Fields
 		// =============================================================================================================
 		/**
-		 * The original definition of this variable within the same scope.
+		 * The original definition of this variable within the same scope, or a null pointer if this is the first
+		 * definition of the variable.
 		 *
 		 * This enables a re-definition of an existing variable to be based on the prior value of the same variable.
 		 */
@@ -609,9 +882,14 @@ private:
 		TGeneratorRedefineFunc<VariableType> GeneratorFunc;
 
 		/**
-		 * The value of this variable (if any) that was memoized during the current test.
+		 * Storage for the value of this variable (if any) that was memoized during the current test.
 		 */
-		VariableType MemoizedValue;
+		TTypeCompatibleBytes<VariableType> ValueStorage;
+
+		/**
+		 * Whether a value has been constructed in the storage and not yet destroyed.
+		 */
+		bool bHasValue;
 
 		// =============================================================================================================
 		// Public Constructors and Destructors
@@ -620,21 +898,28 @@ private:
 		/**
 		 * Constructs a new instance for a Let() block that has no prior definition in outer scopes.
 		 *
+		 * @param RunState
+		 *	The state of the test case that is currently running, which is owned by the spec that is defining the
+		 *	variable.
 		 * @param GeneratorFunc
 		 *	The lambda to invoke to generate the value of the variable. The lambda receives a const pointer to the
 		 *	previous definition of variable, to enable the variable to base its value on its prior definition. If the
 		 *	variable has been redefined multiple times (e.g., through multiple nested scopes), the variables are
 		 *	chained, so only the prior definition is accessible within each lambda.
 		 */
-		explicit TSpecLet(TGeneratorRedefineFunc<VariableType> GeneratorFunc) :
-			PriorDefinition(TSharedPtr<TSpecLet>(new TNoOpSpecLet<VariableType>())),
-			GeneratorFunc(MoveTemp(GeneratorFunc))
+		explicit TSpecLet(FSpecVariableRunState* RunState, TGeneratorRedefineFunc<VariableType> GeneratorFunc) :
+			FSpecLetWildcard(RunState),
+			GeneratorFunc(MoveTemp(GeneratorFunc)),
+			bHasValue(false)
 		{
 		}
 
 		/**
 		 * Constructs a new instance for a Let() block that is redefining a definition from outer scopes.
 		 *
+		 * @param RunState
+		 *	The state of the test case that is currently running, which is owned by the spec that is defining the
+		 *	variable.
 		 * @param PriorDefinition
 		 *	The original definition of this variable from an outer scope or earlier within the same scope.
 		 * @param GeneratorFunc
@@ -643,9 +928,13 @@ private:
 		 *	variable has been redefined multiple times (e.g., through multiple nested scopes), the variables are
 		 *	chained, so only the prior definition is accessible within each lambda.
 		 */
-		explicit TSpecLet(TGeneratorRedefineFunc<VariableType> GeneratorFunc, TSharedPtr<TSpecLet> PriorDefinition) :
+		explicit TSpecLet(FSpecVariableRunState*               RunState,
+		                  TGeneratorRedefineFunc<VariableType> GeneratorFunc,
+		                  TSharedPtr<TSpecLet>                 PriorDefinition) :
+			FSpecLetWildcard(RunState),
 			PriorDefinition(MoveTemp(PriorDefinition)),
-			GeneratorFunc(MoveTemp(GeneratorFunc))
+			GeneratorFunc(MoveTemp(GeneratorFunc)),
+			bHasValue(false)
 		{
 		}
 
@@ -654,7 +943,8 @@ private:
 		 */
 		virtual ~TSpecLet() override
 		{
-		};
+			this->DestroyValue();
+		}
 
 		// =============================================================================================================
 		// Public Methods
@@ -671,11 +961,16 @@ private:
 		{
 			if (!this->WasGenerated())
 			{
-				this->MemoizedValue = this->GeneratorFunc(this->PriorDefinition);
-				this->bWasGenerated = true;
+				// Destroy any value left over from an earlier test first, so that two values never coexist.
+				this->DestroyValue();
+
+				new (this->ValueStorage.GetTypedPtr()) VariableType(this->GeneratorFunc(this->PriorDefinition));
+
+				this->bHasValue = true;
+				this->MarkAsGenerated();
 			}
 
-			return this->MemoizedValue;
+			return *this->ValueStorage.GetTypedPtr();
 		}
 
 		/**
@@ -709,56 +1004,278 @@ private:
 		// =============================================================================================================
 		// Public Methods - FSpecLetWildcard Overrides
 		// =============================================================================================================
-		virtual void Reset() override
+		virtual void Release() override
+		{
+			this->DestroyValue();
+
+			// Force the value to be generated again if it is requested later in the same test.
+			this->GeneratedGeneration = 0;
+		}
+
+		virtual FSpecVariablePtrWildcard Clone(FSpecVariableRunState* CopyRunState) const override
+		{
+			TSharedPtr<TSpecLet> PriorClone;
+
+			if (this->PriorDefinition.IsValid())
+			{
+				PriorClone = StaticCastSharedPtr<TSpecLet>(this->PriorDefinition->Clone(CopyRunState));
+			}
+
+			return FSpecVariablePtrWildcard(new TSpecLet(CopyRunState, this->GeneratorFunc, MoveTemp(PriorClone)));
+		}
+
+	private:
+		// =============================================================================================================
+		// Private Methods
+		// =============================================================================================================
+		/**
+		 * Destroys the value in the storage of this variable, if there is one.
+		 */
+		void DestroyValue()
 		{
-			FSpecLetWildcard::Reset();
+			if (this->bHasValue)
+			{
+				DestructItem(this->ValueStorage.GetTypedPtr());
 
-			this->MemoizedValue = VariableType();
+				this->bHasValue = false;
+			}
 		}
 	};
 
 	/**
-	 * An automation test command that just runs code and waits until it returns.
-	 *
-	 * The code executes within a single engine frame.
+	 * Base class for all automation test commands created by the spec. DSL (It(), BeforeEach(), AfterEach(), etc.).
 	 */
-	class FSimpleBlockingCommand final : public IAutomationLatentCommand
+	class FSpecLatentCommand : public IAutomationLatentCommand
 	{
 		// =============================================================================================================
 		// Private Fields
 		// =============================================================================================================
 		/**
-		 * The automation test specification that supplied the code for this command.
+		 * The kind of block that this command runs (e.g., "BeforeEach" or "It"), or a null pointer if runs of this
+		 * command are not being traced.
 		 */
-		const FEnhancedAutomationSpecBase* const Spec;
+		const TCHAR* TraceCategory = nullptr;
 
 		/**
-		 * The code to execute for this command.
+		 * The descriptions of the scopes that enclose the block of this command, separated by periods.
 		 */
-		const TFunction<void()> Work;
+		FString TraceScope;
 
+	protected:
+		// =============================================================================================================
+		// Protected Fields
+		// =============================================================================================================
 		/**
-		 * Whether this command should skip execution if the parent specification has reported a failure in prior tests.
+		 * The time at which the current run of this command started, in seconds, as reported by
+		 * FPlatformTime::Seconds().
 		 */
-		const bool bSkipIfErrored;
+		double TraceStartSeconds = 0.0;
+
+		/**
+		 * The time at which the work of the current run of this command finished, in seconds; or, 0 if it has not yet
+		 * finished.
+		 */
+		double TraceEndSeconds = 0.0;
+
+		/**
+		 * The engine frame during which the current run of this command started.
+		 */
+		uint64 TraceStartFrame = 0;
+
+		/**
+		 * The ID of the thread that is running the work of the current run of this command.
+		 */
+		uint32 TraceThreadId = 0;
 
 	public:
 		// =============================================================================================================
-		// Public Constructor / Destructor
+		// Public Methods
 		// =============================================================================================================
 		/**
-		 * Constructs a new instance.
+		 * Enables tracing of each run of this command.
 		 *
-		 * @param Spec
-		 *	The automation test specification that is instantiating this command.
-		 * @param Work
-		 *	The code the command should execute.
-		 * @param bInSkipIfErrored
-		 *	Whether the command should skip execution if the parent specification reports failures in prior tests.
+		 * @param Category
+		 *	The kind of block that this command runs (e.g., "BeforeEach" or "It").
+		 * @param Scope
+		 *	The descriptions of the scopes that enclose the block of this command, separated by periods.
 		 */
-		FSimpleBlockingCommand(const FEnhancedAutomationSpecBase* const Spec,
-		                       TFunction<void()>                        Work,
-		                       const bool                               bInSkipIfErrored = false) :
+		void SetTraceInfo(const TCHAR* Category, FString Scope)
+		{
+			this->TraceCategory = Category;
+			this->TraceScope    = MoveTemp(Scope);
+		}
+
+		/**
+		 * Gets whether this command always finishes its work within a single call to Update(), on the calling thread.
+		 *
+		 * Only specs made entirely of synchronous commands are eligible to run in parallel with other specs.
+		 *
+		 * @return
+		 *	true if the command is synchronous; or, false if the command spans multiple frames or other threads.
+		 */
+		UE_NODISCARD virtual bool IsSynchronous() const = 0;
+
+		/**
+		 * Blocks the calling thread until this command has likely made progress, so that it can be updated again.
+		 *
+		 * This lets a runner react to a command finishing on another thread right away, rather than on the next frame.
+		 * Commands that only make progress when the engine ticks (or that do not know how they will make progress)
+		 * return immediately without waiting.
+		 *
+		 * @param MaxWaitSeconds
+		 *	The longest that the calling thread is willing to wait, in seconds.
+		 *
+		 * @return
+		 *	true if this command waited, and should be updated again before yielding to the engine; or, false if this
+		 *	command cannot be waited on.
+		 */
+		virtual bool WaitForProgress(const double MaxWaitSeconds)
+		{
+			return false;
+		}
+
+		/**
+		 * Gets the signal that this command raises once it may be able to make progress after Update() returned false.
+		 *
+		 * @return
+		 *	The signal of this command; or, a null pointer if the command must be updated every frame while it waits.
+		 */
+		virtual TSharedPtr<FSpecWakeSignal> GetWakeSignal() const
+		{
+			return nullptr;
+		}
+
+	protected:
+		// =============================================================================================================
+		// Protected Methods
+		// =============================================================================================================
+		/**
+		 * Gets whether runs of this command are being traced.
+		 *
+		 * @return
+		 *	true if each run of this command is recorded to the trace or the duration baseline of the session; or,
+		 *	false otherwise.
+		 */
+		FORCEINLINE bool IsTraced() const
+		{
+			return (this->TraceCategory != nullptr);
+		}
+
+		/**
+		 * Gets whether this command runs the code of an It() block, rather than of a hook like BeforeEach().
+		 *
+		 * This is only known for commands that are traced.
+		 *
+		 * @return
+		 *	true if this command is traced and runs the code of an It() block; or, false otherwise.
+		 */
+		bool IsItBlock() const;
+
+		/**
+		 * Notes that a run of this command is starting on the calling thread, if runs of this command are being traced.
+		 */
+		void BeginTrace();
+
+		/**
+		 * Notes that the work of the current run of this command is running on the calling thread, if runs of this
+		 * command are being traced.
+		 */
+		void MarkTraceThread();
+
+		/**
+		 * Notes that the work of the current run of this command has finished, if runs of this command are being
+		 * traced.
+		 */
+		void MarkTraceWorkDone();
+
+		/**
+		 * Records the current run of this command to the trace of the session, if runs of this command are being
+		 * traced.
+		 *
+		 * @param Spec
+		 *	The automation test specification that supplied the code for this command.
+		 * @param bTimedOut
+		 *	Whether the run timed out before its work finished.
+		 */
+		void EndTrace(const FEnhancedAutomationSpecBase& Spec, const bool bTimedOut);
+
+		/**
+		 * Arms the signal of this command for a new run, and registers the deadline of the run with the timer queue.
+		 *
+		 * @param Signal
+		 *	The signal of this command.
+		 * @param Deadline
+		 *	The time after which the run times out, in seconds, as reported by FPlatformTime::Seconds().
+		 */
+		static void ArmWakeSignal(const TSharedRef<FSpecWakeSignal>& Signal, const double Deadline);
+
+		/**
+		 * Records a run of this command to the trace of the session, and to the duration baseline if the command runs a
+		 * hook, depending on which of them are enabled.
+		 *
+		 * @param Spec
+		 *	The automation test specification that supplied the code for this command.
+		 * @param StartSeconds
+		 *	The time at which the run started, in seconds, as reported by FPlatformTime::Seconds().
+		 * @param StartFrame
+		 *	The engine frame during which the run started.
+		 * @param EndSeconds
+		 *	The time at which the run finished, in seconds, as reported by FPlatformTime::Seconds().
+		 * @param ThreadId
+		 *	The ID of the thread that ran the work of the run.
+		 * @param bTimedOut
+		 *	Whether the run timed out before its work finished.
+		 */
+		void RecordTrace(const FEnhancedAutomationSpecBase& Spec,
+		                 const double                       StartSeconds,
+		                 const uint64                       StartFrame,
+		                 const double                       EndSeconds,
+		                 const uint32                       ThreadId,
+		                 const bool                         bTimedOut) const;
+	};
+
+	/**
+	 * An automation test command that just runs code and waits until it returns.
+	 *
+	 * The code executes within a single engine frame.
+	 */
+	class FSimpleBlockingCommand final : public FSpecLatentCommand
+	{
+		// =============================================================================================================
+		// Private Fields
+		// =============================================================================================================
+		/**
+		 * The automation test specification that supplied the code for this command.
+		 */
+		FEnhancedAutomationSpecBase* const Spec;
+
+		/**
+		 * The code to execute for this command.
+		 */
+		const TFunction<void()> Work;
+
+		/**
+		 * Whether this command should skip execution if the parent specification has reported a failure in prior tests.
+		 */
+		const bool bSkipIfErrored;
+
+	public:
+		// =============================================================================================================
+		// Public Constructor / Destructor
+		// =============================================================================================================
+		/**
+		 * Constructs a new instance.
+		 *
+		 * @param Spec
+		 *	The automation test specification that is instantiating this command.
+		 * @param Work
+		 *	The code the command should execute.
+		 * @param bInSkipIfErrored
+		 *	Whether the command should skip execution if the parent specification reports failures in prior tests.
+		 */
+		FSimpleBlockingCommand(FEnhancedAutomationSpecBase* const Spec,
+		                       TFunction<void()>                  Work,
+		                       const bool                         bInSkipIfErrored = false) :
 			Spec(Spec),
 			Work(MoveTemp(Work)),
 			bSkipIfErrored(bInSkipIfErrored)
@@ -776,12 +1293,20 @@ private:
 		// Public Methods - IAutomationLatentCommand Overrides
 		// =============================================================================================================
 		virtual bool Update() override;
+
+		// =============================================================================================================
+		// Public Methods - FSpecLatentCommand Overrides
+		// =============================================================================================================
+		virtual bool IsSynchronous() const override
+		{
+			return true;
+		}
 	};
 
 	/**
 	 * An automation test command for performing actions asynchronously with custom execution.
 	 */
-	class FAsyncCommand final : public IAutomationLatentCommand
+	class FAsyncCommand final : public FSpecLatentCommand
 	{
 		// =============================================================================================================
 		// Private Fields
@@ -811,15 +1336,35 @@ private:
 		 */
 		const bool bSkipIfErrored;
 
+		/**
+		 * Whether the command has started running.
+		 */
+		FThreadSafeBool bHasStartedRunning;
+
 		/**
 		 * Indicates whether this command has finished running.
 		 */
 		FThreadSafeBool bDone;
 
 		/**
-		 * The date and time that the command started running (for timing).
+		 * The time after which the command times out, in seconds, as reported by FPlatformTime::Seconds().
+		 */
+		double Deadline;
+
+		/**
+		 * An event that is triggered when the work of this command has completed running.
+		 */
+		FEventRef CompletionEvent;
+
+		/**
+		 * The signal that is raised when the work of this command completes or times out.
+		 */
+		const TSharedRef<FSpecWakeSignal> WakeSignal;
+
+		/**
+		 * The token given to the current run of the work, which is canceled if the work times out.
 		 */
-		FDateTime StartTime;
+		TSharedPtr<FSpecCancellationToken> CancellationToken;
 
 		/**
 		 * The eventual result of executing the work.
@@ -854,7 +1399,10 @@ private:
 			Work(MoveTemp(Work)),
 			Timeout(Timeout),
 			bSkipIfErrored(bSkipIfErrored),
-			bDone(false)
+			bHasStartedRunning(false),
+			bDone(false),
+			Deadline(0.0),
+			WakeSignal(MakeShared<FSpecWakeSignal>())
 		{
 		}
 
@@ -870,11 +1418,35 @@ private:
 		// =============================================================================================================
 		virtual bool Update() override;
 
+		// =============================================================================================================
+		// Public Methods - FSpecLatentCommand Overrides
+		// =============================================================================================================
+		virtual bool IsSynchronous() const override
+		{
+			return false;
+		}
+
+		virtual bool WaitForProgress(const double MaxWaitSeconds) override;
+
+		virtual TSharedPtr<FSpecWakeSignal> GetWakeSignal() const override
+		{
+			return this->WakeSignal;
+		}
+
 	private:
 		/**
 		 * Callback invoked when the work of the command has completed running.
+		 *
+		 * @param Token
+		 *	The token that was given to the run of the work that completed. If the run has since been abandoned, the
+		 *	completion is ignored.
 		 */
-		void Done();
+		void Done(const TSharedRef<FSpecCancellationToken> Token);
+
+		/**
+		 * Cancels the current run of the work and hands it off to be joined at the end of the session.
+		 */
+		void Abandon();
 
 		/**
 		 * Clears and resets the state of this command so that it can be run again.
@@ -888,7 +1460,7 @@ private:
 	 * When using this variation, the test will not continue execution to the next code block in the test sequence until
 	 * the actively running latent code block invokes the Done() delegate.
 	 */
-	class FMultiFrameLatentCommand final : public IAutomationLatentCommand
+	class FMultiFrameLatentCommand final : public FSpecLatentCommand
 	{
 		// =============================================================================================================
 		// Private Fields
@@ -919,15 +1491,20 @@ private:
 		bool bHasStartedRunning;
 
 		/**
-		 * The date and time that the command started running (for timing).
+		 * The time after which the command times out, in seconds, as reported by FPlatformTime::Seconds().
 		 */
-		FDateTime StartTime;
+		double Deadline;
 
 		/**
 		 * Indicates whether this command has finished running.
 		 */
 		FThreadSafeBool bDone;
 
+		/**
+		 * The signal that is raised when the work of this command completes or times out.
+		 */
+		const TSharedRef<FSpecWakeSignal> WakeSignal;
+
 	public:
 		// =============================================================================================================
 		// Public Constructor / Destructor
@@ -953,7 +1530,9 @@ private:
 			Timeout(Timeout),
 			bSkipIfErrored(bSkipIfErrored),
 			bHasStartedRunning(false),
-			bDone(false)
+			Deadline(0.0),
+			bDone(false),
+			WakeSignal(MakeShared<FSpecWakeSignal>())
 		{
 		}
 
@@ -969,6 +1548,19 @@ private:
 		// =============================================================================================================
 		virtual bool Update() override;
 
+		// =============================================================================================================
+		// Public Methods - FSpecLatentCommand Overrides
+		// =============================================================================================================
+		virtual bool IsSynchronous() const override
+		{
+			return false;
+		}
+
+		virtual TSharedPtr<FSpecWakeSignal> GetWakeSignal() const override
+		{
+			return this->WakeSignal;
+		}
+
 	private:
 		/**
 		 * Callback invoked when the work of the command has completed running.
@@ -987,7 +1579,7 @@ private:
 	 * When using this variation, the test will not continue execution to the next code block in the test sequence until
 	 * the actively running latent code block invokes the Done() delegate.
 	 */
-	class FAsyncMultiFrameLatentCommand final : public IAutomationLatentCommand
+	class FAsyncMultiFrameLatentCommand final : public FSpecLatentCommand
 	{
 		// =============================================================================================================
 		// Private Fields
@@ -1017,15 +1609,35 @@ private:
 		 */
 		const bool bSkipIfErrored;
 
+		/**
+		 * Whether the command has started running.
+		 */
+		FThreadSafeBool bHasStartedRunning;
+
 		/**
 		 * Indicates whether this command has finished running.
 		 */
 		FThreadSafeBool bDone;
 
 		/**
-		 * The date and time that the command started running (for timing).
+		 * The time after which the command times out, in seconds, as reported by FPlatformTime::Seconds().
+		 */
+		double Deadline;
+
+		/**
+		 * An event that is triggered when the work of this command has completed running.
+		 */
+		FEventRef CompletionEvent;
+
+		/**
+		 * The signal that is raised when the work of this command completes or times out.
+		 */
+		const TSharedRef<FSpecWakeSignal> WakeSignal;
+
+		/**
+		 * The token given to the current run of the work, which is canceled if the work times out.
 		 */
-		FDateTime StartTime;
+		TSharedPtr<FSpecCancellationToken> CancellationToken;
 
 		/**
 		 * The eventual result of executing the work.
@@ -1060,7 +1672,10 @@ private:
 			Work(MoveTemp(Work)),
 			Timeout(Timeout),
 			bSkipIfErrored(bSkipIfErrored),
-			bDone(false)
+			bHasStartedRunning(false),
+			bDone(false),
+			Deadline(0.0),
+			WakeSignal(MakeShared<FSpecWakeSignal>())
 		{
 		}
 
@@ -1076,11 +1691,35 @@ private:
 		// =============================================================================================================
 		virtual bool Update() override;
 
+		// =============================================================================================================
+		// Public Methods - FSpecLatentCommand Overrides
+		// =============================================================================================================
+		virtual bool IsSynchronous() const override
+		{
+			return false;
+		}
+
+		virtual bool WaitForProgress(const double MaxWaitSeconds) override;
+
+		virtual TSharedPtr<FSpecWakeSignal> GetWakeSignal() const override
+		{
+			return this->WakeSignal;
+		}
+
 	private:
 		/**
 		 * Callback invoked when the work of the command has completed running.
+		 *
+		 * @param Token
+		 *	The token that was given to the run of the work that completed. If the run has since been abandoned, the
+		 *	completion is ignored.
 		 */
-		void Done();
+		void Done(const TSharedRef<FSpecCancellationToken> Token);
+
+		/**
+		 * Cancels the current run of the work and hands it off to be joined at the end of the session.
+		 */
+		void Abandon();
 
 		/**
 		 * Clears and resets the state of this command so that it can be run again.
@@ -1088,6 +1727,90 @@ private:
 		void Reset();
 	};
 
+	/**
+	 * An automation test command that runs a sequence of other commands, as many as possible per frame.
+	 *
+	 * The automation framework only updates one latent command per frame, so enqueuing each block of a spec as its own
+	 * command would cost at least one frame per block, even for blocks that do not need to wait on anything. This
+	 * command instead keeps running commands in order within the same frame for as long as each one finishes
+	 * immediately, and only yields when a command needs to wait (e.g., a latent or asynchronous block) or when the
+	 * time budget for the frame (controlled by the "EnhancedSpecs.FrameBudgetMs" console variable) has been used up.
+	 *
+	 * While a command waits, the sequence does not update it again until the command raises its wake signal, either
+	 * because its work has completed or because the timer queue of the session has found that it timed out. Each frame
+	 * in between only costs the sequence a check of that signal.
+	 */
+	class FSpecCommandSequence final : public IAutomationLatentCommand
+	{
+		// =============================================================================================================
+		// Private Fields
+		// =============================================================================================================
+		/**
+		 * The automation test specification that supplied the commands.
+		 */
+		FEnhancedAutomationSpecBase* const Spec;
+
+		/**
+		 * The commands to run, in order.
+		 */
+		const TArray<TSharedRef<FSpecLatentCommand>> Commands;
+
+		/**
+		 * The index of the next command to update.
+		 */
+		int32 NextCommandIndex;
+
+		/**
+		 * The signal of the command that the sequence is waiting on; or, a null pointer if the next command should be
+		 * updated on the next frame.
+		 */
+		TSharedPtr<FSpecWakeSignal> PendingWakeSignal;
+
+	public:
+		// =============================================================================================================
+		// Public Constructor / Destructor
+		// =============================================================================================================
+		/**
+		 * Constructs a new instance.
+		 *
+		 * @param Spec
+		 *	The automation test specification that supplied the commands.
+		 * @param Commands
+		 *	The commands to run, in order.
+		 */
+		explicit FSpecCommandSequence(FEnhancedAutomationSpecBase* const     Spec,
+		                              TArray<TSharedRef<FSpecLatentCommand>> Commands) :
+			Spec(Spec),
+			Commands(MoveTemp(Commands)),
+			NextCommandIndex(0)
+		{
+		}
+
+		/**
+		 * Destructor.
+		 */
+		virtual ~FSpecCommandSequence() override
+		{
+		}
+
+		// =============================================================================================================
+		// Public Methods - IAutomationLatentCommand Overrides
+		// =============================================================================================================
+		virtual bool Update() override;
+
+	private:
+		// =============================================================================================================
+		// Private Methods
+		// =============================================================================================================
+		/**
+		 * Runs commands in order until one needs to wait or the time budget for the frame has been used up.
+		 *
+		 * @return
+		 *	true if every command has finished; or, false if commands remain to be run in a later frame.
+		 */
+		bool UpdateCommands();
+	};
+
 	/**
 	 * Represents an It() block within a specification.
 	 *
@@ -1125,7 +1848,7 @@ private:
 		/**
 		 * The automation command to invoke to execute the test case of this block.
 		 */
-		TSharedRef<IAutomationLatentCommand> Command;
+		TSharedRef<FSpecLatentCommand> Command;
 
 		// =============================================================================================================
 		// Public Constructor
@@ -1144,11 +1867,11 @@ private:
 		 * @param Command
 		 *	The automation command to invoke to execute the test case of the block.
 		 */
-		FSpecItDefinition(FString                              Id,
-		                  FString                              Description,
-		                  FString                              Filename,
-		                  int32                                LineNumber,
-		                  TSharedRef<IAutomationLatentCommand> Command) :
+		FSpecItDefinition(FString                        Id,
+		                  FString                        Description,
+		                  FString                        Filename,
+		                  int32                          LineNumber,
+		                  TSharedRef<FSpecLatentCommand> Command) :
 			Id(MoveTemp(Id)),
 			Description(MoveTemp(Description)),
 			Filename(MoveTemp(Filename)),
@@ -1162,22 +1885,35 @@ private:
 	 * Represents the scope of execution for one or more test cases being defined.
 	 *
 	 * This is the container for the setup (defined by BeforeAll() and BeforeEach()), execution (defined by It()), and
-	 * teardown (defined by AfterEach()) commands associated with test cases. The scope can also have zero or more child
-	 * scopes (defined by Describe()).
+	 * teardown (defined by AfterEach() and AfterAll()) commands associated with test cases. The scope can also have
+	 * zero or more child scopes (defined by Describe()).
 	 *
-	 * The data in this struct is only maintained while tests are being defined, but is then converted into an FSpec for
-	 * execution during PostDefine().
+	 * The data in this struct is only maintained while tests are being defined, but is then converted into an
+	 * FSpecScopeNode for execution during PostDefine().
 	 */
 	struct FSpecDefinitionScope final
 	{
 		// =============================================================================================================
 		// Public Fields
 		// =============================================================================================================
+		/**
+		 * A handle that uniquely identifies this scope during a test session.
+		 *
+		 * This is assigned when the scope is defined, so that AfterAll() blocks can refer to their scope before its
+		 * node has been built. The node of the scope receives the same handle.
+		 */
+		FSpecBlockHandle Handle;
+
 		/**
 		 * The human-readable description for this scope, as provided by Describe().
 		 */
 		FString Description;
 
+		/**
+		 * Whether the test cases within this scope may run concurrently, as requested by DescribeParallel().
+		 */
+		bool bRunInParallel = false;
+
 		/**
 		 * The variables defined in this scope.
 		 */
@@ -1186,12 +1922,12 @@ private:
 		/**
 		 * Latent commands to execute once before all It() blocks within the specification (including nested scopes).
 		 */
-		TArray<TSharedRef<IAutomationLatentCommand>> BeforeAll;
+		TArray<TSharedRef<FSpecLatentCommand>> BeforeAll;
 
 		/**
 		 * Latent commands to execute before each It() block within the specification (including nested scopes).
 		 */
-		TArray<TSharedRef<IAutomationLatentCommand>> BeforeEach;
+		TArray<TSharedRef<FSpecLatentCommand>> BeforeEach;
 
 		/**
 		 * Collection of It() blocks defining the individual expectations of this immediate scope.
@@ -1201,29 +1937,49 @@ private:
 		/**
 		 * Latent commands to execute after each It() block within the specification (including nested scopes).
 		 */
-		TArray<TSharedRef<IAutomationLatentCommand>> AfterEach;
+		TArray<TSharedRef<FSpecLatentCommand>> AfterEach;
+
+		/**
+		 * Latent commands to execute once after the last It() block within the specification (including nested
+		 * scopes).
+		 */
+		TArray<TSharedRef<FSpecLatentCommand>> AfterAll;
 
 		/**
 		 * Child definitions representing nested scopes within this one.
 		 */
 		TArray<TSharedRef<FSpecDefinitionScope>> Children;
+
+		/**
+		 * Nested scopes within this one whose bodies have not yet been run, because definitions are being loaded
+		 * lazily.
+		 */
+		TArray<TSharedRef<FSpecDeferredScope>> DeferredChildren;
 	};
 
 	/**
-	 * A flattened, ready-to-execute test case.
+	 * An immutable node in the tree of scopes of a specification, shared by all test cases within that scope.
+	 *
+	 * Each node holds only the setup and teardown commands that were defined directly in its scope, plus a link to the
+	 * node of the enclosing scope. A test case finds all the commands that apply to it by walking from the node of its
+	 * innermost scope up to the root, so commands are never copied into each test case.
 	 *
-	 * Each instance of this struct is populated with all the commands of the information needed to setup (BeforeAll(),
-	 * BeforeEach()), execute (It()), and tear down a test case (AfterEach()).
+	 * Nodes are built from FSpecDefinitionScope instances by PostDefine().
 	 */
-	struct FSpec final
+	struct FSpecScopeNode final
 	{
 		// =============================================================================================================
 		// Public Fields
 		// =============================================================================================================
 		/**
-		 * The unique identifier for this test case.
+		 * The node of the enclosing scope, or a null pointer if this is the root scope.
 		 */
-		FString Id;
+		TSharedPtr<const FSpecScopeNode> Parent;
+
+		/**
+		 * A handle that uniquely identifies this scope during a test session.
+		 */
+		FSpecBlockHandle Handle;
 
 		/**
 		 * The human-readable description for this scope, as provided by Describe().
@@ -1231,7 +1987,111 @@ private:
 		FString Description;
 
 		/**
-		 * The filename of the specification in which this test was defined.
+		 * The outer-most scope declared with DescribeParallel() that encloses this scope (possibly this scope itself),
+		 * or a null pointer if test cases in this scope run sequentially.
+		 *
+		 * All test cases that share the same parallel scope and that are requested by the same run of the specification
+		 * are run together as a single batch.
+		 */
+		const FSpecScopeNode* ParallelScope = nullptr;
+
+		/**
+		 * The variables visible in this scope, including those inherited from enclosing scopes.
+		 *
+		 * Scopes that do not define or redefine any variables share the table of their enclosing scope.
+		 */
+		TSharedPtr<const FSpecVariableScope> Variables;
+
+		/**
+		 * Latent commands to execute once before all It() blocks within this scope (including nested scopes).
+		 */
+		TArray<TSharedRef<FSpecLatentCommand>> BeforeAll;
+
+		/**
+		 * Latent commands to execute before each It() block within this scope (including nested scopes).
+		 */
+		TArray<TSharedRef<FSpecLatentCommand>> BeforeEach;
+
+		/**
+		 * Latent commands to execute after each It() block within this scope (including nested scopes).
+		 */
+		TArray<TSharedRef<FSpecLatentCommand>> AfterEach;
+
+		/**
+		 * Latent commands to execute once after the last It() block within this scope (including nested scopes) that
+		 * runs on the current runner.
+		 */
+		TArray<TSharedRef<FSpecLatentCommand>> AfterAll;
+	};
+
+	/**
+	 * A scope declared with Describe() whose body has not yet been run, because definitions are being loaded lazily.
+	 *
+	 * The body is only run once a lookup for a test case that could be within the scope reaches it. At that point, the
+	 * scope is defined and converted into an FSpecScopeNode just like any other scope.
+	 */
+	struct FSpecDeferredScope final
+	{
+		// =============================================================================================================
+		// Public Fields
+		// =============================================================================================================
+		/**
+		 * The human-readable description for this scope, as provided by Describe().
+		 */
+		FString Description;
+
+		/**
+		 * The descriptions of all scopes that enclose this scope, followed by the description of this scope.
+		 */
+		TArray<FString> DescriptionStack;
+
+		/**
+		 * The start of the ID of every test case within this scope, unless the test case has a custom ID.
+		 */
+		FString IdPrefix;
+
+		/**
+		 * The body of the scope, as provided by Describe().
+		 */
+		TFunction<void()> DoWork;
+
+		/**
+		 * The node of the enclosing scope.
+		 *
+		 * This is only set once the enclosing scope has been converted into a node.
+		 */
+		TSharedPtr<const FSpecScopeNode> ParentNode;
+	};
+
+	/**
+	 * The nodes of all scopes that enclose a test case, ordered from the inner-most scope outwards.
+	 */
+	using FSpecScopeChain = TArray<const FSpecScopeNode*, TInlineAllocator<16>>;
+
+	/**
+	 * A ready-to-execute test case.
+	 *
+	 * Each instance of this struct references the command of its It() block and the node of the scope in which it was
+	 * defined. The commands needed to setup (BeforeAll(), BeforeEach()) and tear down (AfterEach(), AfterAll()) the
+	 * test case are found by walking from that node up to the root scope.
+	 */
+	struct FSpec final
+	{
+		// =============================================================================================================
+		// Public Fields
+		// =============================================================================================================
+		/**
+		 * The unique identifier for this test case.
+		 */
+		FString Id;
+
+		/**
+		 * The human-readable description for this scope, as provided by Describe().
+		 */
+		FString Description;
+
+		/**
+		 * The filename of the specification in which this test was defined.
 		 */
 		FString Filename;
 
@@ -1241,14 +2101,73 @@ private:
 		int32 LineNumber;
 
 		/**
-		 * The variables defined in this scope.
+		 * The node of the innermost scope in which this test was defined.
 		 */
-		FSpecVariableScope Variables;
+		TSharedPtr<const FSpecScopeNode> Scope;
+
+		/**
+		 * The automation command to execute to perform the expectation of this test (i.e., the It() block).
+		 */
+		TSharedPtr<FSpecLatentCommand> Command;
+
+		/**
+		 * Whether this test case belongs to the shard of the current runner.
+		 *
+		 * This is always true unless the test cases of the specification are being sharded across multiple runners.
+		 */
+		bool bIsInShard = true;
+	};
+
+	/**
+	 * The test cases requested by a single run of this specification that are waiting to run in parallel, grouped by
+	 * the node of the scope declared with DescribeParallel() that encloses them.
+	 *
+	 * Each group is shared by the commands of all test cases in it, so whichever of those commands runs first can run
+	 * the entire group as a batch, together with the test cases of the scope that later runs will request.
+	 */
+	using FSpecParallelBatches = TMap<const FSpecScopeNode*, TSharedRef<TArray<TSharedRef<FSpec>>>>;
+
+	/**
+	 * The isolated state of a test case that is running concurrently with other test cases of the same specification.
+	 *
+	 * While a test case runs in parallel, it reads private copies of its variables, and the errors, warnings, and info
+	 * messages it reports are captured here rather than being added to whichever test the automation framework is
+	 * currently running. The captured messages are reported later, when the framework runs that test case.
+	 */
+	struct FParallelSpecContext final
+	{
+		// =============================================================================================================
+		// Public Fields
+		// =============================================================================================================
+		/**
+		 * The private copies of the variables of the test case.
+		 */
+		TSharedPtr<const FSpecVariableScope> Variables;
 
 		/**
-		 * The automation commands to execute to perform this test.
+		 * The state shared by the private copies of the variables of the test case.
 		 */
-		TArray<TSharedRef<IAutomationLatentCommand>> Commands;
+		FSpecVariableRunState VariableRunState;
+
+		/**
+		 * The errors, warnings, and info messages reported by the test case, in the order they were reported.
+		 */
+		TArray<FAutomationEvent> Events;
+
+		/**
+		 * Whether the test case has reported any errors.
+		 */
+		bool bHasErrors = false;
+
+		/**
+		 * How long the test case took to run on its worker thread, in seconds.
+		 */
+		double DurationSeconds = 0.0;
+
+		/**
+		 * The test case.
+		 */
+		const FSpec* Spec = nullptr;
 	};
 
 	/**
@@ -1262,23 +2181,69 @@ private:
 		// Private Fields
 		// =============================================================================================================
 		/**
-		 * The handle of the delegate that has been registered to be notified about test completion.
+		 * The specification to which this state belongs.
 		 */
-		FDelegateHandle TestDelegateHandle;
+		FEnhancedAutomationSpecBase& Spec;
+
+		/**
+		 * The handle of the delegate that has been registered to be notified when the test session ends.
+		 */
+		FDelegateHandle SessionEndHandle;
+
+		/**
+		 * Whether the test session is ending, in which case AfterAll() blocks that have not yet run are being run.
+		 */
+		bool bIsEndingSession;
 
 		/**
 		 * The handles of the blocks for which execution is being tracked (e.g., "BeforeAll()" blocks).
 		 */
 		TSet<FSpecBlockHandle> BlocksRun;
 
+		/**
+		 * The messages reported by test cases that have already run in parallel or ahead of time, keyed by the ID of
+		 * each test case.
+		 */
+		TMap<FString, TArray<FAutomationEvent>> ParallelResults;
+
+		/**
+		 * The IDs of the test cases that have started running during this session.
+		 */
+		TSet<FString> SpecsRun;
+
+		/**
+		 * The full names of the test cases that the automation controller was asked to run during this session; or,
+		 * an unset value if they have not been looked up yet.
+		 */
+		TOptional<TSet<FString>> RequestedTestNames;
+
+		/**
+		 * Whether the automation controller could supply the names of the test cases it was asked to run.
+		 */
+		bool bAreRequestedTestNamesKnown;
+
+		/**
+		 * The number of test cases that have finished within each scope that has AfterAll() blocks, keyed by the
+		 * handle of the scope.
+		 */
+		TMap<FSpecBlockHandle, int32> NumSpecsFinishedPerScope;
+
+		/**
+		 * The handles of the scopes with AfterAll() blocks in which at least one test case has started.
+		 */
+		TSet<FSpecBlockHandle> ScopesStarted;
+
 	public:
 		// =============================================================================================================
 		// Public Constructor / Destructor
 		// =============================================================================================================
 		/**
 		 * Constructs a new instance.
+		 *
+		 * @param Spec
+		 *	The specification to which this state belongs.
 		 */
-		explicit FEnhancedTestSessionState();
+		explicit FEnhancedTestSessionState(FEnhancedAutomationSpecBase& Spec);
 
 		/**
 		 * Destructor.
@@ -1307,25 +2272,146 @@ private:
 		 */
 		void MarkBlockAsRun(const FSpecBlockHandle& BlockHandle);
 
-	private:
-		// =============================================================================================================
-		// Private Methods
-		// =============================================================================================================
 		/**
-		 * Tries to get the automation controller manager.
+		 * Records the messages reported by a test case that ran in parallel, until that test case is run.
+		 *
+		 * @param SpecId
+		 *	The ID of the test case.
+		 * @param Events
+		 *	The errors, warnings, and info messages reported by the test case.
+		 */
+		void StoreParallelResult(const FString& SpecId, TArray<FAutomationEvent> Events);
+
+		/**
+		 * Retrieves and forgets the messages reported by a test case that ran in parallel.
+		 *
+		 * @param SpecId
+		 *	The ID of the test case.
+		 * @param OutEvents
+		 *	The array to receive the errors, warnings, and info messages reported by the test case.
+		 *
+		 * @return
+		 *	true if the test case ran in parallel during this session and had not yet been reported; or, false
+		 *	otherwise.
+		 */
+		bool TakeParallelResult(const FString& SpecId, TArray<FAutomationEvent>& OutEvents);
+
+		/**
+		 * Checks whether a test case has run in parallel and is waiting to have its messages reported.
+		 *
+		 * @param SpecId
+		 *	The ID of the test case.
+		 *
+		 * @return
+		 *	true if the messages of the test case are stored; or, false otherwise.
+		 */
+		bool HasParallelResult(const FString& SpecId) const;
+
+		/**
+		 * Records that a test case has started running, so that it is not picked up again by a parallel batch or by a
+		 * test case that runs the ones after it ahead of time.
+		 *
+		 * @param SpecId
+		 *	The ID of the test case.
+		 */
+		void MarkSpecAsRun(const FString& SpecId);
+
+		/**
+		 * Checks whether a test case has started running during this session.
+		 *
+		 * @param SpecId
+		 *	The ID of the test case.
+		 *
+		 * @return
+		 *	true if the test case has already run; or, false otherwise.
+		 */
+		bool HasSpecRun(const FString& SpecId) const;
+
+		/**
+		 * Gets the full names of the test cases that the automation controller was asked to run during this session.
+		 *
+		 * The names are looked up from the specification the first time they are needed, and kept until the session
+		 * ends.
+		 *
+		 * @return
+		 *	The names of the requested test cases; or, a null pointer if they are not known (e.g., because the
+		 *	automation controller runs in a different process).
+		 */
+		const TSet<FString>* GetRequestedTestNames();
+
+		/**
+		 * Records that a test case within a scope has finished.
+		 *
+		 * @param ScopeHandle
+		 *	The handle of the scope.
+		 */
+		void MarkSpecAsFinished(const FSpecBlockHandle& ScopeHandle);
+
+		/**
+		 * Gets how many test cases within a scope have finished during this session.
+		 *
+		 * @param ScopeHandle
+		 *	The handle of the scope.
+		 *
+		 * @return
+		 *	The number of test cases that have finished within the scope, including its nested scopes.
+		 */
+		int32 GetNumSpecsFinished(const FSpecBlockHandle& ScopeHandle) const;
+
+		/**
+		 * Records that a test case within a scope has started.
+		 *
+		 * @param ScopeHandle
+		 *	The handle of the scope.
+		 */
+		void MarkScopeAsStarted(const FSpecBlockHandle& ScopeHandle);
+
+		/**
+		 * Checks whether any test case within a scope has started during this session.
+		 *
+		 * @param ScopeHandle
+		 *	The handle of the scope.
+		 *
+		 * @return
+		 *	true if at least one test case within the scope, including its nested scopes, has started; or, false
+		 *	otherwise.
+		 */
+		bool HasScopeStarted(const FSpecBlockHandle& ScopeHandle) const;
+
+		/**
+		 * Gets the handles of the scopes with AfterAll() blocks in which at least one test case has started.
+		 *
+		 * @return
+		 *	The handles of the scopes.
+		 */
+		FORCEINLINE const TSet<FSpecBlockHandle>& GetScopesStarted() const
+		{
+			return this->ScopesStarted;
+		}
+
+		/**
+		 * Checks whether the test session is ending.
 		 *
 		 * @return
-		 *	Either the automation controller manager; or a null pointer if the manager is not available (e.g., during
-		 *	shutdown of the engine).
+		 *	true if the AfterAll() blocks that have not yet run during this session are being run; or, false otherwise.
 		 */
-		static IAutomationControllerManagerPtr GetAutomationController();
+		FORCEINLINE bool IsEndingSession() const
+		{
+			return this->bIsEndingSession;
+		}
 
+	private:
+		// =============================================================================================================
+		// Private Methods
+		// =============================================================================================================
 		/**
-		 * Clears all test state.
+		 * Runs the AfterAll() blocks that are still pending, then clears all test state of this spec class.
 		 *
-		 * This is invoked automatically whenever tests in the current session finish running.
+		 * This is invoked automatically by the module whenever tests in the current session finish running. Work that
+		 * is shared by all spec classes (e.g., releasing fixtures) is performed by the module afterward, once per
+		 * session, so fixtures released by pending AfterAll() blocks are released before then.
 		 */
-		void ClearState();
+		void EndSession();
 	};
 
 	// =================================================================================================================
@@ -1334,26 +2420,170 @@ private:
 	/**
 	 * Gets the current value of a variable from a scope.
 	 *
+	 * This is a bounds-checked load from the variable table; it does not copy the table or touch the reference count of
+	 * the variable.
+	 *
 	 * @tparam VariableType
 	 *	The type of the variable.
 	 *
 	 * @param Variables
 	 *	The scope of variables from which to obtain the variable.
-	 * @param Handle
-	 *	The unique handle of the desired variable.
+	 * @param SlotIndex
+	 *	The slot index of the desired variable.
 	 *
 	 * @return
 	 *	The value of the variable.
 	 */
 	template <typename VariableType>
-	UE_NODISCARD FORCEINLINE static TSpecVariablePtr<VariableType> GetVariableFromScope(
-		FSpecVariableScope      Variables,
-		const FSpecBlockHandle& Handle)
+	UE_NODISCARD FORCEINLINE static TSpecLet<VariableType>& GetVariableFromScope(const FSpecVariableScope& Variables,
+	                                                                            const int32               SlotIndex)
 	{
-		check(Variables.Contains(Handle));
-		return StaticCastSharedPtr<TSpecLet<VariableType>>(Variables[Handle]);
+		check(Variables.IsValidIndex(SlotIndex));
+
+		const FSpecVariablePtrWildcard& Variable = Variables[SlotIndex];
+
+		check(Variable.IsValid());
+		return static_cast<TSpecLet<VariableType>&>(*Variable);
 	}
 
+	/**
+	 * Checks whether a scope has a definition for the variable in the specified slot.
+	 *
+	 * @param Variables
+	 *	The scope of variables to check.
+	 * @param SlotIndex
+	 *	The slot index of the variable.
+	 *
+	 * @return
+	 *	true if the scope defines or redefines the variable; or, false otherwise.
+	 */
+	UE_NODISCARD FORCEINLINE static bool IsVariableInScope(const FSpecVariableScope& Variables, const int32 SlotIndex)
+	{
+		return Variables.IsValidIndex(SlotIndex) && Variables[SlotIndex].IsValid();
+	}
+
+	/**
+	 * Adds or replaces the definition of a variable in a scope, growing the table of the scope as needed.
+	 *
+	 * @param Variables
+	 *	The scope of variables to modify.
+	 * @param SlotIndex
+	 *	The slot index of the variable.
+	 * @param Definition
+	 *	The new definition of the variable.
+	 */
+	static void SetVariableInScope(FSpecVariableScope&      Variables,
+	                               const int32              SlotIndex,
+	                               FSpecVariablePtrWildcard Definition);
+
+	/**
+	 * Gets the context of the test case that the calling thread is running in parallel, if any.
+	 *
+	 * @return
+	 *	A reference to the thread-local pointer to the context. The pointer is null when the calling thread is not
+	 *	running a test case in parallel.
+	 */
+	static FParallelSpecContext*& GetParallelContextForThread();
+
+	/**
+	 * Gets the cancellation token of the asynchronous work that the calling thread is running, if any.
+	 *
+	 * @return
+	 *	A reference to the thread-local pointer to the token. The pointer is null when the calling thread is not
+	 *	running the work of an asynchronous block.
+	 */
+	static TSharedPtr<FSpecCancellationToken>& GetCancellationTokenForThread();
+
+	/**
+	 * Checks whether a message is being reported by asynchronous work that was abandoned after timing out.
+	 *
+	 * Messages from abandoned work are logged and then discarded rather than being added to the results of the test.
+	 *
+	 * @param MessageKind
+	 *	The kind of message being reported (e.g., "error"), for logging.
+	 * @param Message
+	 *	The message being reported.
+	 *
+	 * @return
+	 *	true if the message was discarded; or, false if it should be added to the results of the test.
+	 */
+	static bool DiscardIfAbandoned(const TCHAR* MessageKind, const FString& Message);
+
+	/**
+	 * Collects the nodes of all scopes that enclose a test case.
+	 *
+	 * @param Spec
+	 *	The test case for which scopes are being collected.
+	 * @param OutScopeChain
+	 *	The array to receive the scopes, ordered from the inner-most scope outwards.
+	 */
+	static void GatherScopeChain(const FSpec& Spec, FSpecScopeChain& OutScopeChain);
+
+	/**
+	 * Checks whether a test case can run in parallel with other test cases.
+	 *
+	 * A test case can run in parallel only if it was defined within DescribeParallel() and all of its commands,
+	 * including those of the setup and teardown blocks of all enclosing scopes, are synchronous.
+	 *
+	 * @param Spec
+	 *	The test case to check.
+	 * @param ScopeChain
+	 *	The nodes of all scopes that enclose the test case, ordered from the inner-most scope outwards.
+	 *
+	 * @return
+	 *	true if the test case can run in parallel; or, false if it must run sequentially.
+	 */
+	static bool CanRunInParallel(const FSpec& Spec, const FSpecScopeChain& ScopeChain);
+
+	/**
+	 * Checks whether all commands of a test case, except for AfterAll() blocks, finish within a single update.
+	 *
+	 * @param Spec
+	 *	The test case to check.
+	 * @param ScopeChain
+	 *	The nodes of all scopes that enclose the test case, ordered from the inner-most scope outwards.
+	 *
+	 * @return
+	 *	true if the BeforeAll(), BeforeEach(), It(), and AfterEach() blocks of the test case are all synchronous; or,
+	 *	false if any of them spans multiple frames or other threads.
+	 */
+	static bool CanRunSynchronously(const FSpec& Spec, const FSpecScopeChain& ScopeChain);
+
+	/**
+	 * Runs the blocks of a test case on the calling thread, except for AfterAll() blocks, capturing the messages that
+	 * it reports in the given context instead of adding them to the results of the running test.
+	 *
+	 * The test case gets a private copy of its variables, which is released on the calling thread before this returns.
+	 *
+	 * @param Spec
+	 *	The test case to run.
+	 * @param ScopeChain
+	 *	The nodes of all scopes that enclose the test case, ordered from the inner-most scope outwards.
+	 * @param Context
+	 *	The context that receives the messages and duration of the test case.
+	 * @param bRunBeforeAll
+	 *	Whether to also run the BeforeAll() blocks of the enclosing scopes that have yet to run. This must only be true
+	 *	on the game thread.
+	 */
+	static void RunSpecInContext(const FSpec&           Spec,
+	                             const FSpecScopeChain& ScopeChain,
+	                             FParallelSpecContext&  Context,
+	                             bool                   bRunBeforeAll);
+
+	/**
+	 * Gets the scope that determines which test cases must run on the same shard as a given test case.
+	 *
+	 * This is the outer-most scope enclosing the test case that either has BeforeAll() blocks or was declared with
+	 * DescribeParallel(), so that the work of those blocks or of the parallel batch is only performed on one runner.
+	 *
+	 * @param ScopeChain
+	 *	The nodes of all scopes that enclose the test case, ordered from the inner-most scope outwards.
+	 *
+	 * @return
+	 *	The node of the scope; or, a null pointer if the test case can be assigned to a shard on its own.
+	 */
+	static const FSpecScopeNode* GetShardGroupScope(const FSpecScopeChain& ScopeChain);
+
 	// =================================================================================================================
 	// Private Fields
 	// =================================================================================================================
@@ -1363,13 +2593,125 @@ private:
 	TArray<FString> DescriptionStack;
 
 	/**
-	 * A map that associates the ID of each specification to the ready-to-execute test case for that spec.
+	 * The non-empty descriptions on the description stack, joined into the ID of the test currently being defined.
+	 */
+	FString StackedId;
+
+	/**
+	 * The non-empty descriptions on the description stack, joined into the description of the test being defined.
+	 */
+	FString StackedDescription;
+
+	/**
+	 * The length that StackedId had before each description on the description stack was pushed.
+	 */
+	TArray<int32> StackedIdLengths;
+
+	/**
+	 * The length that StackedDescription had before each description on the description stack was pushed.
+	 */
+	TArray<int32> StackedDescriptionLengths;
+
+	/**
+	 * A map that associates the hash of the ID of each specification to the ready-to-execute test case for that spec.
+	 *
+	 * Keying on the hash allows test cases to be looked up by a view of their ID, without allocating a string for the
+	 * key. Different IDs can share the same hash, so each hash can map to more than one test case; FindSpec() compares
+	 * the IDs of the test cases under a hash to find the right one. This is populated from the hierarchy of test
+	 * definitions by PostDefine().
+	 *
+	 * @see FindSpec()
+	 * @see PostDefine()
+	 */
+	TMultiMap<uint64, TSharedRef<FSpec>> SpecsByIdHash;
+
+	/**
+	 * A map from the node of each scope declared with DescribeParallel() to the test cases within it (including nested
+	 * scopes).
 	 *
-	 * This is populated from the hierarchy of test definitions by PostDefine().
+	 * This is populated by PostDefine(), and used to gather the other requested test cases of a parallel scope once the
+	 * first of them runs.
 	 *
 	 * @see PostDefine()
 	 */
-	TMap<FString, TSharedRef<FSpec>> IdToSpecMap;
+	TMap<const FSpecScopeNode*, TArray<TSharedRef<FSpec>>> ParallelSpecGroups;
+
+	/**
+	 * A map from the handle of each scope that has AfterAll() blocks to the number of test cases within that scope
+	 * (including nested scopes) that run on this runner.
+	 *
+	 * The AfterAll() blocks of a scope run once this many of its test cases have finished. This is populated by
+	 * PostDefine(), after test cases have been assigned to shards.
+	 *
+	 * @see PostDefine()
+	 */
+	TMap<FSpecBlockHandle, int32> NumSpecsInShardPerScope;
+
+	/**
+	 * Scopes whose bodies have not yet been run, because definitions are being loaded lazily.
+	 *
+	 * This is populated by PostDefine() and by each expansion of a deferred scope that defers scopes of its own.
+	 *
+	 * @see ShouldDefineLazily()
+	 */
+	TArray<TSharedRef<FSpecDeferredScope>> DeferredScopes;
+
+	/**
+	 * The handles of scopes that have AfterAll() blocks and that enclose at least one deferred scope.
+	 *
+	 * The number of test cases within these scopes is not yet known, so their AfterAll() blocks cannot run yet.
+	 */
+	TSet<FSpecBlockHandle> ScopesWithDeferredScopes;
+
+	/**
+	 * The node of the scope that encloses the deferred scope that is currently being expanded, if any.
+	 *
+	 * This provides RedefineLet() with the definitions of variables from enclosing scopes, which are no longer on the
+	 * definition scope stack by the time a deferred scope is expanded.
+	 */
+	TSharedPtr<const FSpecScopeNode> DeferredScopeParentNode;
+
+	/**
+	 * Whether Describe() is deferring the bodies of scopes until test cases within them are looked up.
+	 */
+	bool bIsDefiningLazily;
+
+	/**
+	 * The shared fixtures on which this specification has declared a dependency with UseFixture().
+	 */
+	TArray<FEnhancedSpecFixtureBase*> FixtureDependencies;
+
+	/**
+	 * The shared fixtures for which this specification has been counted as a dependent in the fixture registry.
+	 *
+	 * This is only the case when at least one of its test cases runs on this runner. When its test cases are listed
+	 * from the definition cache, this specification is counted as a dependent of the fixtures recorded in the cache
+	 * before it has been defined, so that fixtures are not released while it has yet to run.
+	 */
+	TArray<FEnhancedSpecFixtureBase*> FixturesCountedAsDependent;
+
+	/**
+	 * The name of the module that declares this specification, or an empty string if unknown.
+	 *
+	 * The test cases of this specification are only listed from the definition cache if they were cached from the same
+	 * build of the binary of this module. Specifications without a module name are never cached.
+	 */
+	FString ModuleName;
+
+	/**
+	 * The number of variable slots that have been assigned by Let() so far in this specification.
+	 *
+	 * This is also the size of the variable table of each ready-to-execute test case.
+	 */
+	int32 NumVariableSlots;
+
+	/**
+	 * The arena that owns the scopes, test cases, and commands created while defining this specification.
+	 *
+	 * The arena is replaced when this specification is redefined; its memory is returned to the heap once the last of
+	 * the objects that were defined in it has been released.
+	 */
+	TSharedRef<FEnhancedSpecArena> DefinitionArena;
 
 	/**
 	 * The top-most, root scope of the test hierarchy/tree structure.
@@ -1408,9 +2750,62 @@ private:
 	/**
 	 * The variables defined for the current test.
 	 *
-	 * This is cleared and repopulated at the start of each test case.
+	 * This points at the variable table of the scope of each test case when that test case starts running.
 	 */
-	FSpecVariableScope VariablesInScope;
+	TSharedPtr<const FSpecVariableScope> VariablesInScope;
+
+	/**
+	 * The state shared by the variables of the test case that is currently running, when running sequentially.
+	 */
+	FSpecVariableRunState VariableRunState;
+
+	/**
+	 * Whether test cases are currently running in contexts of their own, either in a parallel batch or ahead of time.
+	 *
+	 * This is only changed on the game thread, before workers start and after they have all finished, so workers can
+	 * check it without synchronization. It allows the common, sequential case to skip the thread-local lookup.
+	 */
+	bool bIsRunningInParallel;
+
+	/**
+	 * The test case that is currently running sequentially, or whose AfterAll() blocks are currently running.
+	 *
+	 * This is only used to label the runs of blocks in traces of the session.
+	 */
+	const FSpec* RunningSpec;
+
+	/**
+	 * The time at which the test case that is running sequentially last resumed its work, in seconds, as reported by
+	 * FPlatformTime::Seconds().
+	 */
+	double SpecWorkStartTime;
+
+	/**
+	 * How long the test case that is running sequentially has spent running its own blocks before it last yielded to
+	 * the engine, in seconds.
+	 *
+	 * Frames that pass while the test case is waiting to resume are not counted, so that its duration does not depend
+	 * on how long the engine takes to tick (e.g., with a slow renderer or a busy editor).
+	 */
+	double SpecWorkSeconds;
+
+	/**
+	 * Whether the memory high-watermark of the current test case is reported when it finishes.
+	 *
+	 * This is captured when the test case starts, so that changing "EnhancedSpecs.ReportMemoryWatermark" while it runs
+	 * does not produce a report without a baseline.
+	 */
+	bool bIsReportingMemory;
+
+	/**
+	 * The peak physical memory used by the process when the current test case started running, in bytes.
+	 */
+	uint64 SpecStartPeakUsedPhysical;
+
+	/**
+	 * The physical memory used by the process when the current test case started running, in bytes.
+	 */
+	uint64 SpecStartUsedPhysical;
 
 public:
 	// =================================================================================================================
@@ -1423,13 +2818,27 @@ public:
 	 *	The name of the automation test.
 	 * @param bComplexTask
 	 *	Whether this test is complex and should be included in a stress test.
+	 * @param ModuleName
+	 *	The name of the module that declares the test (i.e., UE_MODULE_NAME), or an empty string to never cache the
+	 *	list of its test cases.
 	 */
-	FEnhancedAutomationSpecBase(const FString& Name, const bool bComplexTask) :
+	FEnhancedAutomationSpecBase(const FString& Name, const bool bComplexTask, const ANSICHAR* ModuleName = "") :
 		FAutomationTestBase(Name, bComplexTask),
-		RootDefinitionScope(MakeShareable(new FSpecDefinitionScope())),
+		bIsDefiningLazily(false),
+		ModuleName(ModuleName),
+		NumVariableSlots(0),
+		DefinitionArena(MakeShared<FEnhancedSpecArena>()),
+		RootDefinitionScope(DefinitionArena->New<FSpecDefinitionScope>()),
 		bHasBeenDefined(false),
 		DefaultTimeout(FTimespan::FromSeconds(30)),
-		bEnableSkipIfError(true)
+		bEnableSkipIfError(true),
+		bIsRunningInParallel(false),
+		RunningSpec(nullptr),
+		SpecWorkStartTime(0.0),
+		SpecWorkSeconds(0.0),
+		bIsReportingMemory(false),
+		SpecStartPeakUsedPhysical(0),
+		SpecStartUsedPhysical(0)
 	{
 		this->DefinitionScopeStack.Push(this->RootDefinitionScope.ToSharedRef());
 	}
@@ -1446,6 +2855,9 @@ public:
 	virtual int32 GetTestSourceFileLine(const FString& InTestName) const override;
 	virtual void GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const override;
 	virtual bool RunTest(const FString& InParameters) override;
+	virtual void AddError(const FString& InError, int32 StackOffset = 0) override;
+	virtual void AddWarning(const FString& InWarning, int32 StackOffset = 0) override;
+	virtual void AddInfo(const FString& InLogItem, int32 StackOffset = 0, bool bCaptureStack = false) override;
 
 protected:
 	// =================================================================================================================
@@ -1486,6 +2898,45 @@ protected:
 		// Disabled.
 	}
 
+	/**
+	 * Defines a new scope for expectations that are independent of one another and can run concurrently.
+	 *
+	 * This behaves like Describe(), except that when the first test case within the scope runs, all other test cases
+	 * in the scope (including nested scopes) that were requested by the same run of the specification are run at the
+	 * same time on worker threads. Each test case gets its own copy of all variables declared with Let(), and the
+	 * errors each test case reports are attributed to that test case when the automation framework gets to it. The
+	 * BeforeAll() blocks of the scope and its enclosing scopes run once, on the game thread, before any of the test
+	 * cases start.
+	 *
+	 * Only test cases that consist entirely of synchronous blocks can run in parallel. Test cases that use latent or
+	 * asynchronous blocks, either directly or through an enclosing scope, still run sequentially. Code in the blocks of
+	 * a parallel scope must be thread-safe; for example, it must not modify fields of the spec class or interact with
+	 * the world.
+	 *
+	 * @param InDescription
+	 *	A string that describes the scope of the expectations within it.
+	 * @param DoWork
+	 *	A lambda that defines the expectations within this scope.
+	 */
+	void DescribeParallel(const FString& InDescription, const TFunction<void()>& DoWork);
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of DescribeParallel().
+	 *
+	 * @see DescribeParallel(const FString&, const TFunction<void()>&)
+	 *
+	 * @param InDescription
+	 *	A string that describes the scope of the expectations within it.
+	 * @param DoWork
+	 *	A lambda that defines the expectations within this scope.
+	 */
+	FORCEINLINE void xDescribeParallel(const FString& InDescription, const TFunction<void()>& DoWork)
+	{
+		// Disabled.
+	}
+
 	/**
 	 * Declares a variable for use in a test.
 	 *
@@ -1502,17 +2953,21 @@ protected:
 	TSpecVariable<VariableType> Let(const TGeneratorFunc<VariableType>& GeneratorFunc)
 	{
 		const TSharedRef<FSpecDefinitionScope> CurrentScope = this->GetCurrentScope();
-		TSpecVariable<VariableType>            Variable     = TSpecVariable<VariableType>(this);
+		const int32                            SlotIndex    = this->NumVariableSlots++;
+		TSpecVariable<VariableType>            Variable     = TSpecVariable<VariableType>(this, SlotIndex);
 
 		// Adapt the signature so that we only have one type of generator function we have to call.
 		FSpecVariablePtrWildcard Definition = FSpecVariablePtrWildcard(
-			new TSpecLet<VariableType>([GeneratorFunc](const TSpecVariablePtr<VariableType>)
-			{
-				return GeneratorFunc();
-			})
+			new TSpecLet<VariableType>(
+				&this->VariableRunState,
+				[GeneratorFunc](const TSpecVariablePtr<VariableType>)
+				{
+					return GeneratorFunc();
+				}
+			)
 		);
 
-		CurrentScope->Variables.Add(Variable.GetHandle(), Definition);
+		SetVariableInScope(CurrentScope->Variables, SlotIndex, MoveTemp(Definition));
 
 		return Variable;
 	}
@@ -1534,7 +2989,7 @@ protected:
 	template <typename VariableType>
 	void RedefineLet(TSpecVariable<VariableType> Variable, const TGeneratorRedefineFunc<VariableType>& GeneratorFunc)
 	{
-		const FSpecBlockHandle&                VariableHandle  = Variable.GetHandle();
+		const int32                            SlotIndex       = Variable.GetSlotIndex();
 		const TSharedRef<FSpecDefinitionScope> CurrentScope    = this->GetCurrentScope();
 		TSpecVariablePtr<VariableType>         PriorDefinition = TSpecVariablePtr<VariableType>();
 		FSpecVariablePtrWildcard               NewDefinition;
@@ -1545,18 +3000,29 @@ protected:
 		{
 			const TSharedRef<FSpecDefinitionScope> Scope = this->DefinitionScopeStack[ScopeIndex];
 
-			if (Scope->Variables.Contains(VariableHandle))
+			if (IsVariableInScope(Scope->Variables, SlotIndex))
 			{
-				PriorDefinition = GetVariableFromScope<VariableType>(Scope->Variables, VariableHandle);
+				PriorDefinition = StaticCastSharedPtr<TSpecLet<VariableType>>(Scope->Variables[SlotIndex]);
 				break;
 			}
 		}
 
+		// Scopes that enclose a deferred scope have already been converted into nodes by the time it is expanded.
+		if (!PriorDefinition.IsValid() && this->DeferredScopeParentNode.IsValid() &&
+		    IsVariableInScope(*this->DeferredScopeParentNode->Variables, SlotIndex))
+		{
+			PriorDefinition = StaticCastSharedPtr<TSpecLet<VariableType>>(
+				(*this->DeferredScopeParentNode->Variables)[SlotIndex]
+			);
+		}
+
 		check(PriorDefinition.IsValid());
 
-		NewDefinition = FSpecVariablePtrWildcard(new TSpecLet<VariableType>(GeneratorFunc, PriorDefinition));
+		NewDefinition = FSpecVariablePtrWildcard(
+			new TSpecLet<VariableType>(&this->VariableRunState, GeneratorFunc, PriorDefinition)
+		);
 
-		CurrentScope->Variables.Add(VariableHandle, NewDefinition);
+		SetVariableInScope(CurrentScope->Variables, SlotIndex, MoveTemp(NewDefinition));
 	}
 
 	/**
@@ -1572,8 +3038,13 @@ protected:
 	 *	A descriptive string specifying the expectation or behavior being tested.
 	 * @param DoWork
 	 *	A lambda that contains the code to execute for the specified scenario.
+	 * @param Location
+	 *	The location in source code at which the block is being defined. This is captured automatically at the call
+	 *	site and does not normally need to be provided.
 	 */
-	void It(const FString& InDescription, const TFunction<void()>& DoWork);
+	void It(const FString&             InDescription,
+	        const TFunction<void()>&   DoWork,
+	        const FSpecSourceLocation& Location = FSpecSourceLocation::Current());
 
 	// ReSharper disable once CppMemberFunctionMayBeStatic
 	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
@@ -1607,8 +3078,14 @@ protected:
 	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
 	 * @param DoWork
 	 *	A lambda that contains the code to execute for the specified scenario.
+	 * @param Location
+	 *	The location in source code at which the block is being defined. This is captured automatically at the call
+	 *	site and does not normally need to be provided.
 	 */
-	void It(const FString& InDescription, const EAsyncExecution Execution, const TFunction<void()>& DoWork);
+	void It(const FString&             InDescription,
+	        const EAsyncExecution      Execution,
+	        const TFunction<void()>&   DoWork,
+	        const FSpecSourceLocation& Location = FSpecSourceLocation::Current());
 
 	// ReSharper disable once CppMemberFunctionMayBeStatic
 	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
@@ -1646,11 +3123,15 @@ protected:
 	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
 	 * @param DoWork
 	 *	A lambda that contains the code to execute for the specified scenario.
+	 * @param Location
+	 *	The location in source code at which the block is being defined. This is captured automatically at the call
+	 *	site and does not normally need to be provided.
 	 */
-	void It(const FString&           InDescription,
-	        const EAsyncExecution    Execution,
-	        const FTimespan&         Timeout,
-	        const TFunction<void()>& DoWork);
+	void It(const FString&             InDescription,
+	        const EAsyncExecution      Execution,
+	        const FTimespan&           Timeout,
+	        const TFunction<void()>&   DoWork,
+	        const FSpecSourceLocation& Location = FSpecSourceLocation::Current());
 
 	// ReSharper disable once CppMemberFunctionMayBeStatic
 	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
@@ -1690,8 +3171,13 @@ protected:
 	 *	A descriptive string specifying the expectation or behavior being tested.
 	 * @param DoWork
 	 *	A lambda that contains the code to execute for the specified scenario.
+	 * @param Location
+	 *	The location in source code at which the block is being defined. This is captured automatically at the call
+	 *	site and does not normally need to be provided.
 	 */
-	void LatentIt(const FString& InDescription, const TFunction<void(const FDoneDelegate&)>& DoWork);
+	void LatentIt(const FString&                               InDescription,
+	              const TFunction<void(const FDoneDelegate&)>& DoWork,
+	              const FSpecSourceLocation&                   Location = FSpecSourceLocation::Current());
 
 	// ReSharper disable once CppMemberFunctionMayBeStatic
 	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
@@ -1726,10 +3212,14 @@ protected:
 	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
 	 * @param DoWork
 	 *	A lambda that contains the code to execute for the specified scenario.
+	 * @param Location
+	 *	The location in source code at which the block is being defined. This is captured automatically at the call
+	 *	site and does not normally need to be provided.
 	 */
 	void LatentIt(const FString&                               InDescription,
 	              const FTimespan&                             Timeout,
-	              const TFunction<void(const FDoneDelegate&)>& DoWork);
+	              const TFunction<void(const FDoneDelegate&)>& DoWork,
+	              const FSpecSourceLocation&                   Location = FSpecSourceLocation::Current());
 
 	// ReSharper disable once CppMemberFunctionMayBeStatic
 	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
@@ -1768,10 +3258,14 @@ protected:
 	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
 	 * @param DoWork
 	 *	A lambda that contains the code to execute for the specified scenario.
+	 * @param Location
+	 *	The location in source code at which the block is being defined. This is captured automatically at the call
+	 *	site and does not normally need to be provided.
 	 */
 	void LatentIt(const FString&                               InDescription,
 	              const EAsyncExecution                        Execution,
-	              const TFunction<void(const FDoneDelegate&)>& DoWork);
+	              const TFunction<void(const FDoneDelegate&)>& DoWork,
+	              const FSpecSourceLocation&                   Location = FSpecSourceLocation::Current());
 
 	// ReSharper disable once CppMemberFunctionMayBeStatic
 	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
@@ -1812,11 +3306,15 @@ protected:
 	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
 	 * @param DoWork
 	 *	A lambda that contains the code to execute for the specified scenario.
+	 * @param Location
+	 *	The location in source code at which the block is being defined. This is captured automatically at the call
+	 *	site and does not normally need to be provided.
 	 */
 	void LatentIt(const FString&                               InDescription,
 	              const EAsyncExecution                        Execution,
 	              const FTimespan&                             Timeout,
-	              const TFunction<void(const FDoneDelegate&)>& DoWork);
+	              const TFunction<void(const FDoneDelegate&)>& DoWork,
+	              const FSpecSourceLocation&                   Location = FSpecSourceLocation::Current());
 
 	// ReSharper disable once CppMemberFunctionMayBeStatic
 	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
@@ -1842,6 +3340,93 @@ protected:
 		// Disabled.
 	}
 
+	/**
+	 * Defines a benchmark of code within the current test scope, using the default benchmark options.
+	 *
+	 * @see Benchmark(const FString&, const FEnhancedSpecBenchmarkOptions&, const TFunction<void()>&)
+	 *
+	 * @param InDescription
+	 *	A descriptive string specifying the code being measured.
+	 * @param DoWork
+	 *	A lambda that contains the code to measure.
+	 * @param Location
+	 *	The location in source code at which the block is being defined. This is captured automatically at the call
+	 *	site and does not normally need to be provided.
+	 */
+	void Benchmark(const FString&             InDescription,
+	               const TFunction<void()>&   DoWork,
+	               const FSpecSourceLocation& Location = FSpecSourceLocation::Current());
+
+	/**
+	 * Defines a benchmark of code within the current test scope.
+	 *
+	 * A benchmark is a test case like any other, so it runs the BeforeAll(), BeforeEach(), AfterEach(), and AfterAll()
+	 * blocks of its scope and can read the variables of its scope. Its code, however, runs many times: first to warm
+	 * up, then in timed samples of several iterations each. BeforeEach() and AfterEach() blocks run once around all of
+	 * these runs, and Let() values are only generated once, so the code should not assume that it starts from a clean
+	 * state each time it runs.
+	 *
+	 * The time of each iteration is summarized (min, median, p95, p99, max, and median absolute deviation, with
+	 * outliers rejected), added to the results of the test as info, and written as JSON to the benchmark results
+	 * directory. Measuring stops as soon as the test reports an error.
+	 *
+	 * If Options.Budget sets any limits, the test fails when the results exceed them. Limits relative to the recorded
+	 * baseline of the benchmark are only checked once a baseline has been recorded, by running with
+	 * "-EnhancedSpecRecordBenchmarkBaseline".
+	 *
+	 * @param InDescription
+	 *	A descriptive string specifying the code being measured.
+	 * @param Options
+	 *	Settings that control the warmup, the number of samples, outlier rejection, and performance budget.
+	 * @param DoWork
+	 *	A lambda that contains the code to measure.
+	 * @param Location
+	 *	The location in source code at which the block is being defined. This is captured automatically at the call
+	 *	site and does not normally need to be provided.
+	 */
+	void Benchmark(const FString&                       InDescription,
+	               const FEnhancedSpecBenchmarkOptions& Options,
+	               const TFunction<void()>&             DoWork,
+	               const FSpecSourceLocation&           Location = FSpecSourceLocation::Current());
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of Benchmark().
+	 *
+	 * @see Benchmark(const FString&, const TFunction<void()>&)
+	 *
+	 * @param InDescription
+	 *	A descriptive string specifying the code being measured.
+	 * @param DoWork
+	 *	A lambda that contains the code to measure.
+	 */
+	FORCEINLINE void xBenchmark(const FString& InDescription, const TFunction<void()>& DoWork)
+	{
+		// Disabled.
+	}
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of Benchmark().
+	 *
+	 * @see Benchmark(const FString&, const FEnhancedSpecBenchmarkOptions&, const TFunction<void()>&)
+	 *
+	 * @param InDescription
+	 *	A descriptive string specifying the code being measured.
+	 * @param Options
+	 *	Settings that control the warmup, the number of samples, outlier rejection, and performance budget.
+	 * @param DoWork
+	 *	A lambda that contains the code to measure.
+	 */
+	FORCEINLINE void xBenchmark(const FString&                       InDescription,
+	                            const FEnhancedSpecBenchmarkOptions& Options,
+	                            const TFunction<void()>&             DoWork)
+	{
+		// Disabled.
+	}
+
 	/**
 	 * Defines code that must run before the first It() block of the current scope.
 	 *
@@ -2523,35 +4108,372 @@ protected:
 	 * @param DoWork
 	 *	A lambda that defines the code to execute after each It() block within the enclosing scope.
 	 */
-	void LatentAfterEach(const EAsyncExecution                        Execution,
-	                     const FTimespan&                             Timeout,
-	                     const TFunction<void(const FDoneDelegate&)>& DoWork);
+	void LatentAfterEach(const EAsyncExecution                        Execution,
+	                     const FTimespan&                             Timeout,
+	                     const TFunction<void(const FDoneDelegate&)>& DoWork);
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of LatentAfterEach().
+	 *
+	 * @see LatentAfterEach(const EAsyncExecution, const FTimespan&, const TFunction<void(const FDoneDelegate&)>&)
+	 *
+	 * @param Execution
+	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
+	 * @param Timeout
+	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after each It() block within the enclosing scope.
+	 */
+	FORCEINLINE void xLatentAfterEach(const EAsyncExecution                        Execution,
+	                                  const FTimespan&                             Timeout,
+	                                  const TFunction<void(const FDoneDelegate&)>& DoWork)
+	{
+		// Disabled.
+	}
+
+	/**
+	 * Defines code that must run after the last It() block of the current scope.
+	 *
+	 * AfterAll() affects only the Describe() scope in which it is defined and its children. The code blocks run once,
+	 * after the last It() block within that scope (including nested scopes) that runs on the current runner, and after
+	 * the AfterEach() blocks of that test case. They run in the reverse of the order in which they were defined, and
+	 * the AfterAll() blocks of inner scopes run before those of enclosing scopes. This makes AfterAll() the place to
+	 * release anything expensive that BeforeAll() created, as soon as the tests that need it have finished. If only
+	 * some of the It() blocks of the scope run during a test session, the code blocks run when the session ends.
+	 *
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	void AfterAll(const TFunction<void()>& DoWork);
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of AfterAll().
+	 *
+	 * @see AfterAll(const TFunction<void()>&)
+	 *
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	FORCEINLINE void xAfterAll(const TFunction<void()>& DoWork)
+	{
+		// Disabled.
+	}
+
+	/**
+	 * Defines code that must run asynchronously after the last It() block of the current scope.
+	 *
+	 * AfterAll() affects only the Describe() scope in which it is defined and its children. The code blocks run once,
+	 * after the last It() block within that scope (including nested scopes) that runs on the current runner, and after
+	 * the AfterEach() blocks of that test case. They run in the reverse of the order in which they were defined, and
+	 * the AfterAll() blocks of inner scopes run before those of enclosing scopes. This makes AfterAll() the place to
+	 * release anything expensive that BeforeAll() created, as soon as the tests that need it have finished.
+	 *
+	 * @param Execution
+	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	void AfterAll(const EAsyncExecution Execution, const TFunction<void()>& DoWork);
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of AfterAll().
+	 *
+	 * @see AfterAll(const EAsyncExecution, const TFunction<void()>&)
+	 *
+	 * @param Execution
+	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	FORCEINLINE void xAfterAll(const EAsyncExecution Execution, const TFunction<void()>& DoWork)
+	{
+		// Disabled.
+	}
+
+	/**
+	 * Defines code that must run asynchronously after the last It() block of the current scope, with a timeout.
+	 *
+	 * AfterAll() affects only the Describe() scope in which it is defined and its children. The code blocks run once,
+	 * after the last It() block within that scope (including nested scopes) that runs on the current runner, and after
+	 * the AfterEach() blocks of that test case. They run in the reverse of the order in which they were defined, and
+	 * the AfterAll() blocks of inner scopes run before those of enclosing scopes. This makes AfterAll() the place to
+	 * release anything expensive that BeforeAll() created, as soon as the tests that need it have finished.
+	 *
+	 * @param Execution
+	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
+	 * @param Timeout
+	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	void AfterAll(const EAsyncExecution Execution, const FTimespan& Timeout, const TFunction<void()>& DoWork);
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of AfterAll().
+	 *
+	 * @see AfterAll(const EAsyncExecution, const FTimespan&, const TFunction<void()>&)
+	 *
+	 * @param Execution
+	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
+	 * @param Timeout
+	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	FORCEINLINE void xAfterAll(const EAsyncExecution    Execution,
+	                           const FTimespan&         Timeout,
+	                           const TFunction<void()>& DoWork)
+	{
+		// Disabled.
+	}
+
+	/**
+	 * Defines code that must run over multiple frames after the last It() block of the current scope.
+	 *
+	 * AfterAll() affects only the Describe() scope in which it is defined and its children. The code blocks run once,
+	 * after the last It() block within that scope (including nested scopes) that runs on the current runner, and after
+	 * the AfterEach() blocks of that test case. They run in the reverse of the order in which they were defined, and
+	 * the AfterAll() blocks of inner scopes run before those of enclosing scopes. This makes AfterAll() the place to
+	 * release anything expensive that BeforeAll() created, as soon as the tests that need it have finished.
+	 *
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	void LatentAfterAll(const TFunction<void(const FDoneDelegate&)>& DoWork);
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of LatentAfterAll().
+	 *
+	 * @see LatentAfterAll(const TFunction<void(const FDoneDelegate&)>&)
+	 *
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	FORCEINLINE void xLatentAfterAll(const TFunction<void(const FDoneDelegate&)>& DoWork)
+	{
+		// Disabled.
+	}
+
+	/**
+	 * Defines code that must run over multiple frames with a timeout after the last It() block of the current scope.
+	 *
+	 * AfterAll() affects only the Describe() scope in which it is defined and its children. The code blocks run once,
+	 * after the last It() block within that scope (including nested scopes) that runs on the current runner, and after
+	 * the AfterEach() blocks of that test case. They run in the reverse of the order in which they were defined, and
+	 * the AfterAll() blocks of inner scopes run before those of enclosing scopes. This makes AfterAll() the place to
+	 * release anything expensive that BeforeAll() created, as soon as the tests that need it have finished.
+	 *
+	 * @param Timeout
+	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	void LatentAfterAll(const FTimespan& Timeout, const TFunction<void(const FDoneDelegate&)>& DoWork);
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of LatentAfterAll().
+	 *
+	 * @see LatentAfterAll(const FTimespan&, const TFunction<void(const FDoneDelegate&)>&)
+	 *
+	 * @param Timeout
+	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	FORCEINLINE void xLatentAfterAll(const FTimespan& Timeout, const TFunction<void(const FDoneDelegate&)>& DoWork)
+	{
+		// Disabled.
+	}
+
+	/**
+	 * Defines async. code that must run over multiple frames after the last It() block of the current scope.
+	 *
+	 * AfterAll() affects only the Describe() scope in which it is defined and its children. The code blocks run once,
+	 * after the last It() block within that scope (including nested scopes) that runs on the current runner, and after
+	 * the AfterEach() blocks of that test case. They run in the reverse of the order in which they were defined, and
+	 * the AfterAll() blocks of inner scopes run before those of enclosing scopes. This makes AfterAll() the place to
+	 * release anything expensive that BeforeAll() created, as soon as the tests that need it have finished.
+	 *
+	 * @param Execution
+	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	void LatentAfterAll(const EAsyncExecution Execution, const TFunction<void(const FDoneDelegate&)>& DoWork);
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of LatentAfterAll().
+	 *
+	 * @see LatentAfterAll(const EAsyncExecution, const TFunction<void(const FDoneDelegate&)>&)
+	 *
+	 * @param Execution
+	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	FORCEINLINE void xLatentAfterAll(const EAsyncExecution                        Execution,
+	                                 const TFunction<void(const FDoneDelegate&)>& DoWork)
+	{
+		// Disabled.
+	}
+
+	/**
+	 * Defines async. code that must run over multiple frames with a timeout after the last It() block of the current
+	 * scope.
+	 *
+	 * AfterAll() affects only the Describe() scope in which it is defined and its children. The code blocks run once,
+	 * after the last It() block within that scope (including nested scopes) that runs on the current runner, and after
+	 * the AfterEach() blocks of that test case. They run in the reverse of the order in which they were defined, and
+	 * the AfterAll() blocks of inner scopes run before those of enclosing scopes. This makes AfterAll() the place to
+	 * release anything expensive that BeforeAll() created, as soon as the tests that need it have finished.
+	 *
+	 * @param Execution
+	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
+	 * @param Timeout
+	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	void LatentAfterAll(const EAsyncExecution                        Execution,
+	                    const FTimespan&                             Timeout,
+	                    const TFunction<void(const FDoneDelegate&)>& DoWork);
+
+	// ReSharper disable once CppMemberFunctionMayBeStatic
+	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
+	/**
+	 * Disabled/skipped version of LatentAfterAll().
+	 *
+	 * @see LatentAfterAll(const EAsyncExecution, const FTimespan&, const TFunction<void(const FDoneDelegate&)>&)
+	 *
+	 * @param Execution
+	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
+	 * @param Timeout
+	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
+	 * @param DoWork
+	 *	A lambda that defines the code to execute after the last It() block within the enclosing scope.
+	 */
+	FORCEINLINE void xLatentAfterAll(const EAsyncExecution                        Execution,
+	                                 const FTimespan&                             Timeout,
+	                                 const TFunction<void(const FDoneDelegate&)>& DoWork)
+	{
+		// Disabled.
+	}
+
+	/**
+	 * Declares that this specification depends on a fixture that is shared with other spec classes.
+	 *
+	 * The fixture is built once per runner, the first time any spec class requests its value, and is then shared
+	 * read-only by all spec classes that depend on it. Its value is released once the last test case of every
+	 * dependent spec class on the current runner has finished, or at the end of the test session.
+	 *
+	 * This must be called from Define(). Declaring the same fixture more than once has no further effect.
+	 *
+	 * @param Fixture
+	 *	The fixture on which this specification depends.
+	 */
+	void UseFixture(FEnhancedSpecFixtureBase& Fixture);
+
+	/**
+	 * Gets whether the asynchronous work that is calling this method has timed out and should stop early.
+	 *
+	 * This can be called from the work of any asynchronous It(), LatentIt(), BeforeAll(), BeforeEach(), AfterEach(), or
+	 * AfterAll() block. Work that calls it from a thread other than the one that the block started on should use
+	 * GetCancellationToken() instead.
+	 *
+	 * @return
+	 *	true if the work has been abandoned and should return as soon as it can; or, false otherwise.
+	 */
+	UE_NODISCARD bool IsCancellationRequested() const;
+
+	/**
+	 * Gets the cancellation token of the asynchronous work that is calling this method.
+	 *
+	 * The token can be captured and handed to other threads or callbacks that the work starts, so that they can also
+	 * tell when the work has been abandoned.
+	 *
+	 * @return
+	 *	The token of the calling work; or, a null pointer if the calling thread is not running the work of an
+	 *	asynchronous block.
+	 */
+	UE_NODISCARD TSharedPtr<FSpecCancellationToken> GetCancellationToken() const;
+
+	/**
+	 * Ensures that all test definitions have been loaded and cached.
+	 *
+	 * When definitions are being loaded lazily, this expands every scope that has been deferred so far.
+	 */
+	void EnsureDefinitions() const;
+
+	/**
+	 * Ensures that the definition of a single test case has been loaded and cached.
+	 *
+	 * When definitions are being loaded lazily, this only expands the deferred scopes that could contain the test case.
+	 * If the test case is not found in them (e.g., because it has a custom ID), all deferred scopes are expanded.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case.
+	 */
+	void EnsureDefinitionFor(const FStringView SpecId) const;
+
+	/**
+	 * Gets whether the bodies of Describe() scopes should be deferred until a test case within them is looked up.
+	 *
+	 * By default, this is enabled by passing "-EnhancedSpecLazyDefine" on the command line, unless test cases are being
+	 * sharded (which needs every test case in order to assign them to shards). Sub-classes can override this to opt in
+	 * or out regardless of the command line.
+	 *
+	 * Scopes declared with DescribeParallel(), and all scopes nested within them, are never deferred. The lambdas of
+	 * deferred scopes run after Define() has returned, so they must capture everything they use by value.
+	 *
+	 * @return
+	 *	true if scopes should be defined lazily; or, false if the entire specification should be defined at once.
+	 */
+	virtual bool ShouldDefineLazily() const;
 
-	// ReSharper disable once CppMemberFunctionMayBeStatic
-	// ReSharper disable once CppUE4CodingStandardNamingViolationWarning
 	/**
-	 * Disabled/skipped version of LatentAfterEach().
+	 * Gets whether the test cases of this specification can be listed from the definition cache.
 	 *
-	 * @see LatentAfterEach(const EAsyncExecution, const FTimespan&, const TFunction<void(const FDoneDelegate&)>&)
+	 * By default, this is only the case when this specification was constructed with a module name, which the macros
+	 * for declaring specs do automatically. Sub-classes that define different test cases depending on something other
+	 * than their code (e.g., data files that are loaded by Define()) should override this to return false.
 	 *
-	 * @param Execution
-	 *	How the code in this block should be executed (task graph, thread pool, dedicated thread, etc.).
-	 * @param Timeout
-	 *	The maximum amount of time to wait for the code in this block to execute before failing the test.
-	 * @param DoWork
-	 *	A lambda that defines the code to execute after each It() block within the enclosing scope.
+	 * @return
+	 *	true if the list of test cases can be cached; or, false if this specification must always be defined in order
+	 *	to list its test cases.
 	 */
-	FORCEINLINE void xLatentAfterEach(const EAsyncExecution                        Execution,
-	                                  const FTimespan&                             Timeout,
-	                                  const TFunction<void(const FDoneDelegate&)>& DoWork)
-	{
-		// Disabled.
-	}
+	virtual bool CanCacheDefinitions() const;
 
 	/**
-	 * Ensures that all test definitions have been loaded and cached.
+	 * Gets the full names of the test cases that the automation controller was asked to run during this session.
+	 *
+	 * The automation controller runs each test case through its own call to RunTest(), so this is how the first test
+	 * case of a DescribeParallel() scope finds out which of the other test cases of that scope will also run, and can
+	 * run them together with it. By default, the names are looked up from the automation controller, if it runs in
+	 * this process. Names may either be in the form "<TestName> <ID>" or be beautified paths (e.g.,
+	 * "Category.Suite.Describe It").
+	 *
+	 * @param OutTestNames
+	 *	The set to which the names of the requested test cases are added.
+	 *
+	 * @return
+	 *	true if the requested test cases are known; or, false if they are not, in which case every test case of a
+	 *	parallel scope that belongs to the shard of this runner is assumed to have been requested.
 	 */
-	void EnsureDefinitions() const;
+	virtual bool GetRequestedTestNames(TSet<FString>& OutTestNames) const;
 
 	/**
 	 * Method that sub-classes must implement to define the structure and expectations of the test.
@@ -2572,6 +4494,74 @@ protected:
 	 */
 	void Redefine();
 
+	/**
+	 * Runs all commands of a single test case to completion on the calling thread.
+	 *
+	 * Unlike RunTest(), this does not go through the latent command queue of the automation framework, so it is
+	 * suitable for tools that measure the cost of the framework itself. Commands that only make progress when the
+	 * engine ticks never complete when run this way, so only test cases without such commands should be run with it.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case to run.
+	 *
+	 * @return
+	 *	The number of commands that were run; or, 0 if there is no test case with the given ID.
+	 */
+	int32 RunSpecImmediately(const FString& SpecId);
+
+	/**
+	 * Runs all commands of a single test case to completion on the calling thread, counting the frames it took.
+	 *
+	 * Each time the commands of the test case yield to the engine counts as one frame, even though the engine does not
+	 * tick between them.
+	 *
+	 * @see RunSpecImmediately(const FString&)
+	 *
+	 * @param SpecId
+	 *	The ID of the test case to run.
+	 * @param OutNumFrames
+	 *	Receives the number of frames that the automation framework would have spent running the test case; or, 0 if
+	 *	there is no test case with the given ID.
+	 *
+	 * @return
+	 *	The number of commands that were run; or, 0 if there is no test case with the given ID.
+	 */
+	int32 RunSpecImmediately(const FString& SpecId, int32& OutNumFrames);
+
+	/**
+	 * Counts the references to setup, teardown, and test commands that are held by the test cases of this
+	 * specification, by walking from the node of each test case up to the root scope.
+	 *
+	 * This is intended for tools that measure the memory cost of the framework itself.
+	 *
+	 * @param OutNumHeld
+	 *	Receives the number of command references actually held, counting the commands of each scope node once no
+	 *	matter how many test cases share it, plus the command of each test case.
+	 * @param OutNumReachable
+	 *	Receives the number of command references that the test cases reach, counting the commands of each scope node
+	 *	once for every test case within it. This is how many references would be held if the commands of all enclosing
+	 *	scopes were copied into each test case.
+	 */
+	void CountCommandReferences(int64& OutNumHeld, int64& OutNumReachable) const;
+
+	/**
+	 * Emulates how test cases were converted before scopes shared their commands through a tree, by copying the
+	 * commands of all enclosing scopes and a full variable table into a separate list for each test case.
+	 *
+	 * The copies are only kept until the given callback returns. This is intended for tools that measure the memory
+	 * cost of the framework itself against that of the flattened layout.
+	 *
+	 * @param WhileFlattened
+	 *	The callback to invoke while the copies exist.
+	 * @param OutNumCommandsCopied
+	 *	Receives the number of command references that were copied.
+	 * @param OutNumBytesCopied
+	 *	Receives the number of bytes allocated for the copied command lists and variable tables.
+	 */
+	void EmulateFlattenedSpecs(const TFunction<void()>& WhileFlattened,
+	                           int64&                   OutNumCommandsCopied,
+	                           int64&                   OutNumBytesCopied) const;
+
 private:
 	// =============================================================================================================
 	// Private Methods
@@ -2584,10 +4574,43 @@ private:
 	 */
 	FString GetId() const;
 
+	/**
+	 * Looks up a ready-to-execute test case by its ID, without allocating.
+	 *
+	 * @param SpecId
+	 *	The ID of the test case.
+	 *
+	 * @return
+	 *	The test case; or, a null pointer if no test case with that ID has been defined.
+	 */
+	const TSharedRef<FSpec>* FindSpec(const FStringView SpecId) const;
+
+	/**
+	 * Gets the ID of a test case from the name of the test case that is passed to source lookups.
+	 *
+	 * @param InTestName
+	 *	The name of the test case, which is either its ID or the name of this specification followed by a space and
+	 *	its ID.
+	 *
+	 * @return
+	 *	A view of the ID of the test case within the given name.
+	 */
+	FStringView GetSpecIdFromTestName(const FString& InTestName) const;
+
+	/**
+	 * Looks up the test cases of this specification in the definition cache.
+	 *
+	 * @return
+	 *	The cached test cases; or, a null pointer if this specification cannot be cached, or it has not been cached by
+	 *	the same build.
+	 */
+	TSharedPtr<const FEnhancedSpecListingSet> FindCachedListings() const;
+
 	/**
 	 * Gets the description for the test scenario being defined.
 	 *
-	 * This is assembled by concatenating the current description stack.
+	 * This is the concatenation of the current description stack, which is maintained as descriptions are pushed and
+	 * popped.
 	 *
 	 * @return
 	 *	The description string.
@@ -2606,14 +4629,30 @@ private:
 	}
 
 	/**
-	 * Gets the top-most stack frame, which represents the execution of the current test.
+	 * Gets the filename and line number at which a block is being defined.
+	 *
+	 * The location captured at compile time is used when it is known. Otherwise, this falls back to walking the call
+	 * stack, which is significantly more expensive.
+	 *
+	 * @param Location
+	 *	The location captured at the call site of the method defining the block.
 	 *
 	 * @return
-	 *	The top-most stack frame.
+	 *	The filename and line number of the block.
 	 */
-	FORCEINLINE static const FProgramCounterSymbolInfo& GetTopOfCallStack()
+	FORCEINLINE static TTuple<FString, int32> ResolveSourceLocation(const FSpecSourceLocation& Location)
 	{
-		return GetCallStack().Get()[0];
+		if (Location.IsKnown())
+		{
+			return MakeTuple(FString(Location.Filename), Location.LineNumber);
+		}
+		else
+		{
+			const TSharedRef<TArray<FProgramCounterSymbolInfo>> CallStack  = GetCallStack();
+			const FProgramCounterSymbolInfo&                    TopOfStack = CallStack.Get()[0];
+
+			return MakeTuple(FString(TopOfStack.Filename), static_cast<int32>(TopOfStack.LineNumber));
+		}
 	}
 
 	/**
@@ -2655,6 +4694,23 @@ private:
 	 */
 	void PopDescription();
 
+	/**
+	 * Pops all descriptions from the test hierarchy description stack.
+	 */
+	void ClearDescriptionStack();
+
+	/**
+	 * Defines a new scope for expectations.
+	 *
+	 * @param InDescription
+	 *	A string that describes the scope of the expectations within it.
+	 * @param bRunInParallel
+	 *	Whether the test cases within the scope may run concurrently.
+	 * @param DoWork
+	 *	A lambda that defines the expectations within this scope.
+	 */
+	void DescribeScope(const FString& InDescription, const bool bRunInParallel, const TFunction<void()>& DoWork);
+
 	/**
 	 * Creates a wrapper function for ensuring a block runs only once during a test session.
 	 *
@@ -2685,12 +4741,369 @@ private:
 		const TFunction<void(const FDoneDelegate&)>& DoWork) const;
 
 	/**
-	 * Runs the specified spec.
+	 * Creates a wrapper function for ensuring a block runs only once, after all test cases of its scope have finished.
+	 *
+	 * @param ScopeHandle
+	 *	Handle of the scope in which the block is defined.
+	 * @param BlockHandle
+	 *	Handle of the spec block.
+	 * @param DoWork
+	 *	The code to execute within the block.
+	 *
+	 * @return
+	 *	The wrapper function.
+	 */
+	TFunction<void()> CreateRunAfterScopeWrapper(const FSpecBlockHandle&  ScopeHandle,
+	                                             const FSpecBlockHandle&  BlockHandle,
+	                                             const TFunction<void()>& DoWork) const;
+
+	/**
+	 * Creates a wrapper function for ensuring a block runs only once, after all test cases of its scope have finished.
+	 *
+	 * @param ScopeHandle
+	 *	Handle of the scope in which the block is defined.
+	 * @param BlockHandle
+	 *	Handle of the spec block.
+	 * @param DoWork
+	 *	The code to execute within the block.
+	 *
+	 * @return
+	 *	The wrapper function.
+	 */
+	TFunction<void(const FDoneDelegate&)> CreateRunAfterScopeWrapper(
+		const FSpecBlockHandle&                      ScopeHandle,
+		const FSpecBlockHandle&                      BlockHandle,
+		const TFunction<void(const FDoneDelegate&)>& DoWork) const;
+
+	/**
+	 * Checks whether all test cases of a scope that run on this runner have finished during this test session.
+	 *
+	 * @param ScopeHandle
+	 *	The handle of a scope that has AfterAll() blocks.
+	 *
+	 * @return
+	 *	true if the AfterAll() blocks of the scope can run; or, false if any of its test cases have yet to run.
+	 */
+	bool HasScopeFinished(const FSpecBlockHandle& ScopeHandle) const;
+
+	/**
+	 * Converts a scope that was populated during Define() into an immutable scope node, then does the same for all of
+	 * its nested scopes.
+	 *
+	 * Each It() block of the scope is converted into an FSpec that references the new node, and is registered in
+	 * SpecsByIdHash.
+	 *
+	 * @param Scope
+	 *	The scope to convert.
+	 * @param ParentNode
+	 *	The node that was created for the enclosing scope, or a null pointer if the scope is the root scope.
+	 */
+	void BuildScopeNode(const TSharedRef<FSpecDefinitionScope>& Scope,
+	                    const TSharedPtr<const FSpecScopeNode>& ParentNode);
+
+	/**
+	 * Enables tracing of the commands of a scope node and of the It() blocks defined directly within its scope.
+	 *
+	 * @param Node
+	 *	The node of the scope.
+	 * @param ItDefinitions
+	 *	The It() blocks defined directly within the scope.
+	 */
+	static void TraceScopeCommands(const FSpecScopeNode&                        Node,
+	                               const TArray<TSharedRef<FSpecItDefinition>>& ItDefinitions);
+
+	/**
+	 * Gets whether any scope on the definition scope stack was declared with DescribeParallel().
+	 *
+	 * @return
+	 *	true if the scope being defined is, or is nested within, a parallel scope; or, false otherwise.
+	 */
+	bool IsDefiningParallelScope() const;
+
+	/**
+	 * Records a scope declared with Describe() without running its body, so that it can be expanded later.
+	 *
+	 * @param InDescription
+	 *	The description of the scope.
+	 * @param DoWork
+	 *	The body of the scope.
+	 */
+	void DeferScope(const FString& InDescription, const TFunction<void()>& DoWork);
+
+	/**
+	 * Expands deferred scopes that match a predicate, including any scopes that they defer in turn and that also match
+	 * it, then recounts the test cases of each scope that has AfterAll() blocks.
+	 *
+	 * @param ShouldExpand
+	 *	A predicate that is passed each deferred scope and returns whether to expand it.
+	 */
+	void ExpandDeferredScopes(const TFunctionRef<bool(const FSpecDeferredScope&)> ShouldExpand);
+
+	/**
+	 * Runs the body of a deferred scope, then converts the scope into a node under the node of its enclosing scope.
+	 *
+	 * @param DeferredScope
+	 *	The scope to expand.
+	 */
+	void ExpandDeferredScope(const TSharedRef<FSpecDeferredScope>& DeferredScope);
+
+	/**
+	 * Determines which test cases of this specification belong to the shard of the current runner.
+	 *
+	 * Test cases are grouped so that test cases sharing BeforeAll() blocks stay on the same shard, and then the groups
+	 * are assigned to shards using the durations recorded for each test case in prior sessions.
+	 */
+	void AssignSpecsToShard();
+
+	/**
+	 * Counts how many test cases within each scope that has AfterAll() blocks run on this runner.
+	 *
+	 * This must be called after test cases have been assigned to shards.
+	 */
+	void CountSpecsInShardPerScope();
+
+	/**
+	 * Records that a test case has finished in every scope enclosing it that has AfterAll() blocks.
+	 *
+	 * @param Spec
+	 *	The test case that has finished.
+	 */
+	void MarkSpecAsFinished(const FSpec& Spec);
+
+	/**
+	 * Counts this specification as a dependent of a fixture in the fixture registry, unless it already has been.
+	 *
+	 * @param Fixture
+	 *	The fixture on which this specification depends.
+	 */
+	void CountAsFixtureDependent(FEnhancedSpecFixtureBase& Fixture);
+
+	/**
+	 * Records that a test case has started in every scope enclosing it that has AfterAll() blocks.
+	 *
+	 * @param Spec
+	 *	The test case that has started.
+	 */
+	void MarkSpecAsStarted(const FSpec& Spec);
+
+	/**
+	 * Runs the AfterAll() blocks of each scope in which a test case started but that has not yet run them.
+	 *
+	 * AfterAll() blocks normally run once every test case of their scope on this runner has finished. That never
+	 * happens when only some of the test cases are run (e.g., when running a filtered selection of tests) or when
+	 * the scope still has deferred scopes, so this runs the blocks when the test session ends instead. Blocks run from
+	 * the inner-most scopes outwards, last block first.
+	 */
+	void RunPendingAfterAllBlocks();
+
+	/**
+	 * Gets the name under which the duration of a test case is recorded.
+	 *
+	 * @param Spec
+	 *	The test case.
+	 *
+	 * @return
+	 *	The name of this specification followed by a space and the ID of the test case.
+	 */
+	FString GetFullTestName(const FSpec& Spec) const;
+
+	/**
+	 * Gets the test case that is running on the calling thread.
+	 *
+	 * @return
+	 *	The test case that is running in parallel on the calling thread, if any; otherwise, the test case that is
+	 *	running sequentially, or whose AfterAll() blocks are running; or, a null pointer if no test case is running.
+	 */
+	const FSpec* GetRunningSpec() const;
+
+	/**
+	 * Measures the code of a Benchmark() block, then reports and saves the results.
+	 *
+	 * @param Options
+	 *	Settings that control how the code is measured.
+	 * @param DoWork
+	 *	The code to measure.
+	 */
+	void RunBenchmark(const FEnhancedSpecBenchmarkOptions& Options, const TFunction<void()>& DoWork);
+
+	/**
+	 * Collects the commands needed to run the specified spec, in the order they must be run.
+	 *
+	 * @param SpecToRun
+	 *	The spec to run.
+	 * @param ParallelBatches
+	 *	The test cases that are waiting to run in parallel, out of all the test cases being collected for the same run
+	 *	of this specification. If the spec can run in parallel, it is added to the batch of its parallel scope. When
+	 *	the batch runs, the other requested test cases of the scope that have yet to run are added to it as well.
+	 * @param OutCommands
+	 *	The array to which the commands of the spec are appended.
+	 */
+	void GatherSpecCommands(const TSharedRef<FSpec>&                SpecToRun,
+	                        FSpecParallelBatches&                   ParallelBatches,
+	                        TArray<TSharedRef<FSpecLatentCommand>>& OutCommands);
+
+	/**
+	 * Collects the commands needed to run a spec that cannot run in parallel, except for its AfterAll() blocks.
 	 *
 	 * @param SpecToRun
 	 *	The spec to run.
+	 * @param ScopeChain
+	 *	The nodes of all scopes that enclose the spec, ordered from the inner-most scope outwards.
+	 * @param OutCommands
+	 *	The array to which the commands of the spec are appended.
+	 */
+	void GatherSequentialSpecCommands(const TSharedRef<FSpec>&                SpecToRun,
+	                                  const FSpecScopeChain&                  ScopeChain,
+	                                  TArray<TSharedRef<FSpecLatentCommand>>& OutCommands);
+
+	/**
+	 * Prepares the variables of a spec that is about to run.
+	 *
+	 * This destroys any values left behind by a test case that was aborted before it could finish, invalidates all
+	 * memoized variable values so that they are regenerated for this spec, and then makes the variable table of the
+	 * scope of the spec the active table.
+	 *
+	 * @param SpecToRun
+	 *	The spec that is starting.
 	 */
-	void RunSpec(const TSharedRef<FSpec>& SpecToRun);
+	void BeginSpec(const FSpec& SpecToRun);
+
+	/**
+	 * Tears down a test case after all of its blocks have finished.
+	 *
+	 * This destroys the values of all variables that the test case generated, records how long the blocks of the test
+	 * case took to run (not counting frames spent waiting to resume), reports its memory high-watermark if
+	 * "EnhancedSpecs.ReportMemoryWatermark" is enabled, and counts the test case as finished so that the AfterAll()
+	 * blocks of its scopes can run.
+	 *
+	 * @param SpecToRun
+	 *	The test case that has finished.
+	 */
+	void EndSpec(const FSpec& SpecToRun);
+
+	/**
+	 * Resumes timing the work of the test case that is running sequentially, at the start of a frame.
+	 */
+	void ResumeSpecTimer();
+
+	/**
+	 * Pauses timing the work of the test case that is running sequentially, before yielding to the engine.
+	 */
+	void PauseSpecTimer();
+
+	/**
+	 * Destroys the values of all variables generated by the test case that is running sequentially.
+	 *
+	 * Values are destroyed in the reverse of the order they were generated, since later values may refer to earlier
+	 * ones.
+	 */
+	void ReleaseGeneratedVariables();
+
+	/**
+	 * Adds the other test cases of a parallel scope that will run during this session to a batch, so that they run
+	 * together with the test cases already in it.
+	 *
+	 * Test cases are added if they belong to the shard of this runner, were requested from the automation controller,
+	 * can run in parallel, and have not already run during this session.
+	 *
+	 * @param ParallelScope
+	 *	The node of the scope declared with DescribeParallel().
+	 * @param BatchSpecs
+	 *	The batch to which the test cases are added.
+	 */
+	void AddPendingParallelSpecs(const FSpecScopeNode& ParallelScope, TArray<TSharedRef<FSpec>>& BatchSpecs);
+
+	/**
+	 * Checks whether a test case was requested from the automation controller during this session.
+	 *
+	 * @param Spec
+	 *	The test case to check.
+	 * @param RequestedTestNames
+	 *	The full names of the requested test cases.
+	 *
+	 * @return
+	 *	true if the test case was requested, either by name or by its beautified path; or, false otherwise.
+	 */
+	bool IsSpecRequested(const FSpec& Spec, const TSet<FString>& RequestedTestNames) const;
+
+	/**
+	 * Runs a batch of test cases concurrently, then empties the batch so that it only runs once.
+	 *
+	 * The BeforeAll() blocks of the test cases are run first, on the calling thread. Then, each test case runs its
+	 * BeforeEach(), It(), and AfterEach() blocks on a worker thread, with a private copy of its variables. The messages
+	 * that each test case reports are stored in the session state until the test case is run by the framework. Test
+	 * cases that already have stored messages are skipped.
+	 *
+	 * @param BatchSpecs
+	 *	The test cases to run. All of them must be able to run in parallel. This is empty once this method returns.
+	 */
+	void RunParallelBatch(TArray<TSharedRef<FSpec>>& BatchSpecs);
+
+	/**
+	 * Checks whether a test case should run the test cases after it ahead of time, when it runs.
+	 *
+	 * This is only the case when "EnhancedSpecs.RunSynchronousSpecsAhead" is enabled, memory watermarks are not being
+	 * reported, and the test case can run synchronously outside of any DescribeParallel() scope.
+	 *
+	 * @param Spec
+	 *	The test case to check.
+	 * @param ScopeChain
+	 *	The nodes of all scopes that enclose the test case, ordered from the inner-most scope outwards.
+	 *
+	 * @return
+	 *	true if the test case runs ahead of time along with the test cases after it; or, false if it runs one block at a
+	 *	time, as usual.
+	 */
+	bool CanRunAhead(const FSpec& Spec, const FSpecScopeChain& ScopeChain) const;
+
+	/**
+	 * Runs a test case, along with the requested test cases of this specification that the automation controller will
+	 * run right after it, one after another on the game thread.
+	 *
+	 * Test cases are taken in the order they were defined, which is the order in which they are listed to the
+	 * automation controller. This stops at the first requested test case that cannot run ahead, after the first test
+	 * case that has AfterAll() blocks in its scopes (since those blocks may need to run before the next test case), or
+	 * once the time budget for the frame has been used up. The messages that each test case reports are stored in the
+	 * session state until the automation controller runs that test case.
+	 *
+	 * @param FirstSpec
+	 *	The test case that the automation controller is running. It always runs, even if no others can.
+	 */
+	void RunSpecsAhead(const TSharedRef<FSpec>& FirstSpec);
+
+	/**
+	 * Records how long a test case that ran in a context took, and stores the messages that it reported.
+	 *
+	 * @param Spec
+	 *	The test case that ran.
+	 * @param Context
+	 *	The context in which the test case ran.
+	 */
+	void StoreContextResult(const FSpec& Spec, FParallelSpecContext& Context);
+
+	/**
+	 * Reports the errors, warnings, and info messages that a test case captured while it ran in parallel or ahead of
+	 * time.
+	 *
+	 * @param SpecToReport
+	 *	The test case that ran in parallel or ahead of time.
+	 *
+	 * @return
+	 *	true if the messages of the test case were reported; or, false if the test case has no stored result (e.g.,
+	 *	because the session state was cleared after the batch that contained it had run).
+	 */
+	bool ReportParallelResult(const FSpec& SpecToReport);
+
+	/**
+	 * Checks whether the test case running on the calling thread has reported any errors.
+	 *
+	 * For a test case that is running in parallel, this checks the messages it has captured; otherwise, this checks the
+	 * test that the automation framework is currently running.
+	 *
+	 * @return
+	 *	true if the current test case has reported errors; or, false otherwise.
+	 */
+	bool HasAnyErrorsInContext() const;
 
 	/**
 	 * Gets the value of the specified variable from the scope of the current test.
@@ -2700,15 +5113,23 @@ private:
 	 * @tparam VariableType
 	 *	The type of the variable.
 	 *
-	 * @param Handle
-	 *	The unique handle of the desired variable.
+	 * @param SlotIndex
+	 *	The slot index of the desired variable.
 	 *
 	 * @return
 	 *	The value of the variable.
 	 */
 	template <typename VariableType>
-	UE_NODISCARD FORCEINLINE TSpecVariablePtr<VariableType> GetVariable(const FSpecBlockHandle& Handle) const
+	UE_NODISCARD FORCEINLINE TSpecLet<VariableType>& GetVariable(const int32 SlotIndex) const
 	{
-		return GetVariableFromScope<VariableType>(this->VariablesInScope, Handle);
+		const FParallelSpecContext* ParallelContext =
+			this->bIsRunningInParallel ? GetParallelContextForThread() : nullptr;
+
+		if (ParallelContext != nullptr)
+		{
+			return GetVariableFromScope<VariableType>(*ParallelContext->Variables, SlotIndex);
+		}
+
+		return GetVariableFromScope<VariableType>(*this->VariablesInScope, SlotIndex);
 	}
 };
@@ -7,9 +7,98 @@
 
 #include <Modules/ModuleManager.h>
 
+ENHANCEDAUTOMATIONSPECFRAMEWORK_API DECLARE_LOG_CATEGORY_EXTERN(LogEnhancedAutomationSpecs, Log, All);
+
 /**
  * Top-level code for the module that contains the Enhanced Automation Spec Framework.
+ *
+ * The module owns the end of each test session: once the automation controller reports that all tests have completed,
+ * it first notifies each spec class so that it can finish and reset its own state, and then performs the work that is
+ * shared by all spec classes (e.g., saving timings and baselines) exactly once.
  */
 class FEnhancedAutomationSpecFramework final : public IModuleInterface
 {
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * Delegates to notify when a test session ends, before the work that is shared by all spec classes is performed.
+	 */
+	FSimpleMulticastDelegate SessionEndDelegate;
+
+	/**
+	 * The handle of the delegate that has been registered with the automation controller to be notified when tests
+	 * complete.
+	 */
+	FDelegateHandle TestsCompleteHandle;
+
+	/**
+	 * The handle of the delegate that has been registered with the module manager to be notified when modules load.
+	 */
+	FDelegateHandle ModulesChangedHandle;
+
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the instance of this module, if it is loaded.
+	 *
+	 * @return
+	 *	The module; or, a null pointer if the module is not loaded (e.g., during shutdown of the engine).
+	 */
+	static FEnhancedAutomationSpecFramework* GetIfLoaded();
+
+	// =================================================================================================================
+	// Public Methods - IModuleInterface Overrides
+	// =================================================================================================================
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets the delegates to notify when a test session ends.
+	 *
+	 * Each spec class registers here to reset its own state. Delegates are notified before timings, definitions,
+	 * traces, and baselines are saved, and before shared fixtures are released.
+	 *
+	 * @return
+	 *	The session end delegates.
+	 */
+	FORCEINLINE FSimpleMulticastDelegate& OnSessionEnd()
+	{
+		return this->SessionEndDelegate;
+	}
+
+	/**
+	 * Gets the full names of the test cases that the automation controller of this process was asked to run.
+	 *
+	 * @param OutTestNames
+	 *	The set to which the names of the enabled test cases are added.
+	 *
+	 * @return
+	 *	true if the names are known; or, false if the automation controller is not running in this process or has not
+	 *	been asked to run any tests.
+	 */
+	bool GetRequestedTestNames(TSet<FString>& OutTestNames) const;
+
+private:
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Registers with the automation controller to be notified when tests complete, if the controller is available and
+	 * this module has not already registered.
+	 */
+	void RegisterWithAutomationController();
+
+	/**
+	 * Ends the current test session.
+	 *
+	 * This notifies each spec class, waits for abandoned asynchronous work, releases shared fixtures, and saves
+	 * timings, definitions, traces, and baselines. It runs once for each session, no matter how many spec classes ran.
+	 */
+	void EndSession();
 };
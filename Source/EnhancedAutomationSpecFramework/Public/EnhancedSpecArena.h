@@ -0,0 +1,212 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <Containers/Array.h>
+
+#include <Templates/SharedPointer.h>
+#include <Templates/UnrealTemplate.h>
+
+/**
+ * An arena that owns the scopes, test cases, and commands that a spec class creates while it is being defined.
+ *
+ * A spec class creates tens of thousands of these small objects while it is being defined, and keeps nearly all of them
+ * until it is redefined. Rather than allocating each of them on the heap individually, the arena carves them out of
+ * large blocks, one after the other, so that objects defined together also sit together in memory.
+ *
+ * Objects are still handed out through shared references, so that the automation framework can hold onto commands in
+ * the usual way. Their reference counts are allocated on the heap by the shared pointer framework, as for any object
+ * handed to MakeShareable() with a custom deleter. Each object is destroyed as soon as its last shared reference is
+ * released, but its memory is only returned to the heap, along with the rest of the arena, once the arena has been
+ * released and every object in it has been destroyed. Spec classes release their arena when they are redefined.
+ *
+ * The arena is not thread-safe; objects must only be created from the thread that is defining the spec class.
+ */
+class ENHANCEDAUTOMATIONSPECFRAMEWORK_API FEnhancedSpecArena final : public TSharedFromThis<FEnhancedSpecArena>
+{
+	// =================================================================================================================
+	// Private Types
+	// =================================================================================================================
+	/**
+	 * The deleter of an object created in the arena.
+	 *
+	 * Only the destructor of the object runs when its last shared reference is released; its memory is reclaimed with
+	 * the rest of the arena. The deleter holds the reference that keeps the arena alive for as long as the object is,
+	 * and moves that reference out before destroying the object, so that nothing of the deleter is used once the
+	 * arena, and with it the memory of the object, may have been released.
+	 *
+	 * @tparam ObjectType
+	 *	The type of object being deleted.
+	 */
+	template <typename ObjectType>
+	class TArenaDeleter final
+	{
+		// =============================================================================================================
+		// Private Fields
+		// =============================================================================================================
+		/**
+		 * The arena in which the object was created.
+		 */
+		TSharedPtr<FEnhancedSpecArena> Arena;
+
+	public:
+		// =============================================================================================================
+		// Public Constructor
+		// =============================================================================================================
+		/**
+		 * Constructs a new instance.
+		 *
+		 * @param Arena
+		 *	The arena in which the object was created.
+		 */
+		explicit TArenaDeleter(TSharedRef<FEnhancedSpecArena> Arena) :
+			Arena(MoveTemp(Arena))
+		{
+		}
+
+		// =============================================================================================================
+		// Public Operators
+		// =============================================================================================================
+		/**
+		 * Destroys the object and releases the reference of the object to its arena.
+		 *
+		 * @param Object
+		 *	The object to destroy.
+		 */
+		void operator()(ObjectType* Object)
+		{
+			const TSharedPtr<FEnhancedSpecArena> ObjectArena = MoveTemp(this->Arena);
+
+			Object->~ObjectType();
+
+			// The arena, and with it the memory of the object, is released here if this was its last reference.
+		}
+	};
+
+	// =================================================================================================================
+	// Private Constants
+	// =================================================================================================================
+	/**
+	 * The size of each block of memory that the arena allocates from the heap, in bytes.
+	 *
+	 * Objects that are larger than a quarter of a block get a block of their own, so that they do not waste the rest
+	 * of the current block.
+	 */
+	static constexpr SIZE_T BlockSize = 64 * 1024;
+
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The blocks of memory that have been allocated from the heap.
+	 */
+	TArray<void*> Blocks;
+
+	/**
+	 * The next free byte of the current block.
+	 */
+	uint8* BlockCursor;
+
+	/**
+	 * The end of the current block.
+	 */
+	uint8* BlockEnd;
+
+	/**
+	 * The number of bytes that have been handed out to objects, not counting padding for alignment.
+	 */
+	SIZE_T NumBytesUsed;
+
+	/**
+	 * The total size of all blocks that have been allocated from the heap, in bytes.
+	 */
+	SIZE_T NumBytesAllocated;
+
+public:
+	// =================================================================================================================
+	// Public Constructor / Destructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new, empty instance. No memory is allocated until the first object is created.
+	 */
+	explicit FEnhancedSpecArena();
+
+	FEnhancedSpecArena(const FEnhancedSpecArena&) = delete;
+
+	FEnhancedSpecArena& operator=(const FEnhancedSpecArena&) = delete;
+
+	/**
+	 * Destructor. Returns all blocks of the arena to the heap.
+	 */
+	~FEnhancedSpecArena();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Creates a new object in this arena.
+	 *
+	 * The object keeps the arena alive until the object is destroyed.
+	 *
+	 * @tparam ObjectType
+	 *	The type of object to create.
+	 * @tparam ArgTypes
+	 *	The types of arguments to pass to the constructor of the object.
+	 *
+	 * @param Args
+	 *	The arguments to pass to the constructor of the object.
+	 *
+	 * @return
+	 *	A shared reference to the new object.
+	 */
+	template <typename ObjectType, typename... ArgTypes>
+	TSharedRef<ObjectType> New(ArgTypes&&... Args)
+	{
+		void*       Memory = this->Allocate(sizeof(ObjectType), alignof(ObjectType));
+		ObjectType* Object = new (Memory) ObjectType(Forward<ArgTypes>(Args)...);
+
+		return MakeShareable(Object, TArenaDeleter<ObjectType>(this->AsShared()));
+	}
+
+	/**
+	 * Gets the number of bytes that have been handed out to objects created in this arena.
+	 *
+	 * @return
+	 *	The number of bytes used by objects, not counting padding for alignment.
+	 */
+	FORCEINLINE SIZE_T GetNumBytesUsed() const
+	{
+		return this->NumBytesUsed;
+	}
+
+	/**
+	 * Gets the number of bytes that this arena has allocated from the heap.
+	 *
+	 * @return
+	 *	The total size of all blocks of the arena.
+	 */
+	FORCEINLINE SIZE_T GetNumBytesAllocated() const
+	{
+		return this->NumBytesAllocated;
+	}
+
+private:
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Allocates memory for an object from the current block, starting a new block if the current one is too full.
+	 *
+	 * @param Size
+	 *	The size of the object, in bytes.
+	 * @param Alignment
+	 *	The alignment that the object requires, in bytes.
+	 *
+	 * @return
+	 *	The memory for the object.
+	 */
+	void* Allocate(const SIZE_T Size, const SIZE_T Alignment);
+};
@@ -0,0 +1,322 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <Containers/Array.h>
+#include <Containers/UnrealString.h>
+
+#include <Templates/Function.h>
+
+#include "EnhancedSpecPerfCounterValues.h"
+
+struct FEnhancedSpecBenchmarkResult;
+
+/**
+ * Limits on how long the body of a Benchmark() block may take, which fail the test case when they are exceeded.
+ *
+ * Each limit is disabled when it is 0. Absolute limits are always checked. Limits relative to the baseline are only
+ * checked once a baseline has been recorded for the benchmark, and not while baselines are being recorded.
+ */
+struct ENHANCEDAUTOMATIONSPECFRAMEWORK_API FEnhancedSpecBenchmarkBudget final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * The slowest that the median iteration time may be, in seconds.
+	 */
+	double MaxMedianSeconds = 0.0;
+
+	/**
+	 * The slowest that the 95th percentile of iteration times may be, in seconds.
+	 */
+	double MaxP95Seconds = 0.0;
+
+	/**
+	 * The slowest that the 99th percentile of iteration times may be, in seconds.
+	 */
+	double MaxP99Seconds = 0.0;
+
+	/**
+	 * How much slower than the median of the recorded baseline the median iteration time may be, as a fraction of the
+	 * baseline (e.g., 0.05 allows the median to be up to 5% slower).
+	 */
+	double MaxMedianRegression = 0.0;
+
+	/**
+	 * The most instructions that each iteration may retire, on average.
+	 *
+	 * Instruction counts are far more stable than times on shared, noisy machines. They are only checked when
+	 * hardware performance counters are being read (see FEnhancedSpecPerfCounterValues).
+	 */
+	double MaxInstructions = 0.0;
+
+	/**
+	 * How many more instructions than in the recorded baseline each iteration may retire, as a fraction of the
+	 * baseline (e.g., 0.01 allows up to 1% more instructions). This is only checked when hardware performance counters
+	 * are being read, and were also read when the baseline was recorded.
+	 */
+	double MaxInstructionsRegression = 0.0;
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether any limit of this budget is relative to the recorded baseline.
+	 *
+	 * @return
+	 *	true if the benchmark must be compared to its baseline; or, false otherwise.
+	 */
+	FORCEINLINE bool IsRelativeToBaseline() const
+	{
+		return (this->MaxMedianRegression > 0.0) || (this->MaxInstructionsRegression > 0.0);
+	}
+
+	/**
+	 * Gets whether any limit of this budget is on counts of hardware events rather than on times.
+	 *
+	 * @return
+	 *	true if hardware performance counters must be read to check this budget; or, false otherwise.
+	 */
+	FORCEINLINE bool UsesPerfCounters() const
+	{
+		return (this->MaxInstructions > 0.0) || (this->MaxInstructionsRegression > 0.0);
+	}
+
+	/**
+	 * Checks the results of a benchmark against the limits of this budget.
+	 *
+	 * @param Result
+	 *	The results of the benchmark.
+	 * @param Baseline
+	 *	The recorded baseline of the benchmark; or, nullptr to skip the limits that are relative to the baseline.
+	 *
+	 * @return
+	 *	A description of each limit that was exceeded, or an empty array if the results are within budget.
+	 */
+	TArray<FString> Check(const FEnhancedSpecBenchmarkResult& Result,
+	                      const FEnhancedSpecBenchmarkResult* Baseline) const;
+};
+
+/**
+ * Settings that control how the body of a Benchmark() block is measured.
+ */
+struct ENHANCEDAUTOMATIONSPECFRAMEWORK_API FEnhancedSpecBenchmarkOptions final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * How long to run the body before measuring it, in seconds, so that caches, allocators, and lazily-initialized
+	 * state have settled. The body always runs at least once before it is measured.
+	 */
+	double WarmupSeconds = 0.1;
+
+	/**
+	 * The shortest time that each sample should take, in seconds.
+	 *
+	 * Bodies that finish faster than this are run several times per sample, so that the time of each sample is well
+	 * above the resolution of the clock.
+	 */
+	double MinSampleSeconds = 0.001;
+
+	/**
+	 * The number of samples to take.
+	 */
+	int32 NumSamples = 30;
+
+	/**
+	 * The longest that measuring may take, in seconds, not counting the warmup.
+	 *
+	 * Fewer samples are taken if taking all of them would take longer than this, but never fewer than MinNumSamples.
+	 */
+	double MaxSeconds = 10.0;
+
+	/**
+	 * The fewest samples to take, even if taking them takes longer than MaxSeconds.
+	 */
+	int32 MinNumSamples = 5;
+
+	/**
+	 * How far from the median a sample must be to be rejected as an outlier, in multiples of the median absolute
+	 * deviation (scaled to be comparable to a standard deviation). 0 disables outlier rejection.
+	 */
+	double OutlierThreshold = 3.0;
+
+	/**
+	 * Limits on how long the body may take. No limits are enforced by default.
+	 */
+	FEnhancedSpecBenchmarkBudget Budget;
+};
+
+/**
+ * Statistics about how long each iteration of the body of a Benchmark() block took.
+ *
+ * All times are per iteration of the body, in seconds. The minimum, median, and mean are computed after outliers have
+ * been rejected, so that a few samples disturbed by the rest of the machine do not skew them. The 95th and 99th
+ * percentiles, the maximum, and the median absolute deviation are computed over all samples, including outliers, since
+ * rare slow iterations are exactly what they are meant to capture.
+ */
+struct ENHANCEDAUTOMATIONSPECFRAMEWORK_API FEnhancedSpecBenchmarkResult final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * How many times the body ran in each sample.
+	 */
+	int64 IterationsPerSample = 0;
+
+	/**
+	 * How many samples were taken, including outliers.
+	 */
+	int32 NumSamples = 0;
+
+	/**
+	 * How many samples were rejected as outliers.
+	 */
+	int32 NumOutliers = 0;
+
+	/**
+	 * The fastest iteration time.
+	 */
+	double MinSeconds = 0.0;
+
+	/**
+	 * The median iteration time.
+	 */
+	double MedianSeconds = 0.0;
+
+	/**
+	 * The mean iteration time.
+	 */
+	double MeanSeconds = 0.0;
+
+	/**
+	 * The 95th percentile of iteration times, including outliers.
+	 */
+	double P95Seconds = 0.0;
+
+	/**
+	 * The 99th percentile of iteration times, including outliers.
+	 */
+	double P99Seconds = 0.0;
+
+	/**
+	 * The slowest iteration time, including outliers.
+	 */
+	double MaxSeconds = 0.0;
+
+	/**
+	 * The median absolute deviation of all iteration times from their median, including outliers.
+	 */
+	double MadSeconds = 0.0;
+
+	/**
+	 * The hardware events of each iteration, on average across all samples; or, no counts if hardware performance
+	 * counters are not being read.
+	 */
+	FEnhancedSpecPerfCounterValues PerfCounters;
+
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Computes statistics from samples.
+	 *
+	 * @param SampleSeconds
+	 *	The time of each iteration in each sample, in seconds.
+	 * @param IterationsPerSample
+	 *	How many times the body ran in each sample.
+	 * @param OutlierThreshold
+	 *	How far from the median a sample must be to be rejected as an outlier, in multiples of the scaled median
+	 *	absolute deviation; or, 0 to keep all samples.
+	 *
+	 * @return
+	 *	The statistics of the samples.
+	 */
+	static FEnhancedSpecBenchmarkResult FromSamples(TArray<double> SampleSeconds,
+	                                                const int64    IterationsPerSample,
+	                                                const double   OutlierThreshold);
+
+	/**
+	 * Gets the value at a percentile of sorted values, interpolating linearly between the two nearest values.
+	 *
+	 * @param SortedValues
+	 *	The values, in ascending order. Must not be empty.
+	 * @param Percentile
+	 *	The percentile, from 0 to 100.
+	 *
+	 * @return
+	 *	The value at the percentile.
+	 */
+	static double GetPercentile(const TArray<double>& SortedValues, const double Percentile);
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Formats these statistics for humans to read.
+	 *
+	 * @return
+	 *	A single-line summary of these statistics.
+	 */
+	FString ToString() const;
+};
+
+/**
+ * Measures how long code takes to run, for Benchmark() blocks.
+ */
+class ENHANCEDAUTOMATIONSPECFRAMEWORK_API FEnhancedSpecBenchmark final
+{
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Warms up and then measures the body of a benchmark.
+	 *
+	 * The number of iterations per sample is calibrated during the warmup, so that each sample takes at least
+	 * Options.MinSampleSeconds. If hardware performance counters are enabled, they are read around the samples.
+	 *
+	 * @param Body
+	 *	The code to measure.
+	 * @param Options
+	 *	Settings that control how the body is measured.
+	 * @param ShouldStop
+	 *	A callback that is checked after the first run of the body and after each sample, and returns true if the body
+	 *	has failed and measuring should stop early.
+	 *
+	 * @return
+	 *	The statistics of the samples that were taken; or, statistics with no samples if measuring stopped early.
+	 */
+	static FEnhancedSpecBenchmarkResult Run(const TFunctionRef<void()>           Body,
+	                                        const FEnhancedSpecBenchmarkOptions& Options,
+	                                        const TFunctionRef<bool()>           ShouldStop);
+
+	/**
+	 * Writes the results of a benchmark as JSON to the benchmark results directory.
+	 *
+	 * By default, results are written to "Saved/Automation/EnhancedSpecBenchmarks", but a different directory can be
+	 * supplied on the command line with "-EnhancedSpecBenchmarkResults=<Path>".
+	 *
+	 * @param FullTestName
+	 *	The name of the spec class followed by a space and the ID of the test case of the benchmark.
+	 * @param Filename
+	 *	The filename of the specification in which the benchmark was defined.
+	 * @param LineNumber
+	 *	The line number where the benchmark was defined.
+	 * @param Result
+	 *	The results to write.
+	 *
+	 * @return
+	 *	The path of the file the results were written to; or, an empty string if they could not be written.
+	 */
+	static FString SaveResult(const FString&                      FullTestName,
+	                          const FString&                      Filename,
+	                          const int32                         LineNumber,
+	                          const FEnhancedSpecBenchmarkResult& Result);
+};
@@ -0,0 +1,342 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <HAL/CriticalSection.h>
+
+#include <Misc/ScopeLock.h>
+
+#include <Templates/Function.h>
+#include <Templates/SharedPointer.h>
+
+#include <UObject/NameTypes.h>
+
+/**
+ * Un-templated base class for fixtures that are shared by multiple spec classes.
+ *
+ * Each fixture has a unique name and registers itself with FEnhancedSpecFixtureRegistry when it is constructed. The
+ * registry tracks how many spec classes depend on the fixture, so that the value of the fixture can be released as soon
+ * as the last of them has finished running.
+ */
+class ENHANCEDAUTOMATIONSPECFRAMEWORK_API FEnhancedSpecFixtureBase
+{
+	friend class FEnhancedSpecFixtureRegistry;
+
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The unique name of this fixture.
+	 */
+	FName Name;
+
+	/**
+	 * The number of spec classes that have declared a dependency on this fixture and have test cases on this runner.
+	 */
+	int32 NumDependents;
+
+	/**
+	 * The number of dependent spec classes that have not yet finished running during the current test session.
+	 */
+	int32 NumRemainingDependents;
+
+protected:
+	// =================================================================================================================
+	// Protected Fields
+	// =================================================================================================================
+	/**
+	 * Guards building and releasing the value of this fixture, since test cases that run in parallel can request it.
+	 */
+	mutable FCriticalSection Lock;
+
+public:
+	// =================================================================================================================
+	// Public Constructor / Destructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new instance and registers it with the fixture registry.
+	 *
+	 * @param Name
+	 *	The unique name of the fixture.
+	 */
+	explicit FEnhancedSpecFixtureBase(const FName Name);
+
+	FEnhancedSpecFixtureBase(const FEnhancedSpecFixtureBase&) = delete;
+
+	FEnhancedSpecFixtureBase& operator=(const FEnhancedSpecFixtureBase&) = delete;
+
+	/**
+	 * Destructor. Unregisters this fixture from the fixture registry.
+	 */
+	virtual ~FEnhancedSpecFixtureBase();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets the unique name of this fixture.
+	 *
+	 * @return
+	 *	The name of the fixture.
+	 */
+	FORCEINLINE FName GetName() const
+	{
+		return this->Name;
+	}
+
+	/**
+	 * Gets whether the value of this fixture has been built and not yet released.
+	 *
+	 * @return
+	 *	true if the value is currently alive; or, false otherwise.
+	 */
+	virtual bool IsBuilt() const = 0;
+
+protected:
+	// =================================================================================================================
+	// Protected Methods
+	// =================================================================================================================
+	/**
+	 * Releases the value of this fixture, if it has been built.
+	 *
+	 * Test cases that are still holding a reference to the value keep it alive until they let go of it.
+	 */
+	virtual void Release() = 0;
+};
+
+/**
+ * A fixture of a specific type that is built once per runner and shared, read-only, by multiple spec classes.
+ *
+ * Fixtures are meant to be declared as global variables in the test module, so that every spec class that needs them
+ * can refer to them. For example:
+ *
+ * @code
+ * TEnhancedSpecFixture<FMyDataTable> GMyDataTableFixture(TEXT("MyDataTable"), []
+ * {
+ *	return MakeShared<FMyDataTable>(LoadMyDataTable());
+ * });
+ * @endcode
+ *
+ * A spec class that uses the fixture must declare its dependency by calling UseFixture() from Define(). The value is
+ * built by the factory the first time it is requested, and is released once all spec classes that depend on it have
+ * finished running on the current runner, or at the end of the test session, whichever comes first.
+ *
+ * @tparam FixtureType
+ *	The type of the value of the fixture.
+ */
+template <typename FixtureType>
+class TEnhancedSpecFixture final : public FEnhancedSpecFixtureBase
+{
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * The function that builds the value of this fixture.
+	 */
+	TFunction<TSharedRef<FixtureType>()> Factory;
+
+	/**
+	 * The value of this fixture, or a null pointer if it has not yet been built or has been released.
+	 */
+	TSharedPtr<const FixtureType> Value;
+
+public:
+	// =================================================================================================================
+	// Public Constructor
+	// =================================================================================================================
+	/**
+	 * Constructs a new instance and registers it with the fixture registry.
+	 *
+	 * @param Name
+	 *	The unique name of the fixture.
+	 * @param Factory
+	 *	The function that builds the value of the fixture.
+	 */
+	explicit TEnhancedSpecFixture(const FName Name, TFunction<TSharedRef<FixtureType>()> Factory) :
+		FEnhancedSpecFixtureBase(Name),
+		Factory(MoveTemp(Factory))
+	{
+	}
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets the value of this fixture, building it if it has not yet been built.
+	 *
+	 * @return
+	 *	The shared, read-only value of the fixture.
+	 */
+	TSharedRef<const FixtureType> Get()
+	{
+		FScopeLock ScopeLock(&this->Lock);
+
+		if (!this->Value.IsValid())
+		{
+			this->Value = this->Factory();
+		}
+
+		return this->Value.ToSharedRef();
+	}
+
+	/**
+	 * Gets the value of this fixture, building it if it has not yet been built.
+	 *
+	 * @return
+	 *	The shared, read-only value of the fixture.
+	 */
+	FORCEINLINE const FixtureType& operator*()
+	{
+		return this->Get().Get();
+	}
+
+	/**
+	 * Gets the value of this fixture, building it if it has not yet been built.
+	 *
+	 * @return
+	 *	The shared, read-only value of the fixture.
+	 */
+	FORCEINLINE const FixtureType* operator->()
+	{
+		return &this->Get().Get();
+	}
+
+	// =================================================================================================================
+	// Public Methods - FEnhancedSpecFixtureBase Overrides
+	// =================================================================================================================
+	virtual bool IsBuilt() const override
+	{
+		FScopeLock ScopeLock(&this->Lock);
+
+		return this->Value.IsValid();
+	}
+
+protected:
+	// =================================================================================================================
+	// Protected Methods - FEnhancedSpecFixtureBase Overrides
+	// =================================================================================================================
+	virtual void Release() override
+	{
+		TSharedPtr<const FixtureType> ReleasedValue;
+
+		{
+			FScopeLock ScopeLock(&this->Lock);
+
+			ReleasedValue = MoveTemp(this->Value);
+		}
+
+		// The value is destroyed here, outside the lock, when this is the last reference to it.
+	}
+};
+
+/**
+ * The registry of all fixtures that are shared by spec classes.
+ *
+ * The registry counts, for each fixture, the spec classes that have declared a dependency on it with UseFixture() and
+ * that have test cases on the current runner. Each of those spec classes reports when its last test case has
+ * finished; once all of them have, the value of the fixture is released. All values are released at the end of each
+ * test session, and the counts start over for the next session.
+ */
+class ENHANCEDAUTOMATIONSPECFRAMEWORK_API FEnhancedSpecFixtureRegistry final
+{
+	// =================================================================================================================
+	// Private Fields
+	// =================================================================================================================
+	/**
+	 * Guards access to the fixtures and their counts.
+	 */
+	FCriticalSection Lock;
+
+	/**
+	 * All registered fixtures, keyed by name.
+	 */
+	TMap<FName, FEnhancedSpecFixtureBase*> Fixtures;
+
+public:
+	// =================================================================================================================
+	// Public Static Methods
+	// =================================================================================================================
+	/**
+	 * Gets the fixture registry for this process.
+	 *
+	 * @return
+	 *	The fixture registry.
+	 */
+	static FEnhancedSpecFixtureRegistry& Get();
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Adds a fixture to this registry.
+	 *
+	 * @param Fixture
+	 *	The fixture to add. Its name must not be in use by any other fixture.
+	 */
+	void Register(FEnhancedSpecFixtureBase& Fixture);
+
+	/**
+	 * Removes a fixture from this registry.
+	 *
+	 * @param Fixture
+	 *	The fixture to remove.
+	 */
+	void Unregister(FEnhancedSpecFixtureBase& Fixture);
+
+	/**
+	 * Looks up a fixture by name.
+	 *
+	 * @param Name
+	 *	The name of the fixture.
+	 *
+	 * @return
+	 *	The fixture; or, a null pointer if no fixture has been registered with that name.
+	 */
+	FEnhancedSpecFixtureBase* Find(const FName Name);
+
+	/**
+	 * Records that a spec class with test cases on this runner depends on a fixture.
+	 *
+	 * @param Fixture
+	 *	The fixture on which the spec class depends.
+	 */
+	void AddDependent(FEnhancedSpecFixtureBase& Fixture);
+
+	/**
+	 * Forgets a dependency that was recorded with AddDependent() (e.g., because the spec class is being redefined).
+	 *
+	 * @param Fixture
+	 *	The fixture on which the spec class no longer depends.
+	 */
+	void RemoveDependent(FEnhancedSpecFixtureBase& Fixture);
+
+	/**
+	 * Records that a dependent spec class has finished running all of its test cases on this runner.
+	 *
+	 * The value of the fixture is released once all of its dependents have finished.
+	 *
+	 * @param Fixture
+	 *	The fixture on which the spec class depends.
+	 */
+	void MarkDependentAsFinished(FEnhancedSpecFixtureBase& Fixture);
+
+	/**
+	 * Releases the values of all fixtures and resets their counts for the next test session.
+	 */
+	void EndSession();
+
+private:
+	// =================================================================================================================
+	// Private Methods
+	// =================================================================================================================
+	/**
+	 * Releases the value of a fixture and logs that it was released.
+	 *
+	 * @param Fixture
+	 *	The fixture to release.
+	 */
+	static void ReleaseFixture(FEnhancedSpecFixtureBase& Fixture);
+};
@@ -0,0 +1,106 @@
+// Enhanced Automation Specs for UE, Copyright 2024, Guy Elsmore-Paddock. All Rights Reserved.
+//
+// This Source Code Form is subject to the terms of the MIT License. If a copy of the license was not distributed with
+// this file, you can obtain one at https://github.com/OpenPF2/EnhancedUnrealSpecs/blob/main/LICENSE.txt.
+
+#pragma once
+
+#include <Containers/UnrealString.h>
+
+#include <Templates/Function.h>
+
+/**
+ * Counts of hardware events that occurred while code ran, read from the performance counters of the CPU.
+ *
+ * Counters are only read on Linux, when "-EnhancedSpecPerfCounters" is passed on the command line. Each count is
+ * negative when its counter could not be read (e.g., because the CPU, the hypervisor, or the kernel does not expose
+ * it).
+ */
+struct ENHANCEDAUTOMATIONSPECFRAMEWORK_API FEnhancedSpecPerfCounterValues final
+{
+	// =================================================================================================================
+	// Public Fields
+	// =================================================================================================================
+	/**
+	 * The number of instructions that were retired.
+	 *
+	 * Unlike times, this is nearly the same from run to run and from machine to machine, which makes it suitable for
+	 * budgets on shared, noisy machines.
+	 */
+	double Instructions = -1.0;
+
+	/**
+	 * The number of CPU cycles that elapsed.
+	 */
+	double Cycles = -1.0;
+
+	/**
+	 * The number of reads that missed the level 1 data cache.
+	 */
+	double L1DataCacheMisses = -1.0;
+
+	/**
+	 * The number of accesses that missed the last level cache.
+	 */
+	double LastLevelCacheMisses = -1.0;
+
+	/**
+	 * The number of branches that were mispredicted.
+	 */
+	double BranchMisses = -1.0;
+
+	// =================================================================================================================
+	// Public Methods
+	// =================================================================================================================
+	/**
+	 * Gets whether any counter could be read.
+	 *
+	 * @return
+	 *	true if at least one count is available; or, false otherwise.
+	 */
+	FORCEINLINE bool HasAny() const
+	{
+		return (this->Instructions >= 0.0) ||
+		       (this->Cycles >= 0.0) ||
+		       (this->L1DataCacheMisses >= 0.0) ||
+		       (this->LastLevelCacheMisses >= 0.0) ||
+		       (this->BranchMisses >= 0.0);
+	}
+
+	/**
+	 * Calls a function with the name and value of each count, whether or not it is available, so that the counts can
+	 * be changed or read as fields.
+	 *
+	 * @param Visitor
+	 *	The function to call with the name and value of each count. Changes it makes to a value are kept.
+	 */
+	void ForEachCount(const TFunctionRef<void(const TCHAR* Name, double& Value)> Visitor);
+
+	/**
+	 * Calls a function with the name and value of each count, whether or not it is available, so that the counts can
+	 * be written as fields.
+	 *
+	 * @param Visitor
+	 *	The function to call with the name and value of each count.
+	 */
+	void ForEachCount(const TFunctionRef<void(const TCHAR* Name, double Value)> Visitor) const;
+
+	/**
+	 * Divides each available count, such as to get the counts of a single iteration of code that ran many times.
+	 *
+	 * @param Divisor
+	 *	The number to divide each count by. Must be positive.
+	 *
+	 * @return
+	 *	The divided counts. Counts that are not available stay unavailable.
+	 */
+	FEnhancedSpecPerfCounterValues DividedBy(const double Divisor) const;
+
+	/**
+	 * Formats the available counts for humans to read.
+	 *
+	 * @return
+	 *	A single-line summary of the counts.
+	 */
+	FString ToString() const;
+};